@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationcounter.cpp
+// ============
+// count the heap allocations made by the program in debug builds
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// declaration of global variables
+namespace
+{
+	// zero before any constructor runs, so allocations made by
+	// the static objects of other files are counted as well
+	std::atomic<uint64_t> g_AllocationCount(0);
+}
+
+#if COUNT_HEAP_ALLOCATIONS
+
+/***********************************************************
+ *  operator new()
+ *
+ *  These functions replace the global allocation functions
+ *  of the program, counting every allocation before taking
+ *  the memory from malloc.
+ ***********************************************************/
+void* operator new(size_t size)
+{
+	g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	void* pMemory = malloc((size > 0) ? size : 1);
+	if (NULL == pMemory)
+	{
+		throw std::bad_alloc();
+	}
+
+	return(pMemory);
+}
+
+void* operator new[](size_t size)
+{
+	return(operator new(size));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	g_AllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	return(malloc((size > 0) ? size : 1));
+}
+
+void* operator new[](size_t size, const std::nothrow_t& nothrow) noexcept
+{
+	return(operator new(size, nothrow));
+}
+
+void operator delete(void* pMemory) noexcept
+{
+	free(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept
+{
+	free(pMemory);
+}
+
+void operator delete(void* pMemory, size_t) noexcept
+{
+	free(pMemory);
+}
+
+void operator delete[](void* pMemory, size_t) noexcept
+{
+	free(pMemory);
+}
+
+void operator delete(void* pMemory, const std::nothrow_t&) noexcept
+{
+	free(pMemory);
+}
+
+void operator delete[](void* pMemory, const std::nothrow_t&) noexcept
+{
+	free(pMemory);
+}
+
+#endif
+
+/***********************************************************
+ *  IsEnabled()
+ *
+ *  This method is used for checking whether the allocations
+ *  are counted in this build.
+ ***********************************************************/
+bool AllocationCounter::IsEnabled()
+{
+#if COUNT_HEAP_ALLOCATIONS
+	return(true);
+#else
+	return(false);
+#endif
+}
+
+/***********************************************************
+ *  GetAllocationCount()
+ *
+ *  This method is used for getting the number of allocations
+ *  made since the program started, which stays at zero when
+ *  they are not counted.
+ ***********************************************************/
+uint64_t AllocationCounter::GetAllocationCount()
+{
+	return(g_AllocationCount.load(std::memory_order_relaxed));
+}
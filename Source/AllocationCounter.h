@@ -0,0 +1,35 @@
+///////////////////////////////////////////////////////////////////////////////
+// allocationcounter.h
+// ============
+// count the heap allocations made by the program in debug builds
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+// the global operator new is only replaced in debug builds,
+// unless the counter is asked for in another configuration
+#if defined(_DEBUG) && !defined(COUNT_HEAP_ALLOCATIONS)
+#define COUNT_HEAP_ALLOCATIONS 1
+#endif
+
+/***********************************************************
+ *  AllocationCounter
+ *
+ *  This class reads the number of times the global operator
+ *  new has been called on any thread, which the frame loop
+ *  takes the difference of to show the heap allocations made
+ *  by every frame.  Memory taken with malloc directly by the
+ *  libraries and the driver is not counted.
+ ***********************************************************/
+class AllocationCounter
+{
+public:
+	// set when operator new is counted in this build
+	static bool IsEnabled();
+	// allocations made since the program started
+	static uint64_t GetAllocationCount();
+};
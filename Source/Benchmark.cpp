@@ -0,0 +1,391 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmark.cpp
+// ============
+// replay a camera path offscreen and report the frame time statistics
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+/***********************************************************
+ *  Benchmark()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+Benchmark::Benchmark()
+{
+	m_framebuffer = 0;
+	m_colorBuffer = 0;
+	m_depthBuffer = 0;
+	m_width = 0;
+	m_height = 0;
+	m_frameCount = 0;
+	m_warmupFrameCount = 0;
+	m_currentFrame = 0;
+
+	SetDefaultCameraPath();
+}
+
+/***********************************************************
+ *  ~Benchmark()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+Benchmark::~Benchmark()
+{
+	if (0 != m_framebuffer)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	if (0 != m_colorBuffer)
+	{
+		glDeleteRenderbuffers(1, &m_colorBuffer);
+		m_colorBuffer = 0;
+	}
+	if (0 != m_depthBuffer)
+	{
+		glDeleteRenderbuffers(1, &m_depthBuffer);
+		m_depthBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  SetDefaultCameraPath()
+ *
+ *  This method is used for setting the built in camera path,
+ *  which starts at the driver's view, circles past the wheel,
+ *  the screen and the center console, and returns to the start.
+ ***********************************************************/
+void Benchmark::SetDefaultCameraPath()
+{
+	const CAMERA_KEYFRAME keyframes[] =
+	{
+		{ 0.0f, glm::vec3(0.0f, 1.5f, 3.0f), glm::vec3(0.0f, 0.9f, -0.9f) },
+		{ 1.0f, glm::vec3(-1.2f, 1.3f, 1.5f), glm::vec3(-0.65f, 0.85f, -0.7f) },
+		{ 2.0f, glm::vec3(0.0f, 1.0f, 0.8f), glm::vec3(0.0f, 0.9f, -0.85f) },
+		{ 3.0f, glm::vec3(1.2f, 1.3f, 1.5f), glm::vec3(0.0f, 0.3f, 0.4f) },
+		{ 4.0f, glm::vec3(0.0f, 1.5f, 3.0f), glm::vec3(0.0f, 0.9f, -0.9f) }
+	};
+
+	m_cameraPath.assign(keyframes, keyframes + sizeof(keyframes) / sizeof(keyframes[0]));
+}
+
+/***********************************************************
+ *  LoadCameraPath()
+ *
+ *  This method is used for reading a camera path from a text
+ *  file.  Empty lines and lines starting with # are skipped.
+ *  The current path is kept when the file cannot be used.
+ ***********************************************************/
+bool Benchmark::LoadCameraPath(const char* filename)
+{
+	std::ifstream file(filename);
+	std::vector<CAMERA_KEYFRAME> keyframes;
+	std::string line;
+	int lineNumber = 0;
+
+	if (!file.is_open())
+	{
+		std::cout << "Could not open the camera path:" << filename << std::endl;
+		return(false);
+	}
+
+	while (std::getline(file, line))
+	{
+		std::istringstream values(line);
+		CAMERA_KEYFRAME keyframe;
+		std::string first;
+
+		lineNumber++;
+		if (!(values >> first) || (first[0] == '#'))
+		{
+			continue;
+		}
+
+		values.clear();
+		values.str(line);
+		if (!(values >> keyframe.time
+			>> keyframe.position.x >> keyframe.position.y >> keyframe.position.z
+			>> keyframe.target.x >> keyframe.target.y >> keyframe.target.z))
+		{
+			std::cout << "Invalid camera keyframe on line " << lineNumber << " of " << filename << std::endl;
+			return(false);
+		}
+		keyframes.push_back(keyframe);
+	}
+
+	if (keyframes.empty())
+	{
+		std::cout << "The camera path has no keyframes:" << filename << std::endl;
+		return(false);
+	}
+
+	std::stable_sort(keyframes.begin(), keyframes.end(),
+		[](const CAMERA_KEYFRAME& a, const CAMERA_KEYFRAME& b) { return(a.time < b.time); });
+	m_cameraPath = keyframes;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the offscreen target that
+ *  the frames are rendered into, since the hidden window has
+ *  no visible framebuffer to draw to.
+ ***********************************************************/
+bool Benchmark::Initialize(int width, int height, int frameCount, int warmupFrameCount)
+{
+	GLenum status = GL_FRAMEBUFFER_COMPLETE;
+
+	if ((width <= 0) || (height <= 0) || (frameCount <= 0))
+	{
+		return(false);
+	}
+
+	m_width = width;
+	m_height = height;
+	m_frameCount = frameCount;
+	m_warmupFrameCount = (warmupFrameCount < frameCount) ? warmupFrameCount : (frameCount - 1);
+	m_currentFrame = 0;
+
+	glGenRenderbuffers(1, &m_colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_width, m_height);
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_width, m_height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+	status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (GL_FRAMEBUFFER_COMPLETE != status)
+	{
+		std::cout << "The benchmark framebuffer is incomplete: 0x" << std::hex << status << std::dec << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  SampleCameraPath()
+ *
+ *  This method is used for interpolating the camera path at
+ *  the passed in time, holding the first and last keyframes
+ *  outside of the path.
+ ***********************************************************/
+void Benchmark::SampleCameraPath(float time, glm::vec3& position, glm::vec3& target) const
+{
+	size_t next = 0;
+
+	if (m_cameraPath.empty())
+	{
+		return;
+	}
+
+	while ((next < m_cameraPath.size()) && (m_cameraPath[next].time < time))
+	{
+		next++;
+	}
+
+	if (next == 0)
+	{
+		position = m_cameraPath.front().position;
+		target = m_cameraPath.front().target;
+	}
+	else if (next == m_cameraPath.size())
+	{
+		position = m_cameraPath.back().position;
+		target = m_cameraPath.back().target;
+	}
+	else
+	{
+		const CAMERA_KEYFRAME& from = m_cameraPath[next - 1];
+		const CAMERA_KEYFRAME& to = m_cameraPath[next];
+		float span = to.time - from.time;
+		float blend = (span > 0.0f) ? ((time - from.time) / span) : 1.0f;
+
+		position = glm::mix(from.position, to.position, blend);
+		target = glm::mix(from.target, to.target, blend);
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for binding the offscreen target and
+ *  getting the camera pose of the current frame.  The path is
+ *  stretched over the whole run by frame number.
+ ***********************************************************/
+void Benchmark::BeginFrame(glm::vec3& position, glm::vec3& target)
+{
+	float startTime = m_cameraPath.empty() ? 0.0f : m_cameraPath.front().time;
+	float endTime = m_cameraPath.empty() ? 0.0f : m_cameraPath.back().time;
+	float progress = (m_frameCount > 1) ? ((float)m_currentFrame / (float)(m_frameCount - 1)) : 0.0f;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, m_width, m_height);
+
+	SampleCameraPath(startTime + (endTime - startTime) * progress, position, target);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for waiting until the GPU has finished
+ *  the frame.  Without a swap nothing else would hold the CPU
+ *  back, so the frame times would only measure submission.
+ ***********************************************************/
+void Benchmark::EndFrame()
+{
+	glFinish();
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	m_currentFrame++;
+}
+
+/***********************************************************
+ *  ReadPixels()
+ *
+ *  This method is used for reading back the color of the
+ *  offscreen target after EndFrame(), which has already
+ *  waited for the GPU to finish drawing it.
+ ***********************************************************/
+void Benchmark::ReadPixels(std::vector<unsigned char>& pixels) const
+{
+	pixels.resize((size_t)m_width * (size_t)m_height * 3);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, &pixels[0]);
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+/***********************************************************
+ *  Summarize()
+ *
+ *  This method is used for getting the min, mean, 99th
+ *  percentile and max of the passed in times.  The percentile
+ *  is the nearest rank, so it is always one of the samples.
+ ***********************************************************/
+Benchmark::TIME_SUMMARY Benchmark::Summarize(std::vector<double> times)
+{
+	TIME_SUMMARY summary = { 0, 0.0, 0.0, 0.0, 0.0 };
+	double total = 0.0;
+
+	times.erase(std::remove_if(times.begin(), times.end(),
+		[](double time) { return(time < 0.0); }), times.end());
+	if (times.empty())
+	{
+		return(summary);
+	}
+
+	std::sort(times.begin(), times.end());
+	for (size_t i = 0; i < times.size(); i++)
+	{
+		total += times[i];
+	}
+
+	size_t rank = (size_t)std::ceil(0.99 * (double)times.size());
+	summary.sampleCount = times.size();
+	summary.minimum = times.front();
+	summary.mean = total / (double)times.size();
+	summary.percentile99 = times[(rank > 0) ? (rank - 1) : 0];
+	summary.maximum = times.back();
+
+	return(summary);
+}
+
+/***********************************************************
+ *  WriteResults()
+ *
+ *  This method is used for writing the statistics of the
+ *  measured frames as JSON: the whole frame, then the CPU and
+ *  GPU time of every profiled section, all in milliseconds.
+ ***********************************************************/
+bool Benchmark::WriteResults(
+	const char* filename,
+	const FrameProfiler& profiler,
+	const char* renderPathName) const
+{
+	const std::vector<FrameProfiler::FRAME_STATS>& frames = profiler.GetFrames();
+	std::vector<double> frameTimes;
+	std::ofstream file(filename);
+	size_t firstFrame = (size_t)m_warmupFrameCount;
+
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	for (size_t i = firstFrame; i < frames.size(); i++)
+	{
+		frameTimes.push_back(frames[i].frameMilliseconds);
+	}
+
+	file << std::fixed << std::setprecision(4);
+	file << "{\n";
+	file << "  \"frames\": " << m_frameCount << ",\n";
+	file << "  \"warmup_frames\": " << m_warmupFrameCount << ",\n";
+	file << "  \"width\": " << m_width << ",\n";
+	file << "  \"height\": " << m_height << ",\n";
+	file << "  \"render_path\": \"" << renderPathName << "\",\n";
+	file << "  ";
+	WriteSummary(file, "frame_ms", Summarize(frameTimes));
+	file << ",\n";
+	file << "  \"scopes\": {\n";
+
+	for (int scope = 0; scope < FrameProfiler::SCOPE_COUNT; scope++)
+	{
+		std::vector<double> cpuTimes;
+		std::vector<double> gpuTimes;
+
+		for (size_t i = firstFrame; i < frames.size(); i++)
+		{
+			cpuTimes.push_back(frames[i].cpuMilliseconds[scope]);
+			gpuTimes.push_back(frames[i].gpuMilliseconds[scope]);
+		}
+
+		file << "    \"" << FrameProfiler::GetScopeName((FrameProfiler::PROFILE_SCOPE)scope) << "\": {\n      ";
+		WriteSummary(file, "cpu_ms", Summarize(cpuTimes));
+		file << ",\n      ";
+		WriteSummary(file, "gpu_ms", Summarize(gpuTimes));
+		file << "\n    }" << ((scope + 1 < FrameProfiler::SCOPE_COUNT) ? "," : "") << "\n";
+	}
+
+	file << "  }\n";
+	file << "}\n";
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  WriteSummary()
+ *
+ *  This method is used for writing one time summary as a
+ *  named JSON object.
+ ***********************************************************/
+void Benchmark::WriteSummary(std::ostream& stream, const char* name, const TIME_SUMMARY& summary)
+{
+	stream << "\"" << name << "\": { "
+		<< "\"samples\": " << summary.sampleCount
+		<< ", \"min\": " << summary.minimum
+		<< ", \"mean\": " << summary.mean
+		<< ", \"p99\": " << summary.percentile99
+		<< ", \"max\": " << summary.maximum << " }";
+}
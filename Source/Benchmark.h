@@ -0,0 +1,114 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmark.h
+// ============
+// replay a camera path offscreen and report the frame time statistics
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameProfiler.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  Benchmark
+ *
+ *  This class runs the scene for a fixed number of frames
+ *  without anyone at the keyboard.  The frames are rendered
+ *  into a framebuffer object of a hidden window, the camera
+ *  follows a path of keyframes that is sampled by frame
+ *  number rather than by time, so every run draws the same
+ *  images, and the frame times recorded by the profiler are
+ *  written out as JSON when the run is done.
+ ***********************************************************/
+class Benchmark
+{
+public:
+	// constructor
+	Benchmark();
+	// destructor
+	~Benchmark();
+
+	// use the built in path through the car interior
+	void SetDefaultCameraPath();
+	// read the camera path from a text file with one keyframe
+	// per line: "time posX posY posZ targetX targetY targetZ"
+	bool LoadCameraPath(const char* filename);
+
+	// create the offscreen target and set the frame counts
+	bool Initialize(int width, int height, int frameCount, int warmupFrameCount);
+
+	// check whether every frame of the run has been rendered
+	bool IsFinished() const { return(m_currentFrame >= m_frameCount); }
+	int GetCurrentFrame() const { return(m_currentFrame); }
+	int GetFrameCount() const { return(m_frameCount); }
+	int GetWarmupFrameCount() const { return(m_warmupFrameCount); }
+	int GetWidth() const { return(m_width); }
+	int GetHeight() const { return(m_height); }
+	// start the camera path over for another run of frames
+	void Restart() { m_currentFrame = 0; }
+
+	// bind the offscreen target and get the camera pose of the
+	// current frame
+	void BeginFrame(glm::vec3& position, glm::vec3& target);
+	// wait for the frame to finish on the GPU, which takes the
+	// place of the buffer swap, and move to the next frame
+	void EndFrame();
+	// read the last rendered frame as rows of RGB bytes, from
+	// the bottom row up
+	void ReadPixels(std::vector<unsigned char>& pixels) const;
+
+	// write the frame time statistics of the measured frames,
+	// skipping the warm up frames
+	bool WriteResults(
+		const char* filename,
+		const FrameProfiler& profiler,
+		const char* renderPathName) const;
+
+private:
+	// one point of the camera path
+	struct CAMERA_KEYFRAME
+	{
+		float time;
+		glm::vec3 position;
+		glm::vec3 target;
+	};
+
+	// min, mean, 99th percentile and max of a set of times
+	struct TIME_SUMMARY
+	{
+		size_t sampleCount;
+		double minimum;
+		double mean;
+		double percentile99;
+		double maximum;
+	};
+
+	// camera path, sorted by time
+	std::vector<CAMERA_KEYFRAME> m_cameraPath;
+	// offscreen framebuffer and its attachments
+	GLuint m_framebuffer;
+	GLuint m_colorBuffer;
+	GLuint m_depthBuffer;
+	int m_width;
+	int m_height;
+	// frames of the whole run, and how many of the first ones
+	// are left out of the statistics
+	int m_frameCount;
+	int m_warmupFrameCount;
+	int m_currentFrame;
+
+	// interpolate the camera path at the passed in time
+	void SampleCameraPath(float time, glm::vec3& position, glm::vec3& target) const;
+	// summarize the passed in times, negative times are skipped
+	static TIME_SUMMARY Summarize(std::vector<double> times);
+	// write a summary as a named JSON object
+	static void WriteSummary(std::ostream& stream, const char* name, const TIME_SUMMARY& summary);
+};
@@ -0,0 +1,178 @@
+///////////////////////////////////////////////////////////////////////////////
+// filewatcher.cpp
+// ============
+// notice the asset files that were changed on disk while the scene runs
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FileWatcher.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// seconds between two looks at the files, short enough that
+	// a saved file shows up at once
+	const double DEFAULT_POLL_SECONDS = 0.25;
+}
+
+/***********************************************************
+ *  FileWatcher()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FileWatcher::FileWatcher()
+{
+	m_pollSeconds = DEFAULT_POLL_SECONDS;
+	m_lastPoll = std::chrono::steady_clock::now();
+}
+
+/***********************************************************
+ *  WatchFile()
+ *
+ *  This method is used for adding a file to the watched list.
+ *  The file as it is now is taken as unchanged.
+ ***********************************************************/
+FileWatcher::WatchHandle FileWatcher::WatchFile(const std::string& filename)
+{
+	WATCHED_FILE file;
+
+	for (size_t i = 0; i < m_files.size(); i++)
+	{
+		if (m_files[i].filename == filename)
+		{
+			return((WatchHandle)i);
+		}
+	}
+
+	file.filename = filename;
+	file.reported = ReadStamp(filename);
+	file.pending = file.reported;
+	file.bPending = false;
+	m_files.push_back(file);
+
+	return((WatchHandle)m_files.size() - 1);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing every watched file.
+ ***********************************************************/
+void FileWatcher::Clear()
+{
+	m_files.clear();
+}
+
+/***********************************************************
+ *  PollChanges()
+ *
+ *  This method is used for looking at the watched files once
+ *  the poll interval has passed.  A file that differs from
+ *  how it was last reported is held back until the next poll
+ *  finds it the same again, and a file that is missing is
+ *  never reported, since it is about to be written again.
+ ***********************************************************/
+bool FileWatcher::PollChanges(std::vector<WatchHandle>& changed)
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	bool bChanged = false;
+
+	if (std::chrono::duration<double>(now - m_lastPoll).count() < m_pollSeconds)
+	{
+		return(false);
+	}
+	m_lastPoll = now;
+
+	for (size_t i = 0; i < m_files.size(); i++)
+	{
+		WATCHED_FILE& file = m_files[i];
+		FILE_STAMP stamp = ReadStamp(file.filename);
+
+		if (true == IsSameStamp(stamp, file.reported))
+		{
+			file.bPending = false;
+		}
+		else if ((true == file.bPending) && (true == IsSameStamp(stamp, file.pending)) && (true == stamp.bExists))
+		{
+			file.reported = stamp;
+			file.bPending = false;
+			changed.push_back((WatchHandle)i);
+			bChanged = true;
+		}
+		else
+		{
+			file.pending = stamp;
+			file.bPending = true;
+		}
+	}
+
+	return(bChanged);
+}
+
+/***********************************************************
+ *  ReadStamp()
+ *
+ *  This method is used for reading the modification time and
+ *  size of a file.  The times are kept at the resolution of
+ *  the file system, so two saves in the same second are told
+ *  apart where the system allows it.
+ ***********************************************************/
+FileWatcher::FILE_STAMP FileWatcher::ReadStamp(const std::string& filename)
+{
+	FILE_STAMP stamp;
+
+	stamp.bExists = false;
+	stamp.modifiedTime = 0;
+	stamp.size = 0;
+
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+
+	if (FALSE != GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard, &attributes))
+	{
+		stamp.bExists = true;
+		stamp.modifiedTime = ((int64_t)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+		stamp.size = ((int64_t)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+	}
+#else
+	struct stat status;
+
+	if (stat(filename.c_str(), &status) == 0)
+	{
+		stamp.bExists = true;
+#ifdef __APPLE__
+		stamp.modifiedTime = (int64_t)status.st_mtimespec.tv_sec * 1000000000 + status.st_mtimespec.tv_nsec;
+#else
+		stamp.modifiedTime = (int64_t)status.st_mtim.tv_sec * 1000000000 + status.st_mtim.tv_nsec;
+#endif
+		stamp.size = (int64_t)status.st_size;
+	}
+#endif
+
+	return(stamp);
+}
+
+/***********************************************************
+ *  IsSameStamp()
+ *
+ *  This method is used for comparing two looks at a file.
+ ***********************************************************/
+bool FileWatcher::IsSameStamp(const FILE_STAMP& first, const FILE_STAMP& second)
+{
+	return((first.bExists == second.bExists) &&
+		(first.modifiedTime == second.modifiedTime) &&
+		(first.size == second.size));
+}
@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////////////////////
+// filewatcher.h
+// ============
+// notice the asset files that were changed on disk while the scene runs
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  FileWatcher
+ *
+ *  This class keeps the modification time and size of a list
+ *  of files and compares them again every poll interval.  A
+ *  changed file is only reported once it has looked the same
+ *  on two polls in a row, so a file that an editor is still
+ *  writing, or has deleted to replace it, is not read half
+ *  way.  Only the watched files are looked at, so a poll is a
+ *  handful of stat calls and allocates nothing.
+ ***********************************************************/
+class FileWatcher
+{
+public:
+	// index of a watched file, which its changes are reported with
+	typedef int WatchHandle;
+
+	// constructor
+	FileWatcher();
+
+	// start watching a file, returning the handle of an already
+	// watched file with the same name
+	WatchHandle WatchFile(const std::string& filename);
+	// stop watching every file
+	void Clear();
+
+	// check the files once the poll interval has passed since
+	// the last check, adding the handles of the changed files
+	// to the list; returns whether any file changed
+	bool PollChanges(std::vector<WatchHandle>& changed);
+
+	const std::string& GetFilename(WatchHandle handle) const { return(m_files[handle].filename); }
+	size_t GetFileCount() const { return(m_files.size()); }
+	void SetPollInterval(double seconds) { m_pollSeconds = seconds; }
+
+private:
+	// what a file looked like on one poll
+	struct FILE_STAMP
+	{
+		bool bExists;
+		int64_t modifiedTime;
+		int64_t size;
+	};
+
+	struct WATCHED_FILE
+	{
+		std::string filename;
+		// the file as it was last reported, or first watched
+		FILE_STAMP reported;
+		// a change seen on the last poll that has to settle
+		FILE_STAMP pending;
+		bool bPending;
+	};
+
+	std::vector<WATCHED_FILE> m_files;
+	double m_pollSeconds;
+	std::chrono::steady_clock::time_point m_lastPoll;
+
+	// read the modification time and size of a file
+	static FILE_STAMP ReadStamp(const std::string& filename);
+	static bool IsSameStamp(const FILE_STAMP& first, const FILE_STAMP& second);
+};
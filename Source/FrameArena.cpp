@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.cpp
+// ============
+// hand out the memory of per-frame data from one block reset every frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameArena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+
+// declaration of global variables
+namespace
+{
+	// headroom given to the block when it grows, so a frame
+	// slightly larger than the last one still fits
+	const size_t ARENA_GROWTH_PERCENT = 150;
+}
+
+/***********************************************************
+ *  FrameArena()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameArena::FrameArena()
+{
+	m_pBlock = NULL;
+	m_capacity = 0;
+	m_offset = 0;
+	m_overflowBytes = 0;
+	m_peakBytes = 0;
+}
+
+/***********************************************************
+ *  ~FrameArena()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameArena::~FrameArena()
+{
+	Reset();
+	free(m_pBlock);
+	m_pBlock = NULL;
+	m_capacity = 0;
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for allocating the block of the passed
+ *  in size.  Anything handed out before is taken back.
+ ***********************************************************/
+void FrameArena::Initialize(size_t capacity)
+{
+	Reset();
+	free(m_pBlock);
+
+	m_pBlock = (unsigned char*)malloc(capacity);
+	m_capacity = (NULL != m_pBlock) ? capacity : 0;
+	m_offset = 0;
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for taking back all the memory handed
+ *  out since the last reset.  When the last frame did not fit
+ *  the block, its heap memory is freed and the block is made
+ *  large enough for it, which is the only time the arena
+ *  allocates once the scene is loaded.
+ ***********************************************************/
+void FrameArena::Reset()
+{
+	size_t usedBytes = GetUsedBytes();
+
+	m_peakBytes = std::max(m_peakBytes, usedBytes);
+
+	for (size_t i = 0; i < m_overflowBlocks.size(); i++)
+	{
+		free(m_overflowBlocks[i]);
+	}
+	m_overflowBlocks.clear();
+	m_offset = 0;
+
+	if (m_overflowBytes > 0)
+	{
+		m_overflowBytes = 0;
+		Initialize(usedBytes * ARENA_GROWTH_PERCENT / 100);
+	}
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  This method is used for handing out memory of the passed
+ *  in size from the block, aligned to the passed in power of
+ *  two.  Memory that does not fit comes from the heap.
+ ***********************************************************/
+void* FrameArena::Allocate(size_t size, size_t alignment)
+{
+	uintptr_t base = (uintptr_t)m_pBlock;
+	size_t offset = 0;
+	void* pMemory = NULL;
+
+	if (0 == size)
+	{
+		size = 1;
+	}
+	if (0 == alignment)
+	{
+		alignment = 1;
+	}
+
+	offset = (size_t)(((base + m_offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+	if ((NULL != m_pBlock) && (offset <= m_capacity) && (size <= m_capacity - offset))
+	{
+		m_offset = offset + size;
+		return(m_pBlock + offset);
+	}
+
+	// malloc aligns for every fundamental type, which is all the
+	// containers of a frame ask for
+	pMemory = malloc(size);
+	if (NULL == pMemory)
+	{
+		throw std::bad_alloc();
+	}
+	m_overflowBlocks.push_back(pMemory);
+	m_overflowBytes += size;
+
+	return(pMemory);
+}
@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////////
+// framearena.h
+// ============
+// hand out the memory of per-frame data from one block reset every frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+/***********************************************************
+ *  FrameArena
+ *
+ *  This class hands out memory for the data that only lives
+ *  for one frame by moving an offset through one large block,
+ *  and takes all of it back at once when the next frame is
+ *  started.  Nothing is freed on its own.  An allocation that
+ *  does not fit is taken from the heap and freed on the next
+ *  reset, and the block is then grown to what the frame used,
+ *  so a scene settles into one block without heap allocations.
+ *  The arena is only used from the thread that owns the frame.
+ ***********************************************************/
+class FrameArena
+{
+public:
+	// constructor
+	FrameArena();
+	// destructor
+	~FrameArena();
+
+	// allocate the block that the frames are carved from
+	void Initialize(size_t capacity);
+	// take back everything handed out since the last reset
+	void Reset();
+
+	// memory of the passed in size and power of two alignment,
+	// valid until the next reset
+	void* Allocate(size_t size, size_t alignment);
+
+	// bytes handed out since the last reset, and the most that
+	// any frame has used
+	size_t GetUsedBytes() const { return(m_offset + m_overflowBytes); }
+	size_t GetPeakBytes() const { return(m_peakBytes); }
+	size_t GetCapacity() const { return(m_capacity); }
+	// allocations of the last frame that did not fit the block
+	unsigned int GetOverflowCount() const { return((unsigned int)m_overflowBlocks.size()); }
+
+private:
+	unsigned char* m_pBlock;
+	size_t m_capacity;
+	// offset of the next free byte in the block
+	size_t m_offset;
+	// heap memory given out after the block was full
+	std::vector<void*> m_overflowBlocks;
+	size_t m_overflowBytes;
+	size_t m_peakBytes;
+};
+
+/***********************************************************
+ *  FrameAllocator
+ *
+ *  This class lets the standard containers keep their items
+ *  in a frame arena.  Freeing is left to the arena, so a
+ *  container has to be replaced, not reused, once the arena
+ *  is reset.  Without an arena the heap is used instead, so
+ *  a container made before the first frame still works.
+ ***********************************************************/
+template <typename T>
+class FrameAllocator
+{
+public:
+	typedef T value_type;
+	// a container moved or swapped takes its arena along
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+
+	template <typename U>
+	struct rebind
+	{
+		typedef FrameAllocator<U> other;
+	};
+
+	// constructor
+	FrameAllocator() : m_pArena(NULL)
+	{
+	}
+	explicit FrameAllocator(FrameArena* pArena) : m_pArena(pArena)
+	{
+	}
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other) : m_pArena(other.GetArena())
+	{
+	}
+
+	T* allocate(size_t count)
+	{
+		if (NULL == m_pArena)
+		{
+			return((T*)::operator new(count * sizeof(T)));
+		}
+
+		return((T*)m_pArena->Allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void deallocate(T* pMemory, size_t /*count*/)
+	{
+		// arena memory is only taken back by a reset
+		if (NULL == m_pArena)
+		{
+			::operator delete(pMemory);
+		}
+	}
+
+	FrameArena* GetArena() const { return(m_pArena); }
+
+private:
+	FrameArena* m_pArena;
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& first, const FrameAllocator<U>& second)
+{
+	return(first.GetArena() == second.GetArena());
+}
+
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& first, const FrameAllocator<U>& second)
+{
+	return(first.GetArena() != second.GetArena());
+}
+
+// a vector whose items live in a frame arena
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
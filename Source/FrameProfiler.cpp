@@ -0,0 +1,439 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.cpp
+// =================
+// time the sections of every frame on the CPU and GPU and keep the history
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameProfiler.h"
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+
+// declaration of global variables
+namespace
+{
+	// names of the sections, in PROFILE_SCOPE order
+	const char* g_ScopeNames[FrameProfiler::SCOPE_COUNT] =
+	{
+		"PrepareSceneView",
+		"RenderScene",
+		"StatsOverlay",
+		"SwapBuffers"
+	};
+}
+
+/***********************************************************
+ *  FrameProfiler()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameProfiler::FrameProfiler()
+{
+	m_startTime = std::chrono::steady_clock::now();
+	memset(m_queries, 0, sizeof(m_queries));
+	memset(m_bQueryIssued, 0, sizeof(m_bQueryIssued));
+	for (int i = 0; i < QUERY_BUFFER_COUNT; i++)
+	{
+		m_queryFrames[i] = -1;
+	}
+	m_bQueriesCreated = false;
+	m_bInFrame = false;
+	m_latestCompleteFrame = -1;
+}
+
+/***********************************************************
+ *  ~FrameProfiler()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameProfiler::~FrameProfiler()
+{
+	if (m_bQueriesCreated)
+	{
+		glDeleteQueries(QUERY_BUFFER_COUNT * SCOPE_COUNT, &m_queries[0][0]);
+		m_bQueriesCreated = false;
+	}
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the timer queries.  It
+ *  needs a current OpenGL context.
+ ***********************************************************/
+void FrameProfiler::Initialize()
+{
+	// the history never grows past its limit, so its memory is
+	// taken once instead of while the frames are being timed
+	m_frames.reserve(MAX_RECORDED_FRAMES);
+
+	if (m_bQueriesCreated == false)
+	{
+		glGenQueries(QUERY_BUFFER_COUNT * SCOPE_COUNT, &m_queries[0][0]);
+		m_bQueriesCreated = true;
+	}
+}
+
+/***********************************************************
+ *  GetMicroseconds()
+ *
+ *  This method is used for getting the CPU time since the
+ *  profiler was created, in microseconds.
+ ***********************************************************/
+double FrameProfiler::GetMicroseconds() const
+{
+	std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - m_startTime;
+	return(elapsed.count());
+}
+
+/***********************************************************
+ *  GetScopeName()
+ *
+ *  This method is used for getting the name of a section.
+ ***********************************************************/
+const char* FrameProfiler::GetScopeName(PROFILE_SCOPE scope)
+{
+	if ((scope < 0) || (scope >= SCOPE_COUNT))
+	{
+		return("");
+	}
+
+	return(g_ScopeNames[scope]);
+}
+
+/***********************************************************
+ *  TrimHistory()
+ *
+ *  This method is used for dropping the older half of the
+ *  recorded frames once the history is full, keeping the
+ *  indices of the buffered queries pointing at their frames.
+ ***********************************************************/
+void FrameProfiler::TrimHistory()
+{
+	int dropCount = (int)(MAX_RECORDED_FRAMES / 2);
+
+	if (m_frames.size() < MAX_RECORDED_FRAMES)
+	{
+		return;
+	}
+
+	m_frames.erase(m_frames.begin(), m_frames.begin() + dropCount);
+
+	for (int i = 0; i < QUERY_BUFFER_COUNT; i++)
+	{
+		m_queryFrames[i] = (m_queryFrames[i] >= dropCount) ? (m_queryFrames[i] - dropCount) : -1;
+	}
+	m_latestCompleteFrame = (m_latestCompleteFrame >= dropCount) ? (m_latestCompleteFrame - dropCount) : -1;
+}
+
+/***********************************************************
+ *  ReadQueries()
+ *
+ *  This method is used for reading the GPU times of the frame
+ *  that last used the passed in query buffer.  The frame was
+ *  submitted two frames ago, so the results are normally
+ *  ready; a result that is not is recorded as unavailable
+ *  instead of stalling the CPU.
+ ***********************************************************/
+void FrameProfiler::ReadQueries(int buffer)
+{
+	int frame = m_queryFrames[buffer];
+
+	if ((frame < 0) || (frame >= (int)m_frames.size()))
+	{
+		m_queryFrames[buffer] = -1;
+		return;
+	}
+
+	for (int scope = 0; scope < SCOPE_COUNT; scope++)
+	{
+		GLint bAvailable = 0;
+		GLuint64 elapsedNanoseconds = 0;
+
+		if (m_bQueryIssued[buffer][scope] == false)
+		{
+			continue;
+		}
+
+		glGetQueryObjectiv(m_queries[buffer][scope], GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+		if (bAvailable)
+		{
+			glGetQueryObjectui64v(m_queries[buffer][scope], GL_QUERY_RESULT, &elapsedNanoseconds);
+			m_frames[frame].gpuMilliseconds[scope] = (double)elapsedNanoseconds / 1000000.0;
+		}
+		m_bQueryIssued[buffer][scope] = false;
+	}
+
+	m_queryFrames[buffer] = -1;
+	m_latestCompleteFrame = frame;
+}
+
+/***********************************************************
+ *  ResolveQueries()
+ *
+ *  This method is used for reading back the queries of the
+ *  last frames, which BeginFrame() would otherwise read two
+ *  frames later.  It is meant for the end of a run, after the
+ *  GPU has finished, so the older buffer is read first.
+ ***********************************************************/
+void FrameProfiler::ResolveQueries()
+{
+	int first = 0;
+
+	if (false == m_bQueriesCreated)
+	{
+		return;
+	}
+
+	if ((m_queryFrames[1] >= 0) && ((m_queryFrames[0] < 0) || (m_queryFrames[1] < m_queryFrames[0])))
+	{
+		first = 1;
+	}
+
+	for (int i = 0; i < QUERY_BUFFER_COUNT; i++)
+	{
+		ReadQueries((first + i) % QUERY_BUFFER_COUNT);
+	}
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting a new frame.  The query
+ *  buffer the frame is going to use is read back first.
+ ***********************************************************/
+void FrameProfiler::BeginFrame()
+{
+	FRAME_STATS frame;
+
+	TrimHistory();
+
+	memset(&frame, 0, sizeof(frame));
+	frame.frameIndex = m_frames.empty() ? 0 : (m_frames.back().frameIndex + 1);
+	frame.frameStartMicroseconds = GetMicroseconds();
+	for (int scope = 0; scope < SCOPE_COUNT; scope++)
+	{
+		frame.scopeStartMicroseconds[scope] = -1.0;
+		frame.cpuMilliseconds[scope] = -1.0;
+		frame.gpuMilliseconds[scope] = -1.0;
+	}
+
+	if (m_bQueriesCreated)
+	{
+		ReadQueries(frame.frameIndex % QUERY_BUFFER_COUNT);
+		m_queryFrames[frame.frameIndex % QUERY_BUFFER_COUNT] = (int)m_frames.size();
+	}
+
+	m_frames.push_back(frame);
+	m_bInFrame = true;
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for finishing the current frame and
+ *  recording its total CPU time.
+ ***********************************************************/
+void FrameProfiler::EndFrame()
+{
+	if ((m_bInFrame == false) || m_frames.empty())
+	{
+		return;
+	}
+
+	FRAME_STATS& frame = m_frames.back();
+	frame.frameMilliseconds = (GetMicroseconds() - frame.frameStartMicroseconds) / 1000.0;
+	m_bInFrame = false;
+}
+
+/***********************************************************
+ *  BeginScope()
+ *
+ *  This method is used for starting the CPU timer and the GPU
+ *  timer query of a section of the current frame.
+ ***********************************************************/
+void FrameProfiler::BeginScope(PROFILE_SCOPE scope)
+{
+	if ((m_bInFrame == false) || (scope < 0) || (scope >= SCOPE_COUNT))
+	{
+		return;
+	}
+
+	FRAME_STATS& frame = m_frames.back();
+	frame.scopeStartMicroseconds[scope] = GetMicroseconds();
+
+	if (m_bQueriesCreated)
+	{
+		int buffer = frame.frameIndex % QUERY_BUFFER_COUNT;
+		glBeginQuery(GL_TIME_ELAPSED, m_queries[buffer][scope]);
+	}
+}
+
+/***********************************************************
+ *  EndScope()
+ *
+ *  This method is used for stopping the CPU timer and the GPU
+ *  timer query of a section of the current frame.
+ ***********************************************************/
+void FrameProfiler::EndScope(PROFILE_SCOPE scope)
+{
+	if ((m_bInFrame == false) || (scope < 0) || (scope >= SCOPE_COUNT))
+	{
+		return;
+	}
+
+	FRAME_STATS& frame = m_frames.back();
+	if (frame.scopeStartMicroseconds[scope] < 0.0)
+	{
+		return;
+	}
+	frame.cpuMilliseconds[scope] = (GetMicroseconds() - frame.scopeStartMicroseconds[scope]) / 1000.0;
+
+	if (m_bQueriesCreated)
+	{
+		int buffer = frame.frameIndex % QUERY_BUFFER_COUNT;
+		glEndQuery(GL_TIME_ELAPSED);
+		m_bQueryIssued[buffer][scope] = true;
+	}
+}
+
+/***********************************************************
+ *  SetCounters()
+ *
+ *  This method is used for recording the work that was
+ *  submitted during the current frame.
+ ***********************************************************/
+void FrameProfiler::SetCounters(const FRAME_COUNTERS& counters)
+{
+	if ((m_bInFrame == false) || m_frames.empty())
+	{
+		return;
+	}
+
+	m_frames.back().counters = counters;
+}
+
+/***********************************************************
+ *  GetLatestCompleteFrame()
+ *
+ *  This method is used for getting the newest frame that has
+ *  its GPU times, or NULL before the first one is read back.
+ ***********************************************************/
+const FrameProfiler::FRAME_STATS* FrameProfiler::GetLatestCompleteFrame() const
+{
+	if ((m_latestCompleteFrame < 0) || (m_latestCompleteFrame >= (int)m_frames.size()))
+	{
+		return(NULL);
+	}
+
+	return(&m_frames[m_latestCompleteFrame]);
+}
+
+/***********************************************************
+ *  WriteCsv()
+ *
+ *  This method is used for writing one line per recorded
+ *  frame with its CPU and GPU section times and counters.
+ ***********************************************************/
+bool FrameProfiler::WriteCsv(const char* filename) const
+{
+	std::ofstream file(filename);
+
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	file << "frame,frame_ms";
+	for (int scope = 0; scope < SCOPE_COUNT; scope++)
+	{
+		file << ",cpu_" << g_ScopeNames[scope] << "_ms,gpu_" << g_ScopeNames[scope] << "_ms";
+	}
+	file << ",draw_calls,uniform_uploads,texture_binds,triangles,culled_nodes,shadow_layers,render_width,render_height\n";
+
+	file << std::fixed << std::setprecision(4);
+	for (size_t i = 0; i < m_frames.size(); i++)
+	{
+		const FRAME_STATS& frame = m_frames[i];
+
+		file << frame.frameIndex << "," << frame.frameMilliseconds;
+		for (int scope = 0; scope < SCOPE_COUNT; scope++)
+		{
+			file << "," << frame.cpuMilliseconds[scope] << "," << frame.gpuMilliseconds[scope];
+		}
+		file << "," << frame.counters.drawCalls
+			<< "," << frame.counters.uniformUploads
+			<< "," << frame.counters.textureBinds
+			<< "," << frame.counters.triangles
+			<< "," << frame.counters.culledNodes
+			<< "," << frame.counters.shadowLayers
+			<< "," << frame.counters.renderWidth
+			<< "," << frame.counters.renderHeight << "\n";
+	}
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  WriteChromeTrace()
+ *
+ *  This method is used for writing the recorded frames in the
+ *  Chrome trace event format, which chrome://tracing and
+ *  Perfetto can open.  CPU sections are on thread 1 and GPU
+ *  sections on thread 2; the timer queries only measure
+ *  durations, so GPU sections are placed at their CPU start.
+ ***********************************************************/
+bool FrameProfiler::WriteChromeTrace(const char* filename) const
+{
+	std::ofstream file(filename);
+	bool bFirstEvent = true;
+
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	file << std::fixed << std::setprecision(3);
+	file << "{\"traceEvents\":[\n";
+	for (size_t i = 0; i < m_frames.size(); i++)
+	{
+		const FRAME_STATS& frame = m_frames[i];
+
+		file << (bFirstEvent ? "" : ",\n")
+			<< "{\"name\":\"Frame\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+			<< ",\"ts\":" << frame.frameStartMicroseconds
+			<< ",\"dur\":" << frame.frameMilliseconds * 1000.0
+			<< ",\"args\":{\"frame\":" << frame.frameIndex
+			<< ",\"draw_calls\":" << frame.counters.drawCalls
+			<< ",\"uniform_uploads\":" << frame.counters.uniformUploads
+			<< ",\"texture_binds\":" << frame.counters.textureBinds
+			<< ",\"triangles\":" << frame.counters.triangles
+			<< ",\"culled_nodes\":" << frame.counters.culledNodes
+			<< ",\"shadow_layers\":" << frame.counters.shadowLayers
+			<< ",\"render_width\":" << frame.counters.renderWidth
+			<< ",\"render_height\":" << frame.counters.renderHeight << "}}";
+		bFirstEvent = false;
+
+		for (int scope = 0; scope < SCOPE_COUNT; scope++)
+		{
+			if (frame.cpuMilliseconds[scope] >= 0.0)
+			{
+				file << ",\n{\"name\":\"" << g_ScopeNames[scope] << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+					<< ",\"ts\":" << frame.scopeStartMicroseconds[scope]
+					<< ",\"dur\":" << frame.cpuMilliseconds[scope] * 1000.0 << "}";
+			}
+			if (frame.gpuMilliseconds[scope] >= 0.0)
+			{
+				file << ",\n{\"name\":\"" << g_ScopeNames[scope] << "\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":1,\"tid\":2"
+					<< ",\"ts\":" << frame.scopeStartMicroseconds[scope]
+					<< ",\"dur\":" << frame.gpuMilliseconds[scope] * 1000.0 << "}";
+			}
+		}
+	}
+	file << "\n],\n\"displayTimeUnit\":\"ms\"}\n";
+
+	return(file.good());
+}
@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.h
+// ============
+// time the sections of every frame on the CPU and GPU and keep the history
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <vector>
+
+/***********************************************************
+ *  FrameProfiler
+ *
+ *  This class measures the sections of the main loop with a
+ *  CPU timer and a GL_TIME_ELAPSED query each.  The queries
+ *  are double buffered, so the GPU times of a frame are read
+ *  two frames later without waiting on the GPU.  Every frame
+ *  is kept in a history along with its draw counters, which
+ *  can be written out as CSV or as a Chrome trace.
+ ***********************************************************/
+class FrameProfiler
+{
+public:
+	// the timed sections of a frame
+	enum PROFILE_SCOPE
+	{
+		SCOPE_VIEW = 0,
+		SCOPE_SCENE,
+		SCOPE_OVERLAY,
+		SCOPE_SWAP,
+		SCOPE_COUNT
+	};
+
+	// work submitted during a frame
+	struct FRAME_COUNTERS
+	{
+		unsigned int drawCalls;
+		unsigned int uniformUploads;
+		unsigned int textureBinds;
+		unsigned int triangles;
+		unsigned int culledNodes;
+		// cached shadow map layers that were drawn again
+		unsigned int shadowLayers;
+		// size the scene was drawn at, before it was stretched
+		// over the window
+		unsigned int renderWidth;
+		unsigned int renderHeight;
+		// heap allocations of the previous frame, counted in
+		// debug builds only
+		unsigned int heapAllocations;
+	};
+
+	// everything measured for one frame, GPU times are negative
+	// until their queries have been read
+	struct FRAME_STATS
+	{
+		unsigned int frameIndex;
+		// start of the frame and of each section, in microseconds
+		// since the profiler was created
+		double frameStartMicroseconds;
+		double scopeStartMicroseconds[SCOPE_COUNT];
+		double frameMilliseconds;
+		double cpuMilliseconds[SCOPE_COUNT];
+		double gpuMilliseconds[SCOPE_COUNT];
+		FRAME_COUNTERS counters;
+	};
+
+	// constructor
+	FrameProfiler();
+	// destructor
+	~FrameProfiler();
+
+	// create the timer queries, GPU times stay unavailable when
+	// this is not called
+	void Initialize();
+
+	// mark the start and end of a frame
+	void BeginFrame();
+	void EndFrame();
+
+	// mark the start and end of a section within the frame,
+	// sections must not overlap
+	void BeginScope(PROFILE_SCOPE scope);
+	void EndScope(PROFILE_SCOPE scope);
+
+	// record the work submitted during the current frame
+	void SetCounters(const FRAME_COUNTERS& counters);
+
+	// read back the queries still waiting, once the GPU is idle
+	void ResolveQueries();
+
+	// most recent frame that has its GPU times read back
+	const FRAME_STATS* GetLatestCompleteFrame() const;
+	// all the recorded frames, oldest first
+	const std::vector<FRAME_STATS>& GetFrames() const { return(m_frames); }
+	// name of a section as used in the written files
+	static const char* GetScopeName(PROFILE_SCOPE scope);
+
+	// write the recorded frames to a file
+	bool WriteCsv(const char* filename) const;
+	bool WriteChromeTrace(const char* filename) const;
+
+private:
+	// frames whose queries can be in flight at once
+	static const int QUERY_BUFFER_COUNT = 2;
+	// recorded frames are kept up to this count, after which the
+	// older half of the history is dropped
+	static const size_t MAX_RECORDED_FRAMES = 36000;
+
+	// when the profiler was created
+	std::chrono::steady_clock::time_point m_startTime;
+	// recorded frames, the last one is the current frame
+	std::vector<FRAME_STATS> m_frames;
+	// timer queries of each buffered frame and section
+	GLuint m_queries[QUERY_BUFFER_COUNT][SCOPE_COUNT];
+	// index in m_frames of the frame that used each buffer, or
+	// -1 when the buffer has no results waiting
+	int m_queryFrames[QUERY_BUFFER_COUNT];
+	// set for the sections whose query was issued this frame
+	bool m_bQueryIssued[QUERY_BUFFER_COUNT][SCOPE_COUNT];
+	bool m_bQueriesCreated;
+	bool m_bInFrame;
+	// index in m_frames of the newest frame with GPU times
+	int m_latestCompleteFrame;
+
+	// microseconds since the profiler was created
+	double GetMicroseconds() const;
+	// read the query results of the passed in buffer
+	void ReadQueries(int buffer);
+	// drop the older half of the history when it is full
+	void TrimHistory();
+};
+
+/***********************************************************
+ *  ProfileScope
+ *
+ *  This class times a section of a frame for as long as it
+ *  is in scope.
+ ***********************************************************/
+class ProfileScope
+{
+public:
+	ProfileScope(FrameProfiler* pProfiler, FrameProfiler::PROFILE_SCOPE scope)
+	{
+		m_pProfiler = pProfiler;
+		m_scope = scope;
+		if (NULL != m_pProfiler)
+		{
+			m_pProfiler->BeginScope(m_scope);
+		}
+	}
+	~ProfileScope()
+	{
+		if (NULL != m_pProfiler)
+		{
+			m_pProfiler->EndScope(m_scope);
+		}
+	}
+
+private:
+	FrameProfiler* m_pProfiler;
+	FrameProfiler::PROFILE_SCOPE m_scope;
+};
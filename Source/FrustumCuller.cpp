@@ -0,0 +1,215 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustumculler.cpp
+// ============
+// test the world bounds of the scene nodes against the view frustum
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrustumCuller.h"
+
+#include <cfloat>
+#include <algorithm>
+#include <cmath>
+
+/***********************************************************
+ *  FrustumCuller()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrustumCuller::FrustumCuller()
+{
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the number of boxes.  New
+ *  boxes get an infinite extent, so a node is never culled
+ *  before its bounds have been set.
+ ***********************************************************/
+void FrustumCuller::Resize(size_t count)
+{
+	m_centerX.resize(count, 0.0f);
+	m_centerY.resize(count, 0.0f);
+	m_centerZ.resize(count, 0.0f);
+	m_extentX.resize(count, FLT_MAX);
+	m_extentY.resize(count, FLT_MAX);
+	m_extentZ.resize(count, FLT_MAX);
+}
+
+/***********************************************************
+ *  SetBounds()
+ *
+ *  This method is used for transforming a local box into
+ *  world space.  The world center is the transformed local
+ *  center, and each world half extent is the sum of the local
+ *  half extents weighted by the absolute rotation and scale,
+ *  which gives the smallest axis aligned box around the
+ *  rotated one.
+ ***********************************************************/
+void FrustumCuller::SetBounds(
+	size_t index,
+	const glm::vec3& localMinimum,
+	const glm::vec3& localMaximum,
+	const glm::mat4& worldMatrix)
+{
+	glm::vec3 localCenter = (localMinimum + localMaximum) * 0.5f;
+	glm::vec3 localExtent = (localMaximum - localMinimum) * 0.5f;
+	glm::vec3 worldCenter;
+	glm::vec3 worldExtent;
+
+	if (index >= m_centerX.size())
+	{
+		return;
+	}
+
+	worldCenter = glm::vec3(worldMatrix * glm::vec4(localCenter, 1.0f));
+	worldExtent =
+		glm::abs(glm::vec3(worldMatrix[0])) * localExtent.x +
+		glm::abs(glm::vec3(worldMatrix[1])) * localExtent.y +
+		glm::abs(glm::vec3(worldMatrix[2])) * localExtent.z;
+
+	m_centerX[index] = worldCenter.x;
+	m_centerY[index] = worldCenter.y;
+	m_centerZ[index] = worldCenter.z;
+	m_extentX[index] = worldExtent.x;
+	m_extentY[index] = worldExtent.y;
+	m_extentZ[index] = worldExtent.z;
+}
+
+/***********************************************************
+ *  GetBounds()
+ *
+ *  This method is used for getting the world space center and
+ *  half extent of the box at the passed in index.
+ ***********************************************************/
+void FrustumCuller::GetBounds(size_t index, glm::vec3& center, glm::vec3& extent) const
+{
+	if (index >= m_centerX.size())
+	{
+		return;
+	}
+
+	center = glm::vec3(m_centerX[index], m_centerY[index], m_centerZ[index]);
+	extent = glm::vec3(m_extentX[index], m_extentY[index], m_extentZ[index]);
+}
+
+/***********************************************************
+ *  ExtractFrustum()
+ *
+ *  This method is used for extracting the six planes of the
+ *  view frustum from the rows of the projection * view matrix,
+ *  normalized so that plane distances are in world units.
+ ***********************************************************/
+FrustumCuller::FRUSTUM FrustumCuller::ExtractFrustum(const glm::mat4& viewProjection)
+{
+	FRUSTUM frustum;
+	glm::vec4 rows[4];
+
+	// glm matrices are column major, so gather the rows first
+	for (int row = 0; row < 4; row++)
+	{
+		rows[row] = glm::vec4(viewProjection[0][row], viewProjection[1][row], viewProjection[2][row], viewProjection[3][row]);
+	}
+
+	frustum.planes[0] = rows[3] + rows[0];	// left
+	frustum.planes[1] = rows[3] - rows[0];	// right
+	frustum.planes[2] = rows[3] + rows[1];	// bottom
+	frustum.planes[3] = rows[3] - rows[1];	// top
+	frustum.planes[4] = rows[3] + rows[2];	// near
+	frustum.planes[5] = rows[3] - rows[2];	// far
+
+	for (int plane = 0; plane < 6; plane++)
+	{
+		float length = glm::length(glm::vec3(frustum.planes[plane]));
+		if (length > 0.0f)
+		{
+			frustum.planes[plane] /= length;
+		}
+	}
+
+	return(frustum);
+}
+
+/***********************************************************
+ *  Cull()
+ *
+ *  This method is used for testing every box against the
+ *  frustum.  A box is outside of a plane when its center is
+ *  further behind the plane than the box reaches towards it.
+ *  The planes are the outer loop, so the inner loop is the
+ *  same few multiply adds over contiguous arrays, without
+ *  branches, for every box.
+ ***********************************************************/
+size_t FrustumCuller::Cull(const glm::mat4& viewProjection, std::vector<uint8_t>& visible) const
+{
+	size_t count = m_centerX.size();
+
+	visible.assign(count, 1);
+	if (count == 0)
+	{
+		return(0);
+	}
+
+	return(CullRange(ExtractFrustum(viewProjection), 0, count, &visible[0]));
+}
+
+/***********************************************************
+ *  CullRange()
+ *
+ *  This method is used for testing the boxes from the first
+ *  up to, but not including, the last index against the
+ *  passed in frustum, one plane at a time over the whole
+ *  range.  Ranges that do not overlap can be tested on
+ *  different threads into the same flags.
+ ***********************************************************/
+size_t FrustumCuller::CullRange(const FRUSTUM& frustum, size_t first, size_t last, uint8_t* visible) const
+{
+	size_t visibleCount = 0;
+
+	last = std::min(last, m_centerX.size());
+	if (first >= last)
+	{
+		return(0);
+	}
+
+	const float* centerX = &m_centerX[first];
+	const float* centerY = &m_centerY[first];
+	const float* centerZ = &m_centerZ[first];
+	const float* extentX = &m_extentX[first];
+	const float* extentY = &m_extentY[first];
+	const float* extentZ = &m_extentZ[first];
+	uint8_t* flags = &visible[first];
+	size_t count = last - first;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		flags[i] = 1;
+	}
+
+	for (int plane = 0; plane < 6; plane++)
+	{
+		const float nx = frustum.planes[plane].x;
+		const float ny = frustum.planes[plane].y;
+		const float nz = frustum.planes[plane].z;
+		const float d = frustum.planes[plane].w;
+		const float ax = std::fabs(nx);
+		const float ay = std::fabs(ny);
+		const float az = std::fabs(nz);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			float distance = nx * centerX[i] + ny * centerY[i] + nz * centerZ[i] + d;
+			float reach = ax * extentX[i] + ay * extentY[i] + az * extentZ[i];
+			flags[i] &= (uint8_t)(distance + reach >= 0.0f);
+		}
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		visibleCount += flags[i];
+	}
+
+	return(visibleCount);
+}
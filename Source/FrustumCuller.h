@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustumculler.h
+// ============
+// test the world bounds of the scene nodes against the view frustum
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  FrustumCuller
+ *
+ *  This class keeps the world space bounding box of every
+ *  scene node as a center and a half extent, stored as one
+ *  array per component so the culling loop runs over plain
+ *  contiguous floats that the compiler can vectorize.  The
+ *  boxes are only updated when their node moves, and the six
+ *  frustum planes are extracted from the projection * view
+ *  matrix once per frame.
+ ***********************************************************/
+class FrustumCuller
+{
+public:
+	// the planes of a view frustum, each stored as a normal
+	// pointing inwards and a distance
+	struct FRUSTUM
+	{
+		glm::vec4 planes[6];
+	};
+
+	// constructor
+	FrustumCuller();
+
+	// set the number of boxes, new boxes are always visible
+	// until their bounds are set
+	void Resize(size_t count);
+	size_t GetCount() const { return(m_centerX.size()); }
+
+	// transform a local box by a world matrix and store the
+	// resulting world space box at the passed in index
+	void SetBounds(
+		size_t index,
+		const glm::vec3& localMinimum,
+		const glm::vec3& localMaximum,
+		const glm::mat4& worldMatrix);
+
+	// world space center and half extent of a box
+	void GetBounds(size_t index, glm::vec3& center, glm::vec3& extent) const;
+
+	// test every box against the frustum of the passed in matrix,
+	// setting its flag to 1 when visible, and return the number
+	// of visible boxes
+	size_t Cull(const glm::mat4& viewProjection, std::vector<uint8_t>& visible) const;
+	// test the boxes of one range of indices against a frustum,
+	// into flags that already have room for every box
+	size_t CullRange(const FRUSTUM& frustum, size_t first, size_t last, uint8_t* visible) const;
+
+	// extract the normalized frustum planes of a matrix
+	static FRUSTUM ExtractFrustum(const glm::mat4& viewProjection);
+
+private:
+	// world space box centers and half extents
+	std::vector<float> m_centerX;
+	std::vector<float> m_centerY;
+	std::vector<float> m_centerZ;
+	std::vector<float> m_extentX;
+	std::vector<float> m_extentY;
+	std::vector<float> m_extentZ;
+};
@@ -0,0 +1,572 @@
+///////////////////////////////////////////////////////////////////////////////
+// indirectrenderer.cpp
+// ====================
+// draw the whole scene from one shared mesh buffer with multi-draw indirect
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "IndirectRenderer.h"
+
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// number of draws the buffers start out with
+	const size_t INITIAL_DRAW_CAPACITY = 64;
+	// longest wait for a region in one call, in nanoseconds,
+	// before the wait is made again
+	const GLuint64 REGION_WAIT_TIMEOUT = 1000000000;
+	// flags the per-draw data is stored and mapped with, which
+	// need no flush and no unmapping before a draw
+	const GLbitfield MAPPED_DRAW_DATA_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+}
+
+/***********************************************************
+ *  IndirectRenderer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+IndirectRenderer::IndirectRenderer()
+{
+	m_pShaderManager = NULL;
+	m_programID = 0;
+	m_pMeshLibrary = NULL;
+	m_commandBuffer = 0;
+	m_drawDataBuffer = 0;
+	m_capacity = 0;
+	m_bDepthOnly = false;
+	m_pDrawDataWrite = NULL;
+	m_bPersistentDrawData = false;
+	m_pMappedDrawData = NULL;
+	m_regionSize = 0;
+	m_regionIndex = 0;
+	m_bRegionInUse = false;
+	m_storageAlignment = 1;
+	for (size_t i = 0; i < DRAW_DATA_REGION_COUNT; i++)
+	{
+		m_regionFences[i] = NULL;
+	}
+}
+
+/***********************************************************
+ *  ~IndirectRenderer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+IndirectRenderer::~IndirectRenderer()
+{
+	Clear();
+	ReleaseRegionFences();
+
+	if ((NULL != m_pMappedDrawData) && (0 != m_drawDataBuffer))
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_drawDataBuffer);
+		glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		m_pMappedDrawData = NULL;
+	}
+	if (0 != m_commandBuffer)
+	{
+		glDeleteBuffers(1, &m_commandBuffer);
+		m_commandBuffer = 0;
+	}
+	if (0 != m_drawDataBuffer)
+	{
+		glDeleteBuffers(1, &m_drawDataBuffer);
+		m_drawDataBuffer = 0;
+	}
+	if (NULL != m_pShaderManager)
+	{
+		delete m_pShaderManager;
+		m_pShaderManager = NULL;
+	}
+	m_pMeshLibrary = NULL;
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking whether the current
+ *  context supports multi-draw indirect together with the
+ *  gl_DrawID shader input.  The macOS 3.3 context does not.
+ ***********************************************************/
+bool IndirectRenderer::IsSupported()
+{
+	if (GL_TRUE == glewIsSupported("GL_VERSION_4_6"))
+	{
+		return(true);
+	}
+
+	// gl_DrawID is core from 4.6, and available on 4.3 through
+	// the draw parameters extension
+	if ((GL_TRUE == glewIsSupported("GL_VERSION_4_3")) &&
+		(GL_TRUE == glewIsSupported("GL_ARB_shader_draw_parameters")))
+	{
+		return(true);
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for loading the indirect shader
+ *  program and creating the command and per-draw buffers.
+ *  The previously used program is restored afterwards.
+ ***********************************************************/
+bool IndirectRenderer::Initialize(
+	const char* vertexShaderPath,
+	const char* fragmentShaderPath,
+	MeshLibrary* pMeshLibrary)
+{
+	GLint previousProgram = 0;
+
+	if ((NULL == pMeshLibrary) || (false == IsSupported()))
+	{
+		return(false);
+	}
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+
+	m_pShaderManager = new ShaderManager();
+	m_programID = m_pShaderManager->LoadShaders(vertexShaderPath, fragmentShaderPath);
+	if (0 == m_programID)
+	{
+		std::cout << "Could not load the indirect draw shaders:" << vertexShaderPath << std::endl;
+		delete m_pShaderManager;
+		m_pShaderManager = NULL;
+		glUseProgram((GLuint)previousProgram);
+		return(false);
+	}
+
+	m_uniformCache.ResolveLocations(m_programID);
+	m_pMeshLibrary = pMeshLibrary;
+	m_vertexShaderPath = vertexShaderPath;
+	m_fragmentShaderPath = fragmentShaderPath;
+
+	// without buffer storage the per-draw data is copied into
+	// an orphaned buffer every frame instead
+	m_bPersistentDrawData = (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage);
+	glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &m_storageAlignment);
+	if (m_storageAlignment < 1)
+	{
+		m_storageAlignment = 1;
+	}
+
+	glGenBuffers(1, &m_commandBuffer);
+	glGenBuffers(1, &m_drawDataBuffer);
+	ReserveBuffers(INITIAL_DRAW_CAPACITY);
+
+	glUseProgram((GLuint)previousProgram);
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReloadShaders()
+ *
+ *  This method is used for building the indirect program from
+ *  its changed shader files.  The new program replaces the
+ *  current one only once it has linked, and the buffers are
+ *  kept as they are.  The previously used program is restored
+ *  afterwards.
+ ***********************************************************/
+bool IndirectRenderer::ReloadShaders()
+{
+	ShaderManager* pShaderManager = NULL;
+	GLint previousProgram = 0;
+	GLint bLinked = GL_FALSE;
+	GLuint programID = 0;
+
+	if (NULL == m_pShaderManager)
+	{
+		return(false);
+	}
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+
+	pShaderManager = new ShaderManager();
+	programID = pShaderManager->LoadShaders(m_vertexShaderPath.c_str(), m_fragmentShaderPath.c_str());
+	if (0 != programID)
+	{
+		glGetProgramiv(programID, GL_LINK_STATUS, &bLinked);
+	}
+	if (GL_TRUE != bLinked)
+	{
+		std::cout << "Could not reload the indirect draw shaders, keeping the current ones:" << m_vertexShaderPath << std::endl;
+		if (0 != programID)
+		{
+			glDeleteProgram(programID);
+		}
+		delete pShaderManager;
+		glUseProgram((GLuint)previousProgram);
+		return(false);
+	}
+
+	// a previous program that was the old indirect one is gone
+	if ((GLuint)previousProgram == m_programID)
+	{
+		previousProgram = (GLint)programID;
+	}
+	glDeleteProgram(m_programID);
+	delete m_pShaderManager;
+	m_pShaderManager = pShaderManager;
+	m_programID = programID;
+	m_uniformCache.ResolveLocations(m_programID);
+
+	glUseProgram((GLuint)previousProgram);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all the collected draws,
+ *  keeping the allocated memory for the next frame.
+ ***********************************************************/
+void IndirectRenderer::Clear()
+{
+	m_commands.clear();
+	m_drawData.clear();
+	m_pDrawDataWrite = NULL;
+}
+
+/***********************************************************
+ *  ResizeDraws()
+ *
+ *  This method is used for setting the number of draws of the
+ *  frame.  With the mapped per-draw data, the region of the
+ *  last frame is fenced behind its draws, and the next region
+ *  is waited for until the GPU has finished drawing from it,
+ *  which it has unless it is more than two frames behind.
+ *  This has to be called on the GL thread, before any thread
+ *  sets a draw.
+ ***********************************************************/
+void IndirectRenderer::ResizeDraws(size_t drawCount)
+{
+	if ((true == m_bPersistentDrawData) && (true == m_bRegionInUse))
+	{
+		m_regionFences[m_regionIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_bRegionInUse = false;
+	}
+
+	ReserveBuffers(drawCount);
+
+	m_commands.resize(drawCount);
+	if (true == m_bPersistentDrawData)
+	{
+		m_regionIndex = (m_regionIndex + 1) % DRAW_DATA_REGION_COUNT;
+		WaitForRegion(m_regionIndex);
+		m_pDrawDataWrite = (DRAW_DATA_STD430*)(m_pMappedDrawData + m_regionIndex * m_regionSize);
+	}
+	else
+	{
+		m_drawData.resize(drawCount);
+		m_pDrawDataWrite = (drawCount > 0) ? &m_drawData[0] : NULL;
+	}
+}
+
+/***********************************************************
+ *  SetDraw()
+ *
+ *  This method is used for setting the draw at the passed in
+ *  index to the passed in mesh and per-draw data.  The base
+ *  instance of each command is the index of its per-draw
+ *  data, for reference.  A mesh that is not in the library
+ *  leaves a command that draws nothing, so the draws keep
+ *  their indices.  Only this draw's own memory is written.
+ ***********************************************************/
+bool IndirectRenderer::SetDraw(
+	size_t drawIndex,
+	MeshLibrary::MeshHandle mesh,
+	const DRAW_DATA_STD430& drawData)
+{
+	MeshLibrary::MESH_RANGE range;
+
+	if ((NULL == m_pDrawDataWrite) || (drawIndex >= m_commands.size()))
+	{
+		return(false);
+	}
+
+	DRAW_COMMAND& command = m_commands[drawIndex];
+
+	m_pDrawDataWrite[drawIndex] = drawData;
+	command.baseInstance = (uint32_t)drawIndex;
+
+	if ((NULL == m_pMeshLibrary) || (false == m_pMeshLibrary->GetMeshRange(mesh, range)))
+	{
+		command.count = 0;
+		command.instanceCount = 0;
+		command.firstIndex = 0;
+		command.baseVertex = 0;
+		return(false);
+	}
+
+	command.count = range.indexCount;
+	command.instanceCount = 1;
+	command.firstIndex = range.firstIndex;
+	command.baseVertex = range.baseVertex;
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReserveBuffers()
+ *
+ *  This method is used for growing the command and per-draw
+ *  buffers so that they can hold the passed in draw count.
+ *  The mapped per-draw buffer has immutable storage, so it
+ *  is made again at the new size.
+ ***********************************************************/
+void IndirectRenderer::ReserveBuffers(size_t drawCount)
+{
+	if ((drawCount <= m_capacity) && (m_capacity > 0))
+	{
+		return;
+	}
+
+	if (0 == m_capacity)
+	{
+		m_capacity = INITIAL_DRAW_CAPACITY;
+	}
+	while (m_capacity < drawCount)
+	{
+		m_capacity *= 2;
+	}
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, m_capacity * sizeof(DRAW_COMMAND), NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	if ((true == m_bPersistentDrawData) && (true == CreateMappedDrawData()))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_drawDataBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, m_capacity * sizeof(DRAW_DATA_STD430), NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  CreateMappedDrawData()
+ *
+ *  This method is used for making the per-draw buffer with
+ *  one region per frame at the current capacity, and mapping
+ *  all of it for as long as the buffer lives.  The old buffer
+ *  is deleted, which the driver defers until the GPU is done
+ *  with it, so the fences of its regions are dropped.  When
+ *  the buffer cannot be mapped, the renderer goes back to
+ *  copying the per-draw data every frame.
+ ***********************************************************/
+bool IndirectRenderer::CreateMappedDrawData()
+{
+	size_t drawDataSize = m_capacity * sizeof(DRAW_DATA_STD430);
+
+	ReleaseRegionFences();
+	if (NULL != m_pMappedDrawData)
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_drawDataBuffer);
+		glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+		m_pMappedDrawData = NULL;
+	}
+	glDeleteBuffers(1, &m_drawDataBuffer);
+	glGenBuffers(1, &m_drawDataBuffer);
+
+	// each region starts on an offset that can be bound
+	m_regionSize = ((drawDataSize + m_storageAlignment - 1) / m_storageAlignment) * m_storageAlignment;
+	m_regionIndex = 0;
+	m_bRegionInUse = false;
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_drawDataBuffer);
+	glBufferStorage(GL_SHADER_STORAGE_BUFFER, m_regionSize * DRAW_DATA_REGION_COUNT, NULL, MAPPED_DRAW_DATA_FLAGS);
+	m_pMappedDrawData = (unsigned char*)glMapBufferRange(
+		GL_SHADER_STORAGE_BUFFER,
+		0,
+		m_regionSize * DRAW_DATA_REGION_COUNT,
+		MAPPED_DRAW_DATA_FLAGS);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	if (NULL == m_pMappedDrawData)
+	{
+		std::cout << "Could not map the per-draw buffer, the draws are copied every frame" << std::endl;
+		glDeleteBuffers(1, &m_drawDataBuffer);
+		glGenBuffers(1, &m_drawDataBuffer);
+		m_bPersistentDrawData = false;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  WaitForRegion()
+ *
+ *  This method is used for waiting until the GPU has run the
+ *  draws that read from the passed in region.  The commands
+ *  are flushed on the first wait, so the fence is reached.
+ ***********************************************************/
+void IndirectRenderer::WaitForRegion(size_t region)
+{
+	GLenum result = GL_ALREADY_SIGNALED;
+
+	if (NULL == m_regionFences[region])
+	{
+		return;
+	}
+
+	result = glClientWaitSync(m_regionFences[region], GL_SYNC_FLUSH_COMMANDS_BIT, REGION_WAIT_TIMEOUT);
+	while (GL_TIMEOUT_EXPIRED == result)
+	{
+		result = glClientWaitSync(m_regionFences[region], 0, REGION_WAIT_TIMEOUT);
+	}
+
+	glDeleteSync(m_regionFences[region]);
+	m_regionFences[region] = NULL;
+}
+
+/***********************************************************
+ *  ReleaseRegionFences()
+ *
+ *  This method is used for deleting the fences of every
+ *  region without waiting for them.
+ ***********************************************************/
+void IndirectRenderer::ReleaseRegionFences()
+{
+	for (size_t i = 0; i < DRAW_DATA_REGION_COUNT; i++)
+	{
+		if (NULL != m_regionFences[i])
+		{
+			glDeleteSync(m_regionFences[i]);
+			m_regionFences[i] = NULL;
+		}
+	}
+}
+
+/***********************************************************
+ *  Submit()
+ *
+ *  This method is used for uploading the collected commands
+ *  and per-draw data, and drawing all of them with a single
+ *  multi-draw call.  Every texture is a layer of the bound
+ *  texture array, so no state changes between the draws.  The
+ *  indirect program is left in use, so the caller restores
+ *  its own program.
+ ***********************************************************/
+unsigned int IndirectRenderer::Submit()
+{
+	if ((false == Upload()) || (NULL == Use()))
+	{
+		return(0);
+	}
+
+	return(Draw(0, m_commands.size()));
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for uploading the collected commands,
+ *  and the per-draw data when it is not mapped, and binding
+ *  the per-draw data of this frame to its storage block.  The
+ *  commands are always copied, because the occlusion culling
+ *  writes to them on the GPU.
+ ***********************************************************/
+bool IndirectRenderer::Upload()
+{
+	if ((NULL == m_pShaderManager) || (m_commands.size() == 0) || (NULL == m_pDrawDataWrite))
+	{
+		return(false);
+	}
+
+	// the buffers are orphaned before writing so the driver does
+	// not have to wait for the previous frame to finish with them
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, m_capacity * sizeof(DRAW_COMMAND), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, m_commands.size() * sizeof(DRAW_COMMAND), &m_commands[0]);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	if (true == m_bPersistentDrawData)
+	{
+		// the mapping is coherent, so the writes of the jobs are
+		// seen by the draws without a flush
+		glBindBufferRange(
+			GL_SHADER_STORAGE_BUFFER,
+			DRAW_BLOCK_BINDING,
+			m_drawDataBuffer,
+			(GLintptr)(m_regionIndex * m_regionSize),
+			(GLsizeiptr)(m_commands.size() * sizeof(DRAW_DATA_STD430)));
+		m_bRegionInUse = true;
+		return(true);
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_drawDataBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, m_capacity * sizeof(DRAW_DATA_STD430), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_drawData.size() * sizeof(DRAW_DATA_STD430), &m_drawData[0]);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_BLOCK_BINDING, m_drawDataBuffer);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Use()
+ *
+ *  This method is used for putting the indirect program in
+ *  use, so that the owner can set the uniforms it manages,
+ *  such as the lights, through the returned cache before the
+ *  commands are drawn.
+ ***********************************************************/
+UniformCache* IndirectRenderer::Use()
+{
+	if (NULL == m_pShaderManager)
+	{
+		return(NULL);
+	}
+
+	m_pShaderManager->use();
+
+	return(&m_uniformCache);
+}
+
+/***********************************************************
+ *  Draw()
+ *
+ *  This method is used for drawing a range of the uploaded
+ *  commands with one multi-draw call, with the program put in
+ *  use by Use().  gl_DrawID starts from zero in every call, so
+ *  the first draw of the range is passed to the vertex shader
+ *  as the per-draw data offset.
+ ***********************************************************/
+unsigned int IndirectRenderer::Draw(size_t firstDraw, size_t drawCount)
+{
+	if ((NULL == m_pShaderManager) || (drawCount == 0) || (firstDraw + drawCount > m_commands.size()))
+	{
+		return(0);
+	}
+
+	glBindVertexArray(m_pMeshLibrary->GetVertexArray());
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+
+	// the UV scale is applied per draw in the vertex shader
+	m_uniformCache.SetVec2Value(UniformCache::UNIFORM_UV_SCALE, glm::vec2(1.0f, 1.0f));
+	m_uniformCache.SetIntValue(UniformCache::UNIFORM_OBJECT_TEXTURE, TEXTURE_ARRAY_UNIT);
+	m_uniformCache.SetIntValue(UniformCache::UNIFORM_DRAW_OFFSET, (int)firstDraw);
+	m_uniformCache.SetIntValue(UniformCache::UNIFORM_DEPTH_ONLY, m_bDepthOnly);
+
+	glMultiDrawElementsIndirect(
+		GL_TRIANGLES,
+		GL_UNSIGNED_INT,
+		(void*)(firstDraw * sizeof(DRAW_COMMAND)),
+		(GLsizei)drawCount,
+		0);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	return(1);
+}
@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////
+// indirectrenderer.h
+// ============
+// draw the whole scene from one shared mesh buffer with multi-draw indirect
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "ShaderBlocks.h"
+#include "UniformCache.h"
+#include "MeshLibrary.h"
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  IndirectRenderer
+ *
+ *  This class collects one draw command per scene object,
+ *  referring to a range of the shared MeshLibrary buffers,
+ *  and submits them all with one glMultiDrawElementsIndirect
+ *  call.  The per-draw model matrix, color, UV scale, material
+ *  index and texture array layer are kept in a shader storage
+ *  buffer that the vertex shader indexes with gl_DrawID.  This path needs an
+ *  OpenGL 4.6 context, or 4.3 with ARB_shader_draw_parameters.
+ *  The draws are set by index, so several threads can fill in
+ *  their own ranges of them.  When the context has buffer
+ *  storage, the per-draw data is written straight into a
+ *  persistently mapped buffer of three regions, used in turn
+ *  and fenced, so a frame never writes over the data that the
+ *  GPU is still drawing an earlier frame with.
+ ***********************************************************/
+class IndirectRenderer
+{
+public:
+	// regions of the persistently mapped per-draw buffer, one
+	// for the frame being built and two the GPU can be behind
+	static const size_t DRAW_DATA_REGION_COUNT = 3;
+
+	// constructor
+	IndirectRenderer();
+	// destructor
+	~IndirectRenderer();
+
+	// check whether the current context can run this path
+	static bool IsSupported();
+
+	// load the indirect shader program and create the buffers
+	bool Initialize(
+		const char* vertexShaderPath,
+		const char* fragmentShaderPath,
+		MeshLibrary* pMeshLibrary);
+	// load the changed shaders again, keeping the current program
+	// when the new one does not build
+	bool ReloadShaders();
+
+	// shader program that the indirect draws are made with
+	ShaderManager* GetShaderManager() { return(m_pShaderManager); }
+	GLuint GetProgramID() const { return(m_programID); }
+	// put the program in use before Draw() and return its uniform
+	// cache, for the uniforms the owner sets, or NULL without one
+	UniformCache* Use();
+
+	// remove all the collected draws
+	void Clear();
+	// set the number of draws of the frame, which are then set
+	// by index until the next call
+	void ResizeDraws(size_t drawCount);
+	// set the draw at the passed in index to the passed in mesh
+	// and per-draw data, which can be done for different draws
+	// at once on several threads
+	bool SetDraw(
+		size_t drawIndex,
+		MeshLibrary::MeshHandle mesh,
+		const DRAW_DATA_STD430& drawData);
+	// draw everything that was collected and return the number
+	// of multi-draw calls that it took
+	unsigned int Submit();
+
+	// upload the collected draws without drawing them, so that
+	// the commands can be changed on the GPU before Draw()
+	bool Upload();
+	// draw a range of the uploaded commands with one multi-draw
+	// call with the program in use, returning the number of calls
+	unsigned int Draw(size_t firstDraw, size_t drawCount);
+	// buffer holding the uploaded indirect commands
+	GLuint GetCommandBuffer() const { return(m_commandBuffer); }
+	// draw only the depth of the following ranges, without shading
+	void SetDepthOnly(bool bDepthOnly) { m_bDepthOnly = bDepthOnly; }
+
+	// number of draws set since the last clear
+	size_t GetDrawCount() const { return(m_commands.size()); }
+	// set when the per-draw data is persistently mapped
+	bool IsPersistentlyMapped() const { return(m_bPersistentDrawData); }
+
+private:
+	// layout of one command in the indirect buffer, mirrored
+	// in shaders/occlusionCullCompute.glsl
+	struct DRAW_COMMAND
+	{
+		uint32_t count;
+		uint32_t instanceCount;
+		uint32_t firstIndex;
+		int32_t baseVertex;
+		uint32_t baseInstance;
+	};
+
+	// shader program used for the indirect draws
+	ShaderManager* m_pShaderManager;
+	GLuint m_programID;
+	// the shader files, kept for reloading them
+	std::string m_vertexShaderPath;
+	std::string m_fragmentShaderPath;
+	// cached uniform locations of the indirect program
+	UniformCache m_uniformCache;
+	// shared geometry that the commands refer to
+	MeshLibrary* m_pMeshLibrary;
+	// collected commands, and their per-draw data when it is
+	// not persistently mapped
+	std::vector<DRAW_COMMAND> m_commands;
+	std::vector<DRAW_DATA_STD430> m_drawData;
+	// where SetDraw() writes the per-draw data of this frame
+	DRAW_DATA_STD430* m_pDrawDataWrite;
+	// indirect command buffer and per-draw storage buffer
+	GLuint m_commandBuffer;
+	GLuint m_drawDataBuffer;
+	// number of draws the buffers currently have room for
+	size_t m_capacity;
+	// set while the draws only write depth
+	bool m_bDepthOnly;
+	// persistently mapped per-draw data, split into regions of
+	// the passed in size that are written in turn
+	bool m_bPersistentDrawData;
+	unsigned char* m_pMappedDrawData;
+	size_t m_regionSize;
+	size_t m_regionIndex;
+	// set once the current region has been drawn from
+	bool m_bRegionInUse;
+	// fence after the last draw from every region
+	GLsync m_regionFences[DRAW_DATA_REGION_COUNT];
+	// storage buffer offsets have to be multiples of this
+	GLint m_storageAlignment;
+
+	// grow the buffers to hold the collected draws
+	void ReserveBuffers(size_t drawCount);
+	// create the persistently mapped per-draw buffer at the
+	// current capacity, returning false when it cannot be mapped
+	bool CreateMappedDrawData();
+	// wait for the GPU to finish drawing from a region
+	void WaitForRegion(size_t region);
+	// remove the fences of every region
+	void ReleaseRegionFences();
+};
@@ -0,0 +1,280 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.cpp
+// ============
+// split the building of a frame into jobs on a work-stealing thread pool
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	// most worker threads started, however many cores there are
+	const unsigned int MAX_JOB_THREADS = 64;
+}
+
+/***********************************************************
+ *  JobSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+JobSystem::JobSystem()
+{
+	m_queuedCount = 0;
+	m_bStopping = false;
+}
+
+/***********************************************************
+ *  ~JobSystem()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+JobSystem::~JobSystem()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for starting the worker threads.  The
+ *  thread that starts a loop works on it as well, so one core
+ *  is left for it.  A count of one keeps every loop on the
+ *  calling thread.
+ ***********************************************************/
+void JobSystem::Start(unsigned int threadCount)
+{
+	if (m_workers.size() > 0)
+	{
+		return;
+	}
+
+	if (0 == threadCount)
+	{
+		threadCount = std::thread::hardware_concurrency();
+	}
+	if (threadCount > MAX_JOB_THREADS + 1)
+	{
+		threadCount = MAX_JOB_THREADS + 1;
+	}
+	if (threadCount <= 1)
+	{
+		return;
+	}
+
+	m_bStopping = false;
+	m_queuedCount = 0;
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_queues.push_back(std::unique_ptr<JOB_QUEUE>(new JOB_QUEUE()));
+		m_queues.back()->head = 0;
+	}
+	for (unsigned int i = 0; i < threadCount - 1; i++)
+	{
+		m_workers.push_back(std::thread(&JobSystem::WorkerMain, this, (size_t)i));
+	}
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping and joining the worker
+ *  threads.  No loop is running then, so the queues are empty.
+ ***********************************************************/
+void JobSystem::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+		m_bStopping = true;
+	}
+	m_jobQueued.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+	m_queues.clear();
+	m_bStopping = false;
+}
+
+/***********************************************************
+ *  RunParallel()
+ *
+ *  This method is used for running the passed in function
+ *  over the items from zero up to count.  The chunks are
+ *  dealt out to the queues in turn, the workers are woken,
+ *  and the calling thread runs chunks, its own first, until
+ *  all of them are finished.
+ ***********************************************************/
+void JobSystem::RunParallel(size_t count, size_t grainSize, RANGE_CALLBACK pCallback, const void* pFunction)
+{
+	std::atomic<size_t> remaining;
+	size_t callerQueue = m_queues.size() - 1;
+	size_t chunkCount = 0;
+	JOB job;
+
+	if (0 == count)
+	{
+		return;
+	}
+	if (0 == grainSize)
+	{
+		grainSize = 1;
+	}
+	if ((m_workers.size() == 0) || (count <= grainSize))
+	{
+		pCallback(pFunction, 0, count);
+		return;
+	}
+
+	chunkCount = (count + grainSize - 1) / grainSize;
+	remaining = chunkCount;
+
+	// the count is raised before any chunk can be taken, and
+	// before the wake lock, so a worker checking it under that
+	// lock cannot miss the chunks
+	m_queuedCount += chunkCount;
+
+	for (size_t chunk = 0; chunk < chunkCount; chunk++)
+	{
+		JOB_QUEUE& queue = *m_queues[chunk % m_queues.size()];
+
+		job.pCallback = pCallback;
+		job.pFunction = pFunction;
+		job.first = chunk * grainSize;
+		job.last = std::min(job.first + grainSize, count);
+		job.pRemaining = &remaining;
+
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back(job);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_wakeMutex);
+	}
+	m_jobQueued.notify_all();
+
+	while (remaining.load(std::memory_order_acquire) > 0)
+	{
+		if (PopJob(callerQueue, job))
+		{
+			RunJob(job);
+		}
+		else
+		{
+			// the last chunks are running on the workers
+			std::this_thread::yield();
+		}
+	}
+}
+
+/***********************************************************
+ *  PopJob()
+ *
+ *  This method is used for taking the newest chunk of the
+ *  passed in queue, whose items were dealt out last and are
+ *  the most likely to still be in the cache, or else the
+ *  oldest chunk of the next queue that has any.
+ ***********************************************************/
+bool JobSystem::PopJob(size_t queueIndex, JOB& job)
+{
+	if (m_queuedCount.load(std::memory_order_acquire) == 0)
+	{
+		return(false);
+	}
+
+	{
+		JOB_QUEUE& queue = *m_queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (queue.jobs.size() > queue.head)
+		{
+			job = queue.jobs.back();
+			queue.jobs.pop_back();
+			m_queuedCount--;
+			TrimQueue(queue);
+			return(true);
+		}
+	}
+
+	for (size_t offset = 1; offset < m_queues.size(); offset++)
+	{
+		JOB_QUEUE& queue = *m_queues[(queueIndex + offset) % m_queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if (queue.jobs.size() > queue.head)
+		{
+			job = queue.jobs[queue.head];
+			queue.head++;
+			m_queuedCount--;
+			TrimQueue(queue);
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  TrimQueue()
+ *
+ *  This method is used for emptying a queue whose chunks have
+ *  all been taken, keeping its memory for the next loop.  The
+ *  lock of the queue is held by the caller.
+ ***********************************************************/
+void JobSystem::TrimQueue(JOB_QUEUE& queue)
+{
+	if (queue.head >= queue.jobs.size())
+	{
+		queue.jobs.clear();
+		queue.head = 0;
+	}
+}
+
+/***********************************************************
+ *  RunJob()
+ *
+ *  This method is used for running one chunk, and counting it
+ *  as finished so the thread waiting on the loop can return.
+ ***********************************************************/
+void JobSystem::RunJob(const JOB& job)
+{
+	job.pCallback(job.pFunction, job.first, job.last);
+	job.pRemaining->fetch_sub(1, std::memory_order_release);
+}
+
+/***********************************************************
+ *  WorkerMain()
+ *
+ *  This method is run by every worker thread.  It runs chunks
+ *  while there are any, and sleeps until more are queued or
+ *  the pool is stopped.
+ ***********************************************************/
+void JobSystem::WorkerMain(size_t queueIndex)
+{
+	while (true)
+	{
+		JOB job;
+
+		if (PopJob(queueIndex, job))
+		{
+			RunJob(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_wakeMutex);
+		while ((m_queuedCount.load(std::memory_order_acquire) == 0) && (m_bStopping == false))
+		{
+			m_jobQueued.wait(lock);
+		}
+		if (m_bStopping == true)
+		{
+			return;
+		}
+	}
+}
@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.h
+// ============
+// split the building of a frame into jobs on a work-stealing thread pool
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  JobSystem
+ *
+ *  This class runs the loops that build a frame over ranges
+ *  of their items on a pool of worker threads.  A loop is cut
+ *  into chunks that are dealt out to a queue per thread, and
+ *  every thread takes the newest chunk of its own queue first
+ *  and, once that is empty, steals the oldest chunk of another
+ *  queue, so a thread that finishes early helps the rest.  The
+ *  thread that starts a loop works on it too and returns when
+ *  every chunk is done.  Without workers, or for a loop of one
+ *  chunk, the loop runs on the calling thread.  Jobs must not
+ *  make OpenGL calls, and only one thread starts loops.  The
+ *  queues keep their memory, so a loop allocates nothing once
+ *  the pool has run loops of its size.
+ ***********************************************************/
+class JobSystem
+{
+public:
+	// constructor
+	JobSystem();
+	// destructor
+	~JobSystem();
+
+	// start the worker threads, zero picks a count for the machine
+	void Start(unsigned int threadCount = 0);
+	// stop and join the worker threads
+	void Stop();
+	// number of worker threads, not counting the calling thread
+	unsigned int GetThreadCount() const { return((unsigned int)m_workers.size()); }
+
+	// run the function over the items from zero up to count, in
+	// chunks of the passed in size, and wait for all of them;
+	// the function is called with the first item of a chunk and
+	// the item after its last
+	template <typename FUNCTION>
+	void ParallelFor(size_t count, size_t grainSize, const FUNCTION& function)
+	{
+		RunParallel(count, grainSize, &CallRange<FUNCTION>, &function);
+	}
+
+private:
+	// the work of one chunk, called with the function of the loop
+	typedef void (*RANGE_CALLBACK)(const void* pFunction, size_t first, size_t last);
+
+	// one chunk of a loop
+	struct JOB
+	{
+		RANGE_CALLBACK pCallback;
+		const void* pFunction;
+		size_t first;
+		size_t last;
+		// chunks of the loop that are not finished yet
+		std::atomic<size_t>* pRemaining;
+	};
+
+	// the chunks waiting on one thread, each queue with its own
+	// lock so the threads rarely wait on each other; chunks are
+	// stolen from the head and taken by the owner from the end
+	struct JOB_QUEUE
+	{
+		std::mutex mutex;
+		std::vector<JOB> jobs;
+		size_t head;
+	};
+
+	std::vector<std::thread> m_workers;
+	// a queue per worker, and the last one for the calling thread
+	std::vector<std::unique_ptr<JOB_QUEUE>> m_queues;
+	std::mutex m_wakeMutex;
+	// signalled when chunks are queued or the workers are stopping
+	std::condition_variable m_jobQueued;
+	// chunks in all the queues that no thread has taken yet
+	std::atomic<size_t> m_queuedCount;
+	std::atomic<bool> m_bStopping;
+
+	// call a loop function of the passed in type on one chunk
+	template <typename FUNCTION>
+	static void CallRange(const void* pFunction, size_t first, size_t last)
+	{
+		(*(const FUNCTION*)pFunction)(first, last);
+	}
+
+	// cut a loop into chunks and run them on every thread
+	void RunParallel(size_t count, size_t grainSize, RANGE_CALLBACK pCallback, const void* pFunction);
+	// take a chunk from the passed in queue, or steal one from
+	// another queue, returning false when there is none
+	bool PopJob(size_t queueIndex, JOB& job);
+	// empty a queue whose chunks have all been taken
+	static void TrimQueue(JOB_QUEUE& queue);
+	// run one chunk and count it as finished
+	static void RunJob(const JOB& job);
+	// run chunks until the pool is stopped
+	void WorkerMain(size_t queueIndex);
+};
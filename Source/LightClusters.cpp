@@ -0,0 +1,469 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightclusters.cpp
+// ============
+// assign the local scene lights to the clusters of the view for shading
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightClusters.h"
+#include "ShaderBlocks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// names of the light uniforms in the fragment shader
+	const char* g_LocalLightsName = "localLights";
+	const char* g_ClusterRangesName = "clusterRanges";
+	const char* g_ClusterLightIndicesName = "clusterLightIndices";
+
+	// every light takes two RGBA32F texels in its buffer texture
+	const int LIGHT_TEXELS = 2;
+	// overlaps are packed with the light index in the low bits
+	const int OVERLAP_LIGHT_BITS = 8;
+	const int TILES_PER_SLICE = LightClusters::CLUSTER_COLUMNS * LightClusters::CLUSTER_ROWS;
+
+	/***********************************************************
+	 *  Unproject()
+	 *
+	 *  This function is used for moving a point from normalized
+	 *  device coordinates back into view space.
+	 ***********************************************************/
+	glm::vec3 Unproject(const glm::mat4& inverseProjection, float x, float y, float z)
+	{
+		glm::vec4 point = inverseProjection * glm::vec4(x, y, z, 1.0f);
+		return(glm::vec3(point) / point.w);
+	}
+
+	/***********************************************************
+	 *  PointAtDepth()
+	 *
+	 *  This function is used for finding the point of the line
+	 *  through the passed in near and far points that lies at
+	 *  the passed in view depth.
+	 ***********************************************************/
+	glm::vec3 PointAtDepth(const glm::vec3& nearPoint, const glm::vec3& farPoint, float depth)
+	{
+		float t = (-depth - nearPoint.z) / (farPoint.z - nearPoint.z);
+		return(nearPoint + (farPoint - nearPoint) * t);
+	}
+}
+
+/***********************************************************
+ *  LightClusters()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightClusters::LightClusters()
+{
+	m_bLightsDirty = false;
+	m_projection = glm::mat4(1.0f);
+	m_bHasProjection = false;
+	m_nearDepth = 0.1f;
+	m_farDepth = 100.0f;
+	m_lightBuffer = 0;
+	m_lightTexture = 0;
+	m_rangeBuffer = 0;
+	m_rangeTexture = 0;
+	m_indexBuffer = 0;
+	m_indexTexture = 0;
+	m_indexCapacity = 0;
+}
+
+/***********************************************************
+ *  ~LightClusters()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LightClusters::~LightClusters()
+{
+	GLuint textures[3] = { m_lightTexture, m_rangeTexture, m_indexTexture };
+	GLuint buffers[3] = { m_lightBuffer, m_rangeBuffer, m_indexBuffer };
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (0 != textures[i])
+		{
+			glDeleteTextures(1, &textures[i]);
+		}
+		if (0 != buffers[i])
+		{
+			glDeleteBuffers(1, &buffers[i]);
+		}
+	}
+	m_lightTexture = 0;
+	m_rangeTexture = 0;
+	m_indexTexture = 0;
+	m_lightBuffer = 0;
+	m_rangeBuffer = 0;
+	m_indexBuffer = 0;
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the buffers that hold
+ *  the lights, the cluster ranges and the light index list,
+ *  and the buffer textures the fragment shader reads them
+ *  through.
+ ***********************************************************/
+bool LightClusters::Initialize()
+{
+	glGenBuffers(1, &m_lightBuffer);
+	glBindBuffer(GL_TEXTURE_BUFFER, m_lightBuffer);
+	glBufferData(GL_TEXTURE_BUFFER, MAX_LOCAL_LIGHTS * LIGHT_TEXELS * sizeof(glm::vec4), NULL, GL_DYNAMIC_DRAW);
+
+	glGenBuffers(1, &m_rangeBuffer);
+	glBindBuffer(GL_TEXTURE_BUFFER, m_rangeBuffer);
+	glBufferData(GL_TEXTURE_BUFFER, CLUSTER_COUNT * 2 * sizeof(uint32_t), NULL, GL_STREAM_DRAW);
+
+	// the index list grows with the lights that are visible,
+	// so it starts out with room for one light per cluster
+	m_indexCapacity = CLUSTER_COUNT;
+	glGenBuffers(1, &m_indexBuffer);
+	glBindBuffer(GL_TEXTURE_BUFFER, m_indexBuffer);
+	glBufferData(GL_TEXTURE_BUFFER, m_indexCapacity * sizeof(uint16_t), NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	glGenTextures(1, &m_lightTexture);
+	glBindTexture(GL_TEXTURE_BUFFER, m_lightTexture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_lightBuffer);
+
+	glGenTextures(1, &m_rangeTexture);
+	glBindTexture(GL_TEXTURE_BUFFER, m_rangeTexture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32UI, m_rangeBuffer);
+
+	glGenTextures(1, &m_indexTexture);
+	glBindTexture(GL_TEXTURE_BUFFER, m_indexTexture);
+	glTexBuffer(GL_TEXTURE_BUFFER, GL_R16UI, m_indexBuffer);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+	m_clusterRanges.assign(CLUSTER_COUNT * 2, 0);
+	m_bLightsDirty = true;
+
+	if (GL_NO_ERROR != glGetError())
+	{
+		std::cout << "Could not create the light cluster buffers" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetSamplerUnits()
+ *
+ *  This method is used for pointing the light samplers of the
+ *  passed in program at their texture units.  The units never
+ *  change, so this is only done once after the program has
+ *  been built.  The program must be in use.
+ ***********************************************************/
+void LightClusters::SetSamplerUnits(GLuint programID)
+{
+	if (0 == programID)
+	{
+		return;
+	}
+
+	glUniform1i(glGetUniformLocation(programID, g_LocalLightsName), LOCAL_LIGHT_TEXTURE_UNIT);
+	glUniform1i(glGetUniformLocation(programID, g_ClusterRangesName), CLUSTER_RANGE_TEXTURE_UNIT);
+	glUniform1i(glGetUniformLocation(programID, g_ClusterLightIndicesName), CLUSTER_INDEX_TEXTURE_UNIT);
+}
+
+/***********************************************************
+ *  SetShaderUniforms()
+ *
+ *  This method is used for setting the light count and depth
+ *  slicing that the fragment shader finds the cluster of a
+ *  fragment with.  With bClustered off the shader loops over
+ *  every local light.  The values go through the uniform cache
+ *  of the program in use, so a program that already has them
+ *  is not sent them again.
+ ***********************************************************/
+void LightClusters::SetShaderUniforms(UniformCache& uniforms, bool bClustered) const
+{
+	// the slice of a depth is log(depth) * x + y
+	float depthRatio = std::log(m_farDepth / m_nearDepth);
+	glm::vec2 depthScale(
+		CLUSTER_SLICES / depthRatio,
+		-CLUSTER_SLICES * std::log(m_nearDepth) / depthRatio);
+
+	uniforms.SetIntValue(UniformCache::UNIFORM_USE_CLUSTERED_LIGHTS, bClustered ? 1 : 0);
+	uniforms.SetIntValue(UniformCache::UNIFORM_LOCAL_LIGHT_COUNT, (int)m_lights.size());
+	uniforms.SetVec2Value(UniformCache::UNIFORM_CLUSTER_DEPTH_SCALE, depthScale);
+}
+
+/***********************************************************
+ *  AddLight()
+ *
+ *  This method is used for adding a local light, which lights
+ *  nothing farther away than its radius.  The index of the
+ *  light is returned, or -1 when there is no room left.
+ ***********************************************************/
+int LightClusters::AddLight(const glm::vec3& position, float radius, const glm::vec3& color, float intensity)
+{
+	LOCAL_LIGHT light;
+
+	if (m_lights.size() >= MAX_LOCAL_LIGHTS)
+	{
+		std::cout << "Could not add the local light, " << (int)MAX_LOCAL_LIGHTS << " is the limit" << std::endl;
+		return(-1);
+	}
+	if (radius <= 0.0f)
+	{
+		std::cout << "Could not add the local light, its radius must be above zero" << std::endl;
+		return(-1);
+	}
+
+	light.position = position;
+	light.radius = radius;
+	light.color = color;
+	light.intensity = intensity;
+	m_lights.push_back(light);
+	m_bLightsDirty = true;
+
+	return((int)m_lights.size() - 1);
+}
+
+/***********************************************************
+ *  ClearLights()
+ *
+ *  This method is used for removing every local light.
+ ***********************************************************/
+void LightClusters::ClearLights()
+{
+	m_lights.clear();
+	m_bLightsDirty = true;
+}
+
+/***********************************************************
+ *  BuildClusterBounds()
+ *
+ *  This method is used for finding the view space box of
+ *  every cluster.  The corners of each screen tile are moved
+ *  back into view space on the near and far planes, and the
+ *  lines between them are cut at the depths where the slice
+ *  starts and ends, which works for both the perspective and
+ *  the orthographic projection.
+ ***********************************************************/
+void LightClusters::BuildClusterBounds(const glm::mat4& projection)
+{
+	glm::mat4 inverseProjection = glm::inverse(projection);
+
+	m_projection = projection;
+	m_bHasProjection = true;
+	m_nearDepth = -Unproject(inverseProjection, 0.0f, 0.0f, -1.0f).z;
+	m_farDepth = -Unproject(inverseProjection, 0.0f, 0.0f, 1.0f).z;
+
+	m_clusterMinimum.resize(CLUSTER_COUNT);
+	m_clusterMaximum.resize(CLUSTER_COUNT);
+
+	for (int row = 0; row < CLUSTER_ROWS; row++)
+	{
+		for (int column = 0; column < CLUSTER_COLUMNS; column++)
+		{
+			glm::vec3 nearCorners[4];
+			glm::vec3 farCorners[4];
+
+			for (int corner = 0; corner < 4; corner++)
+			{
+				float x = -1.0f + 2.0f * (float)(column + (corner & 1)) / CLUSTER_COLUMNS;
+				float y = -1.0f + 2.0f * (float)(row + (corner >> 1)) / CLUSTER_ROWS;
+
+				nearCorners[corner] = Unproject(inverseProjection, x, y, -1.0f);
+				farCorners[corner] = Unproject(inverseProjection, x, y, 1.0f);
+			}
+
+			for (int slice = 0; slice < CLUSTER_SLICES; slice++)
+			{
+				int cluster = (slice * CLUSTER_ROWS + row) * CLUSTER_COLUMNS + column;
+				float sliceNear = m_nearDepth * std::pow(m_farDepth / m_nearDepth, (float)slice / CLUSTER_SLICES);
+				float sliceFar = m_nearDepth * std::pow(m_farDepth / m_nearDepth, (float)(slice + 1) / CLUSTER_SLICES);
+				glm::vec3 minimum = PointAtDepth(nearCorners[0], farCorners[0], sliceNear);
+				glm::vec3 maximum = minimum;
+
+				for (int corner = 0; corner < 4; corner++)
+				{
+					glm::vec3 front = PointAtDepth(nearCorners[corner], farCorners[corner], sliceNear);
+					glm::vec3 back = PointAtDepth(nearCorners[corner], farCorners[corner], sliceFar);
+
+					minimum = glm::min(minimum, glm::min(front, back));
+					maximum = glm::max(maximum, glm::max(front, back));
+				}
+
+				m_clusterMinimum[cluster] = minimum;
+				m_clusterMaximum[cluster] = maximum;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  GetDepthSlice()
+ *
+ *  This method is used for finding the slice of the cluster
+ *  grid that the passed in view depth falls into.  The slices
+ *  are spaced logarithmically, so that near clusters are thin.
+ ***********************************************************/
+int LightClusters::GetDepthSlice(float depth) const
+{
+	int slice = 0;
+
+	if (depth <= m_nearDepth)
+	{
+		return(0);
+	}
+
+	slice = (int)std::floor(std::log(depth / m_nearDepth) / std::log(m_farDepth / m_nearDepth) * CLUSTER_SLICES);
+
+	return(std::min(std::max(slice, 0), CLUSTER_SLICES - 1));
+}
+
+/***********************************************************
+ *  UploadLights()
+ *
+ *  This method is used for sending the local lights to their
+ *  buffer texture, as the position and radius followed by the
+ *  color already scaled by the intensity, when they have been
+ *  changed since the last upload.
+ ***********************************************************/
+void LightClusters::UploadLights()
+{
+	if ((false == m_bLightsDirty) || (0 == m_lightBuffer))
+	{
+		return;
+	}
+
+	std::vector<glm::vec4> texels(m_lights.size() * LIGHT_TEXELS);
+
+	for (size_t i = 0; i < m_lights.size(); i++)
+	{
+		texels[i * LIGHT_TEXELS] = glm::vec4(m_lights[i].position, m_lights[i].radius);
+		texels[i * LIGHT_TEXELS + 1] = glm::vec4(m_lights[i].color * m_lights[i].intensity, 0.0f);
+	}
+
+	if (!texels.empty())
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER, m_lightBuffer);
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, texels.size() * sizeof(glm::vec4), &texels[0]);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	}
+
+	m_bLightsDirty = false;
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for assigning the local lights to the
+ *  clusters of the passed in camera.  Every light is tested
+ *  against the clusters of the slices its sphere reaches, the
+ *  overlaps are counted per cluster, and a counting sort turns
+ *  them into one offset and count per cluster into a single
+ *  list of light indices.
+ ***********************************************************/
+void LightClusters::Update(const glm::mat4& view, const glm::mat4& projection)
+{
+	if ((false == m_bHasProjection) || (projection != m_projection))
+	{
+		BuildClusterBounds(projection);
+	}
+	UploadLights();
+
+	m_overlaps.clear();
+	for (size_t i = 0; i < m_lights.size(); i++)
+	{
+		glm::vec3 center = glm::vec3(view * glm::vec4(m_lights[i].position, 1.0f));
+		float radius = m_lights[i].radius;
+		float depth = -center.z;
+
+		// lights behind the camera or past the far plane are
+		// never in any cluster
+		if ((depth + radius < m_nearDepth) || (depth - radius > m_farDepth))
+		{
+			continue;
+		}
+
+		int firstSlice = GetDepthSlice(depth - radius);
+		int lastSlice = GetDepthSlice(depth + radius);
+
+		for (int slice = firstSlice; slice <= lastSlice; slice++)
+		{
+			for (int tile = 0; tile < TILES_PER_SLICE; tile++)
+			{
+				int cluster = slice * TILES_PER_SLICE + tile;
+				glm::vec3 closest = glm::clamp(center, m_clusterMinimum[cluster], m_clusterMaximum[cluster]);
+				glm::vec3 offset = center - closest;
+
+				if (glm::dot(offset, offset) <= radius * radius)
+				{
+					m_overlaps.push_back(((uint32_t)cluster << OVERLAP_LIGHT_BITS) | (uint32_t)i);
+				}
+			}
+		}
+	}
+
+	// count the lights of every cluster, turn the counts into
+	// offsets, then place each light index at its offset
+	std::fill(m_clusterRanges.begin(), m_clusterRanges.end(), 0);
+	for (size_t i = 0; i < m_overlaps.size(); i++)
+	{
+		m_clusterRanges[(m_overlaps[i] >> OVERLAP_LIGHT_BITS) * 2 + 1]++;
+	}
+
+	uint32_t offset = 0;
+	for (int cluster = 0; cluster < CLUSTER_COUNT; cluster++)
+	{
+		m_clusterRanges[cluster * 2] = offset;
+		offset += m_clusterRanges[cluster * 2 + 1];
+		m_clusterRanges[cluster * 2 + 1] = 0;
+	}
+
+	m_clusterLightIndices.resize(m_overlaps.size());
+	for (size_t i = 0; i < m_overlaps.size(); i++)
+	{
+		uint32_t cluster = m_overlaps[i] >> OVERLAP_LIGHT_BITS;
+		uint32_t& count = m_clusterRanges[cluster * 2 + 1];
+
+		m_clusterLightIndices[m_clusterRanges[cluster * 2] + count] =
+			(uint16_t)(m_overlaps[i] & ((1 << OVERLAP_LIGHT_BITS) - 1));
+		count++;
+	}
+
+	glBindBuffer(GL_TEXTURE_BUFFER, m_rangeBuffer);
+	glBufferSubData(GL_TEXTURE_BUFFER, 0, m_clusterRanges.size() * sizeof(uint32_t), &m_clusterRanges[0]);
+
+	if (!m_clusterLightIndices.empty())
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER, m_indexBuffer);
+		if (m_clusterLightIndices.size() > m_indexCapacity)
+		{
+			m_indexCapacity = m_clusterLightIndices.size() * 2;
+			glBufferData(GL_TEXTURE_BUFFER, m_indexCapacity * sizeof(uint16_t), NULL, GL_STREAM_DRAW);
+		}
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, m_clusterLightIndices.size() * sizeof(uint16_t), &m_clusterLightIndices[0]);
+	}
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the light, range and index
+ *  buffer textures to their texture units, leaving the unit
+ *  of the scene texture array active.
+ ***********************************************************/
+void LightClusters::Bind() const
+{
+	glActiveTexture(GL_TEXTURE0 + LOCAL_LIGHT_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_BUFFER, m_lightTexture);
+	glActiveTexture(GL_TEXTURE0 + CLUSTER_RANGE_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_BUFFER, m_rangeTexture);
+	glActiveTexture(GL_TEXTURE0 + CLUSTER_INDEX_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_BUFFER, m_indexTexture);
+	glActiveTexture(GL_TEXTURE0 + TEXTURE_ARRAY_UNIT);
+}
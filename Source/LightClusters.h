@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightclusters.h
+// ============
+// assign the local scene lights to the clusters of the view for shading
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "UniformCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  LightClusters
+ *
+ *  This class keeps the local lights of the scene, which only
+ *  reach as far as their radius, and splits the view frustum
+ *  into a grid of clusters: screen tiles in x and y, and
+ *  slices that grow with the distance in z.  Every frame the
+ *  lights are tested against the view space box of every
+ *  cluster they can reach, and the light list of each cluster
+ *  is sent to the fragment shader in buffer textures, so that
+ *  a fragment only shades the lights of its own cluster.  The
+ *  grid is built on the CPU, which keeps the fragment shader
+ *  at GLSL 330 and lets every context use the same path.
+ ***********************************************************/
+class LightClusters
+{
+public:
+	// size of the cluster grid, must match the defines in
+	// shaders/fragmentShader.glsl
+	static const int CLUSTER_COLUMNS = 16;
+	static const int CLUSTER_ROWS = 9;
+	static const int CLUSTER_SLICES = 24;
+	static const int CLUSTER_COUNT = CLUSTER_COLUMNS * CLUSTER_ROWS * CLUSTER_SLICES;
+	// most local lights that can be added to the scene
+	static const int MAX_LOCAL_LIGHTS = 256;
+
+	// a light that fades out to nothing at its radius
+	struct LOCAL_LIGHT
+	{
+		glm::vec3 position;
+		float radius;
+		glm::vec3 color;
+		float intensity;
+	};
+
+	// constructor
+	LightClusters();
+	// destructor
+	~LightClusters();
+
+	// create the buffer textures the grid is sent in
+	bool Initialize();
+	// point the light samplers of the program in use at their
+	// texture units, once after the program is built
+	static void SetSamplerUnits(GLuint programID);
+	// set the light count and the depth slicing into the program
+	// in use through its cache, and select its shading loop
+	void SetShaderUniforms(UniformCache& uniforms, bool bClustered) const;
+
+	// add a local light and return its index, or -1 when full
+	int AddLight(const glm::vec3& position, float radius, const glm::vec3& color, float intensity);
+	// remove every local light
+	void ClearLights();
+	int GetLightCount() const { return((int)m_lights.size()); }
+
+	// send the local lights to their buffer texture if they
+	// changed, which the forward loop needs as well
+	void UploadLights();
+	// assign the lights to the clusters of the passed in camera
+	void Update(const glm::mat4& view, const glm::mat4& projection);
+	// bind the buffer textures to their texture units
+	void Bind() const;
+
+	// light indices written into the clusters in the last update
+	unsigned int GetAssignedCount() const { return((unsigned int)m_clusterLightIndices.size()); }
+
+private:
+	// the local lights, and whether they changed since upload
+	std::vector<LOCAL_LIGHT> m_lights;
+	bool m_bLightsDirty;
+	// view space boxes of the clusters for the last projection
+	std::vector<glm::vec3> m_clusterMinimum;
+	std::vector<glm::vec3> m_clusterMaximum;
+	glm::mat4 m_projection;
+	bool m_bHasProjection;
+	float m_nearDepth;
+	float m_farDepth;
+	// offset and count of every cluster into the index list
+	std::vector<uint32_t> m_clusterRanges;
+	std::vector<uint16_t> m_clusterLightIndices;
+	// cluster and light of every overlap found in an update
+	std::vector<uint32_t> m_overlaps;
+	// buffers and the buffer textures that read them
+	GLuint m_lightBuffer;
+	GLuint m_lightTexture;
+	GLuint m_rangeBuffer;
+	GLuint m_rangeTexture;
+	GLuint m_indexBuffer;
+	GLuint m_indexTexture;
+	size_t m_indexCapacity;
+
+	// rebuild the cluster boxes for a new projection
+	void BuildClusterBounds(const glm::mat4& projection);
+	// slice that the passed in view depth falls into
+	int GetDepthSlice(float depth) const;
+};
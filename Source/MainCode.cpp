@@ -1,187 +1,902 @@
-///////////////////////////////////////////////////////////////////////////////
-// maincode.cpp
-// ============
-// gets called when application is launched - initializes GLEW, GLFW
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
-
-#include <GL/glew.h>        // GLEW library
-#include "GLFW/glfw3.h"     // GLFW library
-
-// GLM Math Header inclusions
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "SceneManager.h"
-#include "ViewManager.h"
-#include "ShapeMeshes.h"
-#include "ShaderManager.h"
-
-// Namespace for declaring global variables
-namespace
-{
-	// Macro for window title
-	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
-
-	// Main GLFW window
-	GLFWwindow* g_Window = nullptr;
-
-	// scene manager object for managing the 3D scene prepare and render
-	SceneManager* g_SceneManager = nullptr;
-	// shader manager object for dynamic interaction with the shader code
-	ShaderManager* g_ShaderManager = nullptr;
-	// view manager object for managing the 3D view setup and projection to 2D
-	ViewManager* g_ViewManager = nullptr;
-}
-
-// Function declarations - all functions that are called manually
-// need to be pre-declared at the beginning of the source code.
-bool InitializeGLFW();
-bool InitializeGLEW();
-
-
-/***********************************************************
- *  main(int, char*)
- *
- *  This function gets called after the application has been
- *  launched.
- ***********************************************************/
-int main(int argc, char* argv[])
-{
-	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// try to create a new shader manager object
-	g_ShaderManager = new ShaderManager();
-	// try to create a new view manager object
-	g_ViewManager = new ViewManager(
-		g_ShaderManager);
-
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
-
-	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"shaders/vertexShader.glsl",
-		"shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
-
-	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
-
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
-	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
-
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
-
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
-
-
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
-
-		// query the latest GLFW events
-		glfwPollEvents();
-	}
-
-	// clear the allocated manager objects from memory
-	if (NULL != g_SceneManager)
-	{
-		delete g_SceneManager;
-		g_SceneManager = NULL;
-	}
-	if (NULL != g_ViewManager)
-	{
-		delete g_ViewManager;
-		g_ViewManager = NULL;
-	}
-	if (NULL != g_ShaderManager)
-	{
-		delete g_ShaderManager;
-		g_ShaderManager = NULL;
-	}
-
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
-}
-
-/***********************************************************
- *	InitializeGLFW()
- * 
- *  This function is used to initialize the GLFW library.   
- ***********************************************************/
-bool InitializeGLFW()
-{
-	// GLFW: initialize and configure library
-	// --------------------------------------
-	glfwInit();
-
-#ifdef __APPLE__
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#else
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
-	// GLFW: end -------------------------------
-
-	return(true);
-}
-
-/***********************************************************
- *	InitializeGLEW()
- *
- *  This function is used to initialize the GLEW library.
- ***********************************************************/
-bool InitializeGLEW()
-{
-	// GLEW: initialize
-	// -----------------------------------------
-	GLenum GLEWInitResult = GLEW_OK;
-
-	// try to initialize the GLEW library
-	GLEWInitResult = glewInit();
-	if (GLEW_OK != GLEWInitResult)
-	{
-		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
-		return false;
-	}
-	// GLEW: end -------------------------------
-
-	// Displays a successful OpenGL initialization message
-	std::cout << "INFO: OpenGL Successfully Initialized\n";
-	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
-
-	return(true);
-}
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////
+// maincode.cpp
+// ============
+// gets called when application is launched - initializes GLEW, GLFW
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>         // error handling and output
+#include <cstdlib>          // EXIT_FAILURE
+#include <string>
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+// GLM Math Header inclusions
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ShapeMeshes.h"
+#include "ShaderManager.h"
+#include "FrameProfiler.h"
+#include "StatsOverlay.h"
+#include "Benchmark.h"
+#include "FrameArena.h"
+#include "AllocationCounter.h"
+#include "SceneCooker.h"
+#include "ResolutionScaler.h"
+#include "RegressionSuite.h"
+
+// Namespace for declaring global variables
+namespace
+{
+	// Macro for window title
+	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
+
+	// Main GLFW window
+	GLFWwindow* g_Window = nullptr;
+
+	// scene manager object for managing the 3D scene prepare and render
+	SceneManager* g_SceneManager = nullptr;
+	// shader manager object for dynamic interaction with the shader code
+	ShaderManager* g_ShaderManager = nullptr;
+	// view manager object for managing the 3D view setup and projection to 2D
+	ViewManager* g_ViewManager = nullptr;
+
+	// frame profiler timing every frame, and the overlay showing it
+	FrameProfiler* g_FrameProfiler = nullptr;
+	StatsOverlay* g_StatsOverlay = nullptr;
+
+	// runs the scripted benchmark when --benchmark is passed in
+	Benchmark* g_Benchmark = nullptr;
+	// repeats the benchmark on every render path when --regression
+	// is passed in, and checks it against the golden results
+	RegressionSuite* g_RegressionSuite = nullptr;
+
+	// draws the scene at a scaled resolution and stretches it
+	// over the window
+	ResolutionScaler* g_ResolutionScaler = nullptr;
+
+	// memory of the per-frame data, taken back every frame
+	FrameArena* g_FrameArena = nullptr;
+	// size the frame arena starts at, it grows to fit the scene
+	const size_t FRAME_ARENA_SIZE = 4 * 1024 * 1024;
+
+	// names of the render paths on the command line
+	struct RENDER_PATH_NAME
+	{
+		const char* name;
+		SceneManager::RENDER_PATH renderPath;
+	};
+	const RENDER_PATH_NAME g_RenderPathNames[] =
+	{
+		{ "legacy", SceneManager::RENDER_PATH_LEGACY },
+		{ "batched", SceneManager::RENDER_PATH_BATCHED },
+		{ "instanced", SceneManager::RENDER_PATH_INSTANCED },
+		{ "indirect", SceneManager::RENDER_PATH_INDIRECT }
+	};
+	const int g_RenderPathNameCount = sizeof(g_RenderPathNames) / sizeof(g_RenderPathNames[0]);
+
+	// scene drawn when no other one is passed in
+	const char* const DEFAULT_SCENE_FILE = "scenes/dashboard.scene";
+
+	// options read from the command line
+	struct COMMAND_LINE_OPTIONS
+	{
+		// text or cooked scene to draw, and the text scene to
+		// only cook when one was passed in
+		std::string sceneFile;
+		std::string cookSceneFile;
+		// profiler output
+		std::string csvPath;
+		std::string tracePath;
+		bool bShowOverlay;
+		// render path, when one was asked for
+		bool bSetRenderPath;
+		SceneManager::RENDER_PATH renderPath;
+		// frustum culling of the scene nodes, and GPU occlusion
+		// culling on the indirect path
+		bool bCulling;
+		bool bOcclusionCulling;
+		// shading of the local lights, and the depth pre-pass
+		SceneManager::LIGHTING_MODE lightingMode;
+		bool bDepthPrepass;
+		// levels of detail picked by the screen size of the nodes
+		bool bLevelOfDetail;
+		// threads the frame is built on, zero for one per core
+		unsigned int jobThreads;
+		// reloading of the asset files changed while running
+		bool bHotReload;
+		// shadows of the directional and spot lights
+		bool bShadows;
+		// scale the scene is drawn at, the highest one when the
+		// GPU time of the scene is held at a target
+		float renderScale;
+		double targetSceneMilliseconds;
+		// benchmark mode
+		bool bBenchmark;
+		int benchmarkFrames;
+		int benchmarkWarmupFrames;
+		std::string benchmarkOutputPath;
+		std::string cameraPathFile;
+		// regression mode, which runs the benchmark once per
+		// render path, optionally on a generated stress scene
+		bool bRegression;
+		bool bUpdateGoldens;
+		double regressionSlowdownPercent;
+		int regressionStressNodes;
+		std::string goldenDirectory;
+		std::string regressionOutputPath;
+	};
+}
+
+// Function declarations - all functions that are called manually
+// need to be pre-declared at the beginning of the source code.
+bool InitializeGLFW();
+bool InitializeGLEW();
+bool ParseCommandLine(int argc, char* argv[], COMMAND_LINE_OPTIONS& options);
+const char* GetRenderPathName(SceneManager::RENDER_PATH renderPath);
+
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the application has been
+ *  launched.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	COMMAND_LINE_OPTIONS options;
+	bool bOverlayKeyDown = false;
+	uint64_t frameStartAllocations = 0;
+	unsigned int lastFrameAllocations = 0;
+
+	if (ParseCommandLine(argc, argv, options) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// cooking a scene needs no window, so it is done before
+	// anything else is set up
+	if (!options.cookSceneFile.empty())
+	{
+		std::string cookedPath = SceneCooker::GetCookedPath(options.cookSceneFile);
+
+		if (SceneCooker::CookScene(options.cookSceneFile.c_str(), cookedPath.c_str()) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+		return(EXIT_SUCCESS);
+	}
+
+	// if GLFW fails initialization, then terminate the application
+	if (InitializeGLFW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// the stress scene is written before it is loaded like any
+	// other text scene
+	if (options.regressionStressNodes > 0)
+	{
+		options.sceneFile = options.goldenDirectory + "/stress_" + std::to_string(options.regressionStressNodes) + ".scene";
+		if ((RegressionSuite::MakeDirectory(options.goldenDirectory.c_str()) == false) ||
+			(RegressionSuite::WriteStressScene(options.sceneFile.c_str(), options.regressionStressNodes) == false))
+		{
+			std::cout << "Could not write the stress scene:" << options.sceneFile << std::endl;
+			return(EXIT_FAILURE);
+		}
+	}
+
+	// try to create a new shader manager object
+	g_ShaderManager = new ShaderManager();
+	// try to create a new view manager object
+	g_ViewManager = new ViewManager(
+		g_ShaderManager);
+
+	// try to create the main display window, which stays hidden
+	// while benchmarking
+	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE, options.bBenchmark);
+	if (NULL == g_Window)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// if GLEW fails initialization, then terminate the application
+	if (InitializeGLEW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// load the shader code from the external GLSL files
+	g_ShaderManager->LoadShaders(
+		"shaders/vertexShader.glsl",
+		"shaders/fragmentShader.glsl");
+	g_ShaderManager->use();
+
+	// try to create a new scene manager object and prepare the 3D scene
+	g_SceneManager = new SceneManager(g_ShaderManager);
+	if (g_SceneManager->PrepareScene(options.sceneFile.c_str()) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	g_FrameArena = new FrameArena();
+	g_FrameArena->Initialize(FRAME_ARENA_SIZE);
+
+	// create the frame profiler and the overlay, which is shown
+	// from the start with --overlay and toggled with F1
+	g_FrameProfiler = new FrameProfiler();
+	g_FrameProfiler->Initialize();
+	g_StatsOverlay = new StatsOverlay();
+	g_StatsOverlay->Initialize(
+		"shaders/overlayVertexShader.glsl",
+		"shaders/overlayFragmentShader.glsl");
+	g_StatsOverlay->SetVisible(options.bShowOverlay);
+
+	// the benchmark always draws at its own framebuffer size,
+	// so its results compare between runs
+	g_ResolutionScaler = new ResolutionScaler();
+	if (false == options.bBenchmark)
+	{
+		g_ResolutionScaler->SetMaximumScale(options.renderScale);
+		g_ResolutionScaler->SetTargetFrameTime(options.targetSceneMilliseconds);
+	}
+
+	if (options.bSetRenderPath)
+	{
+		g_SceneManager->SetRenderPath(options.renderPath);
+	}
+	g_SceneManager->SetCullingEnabled(options.bCulling);
+	g_SceneManager->SetOcclusionCullingEnabled(options.bOcclusionCulling);
+	g_SceneManager->SetLightingMode(options.lightingMode);
+	g_SceneManager->SetDepthPrepassEnabled(options.bDepthPrepass);
+	g_SceneManager->SetLevelOfDetailEnabled(options.bLevelOfDetail);
+	g_SceneManager->SetShadowsEnabled(options.bShadows);
+	g_SceneManager->StartJobThreads(options.jobThreads);
+	// a benchmark is never disturbed by a file being saved
+	g_SceneManager->SetHotReloadEnabled(options.bHotReload && !options.bBenchmark);
+
+	// the benchmark renders offscreen with vsync off, and waits
+	// for every texture first so streaming does not skew the times
+	if (options.bBenchmark)
+	{
+		int width = 0;
+		int height = 0;
+
+		g_Benchmark = new Benchmark();
+		if (!options.cameraPathFile.empty() &&
+			(g_Benchmark->LoadCameraPath(options.cameraPathFile.c_str()) == false))
+		{
+			return(EXIT_FAILURE);
+		}
+
+		glfwGetFramebufferSize(g_Window, &width, &height);
+		if (g_Benchmark->Initialize(width, height, options.benchmarkFrames, options.benchmarkWarmupFrames) == false)
+		{
+			std::cout << "Could not start the benchmark" << std::endl;
+			return(EXIT_FAILURE);
+		}
+
+		glfwSwapInterval(0);
+		g_SceneManager->FinishTextureLoading();
+		std::cout << "INFO: Benchmarking " << options.benchmarkFrames << " frames" << std::endl;
+	}
+
+	// the regression suite compares whole frames, so the overlay
+	// is kept out of them
+	if (options.bRegression)
+	{
+		g_RegressionSuite = new RegressionSuite();
+		if (g_RegressionSuite->Initialize(
+			options.goldenDirectory.c_str(),
+			options.sceneFile,
+			options.regressionSlowdownPercent,
+			options.bUpdateGoldens) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+		for (int path = 0; path < g_RenderPathNameCount; path++)
+		{
+			g_RegressionSuite->AddPass(g_RenderPathNames[path].renderPath, g_RenderPathNames[path].name);
+		}
+		g_RegressionSuite->BeginFirstPass(*g_SceneManager, *g_FrameProfiler);
+		g_StatsOverlay->SetVisible(false);
+	}
+
+	// loop will keep running until the application is closed 
+	// or until an error has occurred
+	while (!glfwWindowShouldClose(g_Window))
+	{
+		FrameProfiler::FRAME_COUNTERS counters;
+
+		// the regression suite runs the camera path again for
+		// each of its passes
+		if ((NULL != g_Benchmark) && g_Benchmark->IsFinished())
+		{
+			if ((NULL == g_RegressionSuite) ||
+				(g_RegressionSuite->EndPass(*g_Benchmark, *g_FrameProfiler, *g_SceneManager) == false))
+			{
+				break;
+			}
+			g_Benchmark->Restart();
+		}
+
+		// nothing is drawn while the window is minimized
+		int framebufferWidth = 0;
+		int framebufferHeight = 0;
+		g_ViewManager->GetFramebufferSize(framebufferWidth, framebufferHeight);
+		if ((NULL == g_Benchmark) && ((framebufferWidth <= 0) || (framebufferHeight <= 0)))
+		{
+			glfwWaitEvents();
+			continue;
+		}
+
+		// the heap allocations are counted over whole frames, so
+		// the ones shown are those of the frame before this one
+		uint64_t allocationCount = AllocationCounter::GetAllocationCount();
+		lastFrameAllocations = (unsigned int)(allocationCount - frameStartAllocations);
+		frameStartAllocations = allocationCount;
+
+		// the changed shaders, textures and scene file are
+		// reloaded between two frames
+		g_SceneManager->ReloadChangedAssets();
+
+		g_FrameProfiler->BeginFrame();
+
+		// the per-frame data of the last frame is all dropped at
+		// once, and the scene starts its arrays again in the arena
+		g_FrameArena->Reset();
+		g_SceneManager->BeginFrame(g_FrameArena);
+
+		// move the camera along the benchmark path
+		if (NULL != g_Benchmark)
+		{
+			glm::vec3 position;
+			glm::vec3 target;
+
+			g_Benchmark->BeginFrame(position, target);
+			g_ViewManager->SetCameraPose(position, target);
+		}
+
+		// Enable z-depth
+		glEnable(GL_DEPTH_TEST);
+
+		// Clear the frame and z buffers, which for the window are
+		// the ones of the scaled scene at the size picked from the
+		// GPU times read back so far
+		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+		if (NULL != g_Benchmark)
+		{
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		}
+		else
+		{
+			g_ResolutionScaler->SetOutputSize(framebufferWidth, framebufferHeight);
+			g_ResolutionScaler->Update(*g_FrameProfiler);
+			g_ResolutionScaler->BeginScene();
+		}
+
+		// convert from 3D object space to 2D view
+		{
+			ProfileScope scope(g_FrameProfiler, FrameProfiler::SCOPE_VIEW);
+			g_ViewManager->PrepareSceneView();
+		}
+		g_SceneManager->SetCameraMatrices(g_ViewManager->GetViewMatrix(), g_ViewManager->GetProjectionMatrix());
+
+		// refresh the 3D scene
+		{
+			ProfileScope scope(g_FrameProfiler, FrameProfiler::SCOPE_SCENE);
+			g_SceneManager->RenderScene();
+			if (NULL == g_Benchmark)
+			{
+				g_ResolutionScaler->EndScene();
+			}
+		}
+
+		// record what the scene submitted this frame
+		counters.drawCalls = g_SceneManager->GetRenderStats().drawCount;
+		counters.uniformUploads = g_SceneManager->GetUniformUploadCount();
+		counters.textureBinds = g_SceneManager->GetTextureBindCount();
+		counters.triangles = g_SceneManager->GetRenderStats().triangleCount;
+		counters.culledNodes = g_SceneManager->GetCulledNodeCount();
+		counters.shadowLayers = g_SceneManager->GetShadowLayerCount();
+		counters.renderWidth = (NULL != g_Benchmark) ? (unsigned int)framebufferWidth : (unsigned int)g_ResolutionScaler->GetRenderWidth();
+		counters.renderHeight = (NULL != g_Benchmark) ? (unsigned int)framebufferHeight : (unsigned int)g_ResolutionScaler->GetRenderHeight();
+		counters.heapAllocations = lastFrameAllocations;
+		g_FrameProfiler->SetCounters(counters);
+
+		// draw the profiler times over the scene
+		{
+			ProfileScope scope(g_FrameProfiler, FrameProfiler::SCOPE_OVERLAY);
+			g_StatsOverlay->SetContentScale(g_ViewManager->GetContentScale());
+			g_StatsOverlay->Draw(*g_FrameProfiler);
+		}
+
+		// Flips the the back buffer with the front buffer every frame,
+		// the benchmark waits for the GPU instead
+		{
+			ProfileScope scope(g_FrameProfiler, FrameProfiler::SCOPE_SWAP);
+			if (NULL != g_Benchmark)
+			{
+				g_Benchmark->EndFrame();
+			}
+			else
+			{
+				glfwSwapBuffers(g_Window);
+			}
+		}
+
+		g_FrameProfiler->EndFrame();
+
+		// query the latest GLFW events
+		glfwPollEvents();
+
+		// toggle the overlay once per press of F1
+		if (glfwGetKey(g_Window, GLFW_KEY_F1) == GLFW_PRESS)
+		{
+			if (false == bOverlayKeyDown)
+			{
+				g_StatsOverlay->ToggleVisible();
+			}
+			bOverlayKeyDown = true;
+		}
+		else
+		{
+			bOverlayKeyDown = false;
+		}
+	}
+
+	// write the regression or the benchmark results
+	bool bRegressionFailed = false;
+	if (NULL != g_RegressionSuite)
+	{
+		bRegressionFailed = g_RegressionSuite->HasFailed();
+		if (g_RegressionSuite->WriteResults(options.regressionOutputPath.c_str()))
+		{
+			std::cout << "INFO: Regression results written to " << options.regressionOutputPath << std::endl;
+		}
+		else
+		{
+			std::cout << "Could not write the regression results:" << options.regressionOutputPath << std::endl;
+			bRegressionFailed = true;
+		}
+		std::cout << "INFO: Regression " << (bRegressionFailed ? "failed" : "passed") << std::endl;
+	}
+	else if (NULL != g_Benchmark)
+	{
+		g_FrameProfiler->ResolveQueries();
+		if (g_Benchmark->WriteResults(
+			options.benchmarkOutputPath.c_str(),
+			*g_FrameProfiler,
+			GetRenderPathName(g_SceneManager->GetRenderPath())))
+		{
+			std::cout << "INFO: Benchmark results written to " << options.benchmarkOutputPath << std::endl;
+		}
+		else
+		{
+			std::cout << "Could not write the benchmark results:" << options.benchmarkOutputPath << std::endl;
+		}
+	}
+
+	// write the recorded frames when asked to on the command line
+	if (!options.csvPath.empty())
+	{
+		if (g_FrameProfiler->WriteCsv(options.csvPath.c_str()))
+		{
+			std::cout << "INFO: Frame profile written to " << options.csvPath << std::endl;
+		}
+		else
+		{
+			std::cout << "Could not write the frame profile:" << options.csvPath << std::endl;
+		}
+	}
+	if (!options.tracePath.empty())
+	{
+		if (g_FrameProfiler->WriteChromeTrace(options.tracePath.c_str()))
+		{
+			std::cout << "INFO: Frame trace written to " << options.tracePath << std::endl;
+		}
+		else
+		{
+			std::cout << "Could not write the frame trace:" << options.tracePath << std::endl;
+		}
+	}
+
+	// clear the allocated manager objects from memory
+	if (NULL != g_RegressionSuite)
+	{
+		delete g_RegressionSuite;
+		g_RegressionSuite = NULL;
+	}
+	if (NULL != g_Benchmark)
+	{
+		delete g_Benchmark;
+		g_Benchmark = NULL;
+	}
+	if (NULL != g_ResolutionScaler)
+	{
+		delete g_ResolutionScaler;
+		g_ResolutionScaler = NULL;
+	}
+	if (NULL != g_StatsOverlay)
+	{
+		delete g_StatsOverlay;
+		g_StatsOverlay = NULL;
+	}
+	if (NULL != g_FrameProfiler)
+	{
+		delete g_FrameProfiler;
+		g_FrameProfiler = NULL;
+	}
+	if (NULL != g_SceneManager)
+	{
+		delete g_SceneManager;
+		g_SceneManager = NULL;
+	}
+	// the scene arrays in the arena are dropped with the scene
+	if (NULL != g_FrameArena)
+	{
+		delete g_FrameArena;
+		g_FrameArena = NULL;
+	}
+	if (NULL != g_ViewManager)
+	{
+		delete g_ViewManager;
+		g_ViewManager = NULL;
+	}
+	if (NULL != g_ShaderManager)
+	{
+		delete g_ShaderManager;
+		g_ShaderManager = NULL;
+	}
+
+	// Terminates the program, failing when a regression pass did
+	exit(bRegressionFailed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/***********************************************************
+ *	InitializeGLFW()
+ * 
+ *  This function is used to initialize the GLFW library.   
+ ***********************************************************/
+bool InitializeGLFW()
+{
+	// GLFW: initialize and configure library
+	// --------------------------------------
+	glfwInit();
+
+#ifdef __APPLE__
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#else
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
+	// GLFW: end -------------------------------
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLEW()
+ *
+ *  This function is used to initialize the GLEW library.
+ ***********************************************************/
+bool InitializeGLEW()
+{
+	// GLEW: initialize
+	// -----------------------------------------
+	GLenum GLEWInitResult = GLEW_OK;
+
+	// try to initialize the GLEW library
+	GLEWInitResult = glewInit();
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return false;
+	}
+	// GLEW: end -------------------------------
+
+	// Displays a successful OpenGL initialization message
+	std::cout << "INFO: OpenGL Successfully Initialized\n";
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *	ParseCommandLine()
+ *
+ *  This function is used to read the options from the
+ *  command line:
+ *    --scene=<file>             text or cooked scene to draw
+ *    --cook-scene=<file>        cook a text scene and exit
+ *    --profile-csv=<file>       write every frame as CSV on exit
+ *    --profile-trace=<file>     write a Chrome trace on exit
+ *    --overlay                  show the stats overlay at start
+ *    --render-path=<name>       legacy, batched, instanced or indirect
+ *    --no-culling               draw the nodes outside of the frustum
+ *    --occlusion-culling        cull hidden indirect draws on the GPU
+ *    --lighting=<mode>          forward or clustered local lights
+ *    --depth-prepass            draw the opaque depth before shading
+ *    --no-lod                   draw every mesh at one tessellation
+ *    --job-threads=<n>          threads the frame is built on, 1 for none
+ *    --no-hot-reload            do not reload the assets changed on disk
+ *    --no-shadows               draw the lights without shadow maps
+ *    --render-scale=<s>         scale of the scene size, 0.5 to 1
+ *    --dynamic-resolution=<ms>  scale the scene to hold a GPU time
+ *    --benchmark                render offscreen along a camera path
+ *    --benchmark-frames=<n>     frames to render, 600 by default
+ *    --benchmark-warmup=<n>     first frames left out, 60 by default
+ *    --benchmark-output=<file>  results file, benchmark_results.json
+ *    --camera-path=<file>       camera keyframes for the benchmark
+ *    --regression               benchmark every render path and check
+ *                               it against the golden results
+ *    --regression-golden=<dir>  golden files, regression by default
+ *    --regression-update        record the golden files again
+ *    --regression-threshold=<p> slowdown in percent that fails, 10
+ *    --regression-output=<file> results file, regression_results.json
+ *    --regression-stress=<n>    check a generated scene of n nodes,
+ *                               only with --regression
+ ***********************************************************/
+bool ParseCommandLine(int argc, char* argv[], COMMAND_LINE_OPTIONS& options)
+{
+	options.sceneFile = DEFAULT_SCENE_FILE;
+	options.cookSceneFile.clear();
+	options.csvPath.clear();
+	options.tracePath.clear();
+	options.bShowOverlay = false;
+	options.bSetRenderPath = false;
+	options.renderPath = SceneManager::RENDER_PATH_BATCHED;
+	options.bCulling = true;
+	options.bOcclusionCulling = false;
+	options.lightingMode = SceneManager::LIGHTING_FORWARD;
+	options.bDepthPrepass = false;
+	options.bLevelOfDetail = true;
+	options.jobThreads = 0;
+	options.bHotReload = true;
+	options.bShadows = true;
+	options.renderScale = 1.0f;
+	options.targetSceneMilliseconds = 0.0;
+	options.bBenchmark = false;
+	options.benchmarkFrames = 600;
+	options.benchmarkWarmupFrames = 60;
+	options.benchmarkOutputPath = "benchmark_results.json";
+	options.cameraPathFile.clear();
+	options.bRegression = false;
+	options.bUpdateGoldens = false;
+	options.regressionSlowdownPercent = 10.0;
+	options.regressionStressNodes = 0;
+	options.goldenDirectory = "regression";
+	options.regressionOutputPath = "regression_results.json";
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+		std::string name = argument.substr(0, argument.find('='));
+		std::string value = (argument.find('=') != std::string::npos) ? argument.substr(argument.find('=') + 1) : "";
+
+		if (name == "--scene")
+		{
+			options.sceneFile = value;
+		}
+		else if (name == "--cook-scene")
+		{
+			options.cookSceneFile = value;
+		}
+		else if (name == "--profile-csv")
+		{
+			options.csvPath = value;
+		}
+		else if (name == "--profile-trace")
+		{
+			options.tracePath = value;
+		}
+		else if (name == "--overlay")
+		{
+			options.bShowOverlay = true;
+		}
+		else if (name == "--render-path")
+		{
+			for (int path = 0; path < g_RenderPathNameCount; path++)
+			{
+				if (value == g_RenderPathNames[path].name)
+				{
+					options.bSetRenderPath = true;
+					options.renderPath = g_RenderPathNames[path].renderPath;
+				}
+			}
+			if (false == options.bSetRenderPath)
+			{
+				std::cout << "Unknown render path:" << value << std::endl;
+				return(false);
+			}
+		}
+		else if (name == "--no-culling")
+		{
+			options.bCulling = false;
+		}
+		else if (name == "--occlusion-culling")
+		{
+			options.bOcclusionCulling = true;
+		}
+		else if (name == "--lighting")
+		{
+			if (value == "forward")
+			{
+				options.lightingMode = SceneManager::LIGHTING_FORWARD;
+			}
+			else if (value == "clustered")
+			{
+				options.lightingMode = SceneManager::LIGHTING_CLUSTERED;
+			}
+			else
+			{
+				std::cout << "Unknown lighting mode:" << value << std::endl;
+				return(false);
+			}
+		}
+		else if (name == "--depth-prepass")
+		{
+			options.bDepthPrepass = true;
+		}
+		else if (name == "--no-lod")
+		{
+			options.bLevelOfDetail = false;
+		}
+		else if (name == "--job-threads")
+		{
+			int count = (int)strtol(value.c_str(), NULL, 10);
+
+			if (count < 1)
+			{
+				std::cout << "Invalid thread count:" << argument << std::endl;
+				return(false);
+			}
+			options.jobThreads = (unsigned int)count;
+		}
+		else if (name == "--no-hot-reload")
+		{
+			options.bHotReload = false;
+		}
+		else if (name == "--no-shadows")
+		{
+			options.bShadows = false;
+		}
+		else if (name == "--render-scale")
+		{
+			float scale = (float)strtod(value.c_str(), NULL);
+
+			if ((scale < ResolutionScaler::MIN_SCALE) || (scale > 1.0f))
+			{
+				std::cout << "Invalid render scale:" << argument << std::endl;
+				return(false);
+			}
+			options.renderScale = scale;
+		}
+		else if (name == "--dynamic-resolution")
+		{
+			double milliseconds = strtod(value.c_str(), NULL);
+
+			if (milliseconds <= 0.0)
+			{
+				std::cout << "Invalid target frame time:" << argument << std::endl;
+				return(false);
+			}
+			options.targetSceneMilliseconds = milliseconds;
+		}
+		else if (name == "--benchmark")
+		{
+			options.bBenchmark = true;
+		}
+		else if ((name == "--benchmark-frames") || (name == "--benchmark-warmup"))
+		{
+			int count = (int)strtol(value.c_str(), NULL, 10);
+
+			if ((count < 0) || ((count == 0) && (name == "--benchmark-frames")))
+			{
+				std::cout << "Invalid frame count:" << argument << std::endl;
+				return(false);
+			}
+			if (name == "--benchmark-frames")
+			{
+				options.benchmarkFrames = count;
+			}
+			else
+			{
+				options.benchmarkWarmupFrames = count;
+			}
+		}
+		else if (name == "--benchmark-output")
+		{
+			options.benchmarkOutputPath = value;
+		}
+		else if (name == "--camera-path")
+		{
+			options.cameraPathFile = value;
+		}
+		else if (name == "--regression")
+		{
+			options.bRegression = true;
+			options.bBenchmark = true;
+		}
+		else if (name == "--regression-golden")
+		{
+			options.goldenDirectory = value;
+		}
+		else if (name == "--regression-update")
+		{
+			options.bUpdateGoldens = true;
+		}
+		else if (name == "--regression-threshold")
+		{
+			double percent = strtod(value.c_str(), NULL);
+
+			if (percent <= 0.0)
+			{
+				std::cout << "Invalid regression threshold:" << argument << std::endl;
+				return(false);
+			}
+			options.regressionSlowdownPercent = percent;
+		}
+		else if (name == "--regression-output")
+		{
+			options.regressionOutputPath = value;
+		}
+		else if (name == "--regression-stress")
+		{
+			int count = (int)strtol(value.c_str(), NULL, 10);
+
+			if ((count < 1) || (count > RegressionSuite::MAX_STRESS_NODES))
+			{
+				std::cout << "Invalid stress node count:" << argument << std::endl;
+				return(false);
+			}
+			options.regressionStressNodes = count;
+		}
+		else
+		{
+			std::cout << "Unknown command line option:" << argument << std::endl;
+		}
+	}
+
+	// the stress scene replaces the scene file, which is only
+	// wanted when it is being checked
+	if ((options.regressionStressNodes > 0) && (false == options.bRegression))
+	{
+		std::cout << "The --regression-stress option needs --regression" << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *	GetRenderPathName()
+ *
+ *  This function is used to get the command line name of a
+ *  render path.
+ ***********************************************************/
+const char* GetRenderPathName(SceneManager::RENDER_PATH renderPath)
+{
+	for (int path = 0; path < g_RenderPathNameCount; path++)
+	{
+		if (g_RenderPathNames[path].renderPath == renderPath)
+		{
+			return(g_RenderPathNames[path].name);
+		}
+	}
+
+	return("unknown");
+}
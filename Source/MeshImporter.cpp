@@ -0,0 +1,1509 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshimporter.cpp
+// ============
+// import the triangle meshes of glTF 2.0 files into the mesh library
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshImporter.h"
+#include "MeshOptimizer.h"
+
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// declaration of global variables
+namespace
+{
+	// deepest nesting of JSON values and of scene nodes that is
+	// read, which stops a broken file from recursing forever
+	const int MAX_JSON_DEPTH = 64;
+	const int MAX_NODE_DEPTH = 64;
+
+	// chunks of a binary .glb file, all stored little endian
+	const uint32_t GLB_MAGIC = 0x46546C67;
+	const uint32_t GLB_VERSION = 2;
+	const uint32_t GLB_CHUNK_JSON = 0x4E4F534A;
+	const uint32_t GLB_CHUNK_BIN = 0x004E4942;
+	const size_t GLB_HEADER_SIZE = 12;
+	const size_t GLB_CHUNK_HEADER_SIZE = 8;
+
+	// values of the glTF accessors and primitives that are read
+	const int GLTF_BYTE = 5120;
+	const int GLTF_UNSIGNED_BYTE = 5121;
+	const int GLTF_SHORT = 5122;
+	const int GLTF_UNSIGNED_SHORT = 5123;
+	const int GLTF_UNSIGNED_INT = 5125;
+	const int GLTF_FLOAT = 5126;
+	const int GLTF_TRIANGLES = 4;
+
+	// cells along the diagonal of the mesh for each coarser level
+	// of detail, about two and a half pixels per cell at the
+	// largest screen size that the mesh library draws the level at
+	const float LOD_GRID_CELLS[MeshLibrary::MAX_LOD_LEVELS - 1] = { 128.0f, 32.0f, 8.0f };
+	// a coarser level is only kept when it has at most this part
+	// of the triangles of the level before it
+	const float LOD_MIN_REDUCTION = 0.75f;
+
+	// one value of a JSON document
+	struct JSON_VALUE
+	{
+		enum TYPE
+		{
+			JSON_NULL = 0,
+			JSON_BOOLEAN,
+			JSON_NUMBER,
+			JSON_STRING,
+			JSON_ARRAY,
+			JSON_OBJECT
+		};
+
+		TYPE type;
+		// booleans are stored as zero or one
+		double number;
+		std::string text;
+		// elements of an array, or the values of an object in the
+		// order of their keys
+		std::vector<JSON_VALUE> items;
+		std::vector<std::string> keys;
+
+		JSON_VALUE() : type(JSON_NULL), number(0.0) {}
+	};
+
+	// the parts of a glTF file that the accessors are read from
+	struct GLTF_FILE
+	{
+		JSON_VALUE document;
+		std::vector<std::vector<unsigned char> > buffers;
+		const JSON_VALUE* pAccessors;
+		const JSON_VALUE* pBufferViews;
+		const JSON_VALUE* pMeshes;
+		const JSON_VALUE* pNodes;
+		// primitives that are not triangle lists
+		unsigned int skippedPrimitives;
+	};
+
+	/***********************************************************
+	 *  SkipWhitespace()
+	 *
+	 *  This function is used for moving past the white space
+	 *  between JSON values.
+	 ***********************************************************/
+	void SkipWhitespace(const char*& p, const char* end)
+	{
+		while ((p < end) && ((*p == ' ') || (*p == '\t') || (*p == '\n') || (*p == '\r')))
+		{
+			p++;
+		}
+	}
+
+	/***********************************************************
+	 *  AppendUtf8()
+	 *
+	 *  This function is used for writing a code point of a JSON
+	 *  escape sequence as UTF-8.
+	 ***********************************************************/
+	void AppendUtf8(std::string& text, uint32_t codePoint)
+	{
+		if (codePoint < 0x80)
+		{
+			text.push_back((char)codePoint);
+		}
+		else if (codePoint < 0x800)
+		{
+			text.push_back((char)(0xC0 | (codePoint >> 6)));
+			text.push_back((char)(0x80 | (codePoint & 0x3F)));
+		}
+		else if (codePoint < 0x10000)
+		{
+			text.push_back((char)(0xE0 | (codePoint >> 12)));
+			text.push_back((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+			text.push_back((char)(0x80 | (codePoint & 0x3F)));
+		}
+		else
+		{
+			text.push_back((char)(0xF0 | (codePoint >> 18)));
+			text.push_back((char)(0x80 | ((codePoint >> 12) & 0x3F)));
+			text.push_back((char)(0x80 | ((codePoint >> 6) & 0x3F)));
+			text.push_back((char)(0x80 | (codePoint & 0x3F)));
+		}
+	}
+
+	/***********************************************************
+	 *  ParseHexDigits()
+	 *
+	 *  This function is used for reading the four hex digits of
+	 *  a \u escape.
+	 ***********************************************************/
+	bool ParseHexDigits(const char*& p, const char* end, uint32_t& value)
+	{
+		value = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			char c = (p < end) ? *p++ : '\0';
+
+			value <<= 4;
+			if ((c >= '0') && (c <= '9'))
+			{
+				value |= (uint32_t)(c - '0');
+			}
+			else if ((c >= 'a') && (c <= 'f'))
+			{
+				value |= (uint32_t)(c - 'a' + 10);
+			}
+			else if ((c >= 'A') && (c <= 'F'))
+			{
+				value |= (uint32_t)(c - 'A' + 10);
+			}
+			else
+			{
+				return(false);
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ParseString()
+	 *
+	 *  This function is used for reading a JSON string, starting
+	 *  at its opening quote.
+	 ***********************************************************/
+	bool ParseString(const char*& p, const char* end, std::string& text)
+	{
+		text.clear();
+		if ((p >= end) || (*p != '"'))
+		{
+			return(false);
+		}
+		p++;
+
+		while (p < end)
+		{
+			char c = *p++;
+
+			if (c == '"')
+			{
+				return(true);
+			}
+			if (c != '\\')
+			{
+				text.push_back(c);
+				continue;
+			}
+			if (p >= end)
+			{
+				return(false);
+			}
+
+			c = *p++;
+			switch (c)
+			{
+			case '"': text.push_back('"'); break;
+			case '\\': text.push_back('\\'); break;
+			case '/': text.push_back('/'); break;
+			case 'b': text.push_back('\b'); break;
+			case 'f': text.push_back('\f'); break;
+			case 'n': text.push_back('\n'); break;
+			case 'r': text.push_back('\r'); break;
+			case 't': text.push_back('\t'); break;
+			case 'u':
+			{
+				uint32_t codePoint = 0;
+				uint32_t low = 0;
+
+				if (false == ParseHexDigits(p, end, codePoint))
+				{
+					return(false);
+				}
+				// a code point above the first plane is written as
+				// a pair of surrogates
+				if ((codePoint >= 0xD800) && (codePoint < 0xDC00) &&
+					(end - p >= 6) && (p[0] == '\\') && (p[1] == 'u'))
+				{
+					p += 2;
+					if ((false == ParseHexDigits(p, end, low)) || (low < 0xDC00) || (low > 0xDFFF))
+					{
+						return(false);
+					}
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+				}
+				AppendUtf8(text, codePoint);
+				break;
+			}
+			default:
+				return(false);
+			}
+		}
+
+		return(false);
+	}
+
+	/***********************************************************
+	 *  ParseLiteral()
+	 *
+	 *  This function is used for reading true, false or null.
+	 ***********************************************************/
+	bool ParseLiteral(const char*& p, const char* end, const char* literal)
+	{
+		size_t length = strlen(literal);
+
+		if (((size_t)(end - p) < length) || (strncmp(p, literal, length) != 0))
+		{
+			return(false);
+		}
+		p += length;
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ParseValue()
+	 *
+	 *  This function is used for reading one JSON value and the
+	 *  values nested in it.
+	 ***********************************************************/
+	bool ParseValue(const char*& p, const char* end, JSON_VALUE& value, int depth)
+	{
+		SkipWhitespace(p, end);
+		if ((p >= end) || (depth > MAX_JSON_DEPTH))
+		{
+			return(false);
+		}
+
+		if ((*p == '{') || (*p == '['))
+		{
+			bool bObject = (*p == '{');
+			char close = bObject ? '}' : ']';
+
+			value.type = bObject ? JSON_VALUE::JSON_OBJECT : JSON_VALUE::JSON_ARRAY;
+			p++;
+			SkipWhitespace(p, end);
+			if ((p < end) && (*p == close))
+			{
+				p++;
+				return(true);
+			}
+
+			while (p < end)
+			{
+				if (bObject)
+				{
+					std::string key;
+
+					SkipWhitespace(p, end);
+					if (false == ParseString(p, end, key))
+					{
+						return(false);
+					}
+					SkipWhitespace(p, end);
+					if ((p >= end) || (*p != ':'))
+					{
+						return(false);
+					}
+					p++;
+					value.keys.push_back(key);
+				}
+
+				value.items.push_back(JSON_VALUE());
+				if (false == ParseValue(p, end, value.items.back(), depth + 1))
+				{
+					return(false);
+				}
+
+				SkipWhitespace(p, end);
+				if ((p < end) && (*p == ','))
+				{
+					p++;
+				}
+				else if ((p < end) && (*p == close))
+				{
+					p++;
+					return(true);
+				}
+				else
+				{
+					return(false);
+				}
+			}
+
+			return(false);
+		}
+
+		if (*p == '"')
+		{
+			value.type = JSON_VALUE::JSON_STRING;
+			return(ParseString(p, end, value.text));
+		}
+		if ((*p == 't') || (*p == 'f'))
+		{
+			value.type = JSON_VALUE::JSON_BOOLEAN;
+			value.number = (*p == 't') ? 1.0 : 0.0;
+			return(ParseLiteral(p, end, (*p == 't') ? "true" : "false"));
+		}
+		if (*p == 'n')
+		{
+			value.type = JSON_VALUE::JSON_NULL;
+			return(ParseLiteral(p, end, "null"));
+		}
+
+		// a number is copied out, since the document does not end
+		// with a terminator that strtod could stop at
+		std::string number;
+		char* pNumberEnd = NULL;
+
+		while ((p < end) && (strchr("+-0123456789.eE", *p) != NULL) && (*p != '\0'))
+		{
+			number.push_back(*p++);
+		}
+		if (number.empty())
+		{
+			return(false);
+		}
+		value.type = JSON_VALUE::JSON_NUMBER;
+		value.number = strtod(number.c_str(), &pNumberEnd);
+
+		return(*pNumberEnd == '\0');
+	}
+
+	/***********************************************************
+	 *  FindMember()
+	 *
+	 *  This function is used for getting the value of a key of
+	 *  an object, or NULL when it has no such key.
+	 ***********************************************************/
+	const JSON_VALUE* FindMember(const JSON_VALUE* pObject, const char* key)
+	{
+		if ((NULL == pObject) || (pObject->type != JSON_VALUE::JSON_OBJECT))
+		{
+			return(NULL);
+		}
+
+		for (size_t i = 0; i < pObject->keys.size(); i++)
+		{
+			if (pObject->keys[i] == key)
+			{
+				return(&pObject->items[i]);
+			}
+		}
+
+		return(NULL);
+	}
+
+	/***********************************************************
+	 *  GetElement()
+	 *
+	 *  This function is used for getting an element of an array
+	 *  by a JSON index, or NULL when it is not in the array.
+	 ***********************************************************/
+	const JSON_VALUE* GetElement(const JSON_VALUE* pArray, double index)
+	{
+		if ((NULL == pArray) || (pArray->type != JSON_VALUE::JSON_ARRAY) ||
+			(index < 0.0) || (index >= (double)pArray->items.size()) || (index != std::floor(index)))
+		{
+			return(NULL);
+		}
+
+		return(&pArray->items[(size_t)index]);
+	}
+
+	/***********************************************************
+	 *  GetNumber()
+	 *
+	 *  This function is used for getting a number of an object,
+	 *  or the passed in default when it does not have it.
+	 ***********************************************************/
+	double GetNumber(const JSON_VALUE* pObject, const char* key, double defaultValue)
+	{
+		const JSON_VALUE* pValue = FindMember(pObject, key);
+
+		if ((NULL == pValue) || ((pValue->type != JSON_VALUE::JSON_NUMBER) && (pValue->type != JSON_VALUE::JSON_BOOLEAN)))
+		{
+			return(defaultValue);
+		}
+
+		return(pValue->number);
+	}
+
+	/***********************************************************
+	 *  GetSize()
+	 *
+	 *  This function is used for getting a count, offset or
+	 *  length of an object, or the passed in default when it
+	 *  does not have it.  A number that is negative, has a
+	 *  fraction or does not fit 32 bits is rejected before it is
+	 *  converted, since converting it would be undefined.
+	 ***********************************************************/
+	bool GetSize(const JSON_VALUE* pObject, const char* key, size_t defaultValue, size_t& value)
+	{
+		double number = GetNumber(pObject, key, (double)defaultValue);
+
+		if (!(number >= 0.0) || (number >= 4294967296.0) || (number != std::floor(number)))
+		{
+			return(false);
+		}
+
+		value = (size_t)number;
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  GetNumbers()
+	 *
+	 *  This function is used for reading an array of numbers of
+	 *  an object, leaving the passed in values as they are when
+	 *  the object does not have it.
+	 ***********************************************************/
+	bool GetNumbers(const JSON_VALUE* pObject, const char* key, float* pValues, size_t count)
+	{
+		const JSON_VALUE* pArray = FindMember(pObject, key);
+
+		if (NULL == pArray)
+		{
+			return(true);
+		}
+		if ((pArray->type != JSON_VALUE::JSON_ARRAY) || (pArray->items.size() != count))
+		{
+			return(false);
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			if (pArray->items[i].type != JSON_VALUE::JSON_NUMBER)
+			{
+				return(false);
+			}
+			pValues[i] = (float)pArray->items[i].number;
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ReadFileBytes()
+	 *
+	 *  This function is used for reading a whole file.
+	 ***********************************************************/
+	bool ReadFileBytes(const std::string& filename, std::vector<unsigned char>& bytes)
+	{
+		std::ifstream file(filename.c_str(), std::ios::binary);
+		std::ostringstream contents;
+
+		if (!file.is_open())
+		{
+			return(false);
+		}
+
+		contents << file.rdbuf();
+		std::string text = contents.str();
+		bytes.assign(text.begin(), text.end());
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ReadUint32()
+	 *
+	 *  This function is used for reading a little endian value
+	 *  of a .glb header.
+	 ***********************************************************/
+	uint32_t ReadUint32(const unsigned char* pBytes)
+	{
+		return((uint32_t)pBytes[0] | ((uint32_t)pBytes[1] << 8) | ((uint32_t)pBytes[2] << 16) | ((uint32_t)pBytes[3] << 24));
+	}
+
+	/***********************************************************
+	 *  DecodeBase64()
+	 *
+	 *  This function is used for decoding the data of a base64
+	 *  data URI.
+	 ***********************************************************/
+	bool DecodeBase64(const std::string& text, size_t start, std::vector<unsigned char>& bytes)
+	{
+		uint32_t bits = 0;
+		int bitCount = 0;
+
+		bytes.clear();
+		bytes.reserve((text.size() - start) * 3 / 4);
+		for (size_t i = start; i < text.size(); i++)
+		{
+			char c = text[i];
+			uint32_t value = 0;
+
+			if ((c >= 'A') && (c <= 'Z'))
+			{
+				value = (uint32_t)(c - 'A');
+			}
+			else if ((c >= 'a') && (c <= 'z'))
+			{
+				value = (uint32_t)(c - 'a' + 26);
+			}
+			else if ((c >= '0') && (c <= '9'))
+			{
+				value = (uint32_t)(c - '0' + 52);
+			}
+			else if (c == '+')
+			{
+				value = 62;
+			}
+			else if (c == '/')
+			{
+				value = 63;
+			}
+			else if (c == '=')
+			{
+				break;
+			}
+			else
+			{
+				return(false);
+			}
+
+			bits = (bits << 6) | value;
+			bitCount += 6;
+			if (bitCount >= 8)
+			{
+				bitCount -= 8;
+				bytes.push_back((unsigned char)((bits >> bitCount) & 0xFF));
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  DecodeUri()
+	 *
+	 *  This function is used for turning the percent escapes of
+	 *  a relative URI back into the characters of a file name.
+	 ***********************************************************/
+	std::string DecodeUri(const std::string& uri)
+	{
+		std::string path;
+
+		for (size_t i = 0; i < uri.size(); i++)
+		{
+			if ((uri[i] == '%') && (i + 2 < uri.size()))
+			{
+				char digits[3] = { uri[i + 1], uri[i + 2], '\0' };
+				char* pEnd = NULL;
+				long value = strtol(digits, &pEnd, 16);
+
+				if (*pEnd == '\0')
+				{
+					path.push_back((char)value);
+					i += 2;
+					continue;
+				}
+			}
+			path.push_back(uri[i]);
+		}
+
+		return(path);
+	}
+
+	/***********************************************************
+	 *  LoadBuffers()
+	 *
+	 *  This function is used for reading the buffers of a glTF
+	 *  file, from the binary chunk of a .glb file, from data
+	 *  URIs or from files next to the glTF file.
+	 ***********************************************************/
+	bool LoadBuffers(const std::string& filename, const std::vector<unsigned char>& binaryChunk, bool bHasBinaryChunk, GLTF_FILE& file)
+	{
+		const JSON_VALUE* pBuffers = FindMember(&file.document, "buffers");
+		size_t slash = filename.find_last_of("/\\");
+		std::string directory = (slash != std::string::npos) ? filename.substr(0, slash + 1) : "";
+
+		if (NULL == pBuffers)
+		{
+			return(true);
+		}
+		if (pBuffers->type != JSON_VALUE::JSON_ARRAY)
+		{
+			return(false);
+		}
+
+		file.buffers.resize(pBuffers->items.size());
+		for (size_t i = 0; i < pBuffers->items.size(); i++)
+		{
+			const JSON_VALUE* pBuffer = &pBuffers->items[i];
+			const JSON_VALUE* pUri = FindMember(pBuffer, "uri");
+			double byteLength = GetNumber(pBuffer, "byteLength", -1.0);
+			std::vector<unsigned char>& bytes = file.buffers[i];
+
+			if (NULL == pUri)
+			{
+				// only the first buffer of a .glb file has no URI
+				if ((i != 0) || (false == bHasBinaryChunk))
+				{
+					return(false);
+				}
+				bytes = binaryChunk;
+			}
+			else if (pUri->text.compare(0, 5, "data:") == 0)
+			{
+				size_t comma = pUri->text.find(',');
+
+				if ((comma == std::string::npos) || (pUri->text.rfind(";base64", comma) == std::string::npos) ||
+					(false == DecodeBase64(pUri->text, comma + 1, bytes)))
+				{
+					std::cout << "Could not decode a data buffer of the mesh:" << filename << std::endl;
+					return(false);
+				}
+			}
+			else if (false == ReadFileBytes(directory + DecodeUri(pUri->text), bytes))
+			{
+				std::cout << "Could not open the mesh buffer:" << directory + DecodeUri(pUri->text) << std::endl;
+				return(false);
+			}
+
+			// the binary chunk may be padded past the buffer
+			if ((byteLength < 0.0) || ((double)bytes.size() < byteLength))
+			{
+				return(false);
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  OpenGltfFile()
+	 *
+	 *  This function is used for reading the JSON document of a
+	 *  .gltf or .glb file and the buffers it references.
+	 ***********************************************************/
+	bool OpenGltfFile(const char* filename, GLTF_FILE& file)
+	{
+		std::vector<unsigned char> bytes;
+		std::vector<unsigned char> binaryChunk;
+		bool bHasBinaryChunk = false;
+		const char* pJson = NULL;
+		const char* pJsonEnd = NULL;
+
+		file.pAccessors = NULL;
+		file.pBufferViews = NULL;
+		file.pMeshes = NULL;
+		file.pNodes = NULL;
+		file.skippedPrimitives = 0;
+
+		if (false == ReadFileBytes(filename, bytes))
+		{
+			std::cout << "Could not open the mesh:" << filename << std::endl;
+			return(false);
+		}
+
+		if ((bytes.size() >= GLB_HEADER_SIZE) && (ReadUint32(&bytes[0]) == GLB_MAGIC))
+		{
+			size_t offset = GLB_HEADER_SIZE;
+			size_t length = std::min((size_t)ReadUint32(&bytes[8]), bytes.size());
+
+			if (ReadUint32(&bytes[4]) != GLB_VERSION)
+			{
+				std::cout << "Only version 2 binary glTF files can be imported:" << filename << std::endl;
+				return(false);
+			}
+
+			while (offset + GLB_CHUNK_HEADER_SIZE <= length)
+			{
+				size_t chunkLength = ReadUint32(&bytes[offset]);
+				uint32_t chunkType = ReadUint32(&bytes[offset + 4]);
+				size_t chunkStart = offset + GLB_CHUNK_HEADER_SIZE;
+
+				if (chunkLength > length - chunkStart)
+				{
+					return(false);
+				}
+				if ((chunkType == GLB_CHUNK_JSON) && (NULL == pJson))
+				{
+					pJson = (const char*)&bytes[chunkStart];
+					pJsonEnd = pJson + chunkLength;
+				}
+				else if ((chunkType == GLB_CHUNK_BIN) && (false == bHasBinaryChunk))
+				{
+					binaryChunk.assign(bytes.begin() + chunkStart, bytes.begin() + chunkStart + chunkLength);
+					bHasBinaryChunk = true;
+				}
+				// chunks are padded to four bytes
+				offset = chunkStart + ((chunkLength + 3) & ~(size_t)3);
+			}
+		}
+		else if (bytes.size() > 0)
+		{
+			pJson = (const char*)&bytes[0];
+			pJsonEnd = pJson + bytes.size();
+		}
+
+		if ((NULL == pJson) || (false == ParseValue(pJson, pJsonEnd, file.document, 0)) ||
+			(file.document.type != JSON_VALUE::JSON_OBJECT))
+		{
+			std::cout << "Could not read the glTF document of the mesh:" << filename << std::endl;
+			return(false);
+		}
+
+		const JSON_VALUE* pVersion = FindMember(FindMember(&file.document, "asset"), "version");
+		if ((NULL == pVersion) || (pVersion->text.compare(0, 2, "2.") != 0))
+		{
+			std::cout << "Only glTF 2.0 meshes can be imported:" << filename << std::endl;
+			return(false);
+		}
+
+		if (false == LoadBuffers(filename, binaryChunk, bHasBinaryChunk, file))
+		{
+			std::cout << "Could not read the buffers of the mesh:" << filename << std::endl;
+			return(false);
+		}
+
+		file.pAccessors = FindMember(&file.document, "accessors");
+		file.pBufferViews = FindMember(&file.document, "bufferViews");
+		file.pMeshes = FindMember(&file.document, "meshes");
+		file.pNodes = FindMember(&file.document, "nodes");
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ReadComponent()
+	 *
+	 *  This function is used for reading one component of an
+	 *  accessor as a float, mapping the normalized integer types
+	 *  onto 0 to 1 or -1 to 1.
+	 ***********************************************************/
+	float ReadComponent(const unsigned char* pData, int componentType, bool bNormalized)
+	{
+		switch (componentType)
+		{
+		case GLTF_BYTE:
+		{
+			int8_t value = (int8_t)pData[0];
+			return(bNormalized ? std::max((float)value / 127.0f, -1.0f) : (float)value);
+		}
+		case GLTF_UNSIGNED_BYTE:
+			return(bNormalized ? ((float)pData[0] / 255.0f) : (float)pData[0]);
+		case GLTF_SHORT:
+		{
+			int16_t value = 0;
+			memcpy(&value, pData, sizeof(value));
+			return(bNormalized ? std::max((float)value / 32767.0f, -1.0f) : (float)value);
+		}
+		case GLTF_UNSIGNED_SHORT:
+		{
+			uint16_t value = 0;
+			memcpy(&value, pData, sizeof(value));
+			return(bNormalized ? ((float)value / 65535.0f) : (float)value);
+		}
+		case GLTF_UNSIGNED_INT:
+		{
+			uint32_t value = 0;
+			memcpy(&value, pData, sizeof(value));
+			return((float)value);
+		}
+		default:
+		{
+			float value = 0.0f;
+			memcpy(&value, pData, sizeof(value));
+			return(value);
+		}
+		}
+	}
+
+	/***********************************************************
+	 *  GetComponentSize()
+	 *
+	 *  This function is used for getting the bytes of one
+	 *  component of an accessor, or zero for an unknown type.
+	 ***********************************************************/
+	size_t GetComponentSize(int componentType)
+	{
+		switch (componentType)
+		{
+		case GLTF_BYTE:
+		case GLTF_UNSIGNED_BYTE:
+			return(1);
+		case GLTF_SHORT:
+		case GLTF_UNSIGNED_SHORT:
+			return(2);
+		case GLTF_UNSIGNED_INT:
+		case GLTF_FLOAT:
+			return(4);
+		default:
+			return(0);
+		}
+	}
+
+	/***********************************************************
+	 *  GetAccessorData()
+	 *
+	 *  This function is used for finding the first element of an
+	 *  accessor in its buffer and the bytes between elements,
+	 *  after checking that every element is inside the view.
+	 *  An accessor without a view reads as zeros, which pData
+	 *  being NULL stands for.
+	 ***********************************************************/
+	bool GetAccessorData(
+		const GLTF_FILE& file,
+		const JSON_VALUE* pAccessor,
+		size_t componentCount,
+		const unsigned char*& pData,
+		size_t& stride,
+		size_t& count,
+		int& componentType)
+	{
+		static const char* const typeNames[] = { "", "SCALAR", "VEC2", "VEC3", "VEC4" };
+		const JSON_VALUE* pType = FindMember(pAccessor, "type");
+		const JSON_VALUE* pView = NULL;
+		size_t componentSize = 0;
+		size_t elementSize = 0;
+		size_t typeValue = 0;
+
+		pData = NULL;
+		stride = 0;
+		count = 0;
+		componentType = 0;
+
+		if ((NULL == pAccessor) || (NULL == pType) || (pType->text != typeNames[componentCount]) ||
+			(NULL == FindMember(pAccessor, "count")) || (false == GetSize(pAccessor, "count", 0, count)) ||
+			(false == GetSize(pAccessor, "componentType", 0, typeValue)) || (NULL != FindMember(pAccessor, "sparse")))
+		{
+			return(false);
+		}
+		componentType = (int)typeValue;
+		componentSize = GetComponentSize(componentType);
+		elementSize = componentSize * componentCount;
+		if (componentSize == 0)
+		{
+			return(false);
+		}
+
+		if (NULL == FindMember(pAccessor, "bufferView"))
+		{
+			return(true);
+		}
+
+		pView = GetElement(file.pBufferViews, GetNumber(pAccessor, "bufferView", -1.0));
+		double bufferIndex = GetNumber(pView, "buffer", -1.0);
+		if ((NULL == pView) || (bufferIndex < 0.0) || (bufferIndex >= (double)file.buffers.size()) ||
+			(bufferIndex != std::floor(bufferIndex)))
+		{
+			return(false);
+		}
+
+		const std::vector<unsigned char>& buffer = file.buffers[(size_t)bufferIndex];
+		size_t viewOffset = 0;
+		size_t viewLength = 0;
+		size_t accessorOffset = 0;
+
+		if ((false == GetSize(pView, "byteOffset", 0, viewOffset)) ||
+			(false == GetSize(pView, "byteLength", 0, viewLength)) ||
+			(false == GetSize(pAccessor, "byteOffset", 0, accessorOffset)) ||
+			(false == GetSize(pView, "byteStride", 0, stride)))
+		{
+			return(false);
+		}
+		if (stride == 0)
+		{
+			stride = elementSize;
+		}
+
+		if ((viewOffset > buffer.size()) || (viewLength > buffer.size() - viewOffset) || (stride < elementSize) ||
+			((count > 0) && ((accessorOffset > viewLength) ||
+			((uint64_t)(count - 1) * stride + elementSize > (uint64_t)(viewLength - accessorOffset)))))
+		{
+			return(false);
+		}
+
+		if (count > 0)
+		{
+			pData = &buffer[viewOffset + accessorOffset];
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ReadVectorAccessor()
+	 *
+	 *  This function is used for reading an accessor of vectors
+	 *  with the passed in number of components as floats.
+	 ***********************************************************/
+	bool ReadVectorAccessor(const GLTF_FILE& file, double accessorIndex, size_t componentCount, std::vector<float>& values)
+	{
+		const JSON_VALUE* pAccessor = GetElement(file.pAccessors, accessorIndex);
+		const unsigned char* pData = NULL;
+		size_t stride = 0;
+		size_t count = 0;
+		int componentType = 0;
+		bool bNormalized = GetNumber(pAccessor, "normalized", 0.0) != 0.0;
+
+		if (false == GetAccessorData(file, pAccessor, componentCount, pData, stride, count, componentType))
+		{
+			return(false);
+		}
+
+		values.assign(count * componentCount, 0.0f);
+		if (NULL == pData)
+		{
+			return(true);
+		}
+
+		size_t componentSize = GetComponentSize(componentType);
+		for (size_t i = 0; i < count; i++)
+		{
+			for (size_t k = 0; k < componentCount; k++)
+			{
+				values[i * componentCount + k] = ReadComponent(pData + i * stride + k * componentSize, componentType, bNormalized);
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ReadIndexAccessor()
+	 *
+	 *  This function is used for reading an accessor of vertex
+	 *  indices, which are unsigned integers of any size.
+	 ***********************************************************/
+	bool ReadIndexAccessor(const GLTF_FILE& file, double accessorIndex, std::vector<uint32_t>& indices)
+	{
+		const JSON_VALUE* pAccessor = GetElement(file.pAccessors, accessorIndex);
+		const unsigned char* pData = NULL;
+		size_t stride = 0;
+		size_t count = 0;
+		int componentType = 0;
+
+		if ((false == GetAccessorData(file, pAccessor, 1, pData, stride, count, componentType)) ||
+			((componentType != GLTF_UNSIGNED_BYTE) && (componentType != GLTF_UNSIGNED_SHORT) &&
+			(componentType != GLTF_UNSIGNED_INT)))
+		{
+			return(false);
+		}
+
+		indices.assign(count, 0);
+		for (size_t i = 0; (NULL != pData) && (i < count); i++)
+		{
+			const unsigned char* pIndex = pData + i * stride;
+
+			if (componentType == GLTF_UNSIGNED_BYTE)
+			{
+				indices[i] = pIndex[0];
+			}
+			else if (componentType == GLTF_UNSIGNED_SHORT)
+			{
+				uint16_t value = 0;
+				memcpy(&value, pIndex, sizeof(value));
+				indices[i] = value;
+			}
+			else
+			{
+				memcpy(&indices[i], pIndex, sizeof(uint32_t));
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  GetNodeMatrix()
+	 *
+	 *  This function is used for getting the local transform of
+	 *  a node, from its column major matrix or from its
+	 *  translation, rotation quaternion and scale.
+	 ***********************************************************/
+	bool GetNodeMatrix(const JSON_VALUE* pNode, glm::mat4& matrix)
+	{
+		float values[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+		float translation[3] = { 0.0f, 0.0f, 0.0f };
+		float rotation[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+		float scale[3] = { 1.0f, 1.0f, 1.0f };
+
+		if (NULL != FindMember(pNode, "matrix"))
+		{
+			if (false == GetNumbers(pNode, "matrix", values, 16))
+			{
+				return(false);
+			}
+			for (int column = 0; column < 4; column++)
+			{
+				matrix[column] = glm::vec4(values[column * 4], values[column * 4 + 1], values[column * 4 + 2], values[column * 4 + 3]);
+			}
+			return(true);
+		}
+
+		if ((false == GetNumbers(pNode, "translation", translation, 3)) ||
+			(false == GetNumbers(pNode, "rotation", rotation, 4)) ||
+			(false == GetNumbers(pNode, "scale", scale, 3)))
+		{
+			return(false);
+		}
+
+		float x = rotation[0];
+		float y = rotation[1];
+		float z = rotation[2];
+		float w = rotation[3];
+
+		matrix[0] = glm::vec4(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + w * z), 2.0f * (x * z - w * y), 0.0f) * scale[0];
+		matrix[1] = glm::vec4(2.0f * (x * y - w * z), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + w * x), 0.0f) * scale[1];
+		matrix[2] = glm::vec4(2.0f * (x * z + w * y), 2.0f * (y * z - w * x), 1.0f - 2.0f * (x * x + y * y), 0.0f) * scale[2];
+		matrix[3] = glm::vec4(translation[0], translation[1], translation[2], 1.0f);
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  AppendPrimitive()
+	 *
+	 *  This function is used for adding the triangles of one
+	 *  primitive to the mesh, moved by the passed in transform.
+	 *  A primitive without normals gets the area weighted
+	 *  normals of its faces, and a transform that mirrors the
+	 *  primitive turns its triangles around so they keep facing
+	 *  out.  The texture coordinates of glTF start at the top of
+	 *  the image, and the textures are loaded bottom row first,
+	 *  so they are flipped.
+	 ***********************************************************/
+	bool AppendPrimitive(
+		const GLTF_FILE& file,
+		const JSON_VALUE* pPrimitive,
+		const glm::mat4& matrix,
+		std::vector<MeshLibrary::VERTEX>& vertices,
+		std::vector<uint32_t>& indices)
+	{
+		const JSON_VALUE* pAttributes = FindMember(pPrimitive, "attributes");
+		std::vector<float> positions;
+		std::vector<float> normals;
+		std::vector<float> uvs;
+		std::vector<uint32_t> primitiveIndices;
+		glm::mat3 normalMatrix = glm::inverseTranspose(glm::mat3(matrix));
+		bool bMirrored = glm::determinant(glm::mat3(matrix)) < 0.0f;
+		size_t baseVertex = vertices.size();
+		size_t vertexCount = 0;
+
+		if ((NULL == FindMember(pAttributes, "POSITION")) ||
+			(false == ReadVectorAccessor(file, GetNumber(pAttributes, "POSITION", -1.0), 3, positions)))
+		{
+			return(false);
+		}
+		vertexCount = positions.size() / 3;
+
+		if ((NULL != FindMember(pAttributes, "NORMAL")) &&
+			((false == ReadVectorAccessor(file, GetNumber(pAttributes, "NORMAL", -1.0), 3, normals)) ||
+			(normals.size() != vertexCount * 3)))
+		{
+			return(false);
+		}
+		if ((NULL != FindMember(pAttributes, "TEXCOORD_0")) &&
+			((false == ReadVectorAccessor(file, GetNumber(pAttributes, "TEXCOORD_0", -1.0), 2, uvs)) ||
+			(uvs.size() != vertexCount * 2)))
+		{
+			return(false);
+		}
+
+		if (NULL != FindMember(pPrimitive, "indices"))
+		{
+			if (false == ReadIndexAccessor(file, GetNumber(pPrimitive, "indices", -1.0), primitiveIndices))
+			{
+				return(false);
+			}
+		}
+		else
+		{
+			primitiveIndices.resize(vertexCount);
+			for (size_t i = 0; i < vertexCount; i++)
+			{
+				primitiveIndices[i] = (uint32_t)i;
+			}
+		}
+		if (primitiveIndices.size() % 3 != 0)
+		{
+			return(false);
+		}
+
+		vertices.reserve(baseVertex + vertexCount);
+		for (size_t i = 0; i < vertexCount; i++)
+		{
+			MeshLibrary::VERTEX vertex;
+			glm::vec4 position = matrix * glm::vec4(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2], 1.0f);
+
+			vertex.position = glm::vec3(position.x, position.y, position.z);
+			vertex.normal = glm::vec3(0.0f);
+			if (!normals.empty())
+			{
+				glm::vec3 normal = normalMatrix * glm::vec3(normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2]);
+				float length = glm::length(normal);
+				vertex.normal = (length > 0.0f) ? (normal / length) : glm::vec3(0.0f, 1.0f, 0.0f);
+			}
+			vertex.uv = uvs.empty() ? glm::vec2(0.0f) : glm::vec2(uvs[i * 2], 1.0f - uvs[i * 2 + 1]);
+			vertices.push_back(vertex);
+		}
+
+		indices.reserve(indices.size() + primitiveIndices.size());
+		for (size_t i = 0; i < primitiveIndices.size(); i += 3)
+		{
+			uint32_t a = primitiveIndices[i];
+			uint32_t b = primitiveIndices[i + 1];
+			uint32_t c = primitiveIndices[i + 2];
+
+			if ((a >= vertexCount) || (b >= vertexCount) || (c >= vertexCount))
+			{
+				return(false);
+			}
+			if (true == bMirrored)
+			{
+				std::swap(b, c);
+			}
+			indices.push_back((uint32_t)baseVertex + a);
+			indices.push_back((uint32_t)baseVertex + b);
+			indices.push_back((uint32_t)baseVertex + c);
+
+			if (normals.empty())
+			{
+				MeshLibrary::VERTEX& v0 = vertices[baseVertex + a];
+				MeshLibrary::VERTEX& v1 = vertices[baseVertex + b];
+				MeshLibrary::VERTEX& v2 = vertices[baseVertex + c];
+				glm::vec3 faceNormal = glm::cross(v1.position - v0.position, v2.position - v0.position);
+
+				v0.normal += faceNormal;
+				v1.normal += faceNormal;
+				v2.normal += faceNormal;
+			}
+		}
+
+		if (normals.empty())
+		{
+			for (size_t i = baseVertex; i < vertices.size(); i++)
+			{
+				float length = glm::length(vertices[i].normal);
+				vertices[i].normal = (length > 0.0f) ? (vertices[i].normal / length) : glm::vec3(0.0f, 1.0f, 0.0f);
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  AppendNode()
+	 *
+	 *  This function is used for adding the mesh of a node and of
+	 *  every node below it, each moved by the transforms of the
+	 *  nodes above it.
+	 ***********************************************************/
+	bool AppendNode(
+		GLTF_FILE& file,
+		double nodeIndex,
+		const glm::mat4& parentMatrix,
+		int depth,
+		std::vector<MeshLibrary::VERTEX>& vertices,
+		std::vector<uint32_t>& indices)
+	{
+		const JSON_VALUE* pNode = GetElement(file.pNodes, nodeIndex);
+		const JSON_VALUE* pChildren = FindMember(pNode, "children");
+		glm::mat4 matrix(1.0f);
+
+		if ((NULL == pNode) || (depth > MAX_NODE_DEPTH) || (false == GetNodeMatrix(pNode, matrix)))
+		{
+			return(false);
+		}
+		matrix = parentMatrix * matrix;
+
+		if (NULL != FindMember(pNode, "mesh"))
+		{
+			const JSON_VALUE* pMesh = GetElement(file.pMeshes, GetNumber(pNode, "mesh", -1.0));
+			const JSON_VALUE* pPrimitives = FindMember(pMesh, "primitives");
+
+			if ((NULL == pPrimitives) || (pPrimitives->type != JSON_VALUE::JSON_ARRAY))
+			{
+				return(false);
+			}
+			for (size_t i = 0; i < pPrimitives->items.size(); i++)
+			{
+				if (GetNumber(&pPrimitives->items[i], "mode", GLTF_TRIANGLES) != GLTF_TRIANGLES)
+				{
+					file.skippedPrimitives++;
+				}
+				else if (false == AppendPrimitive(file, &pPrimitives->items[i], matrix, vertices, indices))
+				{
+					return(false);
+				}
+			}
+		}
+
+		if (NULL != pChildren)
+		{
+			if (pChildren->type != JSON_VALUE::JSON_ARRAY)
+			{
+				return(false);
+			}
+			for (size_t i = 0; i < pChildren->items.size(); i++)
+			{
+				if (false == AppendNode(file, pChildren->items[i].number, matrix, depth + 1, vertices, indices))
+				{
+					return(false);
+				}
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  FitTextureCoordinates()
+	 *
+	 *  This function is used for moving the texture coordinates
+	 *  of a mesh into the 0 to 1 range of the packed vertices.
+	 *  Coordinates below zero are moved up by whole repeats of
+	 *  the texture, which the repeating texture wrap does not
+	 *  show, and coordinates over one are divided by the number
+	 *  of repeats they span, which is returned as the UV scale
+	 *  the mesh is drawn with.
+	 ***********************************************************/
+	glm::vec2 FitTextureCoordinates(std::vector<MeshLibrary::VERTEX>& vertices)
+	{
+		glm::vec2 minimum = vertices[0].uv;
+		glm::vec2 maximum = vertices[0].uv;
+		glm::vec2 offset(0.0f);
+		glm::vec2 repeats(1.0f);
+
+		for (size_t i = 1; i < vertices.size(); i++)
+		{
+			minimum = glm::min(minimum, vertices[i].uv);
+			maximum = glm::max(maximum, vertices[i].uv);
+		}
+
+		for (int axis = 0; axis < 2; axis++)
+		{
+			if (minimum[axis] < 0.0f)
+			{
+				offset[axis] = std::floor(minimum[axis]);
+			}
+			repeats[axis] = std::max(std::ceil(maximum[axis] - offset[axis]), 1.0f);
+		}
+
+		if ((offset == glm::vec2(0.0f)) && (repeats == glm::vec2(1.0f)))
+		{
+			return(repeats);
+		}
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			vertices[i].uv = (vertices[i].uv - offset) / repeats;
+		}
+
+		return(repeats);
+	}
+
+	/***********************************************************
+	 *  FitPositions()
+	 *
+	 *  This function is used for moving the positions of a mesh
+	 *  into the -1 to 1 range around the origin, where the half
+	 *  floats of the packed vertices keep their precision.  A
+	 *  file modeled far from the origin or in millimeters would
+	 *  otherwise lose its detail, and the vertices that round to
+	 *  the same half floats would be merged.  The uniform scale
+	 *  leaves the normals as they are, and the matrix that puts
+	 *  the mesh back in place is returned.
+	 ***********************************************************/
+	glm::mat4 FitPositions(std::vector<MeshLibrary::VERTEX>& vertices)
+	{
+		glm::vec3 minimum = vertices[0].position;
+		glm::vec3 maximum = vertices[0].position;
+
+		for (size_t i = 1; i < vertices.size(); i++)
+		{
+			minimum = glm::min(minimum, vertices[i].position);
+			maximum = glm::max(maximum, vertices[i].position);
+		}
+
+		glm::vec3 center = (minimum + maximum) * 0.5f;
+		glm::vec3 halfSize = (maximum - minimum) * 0.5f;
+		float extent = std::max(halfSize.x, std::max(halfSize.y, halfSize.z));
+
+		if (extent <= 0.0f)
+		{
+			extent = 1.0f;
+		}
+
+		for (size_t i = 0; i < vertices.size(); i++)
+		{
+			vertices[i].position = (vertices[i].position - center) / extent;
+		}
+
+		return(glm::scale(glm::translate(glm::mat4(1.0f), center), glm::vec3(extent)));
+	}
+}
+
+/***********************************************************
+ *  ReadGltf()
+ *
+ *  This method is used for reading the triangles of the nodes
+ *  of the default scene of a glTF file into one mesh.  A file
+ *  without scenes has its meshes read as they are.
+ ***********************************************************/
+bool MeshImporter::ReadGltf(
+	const char* filename,
+	std::vector<MeshLibrary::VERTEX>& vertices,
+	std::vector<uint32_t>& indices,
+	glm::vec2& uvScale,
+	glm::mat4& meshMatrix)
+{
+	GLTF_FILE file;
+	bool bRead = true;
+
+	vertices.clear();
+	indices.clear();
+	uvScale = glm::vec2(1.0f);
+	meshMatrix = glm::mat4(1.0f);
+
+	if (false == OpenGltfFile(filename, file))
+	{
+		return(false);
+	}
+
+	const JSON_VALUE* pScenes = FindMember(&file.document, "scenes");
+	if (NULL != pScenes)
+	{
+		const JSON_VALUE* pScene = GetElement(pScenes, GetNumber(&file.document, "scene", 0.0));
+		const JSON_VALUE* pRoots = FindMember(pScene, "nodes");
+
+		bRead = (NULL != pRoots) && (pRoots->type == JSON_VALUE::JSON_ARRAY);
+		for (size_t i = 0; bRead && (i < pRoots->items.size()); i++)
+		{
+			bRead = AppendNode(file, pRoots->items[i].number, glm::mat4(1.0f), 0, vertices, indices);
+		}
+	}
+	else if (NULL != file.pMeshes)
+	{
+		for (size_t mesh = 0; bRead && (mesh < file.pMeshes->items.size()); mesh++)
+		{
+			const JSON_VALUE* pPrimitives = FindMember(&file.pMeshes->items[mesh], "primitives");
+
+			bRead = (NULL != pPrimitives) && (pPrimitives->type == JSON_VALUE::JSON_ARRAY);
+			for (size_t i = 0; bRead && (i < pPrimitives->items.size()); i++)
+			{
+				if (GetNumber(&pPrimitives->items[i], "mode", GLTF_TRIANGLES) != GLTF_TRIANGLES)
+				{
+					file.skippedPrimitives++;
+				}
+				else
+				{
+					bRead = AppendPrimitive(file, &pPrimitives->items[i], glm::mat4(1.0f), vertices, indices);
+				}
+			}
+		}
+	}
+
+	if (false == bRead)
+	{
+		std::cout << "Could not read the triangles of the mesh:" << filename << std::endl;
+		return(false);
+	}
+	if (file.skippedPrimitives > 0)
+	{
+		std::cout << "Left out " << file.skippedPrimitives << " primitives that are not triangle lists in " << filename << std::endl;
+	}
+	if (indices.empty())
+	{
+		std::cout << "The mesh has no triangles:" << filename << std::endl;
+		return(false);
+	}
+
+	uvScale = FitTextureCoordinates(vertices);
+	meshMatrix = FitPositions(vertices);
+
+	return(true);
+}
+
+/***********************************************************
+ *  ImportGltf()
+ *
+ *  This method is used for reading a glTF file, optimizing
+ *  its mesh and adding it to the mesh library together with
+ *  its coarser levels of detail.  Each coarser level is built
+ *  from the full mesh with a grid sized for the screen size
+ *  it is drawn at, and a level that would not drop enough
+ *  triangles draws the level before it instead.
+ ***********************************************************/
+bool MeshImporter::ImportGltf(const char* filename, MeshLibrary& meshLibrary, IMPORTED_MESH& imported)
+{
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	std::vector<MeshLibrary::VERTEX> vertices;
+	std::vector<uint32_t> indices;
+	MeshLibrary::MeshHandle levels[MeshLibrary::MAX_LOD_LEVELS];
+	size_t levelTriangles = 0;
+	int levelCount = 1;
+
+	imported.mesh = MeshLibrary::INVALID_MESH;
+	imported.uvScale = glm::vec2(1.0f);
+	imported.meshMatrix = glm::mat4(1.0f);
+
+	if (false == ReadGltf(filename, vertices, indices, imported.uvScale, imported.meshMatrix))
+	{
+		return(false);
+	}
+
+	size_t sourceVertexCount = vertices.size();
+	float sourceMissRatio = MeshOptimizer::GetCacheMissRatio(indices, vertices.size());
+
+	MeshOptimizer::OptimizeMesh(vertices, indices);
+	levels[0] = meshLibrary.CreateMesh(vertices, indices);
+	if (levels[0] == MeshLibrary::INVALID_MESH)
+	{
+		std::cout << "Could not create the optimized mesh:" << filename << std::endl;
+		return(false);
+	}
+	levelTriangles = indices.size() / 3;
+
+	MeshLibrary::MESH_BOUNDS bounds;
+	meshLibrary.GetMeshBounds(levels[0], bounds);
+	float diagonal = glm::length(bounds.maximum - bounds.minimum);
+
+	for (int level = 1; level < MeshLibrary::MAX_LOD_LEVELS; level++)
+	{
+		std::vector<MeshLibrary::VERTEX> levelVertices;
+		std::vector<uint32_t> levelIndices;
+
+		levels[level] = levels[level - 1];
+		if ((false == MeshOptimizer::SimplifyMesh(vertices, indices, diagonal / LOD_GRID_CELLS[level - 1], levelVertices, levelIndices)) ||
+			((float)(levelIndices.size() / 3) > (float)levelTriangles * LOD_MIN_REDUCTION))
+		{
+			continue;
+		}
+
+		MeshOptimizer::OptimizeMesh(levelVertices, levelIndices);
+		MeshLibrary::MeshHandle levelMesh = meshLibrary.CreateMesh(levelVertices, levelIndices);
+		if (levelMesh != MeshLibrary::INVALID_MESH)
+		{
+			levels[level] = levelMesh;
+			levelTriangles = levelIndices.size() / 3;
+			levelCount++;
+		}
+	}
+
+	if (levelCount > 1)
+	{
+		meshLibrary.SetLodLevels(levels[0], levels, MeshLibrary::MAX_LOD_LEVELS);
+	}
+	imported.mesh = levels[0];
+
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	std::cout << "INFO: Imported " << filename << ", " << indices.size() / 3 << " triangles, "
+		<< vertices.size() << " of " << sourceVertexCount << " vertices, cache misses per triangle "
+		<< sourceMissRatio << " to " << MeshOptimizer::GetCacheMissRatio(indices, vertices.size())
+		<< ", " << levelCount << " levels of detail in " << milliseconds << " ms" << std::endl;
+
+	return(true);
+}
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshimporter.h
+// ============
+// import the triangle meshes of glTF 2.0 files into the mesh library
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshLibrary.h"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  MeshImporter
+ *
+ *  This class reads the meshes of a glTF 2.0 file, either a
+ *  .gltf document with its buffers in other files or in data
+ *  URIs, or a binary .glb file.  Every triangle primitive of
+ *  the nodes of the default scene is moved by the transforms
+ *  of its nodes and joined into one mesh, so that one file is
+ *  one part of the scene; the materials of the file are left
+ *  out, as a scene node sets its own.  The mesh is optimized
+ *  for drawing and given coarser levels of detail before it
+ *  is added to the mesh library, where it is drawn through
+ *  its handle like the generated primitives.
+ ***********************************************************/
+class MeshImporter
+{
+public:
+	// the imported mesh and how it is drawn
+	struct IMPORTED_MESH
+	{
+		MeshLibrary::MeshHandle mesh;
+		// the packed texture coordinates only hold 0 to 1, so
+		// coordinates that repeat the texture are divided by the
+		// number of repeats, which the UV scale of a draw of the
+		// mesh multiplies back in
+		glm::vec2 uvScale;
+		// the packed positions are only accurate near the origin,
+		// so the mesh is moved and scaled into -1 to 1, and this
+		// matrix puts it back in place before the node transform
+		glm::mat4 meshMatrix;
+	};
+
+	// read a glTF file and add its optimized mesh and levels of
+	// detail to the mesh library
+	static bool ImportGltf(const char* filename, MeshLibrary& meshLibrary, IMPORTED_MESH& imported);
+
+	// read the triangles of a glTF file into one mesh, with its
+	// positions and texture coordinates fit into the packed range
+	static bool ReadGltf(
+		const char* filename,
+		std::vector<MeshLibrary::VERTEX>& vertices,
+		std::vector<uint32_t>& indices,
+		glm::vec2& uvScale,
+		glm::mat4& meshMatrix);
+};
@@ -0,0 +1,948 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshlibrary.cpp
+// ===============
+// generate the basic primitive meshes and draw them with hardware instancing
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshLibrary.h"
+#include "RenderQueue.h"
+
+#include <glm/gtc/matrix_inverse.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// vertex attribute locations used in vertexShader.glsl
+	const GLuint POSITION_ATTRIBUTE = 0;
+	const GLuint NORMAL_ATTRIBUTE = 1;
+	const GLuint UV_ATTRIBUTE = 2;
+	// the instance model matrix takes four locations, one per column
+	const GLuint INSTANCE_MODEL_ATTRIBUTE = 3;
+	const GLuint INSTANCE_MATERIAL_ATTRIBUTE = 7;
+	const GLuint INSTANCE_COLOR_ATTRIBUTE = 8;
+	// the instance normal matrix takes three locations
+	const GLuint INSTANCE_NORMAL_ATTRIBUTE = 9;
+
+	// tessellation matching the ShapeMeshes primitives
+	const int CYLINDER_SLICES = 36;
+	const int TORUS_MAIN_SEGMENTS = 30;
+	const int TORUS_TUBE_SEGMENTS = 30;
+	const float TORUS_MAIN_RADIUS = 1.0f;
+
+	// tessellation of the cylinder and torus levels of detail,
+	// finest first, where the second level is the ShapeMeshes one
+	const int CYLINDER_LOD_SLICES[MeshLibrary::MAX_LOD_LEVELS] = { 72, CYLINDER_SLICES, 16, 8 };
+	const int TORUS_LOD_MAIN_SEGMENTS[MeshLibrary::MAX_LOD_LEVELS] = { 48, TORUS_MAIN_SEGMENTS, 16, 8 };
+	const int TORUS_LOD_TUBE_SEGMENTS[MeshLibrary::MAX_LOD_LEVELS] = { 32, TORUS_TUBE_SEGMENTS, 10, 6 };
+	// smallest fraction of the screen height that the bounding
+	// sphere of a mesh covers for each level to be drawn; the
+	// last level is drawn below all of them
+	const float LOD_SCREEN_SIZES[MeshLibrary::MAX_LOD_LEVELS - 1] = { 0.35f, 0.08f, 0.02f };
+	const float TORUS_TUBE_RADIUS = 0.1f;
+
+	const float PI = 3.14159265358979f;
+
+	// number of instances the attribute buffers start out with
+	const size_t INITIAL_INSTANCE_CAPACITY = 64;
+
+	// convert a float to a half float, rounding to the nearest;
+	// values too small for a normal half become zero
+	uint16_t FloatToHalf(float value)
+	{
+		uint32_t bits = 0;
+		memcpy(&bits, &value, sizeof(bits));
+
+		uint32_t sign = (bits >> 16) & 0x8000;
+		int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+		uint32_t mantissa = bits & 0x007FFFFF;
+
+		if (((bits >> 23) & 0xFF) == 0xFF)
+		{
+			// infinity stays infinity, and NaN stays NaN
+			return((uint16_t)(sign | 0x7C00 | ((mantissa != 0) ? 0x0200 : 0)));
+		}
+		if (exponent <= 0)
+		{
+			return((uint16_t)sign);
+		}
+
+		// rounding can carry into the exponent, which is right
+		uint32_t half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+		half += (mantissa >> 12) & 1;
+		if (half >= 0x7C00)
+		{
+			return((uint16_t)(sign | 0x7C00));
+		}
+
+		return((uint16_t)(sign | half));
+	}
+
+	int16_t FloatToSnorm16(float value)
+	{
+		return((int16_t)floorf(glm::clamp(value, -1.0f, 1.0f) * 32767.0f + 0.5f));
+	}
+
+	uint16_t FloatToUnorm16(float value)
+	{
+		return((uint16_t)floorf(glm::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f));
+	}
+
+	// map a unit normal onto the octahedron and unfold it into
+	// the square from -1 to 1, the inverse of the decode in
+	// vertexShader.glsl
+	glm::vec2 EncodeOctahedral(glm::vec3 normal)
+	{
+		float length = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+		glm::vec2 encoded(0.0f, 0.0f);
+
+		if (length > 0.0f)
+		{
+			encoded = glm::vec2(normal.x, normal.y) / length;
+			if (normal.z < 0.0f)
+			{
+				glm::vec2 folded(1.0f - fabsf(encoded.y), 1.0f - fabsf(encoded.x));
+				encoded.x = (encoded.x >= 0.0f) ? folded.x : -folded.x;
+				encoded.y = (encoded.y >= 0.0f) ? folded.y : -folded.y;
+			}
+		}
+
+		return(encoded);
+	}
+
+	MeshLibrary::VERTEX MakeVertex(glm::vec3 position, glm::vec3 normal, glm::vec2 uv)
+	{
+		MeshLibrary::VERTEX vertex;
+		vertex.position = position;
+		vertex.normal = normal;
+		vertex.uv = uv;
+		return(vertex);
+	}
+}
+
+/***********************************************************
+ *  MeshLibrary()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshLibrary::MeshLibrary()
+{
+	m_boxMesh = INVALID_MESH;
+	m_planeMesh = INVALID_MESH;
+	m_cylinderMesh = INVALID_MESH;
+	m_torusMesh = INVALID_MESH;
+	m_vao = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_instanceModelBuffer = 0;
+	m_instanceNormalBuffer = 0;
+	m_instanceMaterialBuffer = 0;
+	m_instanceColorBuffer = 0;
+	m_instanceCapacity = 0;
+}
+
+/***********************************************************
+ *  ~MeshLibrary()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshLibrary::~MeshLibrary()
+{
+	m_meshes.clear();
+
+	if (0 != m_vao)
+	{
+		glDeleteVertexArrays(1, &m_vao);
+		m_vao = 0;
+	}
+	if (0 != m_vertexBuffer)
+	{
+		glDeleteBuffers(1, &m_vertexBuffer);
+		m_vertexBuffer = 0;
+	}
+	if (0 != m_indexBuffer)
+	{
+		glDeleteBuffers(1, &m_indexBuffer);
+		m_indexBuffer = 0;
+	}
+
+	if (0 != m_instanceModelBuffer)
+	{
+		glDeleteBuffers(1, &m_instanceModelBuffer);
+		m_instanceModelBuffer = 0;
+	}
+	if (0 != m_instanceNormalBuffer)
+	{
+		glDeleteBuffers(1, &m_instanceNormalBuffer);
+		m_instanceNormalBuffer = 0;
+	}
+	if (0 != m_instanceMaterialBuffer)
+	{
+		glDeleteBuffers(1, &m_instanceMaterialBuffer);
+		m_instanceMaterialBuffer = 0;
+	}
+	if (0 != m_instanceColorBuffer)
+	{
+		glDeleteBuffers(1, &m_instanceColorBuffer);
+		m_instanceColorBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  BuildBoxGeometry()
+ *
+ *  This method is used for building a unit box centered on
+ *  the origin, with four vertices per face so that every
+ *  face has its own normal and texture coordinates.
+ ***********************************************************/
+void MeshLibrary::BuildBoxGeometry(std::vector<VERTEX>& vertices, std::vector<uint32_t>& indices)
+{
+	// normal and the two in-plane axes of every face, chosen so
+	// that uAxis x vAxis points along the normal
+	const glm::vec3 faces[6][3] =
+	{
+		{ glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 1.0f, 0.0f) },
+		{ glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f) },
+		{ glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) }
+	};
+
+	vertices.clear();
+	indices.clear();
+
+	for (int face = 0; face < 6; face++)
+	{
+		glm::vec3 normal = faces[face][0];
+		glm::vec3 uAxis = faces[face][1];
+		glm::vec3 vAxis = faces[face][2];
+		glm::vec3 center = normal * 0.5f;
+		uint32_t first = (uint32_t)vertices.size();
+
+		vertices.push_back(MakeVertex(center - uAxis * 0.5f - vAxis * 0.5f, normal, glm::vec2(0.0f, 0.0f)));
+		vertices.push_back(MakeVertex(center + uAxis * 0.5f - vAxis * 0.5f, normal, glm::vec2(1.0f, 0.0f)));
+		vertices.push_back(MakeVertex(center + uAxis * 0.5f + vAxis * 0.5f, normal, glm::vec2(1.0f, 1.0f)));
+		vertices.push_back(MakeVertex(center - uAxis * 0.5f + vAxis * 0.5f, normal, glm::vec2(0.0f, 1.0f)));
+
+		indices.push_back(first);
+		indices.push_back(first + 1);
+		indices.push_back(first + 2);
+		indices.push_back(first);
+		indices.push_back(first + 2);
+		indices.push_back(first + 3);
+	}
+}
+
+/***********************************************************
+ *  BuildPlaneGeometry()
+ *
+ *  This method is used for building a plane that spans from
+ *  -1 to 1 along X and Z and faces up the Y axis.
+ ***********************************************************/
+void MeshLibrary::BuildPlaneGeometry(std::vector<VERTEX>& vertices, std::vector<uint32_t>& indices)
+{
+	glm::vec3 normal(0.0f, 1.0f, 0.0f);
+
+	vertices.clear();
+	indices.clear();
+
+	vertices.push_back(MakeVertex(glm::vec3(-1.0f, 0.0f, 1.0f), normal, glm::vec2(0.0f, 0.0f)));
+	vertices.push_back(MakeVertex(glm::vec3(1.0f, 0.0f, 1.0f), normal, glm::vec2(1.0f, 0.0f)));
+	vertices.push_back(MakeVertex(glm::vec3(1.0f, 0.0f, -1.0f), normal, glm::vec2(1.0f, 1.0f)));
+	vertices.push_back(MakeVertex(glm::vec3(-1.0f, 0.0f, -1.0f), normal, glm::vec2(0.0f, 1.0f)));
+
+	indices.push_back(0);
+	indices.push_back(1);
+	indices.push_back(2);
+	indices.push_back(0);
+	indices.push_back(2);
+	indices.push_back(3);
+}
+
+/***********************************************************
+ *  BuildCylinderGeometry()
+ *
+ *  This method is used for building a capped cylinder with a
+ *  radius of one, standing on the origin and one unit tall,
+ *  divided into the passed in number of slices.
+ ***********************************************************/
+void MeshLibrary::BuildCylinderGeometry(int slices, std::vector<VERTEX>& vertices, std::vector<uint32_t>& indices)
+{
+	vertices.clear();
+	indices.clear();
+
+	// sides - the seam repeats the first column for the UVs
+	for (int i = 0; i <= slices; i++)
+	{
+		float angle = 2.0f * PI * (float)i / (float)slices;
+		float u = (float)i / (float)slices;
+		glm::vec3 normal(cosf(angle), 0.0f, sinf(angle));
+
+		vertices.push_back(MakeVertex(glm::vec3(normal.x, 0.0f, normal.z), normal, glm::vec2(u, 0.0f)));
+		vertices.push_back(MakeVertex(glm::vec3(normal.x, 1.0f, normal.z), normal, glm::vec2(u, 1.0f)));
+	}
+	for (int i = 0; i < slices; i++)
+	{
+		uint32_t bottom0 = i * 2;
+		uint32_t top0 = bottom0 + 1;
+		uint32_t bottom1 = bottom0 + 2;
+		uint32_t top1 = bottom0 + 3;
+
+		indices.push_back(bottom0);
+		indices.push_back(top0);
+		indices.push_back(bottom1);
+		indices.push_back(bottom1);
+		indices.push_back(top0);
+		indices.push_back(top1);
+	}
+
+	// top and bottom caps
+	for (int cap = 0; cap < 2; cap++)
+	{
+		bool bTop = (cap == 0);
+		float y = bTop ? 1.0f : 0.0f;
+		glm::vec3 normal(0.0f, bTop ? 1.0f : -1.0f, 0.0f);
+		uint32_t center = (uint32_t)vertices.size();
+
+		vertices.push_back(MakeVertex(glm::vec3(0.0f, y, 0.0f), normal, glm::vec2(0.5f, 0.5f)));
+		for (int i = 0; i <= slices; i++)
+		{
+			float angle = 2.0f * PI * (float)i / (float)slices;
+			float x = cosf(angle);
+			float z = sinf(angle);
+			vertices.push_back(MakeVertex(glm::vec3(x, y, z), normal, glm::vec2(0.5f + 0.5f * x, 0.5f + 0.5f * z)));
+		}
+		for (int i = 0; i < slices; i++)
+		{
+			uint32_t ring0 = center + 1 + i;
+			uint32_t ring1 = ring0 + 1;
+
+			indices.push_back(center);
+			indices.push_back(bTop ? ring1 : ring0);
+			indices.push_back(bTop ? ring0 : ring1);
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildTorusGeometry()
+ *
+ *  This method is used for building a torus that lies in the
+ *  XY plane around the Z axis, divided into the passed in
+ *  number of main and tube segments.
+ ***********************************************************/
+void MeshLibrary::BuildTorusGeometry(int mainSegments, int tubeSegments, std::vector<VERTEX>& vertices, std::vector<uint32_t>& indices)
+{
+	vertices.clear();
+	indices.clear();
+
+	for (int i = 0; i <= mainSegments; i++)
+	{
+		float mainAngle = 2.0f * PI * (float)i / (float)mainSegments;
+		glm::vec3 tubeCenter(cosf(mainAngle) * TORUS_MAIN_RADIUS, sinf(mainAngle) * TORUS_MAIN_RADIUS, 0.0f);
+
+		for (int j = 0; j <= tubeSegments; j++)
+		{
+			float tubeAngle = 2.0f * PI * (float)j / (float)tubeSegments;
+			glm::vec3 normal(
+				cosf(tubeAngle) * cosf(mainAngle),
+				cosf(tubeAngle) * sinf(mainAngle),
+				sinf(tubeAngle));
+
+			vertices.push_back(MakeVertex(
+				tubeCenter + normal * TORUS_TUBE_RADIUS,
+				normal,
+				glm::vec2((float)i / (float)mainSegments, (float)j / (float)tubeSegments)));
+		}
+	}
+
+	for (int i = 0; i < mainSegments; i++)
+	{
+		for (int j = 0; j < tubeSegments; j++)
+		{
+			uint32_t a = i * (tubeSegments + 1) + j;
+			uint32_t b = (i + 1) * (tubeSegments + 1) + j;
+
+			indices.push_back(a);
+			indices.push_back(b);
+			indices.push_back(a + 1);
+			indices.push_back(b);
+			indices.push_back(b + 1);
+			indices.push_back(a + 1);
+		}
+	}
+}
+
+/***********************************************************
+ *  CreateBuffers()
+ *
+ *  This method is used for creating the shared vertex array
+ *  with its vertex and index buffers, and the per-instance
+ *  model matrix, normal matrix, material index and color
+ *  buffers.
+ ***********************************************************/
+void MeshLibrary::CreateBuffers()
+{
+	glGenVertexArrays(1, &m_vao);
+	glBindVertexArray(m_vao);
+
+	glGenBuffers(1, &m_vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glEnableVertexAttribArray(POSITION_ATTRIBUTE);
+	glVertexAttribPointer(POSITION_ATTRIBUTE, 3, GL_HALF_FLOAT, GL_FALSE, sizeof(PACKED_VERTEX), (void*)offsetof(PACKED_VERTEX, position));
+	glEnableVertexAttribArray(NORMAL_ATTRIBUTE);
+	glVertexAttribPointer(NORMAL_ATTRIBUTE, 2, GL_SHORT, GL_TRUE, sizeof(PACKED_VERTEX), (void*)offsetof(PACKED_VERTEX, normal));
+	glEnableVertexAttribArray(UV_ATTRIBUTE);
+	glVertexAttribPointer(UV_ATTRIBUTE, 2, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PACKED_VERTEX), (void*)offsetof(PACKED_VERTEX, uv));
+
+	// the index buffer binding is recorded in the vertex array
+	glGenBuffers(1, &m_indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+
+	m_instanceCapacity = INITIAL_INSTANCE_CAPACITY;
+
+	glGenBuffers(1, &m_instanceModelBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceModelBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+
+	glGenBuffers(1, &m_instanceNormalBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceNormalBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(glm::mat3), NULL, GL_STREAM_DRAW);
+
+	glGenBuffers(1, &m_instanceMaterialBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceMaterialBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(uint32_t), NULL, GL_STREAM_DRAW);
+
+	glGenBuffers(1, &m_instanceColorBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceColorBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(glm::vec4), NULL, GL_STREAM_DRAW);
+
+	SetupInstanceAttributes();
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  SetupInstanceAttributes()
+ *
+ *  This method is used for attaching the per-instance model
+ *  and normal matrices, material index and color to the bound
+ *  vertex array.
+ ***********************************************************/
+void MeshLibrary::SetupInstanceAttributes()
+{
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceModelBuffer);
+	for (GLuint column = 0; column < 4; column++)
+	{
+		glEnableVertexAttribArray(INSTANCE_MODEL_ATTRIBUTE + column);
+		glVertexAttribPointer(
+			INSTANCE_MODEL_ATTRIBUTE + column,
+			4,
+			GL_FLOAT,
+			GL_FALSE,
+			sizeof(glm::mat4),
+			(void*)(sizeof(glm::vec4) * column));
+		glVertexAttribDivisor(INSTANCE_MODEL_ATTRIBUTE + column, 1);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceNormalBuffer);
+	for (GLuint column = 0; column < 3; column++)
+	{
+		glEnableVertexAttribArray(INSTANCE_NORMAL_ATTRIBUTE + column);
+		glVertexAttribPointer(
+			INSTANCE_NORMAL_ATTRIBUTE + column,
+			3,
+			GL_FLOAT,
+			GL_FALSE,
+			sizeof(glm::mat3),
+			(void*)(sizeof(glm::vec3) * column));
+		glVertexAttribDivisor(INSTANCE_NORMAL_ATTRIBUTE + column, 1);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceMaterialBuffer);
+	glEnableVertexAttribArray(INSTANCE_MATERIAL_ATTRIBUTE);
+	glVertexAttribIPointer(INSTANCE_MATERIAL_ATTRIBUTE, 1, GL_UNSIGNED_INT, sizeof(uint32_t), (void*)0);
+	glVertexAttribDivisor(INSTANCE_MATERIAL_ATTRIBUTE, 1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceColorBuffer);
+	glEnableVertexAttribArray(INSTANCE_COLOR_ATTRIBUTE);
+	glVertexAttribPointer(INSTANCE_COLOR_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+	glVertexAttribDivisor(INSTANCE_COLOR_ATTRIBUTE, 1);
+}
+
+/***********************************************************
+ *  PackVertex()
+ *
+ *  This method is used for quantizing a vertex into the layout
+ *  of the shared vertex buffer.  The unit primitives keep
+ *  their positions within a few units of the origin, where a
+ *  half float is accurate to about a thousandth, and their
+ *  texture coordinates from 0 to 1, which the UV scale of a
+ *  draw repeats in the shaders.  Imported meshes are fit into
+ *  the same ranges by the importer before they get here.
+ ***********************************************************/
+MeshLibrary::PACKED_VERTEX MeshLibrary::PackVertex(const VERTEX& vertex)
+{
+	PACKED_VERTEX packed;
+	glm::vec2 normal = EncodeOctahedral(vertex.normal);
+
+	packed.position[0] = FloatToHalf(vertex.position.x);
+	packed.position[1] = FloatToHalf(vertex.position.y);
+	packed.position[2] = FloatToHalf(vertex.position.z);
+	packed.position[3] = FloatToHalf(1.0f);
+	packed.normal[0] = FloatToSnorm16(normal.x);
+	packed.normal[1] = FloatToSnorm16(normal.y);
+	packed.uv[0] = FloatToUnorm16(vertex.uv.x);
+	packed.uv[1] = FloatToUnorm16(vertex.uv.y);
+
+	return(packed);
+}
+
+/***********************************************************
+ *  CreateMesh()
+ *
+ *  This method is used for appending the passed in geometry
+ *  to the shared vertex and index buffers and returning the
+ *  handle of the new mesh.  Meshes are created at load time,
+ *  so the buffers are simply uploaded again as they grow.
+ ***********************************************************/
+MeshLibrary::MeshHandle MeshLibrary::CreateMesh(
+	const std::vector<VERTEX>& vertices,
+	const std::vector<uint32_t>& indices)
+{
+	MESH_RANGE mesh;
+	MESH_BOUNDS bounds;
+
+	if ((vertices.size() == 0) || (indices.size() == 0))
+	{
+		return(INVALID_MESH);
+	}
+
+	// a handle past the mesh field of the sort keys would be
+	// batched and instanced together with another mesh
+	if (m_meshes.size() >= (size_t)RenderQueue::MAX_MESH_COUNT)
+	{
+		std::cout << "Could not create a mesh past the " << RenderQueue::MAX_MESH_COUNT << " meshes of the render queue" << std::endl;
+		return(INVALID_MESH);
+	}
+
+	if (0 == m_vao)
+	{
+		CreateBuffers();
+	}
+
+	mesh.firstIndex = (uint32_t)m_indices.size();
+	mesh.indexCount = (uint32_t)indices.size();
+	mesh.baseVertex = (int32_t)m_vertices.size();
+
+	m_vertices.reserve(m_vertices.size() + vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		m_vertices.push_back(PackVertex(vertices[i]));
+	}
+	m_indices.insert(m_indices.end(), indices.begin(), indices.end());
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(PACKED_VERTEX), &m_vertices[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glBindVertexArray(m_vao);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(uint32_t), &m_indices[0], GL_STATIC_DRAW);
+	glBindVertexArray(0);
+
+	// the bounds are used for culling the instances of the mesh
+	bounds.minimum = vertices[0].position;
+	bounds.maximum = vertices[0].position;
+	for (size_t i = 1; i < vertices.size(); i++)
+	{
+		bounds.minimum = glm::min(bounds.minimum, vertices[i].position);
+		bounds.maximum = glm::max(bounds.maximum, vertices[i].position);
+	}
+
+	// a new mesh is its own single level of detail
+	LOD_CHAIN lodChain;
+	lodChain.levelCount = 1;
+	lodChain.levels[0] = (MeshHandle)m_meshes.size();
+
+	m_meshes.push_back(mesh);
+	m_bounds.push_back(bounds);
+	m_lodChains.push_back(lodChain);
+
+	return((MeshHandle)m_meshes.size() - 1);
+}
+
+/***********************************************************
+ *  LoadBoxMesh()
+ *
+ *  This method is used for generating the box mesh.
+ ***********************************************************/
+MeshLibrary::MeshHandle MeshLibrary::LoadBoxMesh()
+{
+	std::vector<VERTEX> vertices;
+	std::vector<uint32_t> indices;
+
+	BuildBoxGeometry(vertices, indices);
+	m_boxMesh = CreateMesh(vertices, indices);
+
+	return(m_boxMesh);
+}
+
+/***********************************************************
+ *  LoadPlaneMesh()
+ *
+ *  This method is used for generating the plane mesh.
+ ***********************************************************/
+MeshLibrary::MeshHandle MeshLibrary::LoadPlaneMesh()
+{
+	std::vector<VERTEX> vertices;
+	std::vector<uint32_t> indices;
+
+	BuildPlaneGeometry(vertices, indices);
+	m_planeMesh = CreateMesh(vertices, indices);
+
+	return(m_planeMesh);
+}
+
+/***********************************************************
+ *  LoadCylinderMesh()
+ *
+ *  This method is used for generating the cylinder mesh and
+ *  its levels of detail.  The returned handle is the level
+ *  with the ShapeMeshes tessellation.
+ ***********************************************************/
+MeshLibrary::MeshHandle MeshLibrary::LoadCylinderMesh()
+{
+	std::vector<VERTEX> vertices;
+	std::vector<uint32_t> indices;
+
+	MeshHandle levels[MAX_LOD_LEVELS];
+
+	for (int level = 0; level < MAX_LOD_LEVELS; level++)
+	{
+		BuildCylinderGeometry(CYLINDER_LOD_SLICES[level], vertices, indices);
+		levels[level] = CreateMesh(vertices, indices);
+	}
+
+	// the level matching ShapeMeshes stands for the whole chain
+	m_cylinderMesh = levels[1];
+	SetLodLevels(m_cylinderMesh, levels, MAX_LOD_LEVELS);
+
+	return(m_cylinderMesh);
+}
+
+/***********************************************************
+ *  LoadTorusMesh()
+ *
+ *  This method is used for generating the torus mesh and its
+ *  levels of detail.  The returned handle is the level with
+ *  the ShapeMeshes tessellation.
+ ***********************************************************/
+MeshLibrary::MeshHandle MeshLibrary::LoadTorusMesh()
+{
+	std::vector<VERTEX> vertices;
+	std::vector<uint32_t> indices;
+
+	MeshHandle levels[MAX_LOD_LEVELS];
+
+	for (int level = 0; level < MAX_LOD_LEVELS; level++)
+	{
+		BuildTorusGeometry(TORUS_LOD_MAIN_SEGMENTS[level], TORUS_LOD_TUBE_SEGMENTS[level], vertices, indices);
+		levels[level] = CreateMesh(vertices, indices);
+	}
+
+	// the level matching ShapeMeshes stands for the whole chain
+	m_torusMesh = levels[1];
+	SetLodLevels(m_torusMesh, levels, MAX_LOD_LEVELS);
+
+	return(m_torusMesh);
+}
+
+/***********************************************************
+ *  SetLodLevels()
+ *
+ *  This method is used for setting the passed in meshes as the
+ *  levels of detail of a mesh, ordered from the finest.  The
+ *  mesh itself is expected to be one of the levels.
+ ***********************************************************/
+void MeshLibrary::SetLodLevels(MeshHandle mesh, const MeshHandle* levels, int levelCount)
+{
+	LOD_CHAIN lodChain;
+
+	if ((false == IsValidMesh(mesh)) || (levelCount <= 0) || (levelCount > MAX_LOD_LEVELS))
+	{
+		return;
+	}
+
+	lodChain.levelCount = levelCount;
+	for (int level = 0; level < levelCount; level++)
+	{
+		if (false == IsValidMesh(levels[level]))
+		{
+			return;
+		}
+		lodChain.levels[level] = levels[level];
+	}
+
+	m_lodChains[mesh] = lodChain;
+}
+
+/***********************************************************
+ *  GetLodCount()
+ *
+ *  This method is used for getting the number of levels of
+ *  detail of the passed in mesh.
+ ***********************************************************/
+int MeshLibrary::GetLodCount(MeshHandle mesh) const
+{
+	if (false == IsValidMesh(mesh))
+	{
+		return(0);
+	}
+
+	return(m_lodChains[mesh].levelCount);
+}
+
+/***********************************************************
+ *  GetLodMesh()
+ *
+ *  This method is used for getting the mesh of the passed in
+ *  level of detail, clamped to the levels that exist.
+ ***********************************************************/
+MeshLibrary::MeshHandle MeshLibrary::GetLodMesh(MeshHandle mesh, int level) const
+{
+	if (false == IsValidMesh(mesh))
+	{
+		return(INVALID_MESH);
+	}
+
+	const LOD_CHAIN& lodChain = m_lodChains[mesh];
+	level = std::max(0, std::min(level, lodChain.levelCount - 1));
+
+	return(lodChain.levels[level]);
+}
+
+/***********************************************************
+ *  SelectLodLevel()
+ *
+ *  This method is used for picking the level of detail of a
+ *  mesh from the fraction of the screen height covered by its
+ *  bounding sphere.  Large meshes get the finest level, and
+ *  every smaller size step drops one level, down to the last
+ *  level the mesh has.
+ ***********************************************************/
+int MeshLibrary::SelectLodLevel(MeshHandle mesh, float screenSize) const
+{
+	int levelCount = GetLodCount(mesh);
+	int level = 0;
+
+	while ((level < levelCount - 1) && (screenSize < LOD_SCREEN_SIZES[level]))
+	{
+		level++;
+	}
+
+	return(level);
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing one copy of the passed in
+ *  mesh from the shared buffers, with the model matrix,
+ *  material and color taken from the shader uniforms.
+ ***********************************************************/
+void MeshLibrary::DrawMesh(MeshHandle mesh)
+{
+	if (false == IsValidMesh(mesh))
+	{
+		return;
+	}
+
+	glBindVertexArray(m_vao);
+	glDrawElementsBaseVertex(
+		GL_TRIANGLES,
+		(GLsizei)m_meshes[mesh].indexCount,
+		GL_UNSIGNED_INT,
+		(void*)(m_meshes[mesh].firstIndex * sizeof(uint32_t)),
+		m_meshes[mesh].baseVertex);
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  DrawMeshInstanced()
+ *
+ *  This method is used for uploading the passed in model and
+ *  normal matrices, material indices and colors into the
+ *  per-instance buffers and drawing count instances of the
+ *  mesh with a single draw call.  Without colors every
+ *  instance is white, and without normal matrices they are
+ *  built from the model matrices here.
+ ***********************************************************/
+void MeshLibrary::DrawMeshInstanced(
+	MeshHandle mesh,
+	const glm::mat4* models,
+	const glm::mat3* normalMatrices,
+	const uint32_t* materialIds,
+	size_t count,
+	const glm::vec4* colors)
+{
+	if ((mesh < 0) || (mesh >= (MeshHandle)m_meshes.size()) || (count == 0))
+	{
+		return;
+	}
+
+	// grow the instance buffers when needed, otherwise orphan
+	// them so the driver does not wait on the previous draw
+	while (m_instanceCapacity < count)
+	{
+		m_instanceCapacity *= 2;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceModelBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::mat4), models);
+
+	if (NULL == normalMatrices)
+	{
+		m_normalMatrices.resize(count);
+		for (size_t i = 0; i < count; i++)
+		{
+			m_normalMatrices[i] = glm::inverseTranspose(glm::mat3(models[i]));
+		}
+		normalMatrices = &m_normalMatrices[0];
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceNormalBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(glm::mat3), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::mat3), normalMatrices);
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceMaterialBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(uint32_t), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(uint32_t), materialIds);
+
+	if (NULL != colors)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, m_instanceColorBuffer);
+		glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(glm::vec4), NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::vec4), colors);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glBindVertexArray(m_vao);
+	// without colors the attribute falls back to its constant value
+	if (NULL != colors)
+	{
+		glEnableVertexAttribArray(INSTANCE_COLOR_ATTRIBUTE);
+	}
+	else
+	{
+		glDisableVertexAttribArray(INSTANCE_COLOR_ATTRIBUTE);
+		glVertexAttrib4f(INSTANCE_COLOR_ATTRIBUTE, 1.0f, 1.0f, 1.0f, 1.0f);
+	}
+	glDrawElementsInstancedBaseVertex(
+		GL_TRIANGLES,
+		(GLsizei)m_meshes[mesh].indexCount,
+		GL_UNSIGNED_INT,
+		(void*)(m_meshes[mesh].firstIndex * sizeof(uint32_t)),
+		(GLsizei)count,
+		m_meshes[mesh].baseVertex);
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  DrawBoxMeshInstanced()
+ *
+ *  This method is used for drawing instances of the box.
+ ***********************************************************/
+void MeshLibrary::DrawBoxMeshInstanced(const glm::mat4* models, const uint32_t* materialIds, size_t count)
+{
+	DrawMeshInstanced(m_boxMesh, models, NULL, materialIds, count);
+}
+
+/***********************************************************
+ *  DrawPlaneMeshInstanced()
+ *
+ *  This method is used for drawing instances of the plane.
+ ***********************************************************/
+void MeshLibrary::DrawPlaneMeshInstanced(const glm::mat4* models, const uint32_t* materialIds, size_t count)
+{
+	DrawMeshInstanced(m_planeMesh, models, NULL, materialIds, count);
+}
+
+/***********************************************************
+ *  DrawCylinderMeshInstanced()
+ *
+ *  This method is used for drawing instances of the cylinder.
+ ***********************************************************/
+void MeshLibrary::DrawCylinderMeshInstanced(const glm::mat4* models, const uint32_t* materialIds, size_t count)
+{
+	DrawMeshInstanced(m_cylinderMesh, models, NULL, materialIds, count);
+}
+
+/***********************************************************
+ *  DrawTorusMeshInstanced()
+ *
+ *  This method is used for drawing instances of the torus.
+ ***********************************************************/
+void MeshLibrary::DrawTorusMeshInstanced(const glm::mat4* models, const uint32_t* materialIds, size_t count)
+{
+	DrawMeshInstanced(m_torusMesh, models, NULL, materialIds, count);
+}
+
+/***********************************************************
+ *  GetTriangleCount()
+ *
+ *  This method is used for getting the number of triangles
+ *  that one instance of the passed in mesh draws.
+ ***********************************************************/
+unsigned int MeshLibrary::GetTriangleCount(MeshHandle mesh) const
+{
+	if ((mesh < 0) || (mesh >= (MeshHandle)m_meshes.size()))
+	{
+		return(0);
+	}
+
+	return(m_meshes[mesh].indexCount / 3);
+}
+
+/***********************************************************
+ *  GetMeshRange()
+ *
+ *  This method is used for getting the location of the passed
+ *  in mesh in the shared index and vertex buffers.
+ ***********************************************************/
+bool MeshLibrary::GetMeshRange(MeshHandle mesh, MESH_RANGE& range) const
+{
+	if ((mesh < 0) || (mesh >= (MeshHandle)m_meshes.size()))
+	{
+		return(false);
+	}
+
+	range = m_meshes[mesh];
+	return(true);
+}
+
+/***********************************************************
+ *  GetMeshBounds()
+ *
+ *  This method is used for getting the local axis aligned
+ *  bounding box of the passed in mesh.
+ ***********************************************************/
+bool MeshLibrary::GetMeshBounds(MeshHandle mesh, MESH_BOUNDS& bounds) const
+{
+	if ((mesh < 0) || (mesh >= (MeshHandle)m_bounds.size()))
+	{
+		return(false);
+	}
+
+	bounds = m_bounds[mesh];
+	return(true);
+}
@@ -0,0 +1,189 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshlibrary.h
+// ============
+// generate the basic primitive meshes and draw them with hardware instancing
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/***********************************************************
+ *  MeshLibrary
+ *
+ *  This class generates the same unit primitives as the
+ *  ShapeMeshes utility (box, plane, cylinder and torus) and
+ *  packs all of them into one shared vertex and index buffer
+ *  behind a single vertex array.  The vertices are quantized
+ *  when they are added: half float positions, octahedral
+ *  normals in two snorm16 values and unorm16 texture
+ *  coordinates, which is 16 bytes instead of 32.  A primitive can be drawn
+ *  many times with a single instanced draw, where each
+ *  instance reads its model and normal matrices, material
+ *  index and color from per-instance vertex attributes, and the ranges of the
+ *  meshes can be used for multi-draw indirect commands.  The
+ *  cylinder and torus are also generated at several levels of
+ *  detail, and a level is picked by how large the drawn mesh
+ *  appears on the screen.
+ ***********************************************************/
+class MeshLibrary
+{
+public:
+	// compact id of a loaded mesh
+	typedef int MeshHandle;
+	static const int INVALID_MESH = -1;
+	// most levels of detail that a mesh can be generated at
+	static const int MAX_LOD_LEVELS = 4;
+
+	// vertex that the meshes are built from on the CPU
+	struct VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 uv;
+	};
+
+	// quantized vertex layout in the shared vertex buffer,
+	// matching the attribute locations in vertexShader.glsl
+	struct PACKED_VERTEX
+	{
+		// half floats, the fourth is padding
+		uint16_t position[4];
+		// octahedral encoded unit normal
+		int16_t normal[2];
+		// texture coordinates from 0 to 1
+		uint16_t uv[2];
+	};
+
+	// location of a mesh in the shared index and vertex buffers
+	struct MESH_RANGE
+	{
+		uint32_t firstIndex;
+		uint32_t indexCount;
+		int32_t baseVertex;
+	};
+
+	// local axis aligned bounding box of a mesh
+	struct MESH_BOUNDS
+	{
+		glm::vec3 minimum;
+		glm::vec3 maximum;
+	};
+
+	// constructor
+	MeshLibrary();
+	// destructor
+	~MeshLibrary();
+
+	// generate the primitive meshes and return their handles
+	MeshHandle LoadBoxMesh();
+	MeshHandle LoadPlaneMesh();
+	MeshHandle LoadCylinderMesh();
+	MeshHandle LoadTorusMesh();
+
+	// upload the passed in geometry as a new mesh, quantizing
+	// its vertices into the shared vertex buffer
+	MeshHandle CreateMesh(
+		const std::vector<VERTEX>& vertices,
+		const std::vector<uint32_t>& indices);
+
+	// add finer and coarser meshes of the same shape as the
+	// levels of detail of a mesh, ordered from the finest
+	void SetLodLevels(MeshHandle mesh, const MeshHandle* levels, int levelCount);
+	int GetLodCount(MeshHandle mesh) const;
+	// mesh of the passed in level, or the mesh itself when it has
+	// no levels of detail
+	MeshHandle GetLodMesh(MeshHandle mesh, int level) const;
+	// level of detail for a mesh whose bounding sphere covers the
+	// passed in fraction of the screen height
+	int SelectLodLevel(MeshHandle mesh, float screenSize) const;
+
+	// draw one copy of a mesh with the model matrix, material
+	// and color set into the shader uniforms
+	void DrawMesh(MeshHandle mesh);
+
+	// draw count instances of a mesh, each with its own model
+	// matrix, material index and optionally its own color; the
+	// normal matrices are built from the models when not passed
+	void DrawMeshInstanced(
+		MeshHandle mesh,
+		const glm::mat4* models,
+		const glm::mat3* normalMatrices,
+		const uint32_t* materialIds,
+		size_t count,
+		const glm::vec4* colors = NULL);
+
+	// draw count instances of the loaded primitives
+	void DrawBoxMeshInstanced(const glm::mat4* models, const uint32_t* materialIds, size_t count);
+	void DrawPlaneMeshInstanced(const glm::mat4* models, const uint32_t* materialIds, size_t count);
+	void DrawCylinderMeshInstanced(const glm::mat4* models, const uint32_t* materialIds, size_t count);
+	void DrawTorusMeshInstanced(const glm::mat4* models, const uint32_t* materialIds, size_t count);
+
+	// number of triangles in a mesh
+	unsigned int GetTriangleCount(MeshHandle mesh) const;
+	// location of a mesh in the shared buffers
+	bool GetMeshRange(MeshHandle mesh, MESH_RANGE& range) const;
+	// local bounding box of a mesh
+	bool GetMeshBounds(MeshHandle mesh, MESH_BOUNDS& bounds) const;
+	// vertex array that all the meshes are drawn from
+	GLuint GetVertexArray() const { return(m_vao); }
+	// bytes of vertex data in the shared vertex buffer
+	size_t GetVertexBytes() const { return(m_vertices.size() * sizeof(PACKED_VERTEX)); }
+
+	// quantize one vertex into the layout of the vertex buffer
+	static PACKED_VERTEX PackVertex(const VERTEX& vertex);
+
+	// build the geometry of the primitives on the CPU
+	static void BuildBoxGeometry(std::vector<VERTEX>& vertices, std::vector<uint32_t>& indices);
+	static void BuildPlaneGeometry(std::vector<VERTEX>& vertices, std::vector<uint32_t>& indices);
+	static void BuildCylinderGeometry(int slices, std::vector<VERTEX>& vertices, std::vector<uint32_t>& indices);
+	static void BuildTorusGeometry(int mainSegments, int tubeSegments, std::vector<VERTEX>& vertices, std::vector<uint32_t>& indices);
+
+private:
+	// the loaded meshes, indexed by mesh handle
+	std::vector<MESH_RANGE> m_meshes;
+	// local bounding boxes, indexed by mesh handle
+	std::vector<MESH_BOUNDS> m_bounds;
+	// levels of detail of a mesh, finest first
+	struct LOD_CHAIN
+	{
+		int levelCount;
+		MeshHandle levels[MAX_LOD_LEVELS];
+	};
+	// level of detail chains, indexed by mesh handle
+	std::vector<LOD_CHAIN> m_lodChains;
+	// geometry of all the meshes, kept for growing the buffers
+	std::vector<PACKED_VERTEX> m_vertices;
+	std::vector<uint32_t> m_indices;
+	// shared vertex array, vertex buffer and index buffer
+	GLuint m_vao;
+	GLuint m_vertexBuffer;
+	GLuint m_indexBuffer;
+	// handles of the loaded primitives
+	MeshHandle m_boxMesh;
+	MeshHandle m_planeMesh;
+	MeshHandle m_cylinderMesh;
+	MeshHandle m_torusMesh;
+	// per-instance attribute buffers shared by all the meshes
+	GLuint m_instanceModelBuffer;
+	GLuint m_instanceNormalBuffer;
+	GLuint m_instanceMaterialBuffer;
+	GLuint m_instanceColorBuffer;
+	size_t m_instanceCapacity;
+	// normal matrices built for the draws that did not pass any
+	std::vector<glm::mat3> m_normalMatrices;
+
+	// create the shared vertex array and attribute buffers
+	void CreateBuffers();
+	// attach the per-instance attributes to the bound vertex array
+	void SetupInstanceAttributes();
+	// check that a handle names a loaded mesh
+	bool IsValidMesh(MeshHandle mesh) const { return((mesh >= 0) && (mesh < (MeshHandle)m_meshes.size())); }
+};
@@ -0,0 +1,693 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshoptimizer.cpp
+// ============
+// reorder and simplify imported meshes for the vertex cache and overdraw
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+// declaration of global variables
+namespace
+{
+	const uint32_t INVALID_INDEX = 0xFFFFFFFF;
+
+	// entries of the LRU cache that the triangle order is
+	// scored for, and the weights of the score as given by
+	// Forsyth for his linear speed cache optimization
+	const int VERTEX_CACHE_SIZE = 32;
+	const float CACHE_DECAY_POWER = 1.5f;
+	const float LAST_TRIANGLE_SCORE = 0.75f;
+	const float VALENCE_BOOST_SCALE = 2.0f;
+	const float VALENCE_BOOST_POWER = 0.5f;
+
+	// rise in the cache misses allowed for sorting the clusters
+	const float OVERDRAW_THRESHOLD = 1.05f;
+	// fewest triangles in a cluster that is split where the
+	// split costs a cache miss
+	const size_t MIN_CLUSTER_TRIANGLES = 32;
+
+	// bits of each grid coordinate in the key of a cell
+	const int CELL_COORDINATE_BITS = 21;
+	const uint64_t CELL_COORDINATE_MASK = (1ULL << CELL_COORDINATE_BITS) - 1;
+	// directions that the vertices of a cell are split by
+	const int NORMAL_DIRECTION_COUNT = 6;
+
+	struct TRIANGLE_CLUSTER
+	{
+		float sortKey;
+		uint32_t firstTriangle;
+		uint32_t triangleCount;
+	};
+
+	/***********************************************************
+	 *  HashPackedVertex()
+	 *
+	 *  This function is used for hashing the bytes of a packed
+	 *  vertex with FNV-1a.
+	 ***********************************************************/
+	uint32_t HashPackedVertex(const MeshLibrary::PACKED_VERTEX& vertex)
+	{
+		const unsigned char* pBytes = (const unsigned char*)&vertex;
+		uint32_t hash = 2166136261u;
+
+		for (size_t i = 0; i < sizeof(vertex); i++)
+		{
+			hash ^= pBytes[i];
+			hash *= 16777619u;
+		}
+
+		return(hash);
+	}
+
+	/***********************************************************
+	 *  GetVertexScore()
+	 *
+	 *  This function is used for scoring a vertex by where it is
+	 *  in the simulated cache and by how many triangles still
+	 *  use it.  The vertices of the last triangle get a fixed
+	 *  score so the next triangle does not simply reuse its
+	 *  edge, and vertices with few triangles left are boosted so
+	 *  they are finished before they leave the cache.
+	 ***********************************************************/
+	float GetVertexScore(int cachePosition, uint32_t remainingTriangles)
+	{
+		float score = 0.0f;
+
+		if (remainingTriangles == 0)
+		{
+			return(-1.0f);
+		}
+
+		if (cachePosition >= 0)
+		{
+			if (cachePosition < 3)
+			{
+				score = LAST_TRIANGLE_SCORE;
+			}
+			else
+			{
+				float position = 1.0f - (float)(cachePosition - 3) / (float)(VERTEX_CACHE_SIZE - 3);
+				score = std::pow(position, CACHE_DECAY_POWER);
+			}
+		}
+
+		score += VALENCE_BOOST_SCALE * std::pow((float)remainingTriangles, -VALENCE_BOOST_POWER);
+
+		return(score);
+	}
+
+	/***********************************************************
+	 *  GetNormalDirection()
+	 *
+	 *  This function is used for getting which of the six axis
+	 *  directions a normal points closest to.
+	 ***********************************************************/
+	int GetNormalDirection(const glm::vec3& normal)
+	{
+		float x = std::fabs(normal.x);
+		float y = std::fabs(normal.y);
+		float z = std::fabs(normal.z);
+
+		if ((x >= y) && (x >= z))
+		{
+			return((normal.x >= 0.0f) ? 0 : 1);
+		}
+		if (y >= z)
+		{
+			return((normal.y >= 0.0f) ? 2 : 3);
+		}
+
+		return((normal.z >= 0.0f) ? 4 : 5);
+	}
+
+	/***********************************************************
+	 *  GetFaceNormal()
+	 *
+	 *  This function is used for getting the normal of a
+	 *  triangle, with a length of twice its area.
+	 ***********************************************************/
+	glm::vec3 GetFaceNormal(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2)
+	{
+		return(glm::cross(p1 - p0, p2 - p0));
+	}
+}
+
+/***********************************************************
+ *  DeduplicateVertices()
+ *
+ *  This method is used for merging the vertices that end up
+ *  as the same packed vertex in the vertex buffer, which
+ *  joins the triangles that a file split into separate
+ *  primitives.  The packed vertices are found in an open
+ *  addressing table of their indices.  Triangles that have
+ *  lost an edge afterwards draw nothing and are dropped.
+ ***********************************************************/
+void MeshOptimizer::DeduplicateVertices(std::vector<MeshLibrary::VERTEX>& vertices, std::vector<uint32_t>& indices)
+{
+	std::vector<MeshLibrary::VERTEX> uniqueVertices;
+	std::vector<MeshLibrary::PACKED_VERTEX> packedVertices;
+	std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX);
+	std::vector<uint32_t> triangles;
+	size_t tableSize = 1;
+
+	while (tableSize < vertices.size() * 2)
+	{
+		tableSize *= 2;
+	}
+	std::vector<uint32_t> table(tableSize, INVALID_INDEX);
+
+	uniqueVertices.reserve(vertices.size());
+	packedVertices.reserve(vertices.size());
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		MeshLibrary::PACKED_VERTEX packed = MeshLibrary::PackVertex(vertices[i]);
+		size_t slot = HashPackedVertex(packed) & (tableSize - 1);
+
+		while ((table[slot] != INVALID_INDEX) &&
+			(memcmp(&packedVertices[table[slot]], &packed, sizeof(packed)) != 0))
+		{
+			slot = (slot + 1) & (tableSize - 1);
+		}
+		if (table[slot] == INVALID_INDEX)
+		{
+			table[slot] = (uint32_t)uniqueVertices.size();
+			uniqueVertices.push_back(vertices[i]);
+			packedVertices.push_back(packed);
+		}
+		remap[i] = table[slot];
+	}
+
+	triangles.reserve(indices.size());
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		uint32_t a = remap[indices[i]];
+		uint32_t b = remap[indices[i + 1]];
+		uint32_t c = remap[indices[i + 2]];
+
+		if ((a != b) && (b != c) && (a != c))
+		{
+			triangles.push_back(a);
+			triangles.push_back(b);
+			triangles.push_back(c);
+		}
+	}
+
+	vertices.swap(uniqueVertices);
+	indices.swap(triangles);
+}
+
+/***********************************************************
+ *  OptimizeVertexCache()
+ *
+ *  This method is used for ordering the triangles with the
+ *  linear speed algorithm by Forsyth.  Every vertex is scored
+ *  by its place in a simulated LRU cache and by how many of
+ *  its triangles are left, a triangle scores the sum of its
+ *  vertices, and the best triangle using a cached vertex is
+ *  drawn next.  Only the vertices that were in the cache are
+ *  scored again after each triangle, which keeps the cost
+ *  linear in the triangle count.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	size_t triangleCount = indices.size() / 3;
+	std::vector<uint32_t> triangleOffsets(vertexCount + 1, 0);
+	std::vector<uint32_t> remainingTriangles(vertexCount, 0);
+	std::vector<uint32_t> vertexTriangles(triangleCount * 3);
+	std::vector<float> vertexScores(vertexCount);
+	std::vector<unsigned char> emitted(triangleCount, 0);
+	std::vector<uint32_t> orderedIndices;
+	uint32_t cache[VERTEX_CACHE_SIZE + 3];
+	uint32_t newCache[VERTEX_CACHE_SIZE + 3];
+	int cacheCount = 0;
+	size_t nextTriangle = 0;
+	int64_t bestTriangle = -1;
+	float bestScore = -1.0f;
+
+	if ((triangleCount == 0) || (vertexCount == 0))
+	{
+		return;
+	}
+
+	// the triangles that use each vertex, in one array
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		remainingTriangles[indices[i]]++;
+	}
+	for (size_t vertex = 0; vertex < vertexCount; vertex++)
+	{
+		triangleOffsets[vertex + 1] = triangleOffsets[vertex] + remainingTriangles[vertex];
+	}
+	std::vector<uint32_t> fillOffsets(triangleOffsets.begin(), triangleOffsets.end() - 1);
+	for (size_t i = 0; i < triangleCount * 3; i++)
+	{
+		vertexTriangles[fillOffsets[indices[i]]++] = (uint32_t)(i / 3);
+	}
+
+	for (size_t vertex = 0; vertex < vertexCount; vertex++)
+	{
+		vertexScores[vertex] = GetVertexScore(-1, remainingTriangles[vertex]);
+	}
+	for (size_t triangle = 0; triangle < triangleCount; triangle++)
+	{
+		const uint32_t* pTriangle = &indices[triangle * 3];
+		float score = vertexScores[pTriangle[0]] + vertexScores[pTriangle[1]] + vertexScores[pTriangle[2]];
+
+		if (score > bestScore)
+		{
+			bestScore = score;
+			bestTriangle = (int64_t)triangle;
+		}
+	}
+
+	orderedIndices.reserve(indices.size());
+	while (bestTriangle >= 0)
+	{
+		const uint32_t* pTriangle = &indices[(size_t)bestTriangle * 3];
+		int newCount = 0;
+
+		emitted[(size_t)bestTriangle] = 1;
+		for (int k = 0; k < 3; k++)
+		{
+			uint32_t vertex = pTriangle[k];
+			uint32_t* pList = &vertexTriangles[triangleOffsets[vertex]];
+			uint32_t count = remainingTriangles[vertex];
+
+			orderedIndices.push_back(vertex);
+
+			// take the triangle out of the list of the vertex
+			for (uint32_t i = 0; i < count; i++)
+			{
+				if (pList[i] == (uint32_t)bestTriangle)
+				{
+					pList[i] = pList[count - 1];
+					remainingTriangles[vertex]--;
+					break;
+				}
+			}
+
+			if (std::find(newCache, newCache + newCount, vertex) == newCache + newCount)
+			{
+				newCache[newCount++] = vertex;
+			}
+		}
+
+		// the vertices of the triangle move to the front of the
+		// cache, and the ones pushed off its end leave it
+		int triangleVertexCount = newCount;
+		for (int i = 0; i < cacheCount; i++)
+		{
+			if (std::find(newCache, newCache + triangleVertexCount, cache[i]) == newCache + triangleVertexCount)
+			{
+				newCache[newCount++] = cache[i];
+			}
+		}
+		for (int i = VERTEX_CACHE_SIZE; i < newCount; i++)
+		{
+			uint32_t vertex = newCache[i];
+
+			vertexScores[vertex] = GetVertexScore(-1, remainingTriangles[vertex]);
+		}
+		cacheCount = std::min(newCount, VERTEX_CACHE_SIZE);
+		for (int i = 0; i < cacheCount; i++)
+		{
+			cache[i] = newCache[i];
+			vertexScores[cache[i]] = GetVertexScore(i, remainingTriangles[cache[i]]);
+		}
+
+		// pick the best triangle left on a cached vertex, with
+		// the scores of its vertices as they now are
+		bestTriangle = -1;
+		bestScore = -1.0f;
+		for (int i = 0; i < cacheCount; i++)
+		{
+			uint32_t vertex = cache[i];
+			const uint32_t* pList = &vertexTriangles[triangleOffsets[vertex]];
+
+			for (uint32_t j = 0; j < remainingTriangles[vertex]; j++)
+			{
+				const uint32_t* pOther = &indices[(size_t)pList[j] * 3];
+				float score = vertexScores[pOther[0]] + vertexScores[pOther[1]] + vertexScores[pOther[2]];
+
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = (int64_t)pList[j];
+				}
+			}
+		}
+
+		// once no cached vertex has a triangle left, the drawing
+		// continues with the next triangle in the original order
+		if (bestTriangle < 0)
+		{
+			while ((nextTriangle < triangleCount) && (emitted[nextTriangle] != 0))
+			{
+				nextTriangle++;
+			}
+			bestTriangle = (nextTriangle < triangleCount) ? (int64_t)nextTriangle : -1;
+		}
+	}
+
+	indices.swap(orderedIndices);
+}
+
+/***********************************************************
+ *  OptimizeOverdraw()
+ *
+ *  This method is used for sorting the cache ordered
+ *  triangles for less overdraw, after Sander, Nehab and
+ *  Barczak.  The order is cut into clusters where all three
+ *  vertices of a triangle miss the simulated FIFO cache, so
+ *  moving a cluster costs no extra cache misses, and where
+ *  two of them miss while the allowed rise in misses lasts.
+ *  The clusters are then sorted by how far their area
+ *  weighted middle lies outward from the middle of the mesh
+ *  along their normal, since the outward facing clusters
+ *  tend to hide the others from any view.
+ ***********************************************************/
+void MeshOptimizer::OptimizeOverdraw(
+	std::vector<uint32_t>& indices,
+	const std::vector<MeshLibrary::VERTEX>& vertices,
+	float threshold)
+{
+	size_t triangleCount = indices.size() / 3;
+	std::vector<uint32_t> timestamps(vertices.size(), 0);
+	std::vector<unsigned char> triangleMisses(triangleCount, 0);
+	std::vector<TRIANGLE_CLUSTER> clusters;
+	std::vector<uint32_t> sortedIndices;
+	uint32_t time = FIFO_CACHE_SIZE + 1;
+	uint32_t totalMisses = 0;
+	float missBudget = 0.0f;
+	glm::vec3 meshCentroid(0.0f);
+	float meshArea = 0.0f;
+
+	if (triangleCount < 2)
+	{
+		return;
+	}
+
+	// a vertex is in the FIFO cache when it was one of the last
+	// vertices to be added to it
+	for (size_t triangle = 0; triangle < triangleCount; triangle++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			uint32_t vertex = indices[triangle * 3 + k];
+
+			if (time - timestamps[vertex] > (uint32_t)FIFO_CACHE_SIZE)
+			{
+				timestamps[vertex] = time++;
+				triangleMisses[triangle]++;
+			}
+		}
+		totalMisses += triangleMisses[triangle];
+	}
+
+	missBudget = (threshold - 1.0f) * (float)totalMisses;
+	for (size_t triangle = 0; triangle < triangleCount; triangle++)
+	{
+		bool bSplit = (triangle == 0) || (triangleMisses[triangle] == 3);
+
+		if ((false == bSplit) && (triangleMisses[triangle] == 2) && (missBudget >= 1.0f) &&
+			(triangle - clusters.back().firstTriangle >= MIN_CLUSTER_TRIANGLES))
+		{
+			bSplit = true;
+			missBudget -= 1.0f;
+		}
+
+		if (true == bSplit)
+		{
+			TRIANGLE_CLUSTER cluster;
+			cluster.sortKey = 0.0f;
+			cluster.firstTriangle = (uint32_t)triangle;
+			cluster.triangleCount = 0;
+			clusters.push_back(cluster);
+		}
+		clusters.back().triangleCount++;
+	}
+
+	if (clusters.size() < 2)
+	{
+		return;
+	}
+
+	std::vector<glm::vec3> clusterCentroids(clusters.size(), glm::vec3(0.0f));
+	std::vector<glm::vec3> clusterNormals(clusters.size(), glm::vec3(0.0f));
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		float clusterArea = 0.0f;
+
+		for (uint32_t i = 0; i < clusters[c].triangleCount; i++)
+		{
+			const uint32_t* pTriangle = &indices[(size_t)(clusters[c].firstTriangle + i) * 3];
+			const glm::vec3& p0 = vertices[pTriangle[0]].position;
+			const glm::vec3& p1 = vertices[pTriangle[1]].position;
+			const glm::vec3& p2 = vertices[pTriangle[2]].position;
+			glm::vec3 normal = GetFaceNormal(p0, p1, p2);
+			float area = glm::length(normal) * 0.5f;
+
+			clusterCentroids[c] += (p0 + p1 + p2) * (area / 3.0f);
+			clusterNormals[c] += normal;
+			clusterArea += area;
+		}
+
+		meshCentroid += clusterCentroids[c];
+		meshArea += clusterArea;
+		if (clusterArea > 0.0f)
+		{
+			clusterCentroids[c] = clusterCentroids[c] / clusterArea;
+		}
+		else
+		{
+			clusterCentroids[c] = vertices[indices[(size_t)clusters[c].firstTriangle * 3]].position;
+		}
+	}
+	if (meshArea <= 0.0f)
+	{
+		return;
+	}
+	meshCentroid = meshCentroid / meshArea;
+
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		float length = glm::length(clusterNormals[c]);
+
+		clusters[c].sortKey = (length > 0.0f) ? (glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c]) / length) : 0.0f;
+	}
+
+	std::stable_sort(clusters.begin(), clusters.end(),
+		[](const TRIANGLE_CLUSTER& a, const TRIANGLE_CLUSTER& b) { return(a.sortKey > b.sortKey); });
+
+	sortedIndices.reserve(indices.size());
+	for (size_t c = 0; c < clusters.size(); c++)
+	{
+		size_t first = (size_t)clusters[c].firstTriangle * 3;
+
+		sortedIndices.insert(sortedIndices.end(),
+			indices.begin() + first,
+			indices.begin() + first + (size_t)clusters[c].triangleCount * 3);
+	}
+
+	indices.swap(sortedIndices);
+}
+
+/***********************************************************
+ *  OptimizeVertexFetch()
+ *
+ *  This method is used for numbering the vertices in the
+ *  order that the triangles first use them, so the vertex
+ *  buffer is read mostly in sequence.
+ ***********************************************************/
+void MeshOptimizer::OptimizeVertexFetch(std::vector<MeshLibrary::VERTEX>& vertices, std::vector<uint32_t>& indices)
+{
+	std::vector<uint32_t> remap(vertices.size(), INVALID_INDEX);
+	std::vector<MeshLibrary::VERTEX> orderedVertices;
+
+	orderedVertices.reserve(vertices.size());
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		uint32_t vertex = indices[i];
+
+		if (remap[vertex] == INVALID_INDEX)
+		{
+			remap[vertex] = (uint32_t)orderedVertices.size();
+			orderedVertices.push_back(vertices[vertex]);
+		}
+		indices[i] = remap[vertex];
+	}
+
+	vertices.swap(orderedVertices);
+}
+
+/***********************************************************
+ *  OptimizeMesh()
+ *
+ *  This method is used for merging the vertices of a mesh
+ *  and ordering its triangles and vertices for drawing.
+ ***********************************************************/
+void MeshOptimizer::OptimizeMesh(std::vector<MeshLibrary::VERTEX>& vertices, std::vector<uint32_t>& indices)
+{
+	DeduplicateVertices(vertices, indices);
+	OptimizeVertexCache(indices, vertices.size());
+	OptimizeOverdraw(indices, vertices, OVERDRAW_THRESHOLD);
+	OptimizeVertexFetch(vertices, indices);
+}
+
+/***********************************************************
+ *  SimplifyMesh()
+ *
+ *  This method is used for building a coarser mesh by vertex
+ *  clustering.  Every vertex falls into a cell of a grid over
+ *  the mesh, and all the vertices of a cell move to their
+ *  average position, so the mesh stays closed.  The normals
+ *  and texture coordinates are averaged separately for each
+ *  of the six directions the normals point closest to, which
+ *  keeps the hard edges of a part.  The triangles that lose
+ *  an edge, or that turn over, are left out.
+ ***********************************************************/
+bool MeshOptimizer::SimplifyMesh(
+	const std::vector<MeshLibrary::VERTEX>& vertices,
+	const std::vector<uint32_t>& indices,
+	float cellSize,
+	std::vector<MeshLibrary::VERTEX>& simplifiedVertices,
+	std::vector<uint32_t>& simplifiedIndices)
+{
+	std::unordered_map<uint64_t, uint32_t> cells;
+	std::unordered_map<uint64_t, uint32_t> clusters;
+	std::vector<glm::vec3> cellPositions;
+	std::vector<uint32_t> cellCounts;
+	std::vector<uint32_t> clusterCells;
+	std::vector<uint32_t> clusterCounts;
+	std::vector<uint32_t> vertexClusters(vertices.size());
+	glm::vec3 minimum;
+
+	simplifiedVertices.clear();
+	simplifiedIndices.clear();
+	if (vertices.empty() || indices.empty() || (cellSize <= 0.0f))
+	{
+		return(false);
+	}
+
+	minimum = vertices[0].position;
+	for (size_t i = 1; i < vertices.size(); i++)
+	{
+		minimum = glm::min(minimum, vertices[i].position);
+	}
+
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		const MeshLibrary::VERTEX& vertex = vertices[i];
+		glm::vec3 offset = (vertex.position - minimum) / cellSize;
+		uint64_t x = std::min((uint64_t)std::floor(offset.x), CELL_COORDINATE_MASK);
+		uint64_t y = std::min((uint64_t)std::floor(offset.y), CELL_COORDINATE_MASK);
+		uint64_t z = std::min((uint64_t)std::floor(offset.z), CELL_COORDINATE_MASK);
+		uint64_t cellKey = x | (y << CELL_COORDINATE_BITS) | (z << (CELL_COORDINATE_BITS * 2));
+		std::unordered_map<uint64_t, uint32_t>::iterator cell = cells.find(cellKey);
+
+		if (cell == cells.end())
+		{
+			cell = cells.insert(std::make_pair(cellKey, (uint32_t)cellPositions.size())).first;
+			cellPositions.push_back(glm::vec3(0.0f));
+			cellCounts.push_back(0);
+		}
+		cellPositions[cell->second] += vertex.position;
+		cellCounts[cell->second]++;
+
+		uint64_t clusterKey = (uint64_t)cell->second * NORMAL_DIRECTION_COUNT + GetNormalDirection(vertex.normal);
+		std::unordered_map<uint64_t, uint32_t>::iterator cluster = clusters.find(clusterKey);
+
+		if (cluster == clusters.end())
+		{
+			MeshLibrary::VERTEX empty;
+
+			empty.position = glm::vec3(0.0f);
+			empty.normal = glm::vec3(0.0f);
+			empty.uv = glm::vec2(0.0f);
+			cluster = clusters.insert(std::make_pair(clusterKey, (uint32_t)simplifiedVertices.size())).first;
+			simplifiedVertices.push_back(empty);
+			clusterCells.push_back(cell->second);
+			clusterCounts.push_back(0);
+		}
+		simplifiedVertices[cluster->second].normal += vertex.normal;
+		simplifiedVertices[cluster->second].uv += vertex.uv;
+		clusterCounts[cluster->second]++;
+		vertexClusters[i] = cluster->second;
+	}
+
+	for (size_t i = 0; i < simplifiedVertices.size(); i++)
+	{
+		MeshLibrary::VERTEX& vertex = simplifiedVertices[i];
+		uint32_t cell = clusterCells[i];
+		float length = glm::length(vertex.normal);
+
+		vertex.position = cellPositions[cell] / (float)cellCounts[cell];
+		vertex.normal = (length > 0.0f) ? (vertex.normal / length) : glm::vec3(0.0f, 1.0f, 0.0f);
+		vertex.uv = vertex.uv / (float)clusterCounts[i];
+	}
+
+	simplifiedIndices.reserve(indices.size());
+	for (size_t i = 0; i + 2 < indices.size(); i += 3)
+	{
+		uint32_t a = vertexClusters[indices[i]];
+		uint32_t b = vertexClusters[indices[i + 1]];
+		uint32_t c = vertexClusters[indices[i + 2]];
+
+		if ((clusterCells[a] == clusterCells[b]) || (clusterCells[b] == clusterCells[c]) || (clusterCells[a] == clusterCells[c]))
+		{
+			continue;
+		}
+
+		glm::vec3 before = GetFaceNormal(vertices[indices[i]].position, vertices[indices[i + 1]].position, vertices[indices[i + 2]].position);
+		glm::vec3 after = GetFaceNormal(simplifiedVertices[a].position, simplifiedVertices[b].position, simplifiedVertices[c].position);
+		if (glm::dot(before, after) <= 0.0f)
+		{
+			continue;
+		}
+
+		simplifiedIndices.push_back(a);
+		simplifiedIndices.push_back(b);
+		simplifiedIndices.push_back(c);
+	}
+
+	return(!simplifiedIndices.empty());
+}
+
+/***********************************************************
+ *  GetCacheMissRatio()
+ *
+ *  This method is used for measuring the average number of
+ *  vertices transformed per triangle, with a FIFO cache of
+ *  FIFO_CACHE_SIZE entries.
+ ***********************************************************/
+float MeshOptimizer::GetCacheMissRatio(const std::vector<uint32_t>& indices, size_t vertexCount)
+{
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	uint32_t time = FIFO_CACHE_SIZE + 1;
+	uint32_t misses = 0;
+
+	if (indices.size() < 3)
+	{
+		return(0.0f);
+	}
+
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		uint32_t vertex = indices[i];
+
+		if (time - timestamps[vertex] > (uint32_t)FIFO_CACHE_SIZE)
+		{
+			timestamps[vertex] = time++;
+			misses++;
+		}
+	}
+
+	return((float)misses / (float)(indices.size() / 3));
+}
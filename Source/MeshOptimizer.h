@@ -0,0 +1,70 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshoptimizer.h
+// ============
+// reorder and simplify imported meshes for the vertex cache and overdraw
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "MeshLibrary.h"
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  MeshOptimizer
+ *
+ *  This class prepares indexed triangle meshes that were not
+ *  generated by the mesh library, before they are added to
+ *  it.  The vertices that quantize to the same packed vertex
+ *  are merged, the triangles are ordered so that the vertices
+ *  they share are still in the post-transform cache, and that
+ *  order is split into clusters that are sorted so the ones
+ *  facing away from the middle of the mesh are drawn first,
+ *  since they tend to hide the others.  The vertices are then
+ *  stored in the order they are first used, so they are read
+ *  from memory in sequence.  Coarser levels of detail are
+ *  built by merging the vertices that fall into the cells of
+ *  a grid.
+ ***********************************************************/
+class MeshOptimizer
+{
+public:
+	// entries of the simulated FIFO post-transform cache, which
+	// is the size the cache miss ratio is measured with
+	static const int FIFO_CACHE_SIZE = 16;
+
+	// merge the vertices that quantize to the same packed vertex
+	// and drop the triangles that lose an edge doing so
+	static void DeduplicateVertices(std::vector<MeshLibrary::VERTEX>& vertices, std::vector<uint32_t>& indices);
+	// order the triangles for the post-transform vertex cache
+	static void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+	// sort clusters of the cache ordered triangles to draw the
+	// outward facing ones first, allowing the cache misses to
+	// rise by the passed in factor
+	static void OptimizeOverdraw(
+		std::vector<uint32_t>& indices,
+		const std::vector<MeshLibrary::VERTEX>& vertices,
+		float threshold);
+	// store the vertices in the order the triangles use them,
+	// leaving out the ones that no triangle uses
+	static void OptimizeVertexFetch(std::vector<MeshLibrary::VERTEX>& vertices, std::vector<uint32_t>& indices);
+	// run every step above on a mesh
+	static void OptimizeMesh(std::vector<MeshLibrary::VERTEX>& vertices, std::vector<uint32_t>& indices);
+
+	// build a coarser mesh by merging the vertices in each cell
+	// of a grid with the passed in cell size, returning false
+	// when no triangle is left
+	static bool SimplifyMesh(
+		const std::vector<MeshLibrary::VERTEX>& vertices,
+		const std::vector<uint32_t>& indices,
+		float cellSize,
+		std::vector<MeshLibrary::VERTEX>& simplifiedVertices,
+		std::vector<uint32_t>& simplifiedIndices);
+
+	// vertices transformed per triangle with a FIFO cache of
+	// FIFO_CACHE_SIZE entries, from 0.5 at best to 3 at worst
+	static float GetCacheMissRatio(const std::vector<uint32_t>& indices, size_t vertexCount);
+};
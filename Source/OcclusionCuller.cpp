@@ -0,0 +1,472 @@
+///////////////////////////////////////////////////////////////////////////////
+// occlusionculler.cpp
+// ============
+// cull the indirect draws hidden behind the large occluders on the GPU
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OcclusionCuller.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// declaration of global variables
+namespace
+{
+	// work group sizes declared in the compute shaders
+	const GLuint HI_Z_GROUP_SIZE = 8;
+	const GLuint CULL_GROUP_SIZE = 64;
+	// image unit that the pyramid level being written is bound to
+	const GLuint HI_Z_IMAGE_UNIT = 0;
+}
+
+/***********************************************************
+ *  OcclusionCuller()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+OcclusionCuller::OcclusionCuller()
+{
+	m_hiZProgram = 0;
+	m_cullProgram = 0;
+	m_framebuffer = 0;
+	m_depthTexture = 0;
+	m_hiZTexture = 0;
+	m_width = 0;
+	m_height = 0;
+	m_levelCount = 0;
+	m_boundsBuffer = 0;
+	m_boundsCapacity = 0;
+	m_previousFramebuffer = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		m_previousViewport[i] = 0;
+	}
+}
+
+/***********************************************************
+ *  ~OcclusionCuller()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+OcclusionCuller::~OcclusionCuller()
+{
+	DestroyTargets();
+	if (0 != m_boundsBuffer)
+	{
+		glDeleteBuffers(1, &m_boundsBuffer);
+		m_boundsBuffer = 0;
+	}
+	if (0 != m_hiZProgram)
+	{
+		glDeleteProgram(m_hiZProgram);
+		m_hiZProgram = 0;
+	}
+	if (0 != m_cullProgram)
+	{
+		glDeleteProgram(m_cullProgram);
+		m_cullProgram = 0;
+	}
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking whether the current
+ *  context supports compute shaders and image stores.
+ ***********************************************************/
+bool OcclusionCuller::IsSupported()
+{
+	return(GL_TRUE == glewIsSupported("GL_VERSION_4_3"));
+}
+
+/***********************************************************
+ *  LoadComputeShader()
+ *
+ *  This method is used for compiling and linking a compute
+ *  shader from a file, and returns 0 when that fails.
+ ***********************************************************/
+GLuint OcclusionCuller::LoadComputeShader(const char* filename)
+{
+	std::ifstream file(filename);
+	std::stringstream source;
+	std::string sourceText;
+	const char* sourcePointer = NULL;
+	GLuint shader = 0;
+	GLuint program = 0;
+	GLint bSuccess = GL_FALSE;
+	char log[1024];
+
+	if (!file.is_open())
+	{
+		std::cout << "Could not open the compute shader:" << filename << std::endl;
+		return(0);
+	}
+	source << file.rdbuf();
+	sourceText = source.str();
+	sourcePointer = sourceText.c_str();
+
+	shader = glCreateShader(GL_COMPUTE_SHADER);
+	glShaderSource(shader, 1, &sourcePointer, NULL);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &bSuccess);
+	if (GL_TRUE != bSuccess)
+	{
+		glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+		std::cout << "Could not compile the compute shader:" << filename << std::endl << log << std::endl;
+		glDeleteShader(shader);
+		return(0);
+	}
+
+	program = glCreateProgram();
+	glAttachShader(program, shader);
+	glLinkProgram(program);
+	glDeleteShader(shader);
+	glGetProgramiv(program, GL_LINK_STATUS, &bSuccess);
+	if (GL_TRUE != bSuccess)
+	{
+		glGetProgramInfoLog(program, sizeof(log), NULL, log);
+		std::cout << "Could not link the compute shader:" << filename << std::endl << log << std::endl;
+		glDeleteProgram(program);
+		return(0);
+	}
+
+	return(program);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for loading the two compute shaders
+ *  and creating the bounds buffer.  The depth targets are
+ *  created on first use, at the size of the viewport.
+ ***********************************************************/
+bool OcclusionCuller::Initialize(
+	const char* hiZShaderPath,
+	const char* cullShaderPath)
+{
+	if (false == IsSupported())
+	{
+		return(false);
+	}
+
+	m_hiZProgram = LoadComputeShader(hiZShaderPath);
+	m_cullProgram = LoadComputeShader(cullShaderPath);
+	if ((0 == m_hiZProgram) || (0 == m_cullProgram))
+	{
+		return(false);
+	}
+
+	glGenBuffers(1, &m_boundsBuffer);
+	m_hiZShaderPath = hiZShaderPath;
+	m_cullShaderPath = cullShaderPath;
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReloadShader()
+ *
+ *  This method is used for building the compute program of a
+ *  changed shader file again.  The new program replaces the
+ *  current one only once it has linked.
+ ***********************************************************/
+bool OcclusionCuller::ReloadShader(const std::string& shaderPath)
+{
+	GLuint* pProgram = NULL;
+	GLuint program = 0;
+
+	if ((shaderPath == m_hiZShaderPath) && (0 != m_hiZProgram))
+	{
+		pProgram = &m_hiZProgram;
+	}
+	else if ((shaderPath == m_cullShaderPath) && (0 != m_cullProgram))
+	{
+		pProgram = &m_cullProgram;
+	}
+	else
+	{
+		return(false);
+	}
+
+	program = LoadComputeShader(shaderPath.c_str());
+	if (0 == program)
+	{
+		std::cout << "Keeping the current compute shader:" << shaderPath << std::endl;
+		return(false);
+	}
+
+	glDeleteProgram(*pProgram);
+	*pProgram = program;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing the bounds of the
+ *  previous frame, keeping the allocated memory.
+ ***********************************************************/
+void OcclusionCuller::Clear()
+{
+	m_bounds.clear();
+}
+
+/***********************************************************
+ *  AddBounds()
+ *
+ *  This method is used for adding the world box of the next
+ *  indirect draw, in the same order as the commands.
+ ***********************************************************/
+void OcclusionCuller::AddBounds(const glm::vec3& center, const glm::vec3& extent, bool bOccluder)
+{
+	DRAW_BOUNDS_STD430 bounds;
+
+	bounds.center = glm::vec4(center, bOccluder ? 1.0f : 0.0f);
+	bounds.extent = glm::vec4(extent, 0.0f);
+	m_bounds.push_back(bounds);
+}
+
+/***********************************************************
+ *  ResizeBounds()
+ *
+ *  This method is used for setting the number of indirect
+ *  draws, so that their boxes can be filled in by index from
+ *  several threads instead of being added in order.
+ ***********************************************************/
+void OcclusionCuller::ResizeBounds(size_t count)
+{
+	m_bounds.resize(count);
+}
+
+/***********************************************************
+ *  SetBounds()
+ *
+ *  This method is used for setting the world box of the
+ *  indirect draw at the passed in index.
+ ***********************************************************/
+void OcclusionCuller::SetBounds(size_t index, const glm::vec3& center, const glm::vec3& extent, bool bOccluder)
+{
+	if (index >= m_bounds.size())
+	{
+		return;
+	}
+
+	m_bounds[index].center = glm::vec4(center, bOccluder ? 1.0f : 0.0f);
+	m_bounds[index].extent = glm::vec4(extent, 0.0f);
+}
+
+/***********************************************************
+ *  DestroyTargets()
+ *
+ *  This method is used for freeing the depth framebuffer and
+ *  the depth pyramid.
+ ***********************************************************/
+void OcclusionCuller::DestroyTargets()
+{
+	if (0 != m_framebuffer)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	if (0 != m_depthTexture)
+	{
+		glDeleteTextures(1, &m_depthTexture);
+		m_depthTexture = 0;
+	}
+	if (0 != m_hiZTexture)
+	{
+		glDeleteTextures(1, &m_hiZTexture);
+		m_hiZTexture = 0;
+	}
+	m_width = 0;
+	m_height = 0;
+	m_levelCount = 0;
+}
+
+/***********************************************************
+ *  ResizeTargets()
+ *
+ *  This method is used for creating the depth texture the
+ *  occluders are drawn into and the pyramid built from it,
+ *  both at the passed in size, with a full mip chain.
+ ***********************************************************/
+void OcclusionCuller::ResizeTargets(int width, int height)
+{
+	int largest = (width > height) ? width : height;
+
+	if ((width == m_width) && (height == m_height) && (0 != m_framebuffer))
+	{
+		return;
+	}
+
+	DestroyTargets();
+	m_width = width;
+	m_height = height;
+	m_levelCount = 1;
+	while ((largest >> m_levelCount) > 0)
+	{
+		m_levelCount++;
+	}
+
+	glGenTextures(1, &m_depthTexture);
+	glBindTexture(GL_TEXTURE_2D, m_depthTexture);
+	glTexStorage2D(GL_TEXTURE_2D, 1, GL_DEPTH_COMPONENT32F, m_width, m_height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glGenTextures(1, &m_hiZTexture);
+	glBindTexture(GL_TEXTURE_2D, m_hiZTexture);
+	glTexStorage2D(GL_TEXTURE_2D, m_levelCount, GL_R32F, m_width, m_height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, m_depthTexture, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	if (GL_FRAMEBUFFER_COMPLETE != glCheckFramebufferStatus(GL_FRAMEBUFFER))
+	{
+		std::cout << "The occlusion depth framebuffer is incomplete" << std::endl;
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+/***********************************************************
+ *  BeginOccluderPass()
+ *
+ *  This method is used for binding the depth-only framebuffer
+ *  at the size of the current viewport and clearing it.  The
+ *  bound framebuffer and viewport are saved for restoring.
+ ***********************************************************/
+void OcclusionCuller::BeginOccluderPass()
+{
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, m_previousViewport);
+
+	ResizeTargets(m_previousViewport[2], m_previousViewport[3]);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, m_width, m_height);
+	glClear(GL_DEPTH_BUFFER_BIT);
+}
+
+/***********************************************************
+ *  EndOccluderPass()
+ *
+ *  This method is used for restoring the framebuffer and
+ *  viewport that were bound before the occluder pass.
+ ***********************************************************/
+void OcclusionCuller::EndOccluderPass()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)m_previousFramebuffer);
+	glViewport(m_previousViewport[0], m_previousViewport[1], m_previousViewport[2], m_previousViewport[3]);
+}
+
+/***********************************************************
+ *  BuildHiZ()
+ *
+ *  This method is used for building the depth pyramid.  Level
+ *  zero is a copy of the occluder depth, and every further
+ *  level keeps the farthest depth of the level below, so a
+ *  texel of any level is a safe bound for the area it covers.
+ ***********************************************************/
+void OcclusionCuller::BuildHiZ()
+{
+	GLint previousProgram = 0;
+
+	if ((0 == m_hiZProgram) || (0 == m_hiZTexture))
+	{
+		return;
+	}
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+	glUseProgram(m_hiZProgram);
+	glUniform1i(glGetUniformLocation(m_hiZProgram, "sourceDepth"), HI_Z_TEXTURE_UNIT);
+	glActiveTexture(GL_TEXTURE0 + HI_Z_TEXTURE_UNIT);
+
+	for (int level = 0; level < m_levelCount; level++)
+	{
+		int levelWidth = (m_width >> level) > 0 ? (m_width >> level) : 1;
+		int levelHeight = (m_height >> level) > 0 ? (m_height >> level) : 1;
+
+		glBindTexture(GL_TEXTURE_2D, (level == 0) ? m_depthTexture : m_hiZTexture);
+		glUniform1i(glGetUniformLocation(m_hiZProgram, "bCopyLevel"), (level == 0) ? 1 : 0);
+		glUniform1i(glGetUniformLocation(m_hiZProgram, "sourceLevel"), (level == 0) ? 0 : (level - 1));
+		glBindImageTexture(HI_Z_IMAGE_UNIT, m_hiZTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+		glDispatchCompute(
+			(levelWidth + HI_Z_GROUP_SIZE - 1) / HI_Z_GROUP_SIZE,
+			(levelHeight + HI_Z_GROUP_SIZE - 1) / HI_Z_GROUP_SIZE,
+			1);
+
+		// the next level reads the one that was just written
+		glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+	}
+
+	glBindImageTexture(HI_Z_IMAGE_UNIT, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glActiveTexture(GL_TEXTURE0 + TEXTURE_ARRAY_UNIT);
+	glUseProgram((GLuint)previousProgram);
+}
+
+/***********************************************************
+ *  CullCommands()
+ *
+ *  This method is used for testing the world box of every
+ *  draw against the depth pyramid and writing the instance
+ *  count of its command in the passed in indirect buffer.
+ *  The commands must be in the same order as the bounds.
+ ***********************************************************/
+void OcclusionCuller::CullCommands(GLuint commandBuffer, const glm::mat4& viewProjection)
+{
+	GLint previousProgram = 0;
+	GLuint drawCount = (GLuint)m_bounds.size();
+
+	if ((0 == m_cullProgram) || (0 == m_hiZTexture) || (drawCount == 0))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_boundsBuffer);
+	if (m_bounds.size() > m_boundsCapacity)
+	{
+		m_boundsCapacity = m_bounds.size() * 2;
+	}
+	// orphaned so the previous frame's cull can still read it
+	glBufferData(GL_SHADER_STORAGE_BUFFER, m_boundsCapacity * sizeof(DRAW_BOUNDS_STD430), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, m_bounds.size() * sizeof(DRAW_BOUNDS_STD430), &m_bounds[0]);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, BOUNDS_BLOCK_BINDING, m_boundsBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BLOCK_BINDING, commandBuffer);
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+	glUseProgram(m_cullProgram);
+	glUniformMatrix4fv(glGetUniformLocation(m_cullProgram, "viewProjection"), 1, GL_FALSE, glm::value_ptr(viewProjection));
+	glUniform1ui(glGetUniformLocation(m_cullProgram, "drawCount"), drawCount);
+	glUniform1i(glGetUniformLocation(m_cullProgram, "hiZ"), HI_Z_TEXTURE_UNIT);
+	glUniform1i(glGetUniformLocation(m_cullProgram, "hiZLevelCount"), m_levelCount);
+
+	glActiveTexture(GL_TEXTURE0 + HI_Z_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_2D, m_hiZTexture);
+
+	glDispatchCompute((drawCount + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+
+	// the indirect draw reads the instance counts written here
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glActiveTexture(GL_TEXTURE0 + TEXTURE_ARRAY_UNIT);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BLOCK_BINDING, 0);
+	glUseProgram((GLuint)previousProgram);
+}
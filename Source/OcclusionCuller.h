@@ -0,0 +1,101 @@
+///////////////////////////////////////////////////////////////////////////////
+// occlusionculler.h
+// ============
+// cull the indirect draws hidden behind the large occluders on the GPU
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderBlocks.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  OcclusionCuller
+ *
+ *  This class culls the commands of the indirect renderer
+ *  against a hierarchical depth (Hi-Z) pyramid.  The large
+ *  occluders are drawn first into a depth-only framebuffer,
+ *  a compute shader reduces that depth into a mip chain where
+ *  each texel holds the farthest depth below it, and a second
+ *  compute shader tests the world box of every draw against
+ *  the pyramid and writes the instance count of its command.
+ *  The whole pass runs on the GPU, so nothing is read back.
+ *  It needs an OpenGL 4.3 context for the compute shaders.
+ ***********************************************************/
+class OcclusionCuller
+{
+public:
+	// constructor
+	OcclusionCuller();
+	// destructor
+	~OcclusionCuller();
+
+	// check whether the current context can run the pass
+	static bool IsSupported();
+
+	// load the compute shaders and create the buffers
+	bool Initialize(
+		const char* hiZShaderPath,
+		const char* cullShaderPath);
+	// load the compute shader of the passed in file again, keeping
+	// the current program when the new one does not build
+	bool ReloadShader(const std::string& shaderPath);
+
+	// remove the bounds of the previous frame
+	void Clear();
+	// add the world box of the next indirect draw
+	void AddBounds(const glm::vec3& center, const glm::vec3& extent, bool bOccluder);
+	// set the number of draws, whose boxes are then set by index
+	void ResizeBounds(size_t count);
+	// set the world box of the indirect draw at the passed in
+	// index, which can be done for different draws at once
+	void SetBounds(size_t index, const glm::vec3& center, const glm::vec3& extent, bool bOccluder);
+
+	// bind the depth-only framebuffer for drawing the occluders
+	void BeginOccluderPass();
+	// restore the framebuffer and viewport of the scene
+	void EndOccluderPass();
+	// build the depth pyramid from the occluder depth
+	void BuildHiZ();
+	// set the instance count of every command in the passed in
+	// indirect buffer, zero for the hidden draws
+	void CullCommands(GLuint commandBuffer, const glm::mat4& viewProjection);
+
+private:
+	// compute programs building the pyramid and culling
+	GLuint m_hiZProgram;
+	GLuint m_cullProgram;
+	// the shader files, kept for reloading them
+	std::string m_hiZShaderPath;
+	std::string m_cullShaderPath;
+	// depth-only framebuffer the occluders are drawn into
+	GLuint m_framebuffer;
+	GLuint m_depthTexture;
+	// farthest depth pyramid, one mip level per reduction
+	GLuint m_hiZTexture;
+	int m_width;
+	int m_height;
+	int m_levelCount;
+	// world boxes of the draws and the buffer they are sent in
+	std::vector<DRAW_BOUNDS_STD430> m_bounds;
+	GLuint m_boundsBuffer;
+	size_t m_boundsCapacity;
+	// framebuffer and viewport restored after the occluder pass
+	GLint m_previousFramebuffer;
+	GLint m_previousViewport[4];
+
+	// compile and link a compute shader from a file
+	static GLuint LoadComputeShader(const char* filename);
+	// create the depth target and pyramid for the viewport size
+	void ResizeTargets(int width, int height);
+	// free the depth target and pyramid
+	void DestroyTargets();
+};
@@ -0,0 +1,288 @@
+///////////////////////////////////////////////////////////////////////////////
+// programcache.cpp
+// ============
+// keep the binaries of linked shader programs on disk between launches
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ProgramCache.h"
+#include "TextureCache.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	// the eight bytes that every cached program file starts with
+	const char PROGRAM_IDENTIFIER[8] = { 'C', 'S', '3', '3', '0', 'P', 'G', 'M' };
+	// raised whenever the layout of the file changes
+	const uint32_t PROGRAM_FILE_VERSION = 1;
+
+	// identifier, file version, binary format, binary length,
+	// four bytes of padding, driver hash and source hash
+	const size_t PROGRAM_HEADER_SIZE = 8 + 4 + 4 + 4 + 4 + 8 + 8;
+
+	// extension of the cached program files
+	const char* g_ProgramExtension = ".glbin";
+
+	void WriteUint32(std::vector<unsigned char>& data, size_t offset, uint32_t value)
+	{
+		memcpy(&data[offset], &value, sizeof(value));
+	}
+
+	void WriteUint64(std::vector<unsigned char>& data, size_t offset, uint64_t value)
+	{
+		memcpy(&data[offset], &value, sizeof(value));
+	}
+
+	uint32_t ReadUint32(const std::vector<unsigned char>& data, size_t offset)
+	{
+		uint32_t value = 0;
+		memcpy(&value, &data[offset], sizeof(value));
+		return(value);
+	}
+
+	uint64_t ReadUint64(const std::vector<unsigned char>& data, size_t offset)
+	{
+		uint64_t value = 0;
+		memcpy(&value, &data[offset], sizeof(value));
+		return(value);
+	}
+
+	// the driver strings can be NULL on a broken context
+	std::string GetDriverString(GLenum name)
+	{
+		const GLubyte* value = glGetString(name);
+		return((value != NULL) ? std::string((const char*)value) : std::string());
+	}
+}
+
+/***********************************************************
+ *  ProgramCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ProgramCache::ProgramCache()
+{
+	m_bEnabled = false;
+	m_driverHash = 0;
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for checking that the context can
+ *  return and accept program binaries, and for hashing the
+ *  driver strings that every cached file is checked against.
+ ***********************************************************/
+void ProgramCache::Initialize(const std::string& cacheDirectory)
+{
+	GLint formatCount = 0;
+	std::string driver;
+
+	m_cacheDirectory = cacheDirectory;
+	m_bEnabled = false;
+
+	if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+	{
+		std::cout << "Program binaries are not supported, shaders are compiled from source" << std::endl;
+		return;
+	}
+
+	// some drivers expose the entry points without any format
+	// that a binary can be returned in
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	if (formatCount <= 0)
+	{
+		std::cout << "The driver has no program binary formats, shaders are compiled from source" << std::endl;
+		return;
+	}
+
+	// a driver update can change the binary format without
+	// changing its number, so the strings are part of the key
+	driver = GetDriverString(GL_VENDOR) + "\n" + GetDriverString(GL_RENDERER) + "\n" + GetDriverString(GL_VERSION);
+	m_driverHash = TextureCache::HashData((const unsigned char*)driver.c_str(), driver.size());
+	m_bEnabled = true;
+}
+
+/***********************************************************
+ *  HashSources()
+ *
+ *  This method is used for hashing the complete sources of a
+ *  program, including the defines of its variant.  A zero
+ *  byte between the stages keeps text moved from the end of
+ *  one stage to the start of the other from hashing the same.
+ ***********************************************************/
+uint64_t ProgramCache::HashSources(const std::string& vertexSource, const std::string& fragmentSource)
+{
+	std::vector<unsigned char> sources;
+
+	sources.reserve(vertexSource.size() + fragmentSource.size() + 1);
+	sources.insert(sources.end(), vertexSource.begin(), vertexSource.end());
+	sources.push_back(0);
+	sources.insert(sources.end(), fragmentSource.begin(), fragmentSource.end());
+
+	return(TextureCache::HashData(&sources[0], sources.size()));
+}
+
+/***********************************************************
+ *  GetCachePath()
+ *
+ *  This method is used for naming the cached file of the
+ *  passed in source hash.
+ ***********************************************************/
+std::string ProgramCache::GetCachePath(uint64_t sourceHash) const
+{
+	char name[32];
+
+	snprintf(name, sizeof(name), "%016llx", (unsigned long long)sourceHash);
+
+	return(m_cacheDirectory + name + g_ProgramExtension);
+}
+
+/***********************************************************
+ *  LoadProgram()
+ *
+ *  This method is used for creating a program from the cached
+ *  binary of the passed in source hash.  It returns 0 when
+ *  there is no file, when the file was written by another
+ *  driver, or when the driver rejects the binary, and a file
+ *  that was rejected is removed so a new one is written.
+ ***********************************************************/
+GLuint ProgramCache::LoadProgram(uint64_t sourceHash) const
+{
+	std::string cachePath;
+	std::vector<unsigned char> data;
+	GLuint program = 0;
+	GLint bSuccess = GL_FALSE;
+
+	if (!m_bEnabled)
+	{
+		return(0);
+	}
+
+	cachePath = GetCachePath(sourceHash);
+	{
+		std::ifstream file(cachePath.c_str(), std::ios::binary);
+
+		if (!file.is_open())
+		{
+			return(0);
+		}
+
+		file.seekg(0, std::ios::end);
+		data.resize((size_t)file.tellg());
+		file.seekg(0, std::ios::beg);
+		if ((data.size() < PROGRAM_HEADER_SIZE) || !file.read((char*)&data[0], data.size()))
+		{
+			data.clear();
+		}
+	}
+
+	uint32_t fileVersion = (data.empty()) ? 0 : ReadUint32(data, 8);
+	uint32_t binaryFormat = (data.empty()) ? 0 : ReadUint32(data, 12);
+	uint32_t binaryLength = (data.empty()) ? 0 : ReadUint32(data, 16);
+
+	// an older driver's binary is expected after an update, so
+	// only the files that are damaged are reported
+	if (data.empty() ||
+		(memcmp(&data[0], PROGRAM_IDENTIFIER, sizeof(PROGRAM_IDENTIFIER)) != 0) ||
+		(fileVersion != PROGRAM_FILE_VERSION) ||
+		(ReadUint64(data, 32) != sourceHash) ||
+		(binaryLength == 0) ||
+		(PROGRAM_HEADER_SIZE + binaryLength != data.size()))
+	{
+		std::cout << "Ignoring the damaged program cache:" << cachePath << std::endl;
+		remove(cachePath.c_str());
+		return(0);
+	}
+	if (ReadUint64(data, 24) != m_driverHash)
+	{
+		remove(cachePath.c_str());
+		return(0);
+	}
+
+	program = glCreateProgram();
+	glProgramBinary(program, (GLenum)binaryFormat, &data[PROGRAM_HEADER_SIZE], (GLsizei)binaryLength);
+	glGetProgramiv(program, GL_LINK_STATUS, &bSuccess);
+	if (GL_TRUE != bSuccess)
+	{
+		glDeleteProgram(program);
+		remove(cachePath.c_str());
+		return(0);
+	}
+
+	return(program);
+}
+
+/***********************************************************
+ *  PrepareProgram()
+ *
+ *  This method is used for asking the driver to keep the
+ *  binary of the passed in program, which has to be done
+ *  before the program is linked.
+ ***********************************************************/
+void ProgramCache::PrepareProgram(GLuint program) const
+{
+	if (m_bEnabled)
+	{
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+}
+
+/***********************************************************
+ *  StoreProgram()
+ *
+ *  This method is used for writing the binary of the passed
+ *  in linked program to the cached file of its source hash.
+ ***********************************************************/
+bool ProgramCache::StoreProgram(uint64_t sourceHash, GLuint program) const
+{
+	std::string cachePath;
+	std::vector<unsigned char> data;
+	GLint binaryLength = 0;
+	GLsizei writtenLength = 0;
+	GLenum binaryFormat = 0;
+
+	if (!m_bEnabled)
+	{
+		return(false);
+	}
+
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	if (binaryLength <= 0)
+	{
+		return(false);
+	}
+
+	data.resize(PROGRAM_HEADER_SIZE + (size_t)binaryLength);
+	glGetProgramBinary(program, binaryLength, &writtenLength, &binaryFormat, &data[PROGRAM_HEADER_SIZE]);
+	if (writtenLength <= 0)
+	{
+		return(false);
+	}
+	data.resize(PROGRAM_HEADER_SIZE + (size_t)writtenLength);
+
+	memcpy(&data[0], PROGRAM_IDENTIFIER, sizeof(PROGRAM_IDENTIFIER));
+	WriteUint32(data, 8, PROGRAM_FILE_VERSION);
+	WriteUint32(data, 12, (uint32_t)binaryFormat);
+	WriteUint32(data, 16, (uint32_t)writtenLength);
+	WriteUint32(data, 20, 0);
+	WriteUint64(data, 24, m_driverHash);
+	WriteUint64(data, 32, sourceHash);
+
+	cachePath = GetCachePath(sourceHash);
+	std::ofstream file(cachePath.c_str(), std::ios::binary | std::ios::trunc);
+	if (!file.is_open() || !file.write((const char*)&data[0], data.size()))
+	{
+		std::cout << "Could not write the program cache:" << cachePath << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
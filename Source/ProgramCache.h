@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// programcache.h
+// ============
+// keep the binaries of linked shader programs on disk between launches
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <string>
+
+/***********************************************************
+ *  ProgramCache
+ *
+ *  This class writes the driver binary of a linked program
+ *  to a file named after the hash of its shader sources, and
+ *  creates the program from that file on the next launch
+ *  instead of compiling the sources again.  Each file also
+ *  records the vendor, renderer and version of the driver
+ *  that made it, so a binary from another driver is never
+ *  loaded.  A binary the driver rejects is treated as a cache
+ *  miss, and the caller compiles the program from source.
+ *  The cache turns itself off when the context cannot
+ *  return program binaries.
+ ***********************************************************/
+class ProgramCache
+{
+public:
+	// constructor
+	ProgramCache();
+
+	// check the context for program binaries, and set the
+	// directory the cached files are kept in
+	void Initialize(const std::string& cacheDirectory);
+	bool IsEnabled() const { return(m_bEnabled); }
+
+	// hash the sources that a program is built from
+	static uint64_t HashSources(const std::string& vertexSource, const std::string& fragmentSource);
+
+	// create a program from its cached binary, or return 0
+	// when there is no valid binary for the sources
+	GLuint LoadProgram(uint64_t sourceHash) const;
+	// ask the driver to keep the binary of a program that is
+	// about to be linked
+	void PrepareProgram(GLuint program) const;
+	// write the binary of a linked program to its cache file
+	bool StoreProgram(uint64_t sourceHash, GLuint program) const;
+
+private:
+	// set when the context can return program binaries
+	bool m_bEnabled;
+	// hash of the driver vendor, renderer and version strings
+	uint64_t m_driverHash;
+	std::string m_cacheDirectory;
+
+	// path of the cached file for the passed in source hash
+	std::string GetCachePath(uint64_t sourceHash) const;
+};
@@ -0,0 +1,747 @@
+///////////////////////////////////////////////////////////////////////////////
+// regressionsuite.cpp
+// ============
+// run the benchmark on every render path and check it against golden results
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RegressionSuite.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+// declaration of global variables
+namespace
+{
+	// a channel may differ by this much from the golden image,
+	// which leaves room for the rounding of a different driver
+	const int PIXEL_TOLERANCE = 2;
+	// part of the pixels that may differ by more than that
+	// before the image counts as changed
+	const double MAX_DIFFERENT_PIXEL_FRACTION = 0.001;
+
+	// the stress scene is a grid of nodes on the ground in front
+	// of the camera path, alternating between boxes and tori
+	const float STRESS_SPACING = 0.35f;
+	const float STRESS_START_Z = -1.0f;
+}
+
+/***********************************************************
+ *  RegressionSuite()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RegressionSuite::RegressionSuite()
+{
+	m_slowdownPercent = 0.0;
+	m_bUpdateGoldens = false;
+	m_currentPass = 0;
+	m_passFirstFrame = 0;
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for setting where the golden files of
+ *  the scene are kept and reading the baselines recorded by
+ *  earlier runs.
+ ***********************************************************/
+bool RegressionSuite::Initialize(
+	const char* goldenDirectory,
+	const std::string& sceneFile,
+	double slowdownPercent,
+	bool bUpdateGoldens)
+{
+	size_t nameStart = sceneFile.find_last_of("/\\");
+	size_t nameEnd = sceneFile.find_last_of('.');
+
+	nameStart = (nameStart == std::string::npos) ? 0 : (nameStart + 1);
+	if ((nameEnd == std::string::npos) || (nameEnd < nameStart))
+	{
+		nameEnd = sceneFile.size();
+	}
+
+	m_goldenDirectory = goldenDirectory;
+	m_sceneName = sceneFile.substr(nameStart, nameEnd - nameStart);
+	m_slowdownPercent = slowdownPercent;
+	m_bUpdateGoldens = bUpdateGoldens;
+	m_currentPass = 0;
+	m_passFirstFrame = 0;
+
+	if (false == MakeDirectory(goldenDirectory))
+	{
+		std::cout << "Could not create the golden directory:" << goldenDirectory << std::endl;
+		return(false);
+	}
+
+	if ((false == m_bUpdateGoldens) && (false == ReadBaselines()))
+	{
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  AddPass()
+ *
+ *  This method is used for adding a render path to the passes
+ *  of the suite.
+ ***********************************************************/
+void RegressionSuite::AddPass(SceneManager::RENDER_PATH renderPath, const char* name)
+{
+	PASS_RESULT pass;
+
+	pass.renderPath = renderPath;
+	pass.name = name;
+	pass.status = PASS_PENDING;
+	pass.frameCount = 0;
+	pass.frameMedian = 0.0;
+	pass.frameP95 = 0.0;
+	pass.frameP99 = 0.0;
+	pass.sceneGpuMedian = -1.0;
+	pass.drawCalls = 0.0;
+	pass.triangles = 0.0;
+	pass.gpuMemoryKilobytes = -1.0;
+	pass.differentPixels = 0;
+	pass.maximumDifference = 0;
+	m_passes.push_back(pass);
+}
+
+/***********************************************************
+ *  BeginFirstPass()
+ *
+ *  This method is used for switching the scene to the render
+ *  path of the first pass before its first frame.
+ ***********************************************************/
+void RegressionSuite::BeginFirstPass(SceneManager& sceneManager, const FrameProfiler& profiler)
+{
+	m_currentPass = 0;
+	m_passFirstFrame = profiler.GetFrames().size();
+	if (!m_passes.empty())
+	{
+		sceneManager.SetRenderPath(m_passes[0].renderPath);
+		std::cout << "INFO: Regression pass " << m_passes[0].name << std::endl;
+	}
+}
+
+/***********************************************************
+ *  EndPass()
+ *
+ *  This method is used for checking the pass that has just
+ *  rendered its last frame and starting the next one.  A path
+ *  that the scene fell back from, like the indirect path
+ *  without multi-draw support, is skipped rather than failed.
+ ***********************************************************/
+bool RegressionSuite::EndPass(const Benchmark& benchmark, FrameProfiler& profiler, SceneManager& sceneManager)
+{
+	if (m_currentPass >= m_passes.size())
+	{
+		return(false);
+	}
+
+	PASS_RESULT& pass = m_passes[m_currentPass];
+
+	// the GPU times of the last frames are read before they are
+	// measured, since the next pass would only read them later
+	profiler.ResolveQueries();
+
+	if (sceneManager.GetRenderPath() != pass.renderPath)
+	{
+		pass.status = PASS_SKIPPED;
+		pass.reason = "the render path is not supported";
+	}
+	else
+	{
+		MeasurePass(benchmark, profiler, pass);
+		CheckImage(benchmark, pass);
+		CheckBaseline(pass);
+		if (pass.status == PASS_PENDING)
+		{
+			pass.status = PASS_PASSED;
+		}
+	}
+
+	std::cout << "INFO: Regression pass " << pass.name << " " << GetStatusName(pass.status)
+		<< std::fixed << std::setprecision(3)
+		<< ", median " << pass.frameMedian << " ms, p95 " << pass.frameP95 << " ms, p99 " << pass.frameP99
+		<< " ms, " << pass.drawCalls << " draws, " << pass.differentPixels << " pixels changed"
+		<< (pass.reason.empty() ? "" : ", ") << pass.reason << std::endl;
+	std::cout.unsetf(std::ios::floatfield);
+
+	m_currentPass++;
+	if (m_currentPass >= m_passes.size())
+	{
+		if (false == WriteBaselines())
+		{
+			std::cout << "Could not write the regression baselines:" << GetGoldenPath("baseline", ".txt") << std::endl;
+		}
+		return(false);
+	}
+
+	m_passFirstFrame = profiler.GetFrames().size();
+	sceneManager.SetRenderPath(m_passes[m_currentPass].renderPath);
+	std::cout << "INFO: Regression pass " << m_passes[m_currentPass].name << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  MeasurePass()
+ *
+ *  This method is used for summarizing the frames of the
+ *  current pass that follow its warm up frames.
+ ***********************************************************/
+void RegressionSuite::MeasurePass(const Benchmark& benchmark, const FrameProfiler& profiler, PASS_RESULT& pass) const
+{
+	const std::vector<FrameProfiler::FRAME_STATS>& frames = profiler.GetFrames();
+	std::vector<double> frameTimes;
+	std::vector<double> sceneGpuTimes;
+	double drawCalls = 0.0;
+	double triangles = 0.0;
+
+	for (size_t i = m_passFirstFrame + (size_t)benchmark.GetWarmupFrameCount(); i < frames.size(); i++)
+	{
+		frameTimes.push_back(frames[i].frameMilliseconds);
+		sceneGpuTimes.push_back(frames[i].gpuMilliseconds[FrameProfiler::SCOPE_SCENE]);
+		drawCalls += frames[i].counters.drawCalls;
+		triangles += frames[i].counters.triangles;
+	}
+
+	pass.frameCount = frameTimes.size();
+	pass.frameMedian = GetPercentile(frameTimes, 0.50);
+	pass.frameP95 = GetPercentile(frameTimes, 0.95);
+	pass.frameP99 = GetPercentile(frameTimes, 0.99);
+	pass.sceneGpuMedian = GetPercentile(sceneGpuTimes, 0.50);
+	pass.drawCalls = (pass.frameCount > 0) ? (drawCalls / (double)pass.frameCount) : 0.0;
+	pass.triangles = (pass.frameCount > 0) ? (triangles / (double)pass.frameCount) : 0.0;
+	pass.gpuMemoryKilobytes = QueryGpuMemoryKilobytes();
+}
+
+/***********************************************************
+ *  CheckImage()
+ *
+ *  This method is used for comparing the last frame of the
+ *  pass with its golden image.  A missing golden image is
+ *  recorded from the frame, while one that is there but can
+ *  not be read fails the pass until it is recorded again
+ *  with --regression-update.  A changed frame is written
+ *  next to the golden one so the two can be looked at.
+ ***********************************************************/
+void RegressionSuite::CheckImage(const Benchmark& benchmark, PASS_RESULT& pass) const
+{
+	std::vector<unsigned char> pixels;
+	std::vector<unsigned char> goldenPixels;
+	std::string goldenPath = GetGoldenPath(pass.name, ".ppm");
+	int goldenWidth = 0;
+	int goldenHeight = 0;
+
+	benchmark.ReadPixels(pixels);
+
+	if ((true == m_bUpdateGoldens) || (false == std::ifstream(goldenPath.c_str(), std::ios::binary).is_open()))
+	{
+		if (false == WriteImage(goldenPath, benchmark.GetWidth(), benchmark.GetHeight(), pixels))
+		{
+			pass.status = PASS_FAILED;
+			pass.reason = "could not write the golden image " + goldenPath;
+			return;
+		}
+		pass.status = PASS_RECORDED;
+		return;
+	}
+
+	if (false == ReadImage(goldenPath, goldenWidth, goldenHeight, goldenPixels))
+	{
+		pass.status = PASS_FAILED;
+		pass.reason = "could not read the golden image " + goldenPath + ", run with --regression-update to record it again";
+		return;
+	}
+
+	if ((goldenWidth != benchmark.GetWidth()) || (goldenHeight != benchmark.GetHeight()))
+	{
+		std::ostringstream reason;
+
+		reason << "the golden image is " << goldenWidth << " x " << goldenHeight << " instead of "
+			<< benchmark.GetWidth() << " x " << benchmark.GetHeight();
+		pass.status = PASS_FAILED;
+		pass.reason = reason.str();
+		return;
+	}
+
+	for (size_t i = 0; i < pixels.size(); i += 3)
+	{
+		int difference = 0;
+
+		for (size_t channel = 0; channel < 3; channel++)
+		{
+			difference = std::max(difference, std::abs((int)pixels[i + channel] - (int)goldenPixels[i + channel]));
+		}
+		pass.maximumDifference = std::max(pass.maximumDifference, difference);
+		if (difference > PIXEL_TOLERANCE)
+		{
+			pass.differentPixels++;
+		}
+	}
+
+	if ((double)pass.differentPixels > MAX_DIFFERENT_PIXEL_FRACTION * (double)(pixels.size() / 3))
+	{
+		std::string failedPath = GetGoldenPath(pass.name, "_failed.ppm");
+
+		WriteImage(failedPath, benchmark.GetWidth(), benchmark.GetHeight(), pixels);
+		pass.status = PASS_FAILED;
+		pass.reason = "the frame differs from the golden image, written to " + failedPath;
+	}
+}
+
+/***********************************************************
+ *  CheckBaseline()
+ *
+ *  This method is used for comparing the median frame time
+ *  of the pass with its baseline, which the median is the
+ *  steadiest of.  A pass without a baseline, or one that is
+ *  being updated, becomes the baseline.
+ ***********************************************************/
+void RegressionSuite::CheckBaseline(PASS_RESULT& pass)
+{
+	BASELINE* pBaseline = NULL;
+
+	for (size_t i = 0; i < m_baselines.size(); i++)
+	{
+		if (m_baselines[i].name == pass.name)
+		{
+			pBaseline = &m_baselines[i];
+		}
+	}
+
+	if ((NULL == pBaseline) || (true == m_bUpdateGoldens))
+	{
+		if (NULL == pBaseline)
+		{
+			m_baselines.push_back(BASELINE());
+			pBaseline = &m_baselines.back();
+		}
+		pBaseline->name = pass.name;
+		pBaseline->frameMedian = pass.frameMedian;
+		pBaseline->frameP95 = pass.frameP95;
+		pBaseline->frameP99 = pass.frameP99;
+		pBaseline->drawCalls = pass.drawCalls;
+		if (pass.status == PASS_PENDING)
+		{
+			pass.status = PASS_RECORDED;
+		}
+		return;
+	}
+
+	if (pass.drawCalls > pBaseline->drawCalls)
+	{
+		std::cout << "INFO: Regression pass " << pass.name << " makes " << pass.drawCalls
+			<< " draw calls, the baseline made " << pBaseline->drawCalls << std::endl;
+	}
+
+	double limit = pBaseline->frameMedian * (1.0 + m_slowdownPercent / 100.0);
+	if (pass.frameMedian > limit)
+	{
+		std::ostringstream reason;
+
+		reason << std::fixed << std::setprecision(3) << "the median frame time is " << pass.frameMedian
+			<< " ms, more than " << m_slowdownPercent << "% over the baseline of " << pBaseline->frameMedian << " ms";
+		if (!pass.reason.empty())
+		{
+			pass.reason += ", and ";
+		}
+		pass.reason += reason.str();
+		pass.status = PASS_FAILED;
+	}
+}
+
+/***********************************************************
+ *  ReadBaselines()
+ *
+ *  This method is used for reading the baselines of the scene,
+ *  one pass per line: "name median p95 p99 drawCalls".  No
+ *  file means no baselines have been recorded yet.
+ ***********************************************************/
+bool RegressionSuite::ReadBaselines()
+{
+	std::string filename = GetGoldenPath("baseline", ".txt");
+	std::ifstream file(filename.c_str());
+	std::string line;
+	int lineNumber = 0;
+
+	m_baselines.clear();
+	if (!file.is_open())
+	{
+		return(true);
+	}
+
+	while (std::getline(file, line))
+	{
+		std::istringstream values(line);
+		BASELINE baseline;
+
+		lineNumber++;
+		if (!(values >> baseline.name) || (baseline.name[0] == '#'))
+		{
+			continue;
+		}
+
+		if (!(values >> baseline.frameMedian >> baseline.frameP95 >> baseline.frameP99 >> baseline.drawCalls))
+		{
+			std::cout << "Invalid regression baseline on line " << lineNumber << " of " << filename << std::endl;
+			return(false);
+		}
+		m_baselines.push_back(baseline);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteBaselines()
+ *
+ *  This method is used for writing the baselines of the scene
+ *  after the last pass, keeping those of the passes that were
+ *  not run.
+ ***********************************************************/
+bool RegressionSuite::WriteBaselines() const
+{
+	std::ofstream file(GetGoldenPath("baseline", ".txt").c_str(), std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	file << "# render path, median, p95 and p99 frame milliseconds, draw calls per frame\n";
+	file << std::fixed << std::setprecision(4);
+	for (size_t i = 0; i < m_baselines.size(); i++)
+	{
+		const BASELINE& baseline = m_baselines[i];
+
+		file << baseline.name << " " << baseline.frameMedian << " " << baseline.frameP95 << " "
+			<< baseline.frameP99 << " " << baseline.drawCalls << "\n";
+	}
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  WriteResults()
+ *
+ *  This method is used for writing what every pass measured
+ *  and how it compared as JSON, with the times in
+ *  milliseconds.
+ ***********************************************************/
+bool RegressionSuite::WriteResults(const char* filename) const
+{
+	std::ofstream file(filename);
+
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	file << std::fixed << std::setprecision(4);
+	file << "{\n";
+	file << "  \"scene\": \"" << m_sceneName << "\",\n";
+	file << "  \"slowdown_percent\": " << m_slowdownPercent << ",\n";
+	file << "  \"passed\": " << (HasFailed() ? "false" : "true") << ",\n";
+	file << "  \"passes\": [\n";
+
+	for (size_t i = 0; i < m_passes.size(); i++)
+	{
+		const PASS_RESULT& pass = m_passes[i];
+
+		file << "    {\n";
+		file << "      \"render_path\": \"" << pass.name << "\",\n";
+		file << "      \"status\": \"" << GetStatusName(pass.status) << "\",\n";
+		file << "      \"reason\": \"" << pass.reason << "\",\n";
+		file << "      \"frames\": " << pass.frameCount << ",\n";
+		file << "      \"frame_ms\": { \"p50\": " << pass.frameMedian << ", \"p95\": " << pass.frameP95
+			<< ", \"p99\": " << pass.frameP99 << " },\n";
+		file << "      \"scene_gpu_ms_p50\": " << pass.sceneGpuMedian << ",\n";
+		file << "      \"draw_calls\": " << pass.drawCalls << ",\n";
+		file << "      \"triangles\": " << pass.triangles << ",\n";
+		file << "      \"gpu_memory_kb\": " << pass.gpuMemoryKilobytes << ",\n";
+		file << "      \"different_pixels\": " << pass.differentPixels << ",\n";
+		file << "      \"max_channel_difference\": " << pass.maximumDifference << "\n";
+		file << "    }" << ((i + 1 < m_passes.size()) ? "," : "") << "\n";
+	}
+
+	file << "  ]\n";
+	file << "}\n";
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  HasFailed()
+ *
+ *  This method is used for checking whether any pass failed
+ *  or was never finished.
+ ***********************************************************/
+bool RegressionSuite::HasFailed() const
+{
+	for (size_t i = 0; i < m_passes.size(); i++)
+	{
+		if ((m_passes[i].status == PASS_FAILED) || (m_passes[i].status == PASS_PENDING))
+		{
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  WriteStressScene()
+ *
+ *  This method is used for writing a text scene with the
+ *  passed in number of untextured boxes and tori in a grid,
+ *  which share a few materials and colors so the batched and
+ *  instanced paths have long runs to merge.
+ ***********************************************************/
+bool RegressionSuite::WriteStressScene(const char* filename, int nodeCount)
+{
+	static const char* const materials[] = { "matteblack", "polishwhite", "plastic" };
+	static const char* const colors[] = { "0.8 0.2 0.2 1", "0.2 0.6 0.9 1", "0.9 0.8 0.3 1", "0.6 0.6 0.6 1" };
+	std::ofstream file(filename, std::ios::trunc);
+	int columns = 1;
+
+	if ((nodeCount <= 0) || (nodeCount > MAX_STRESS_NODES) || !file.is_open())
+	{
+		return(false);
+	}
+
+	while (columns * columns < nodeCount)
+	{
+		columns++;
+	}
+
+	file << "# " << nodeCount << " boxes and tori written by the regression suite\n";
+	file << "material matteblack diffuse 0.1 0.1 0.1 specular 0.1 0.1 0.1 shininess 8\n";
+	file << "material polishwhite diffuse 0.95 0.95 0.95 specular 0.5 0.5 0.5 shininess 32\n";
+	file << "material plastic diffuse 0.15 0.15 0.15 specular 0.3 0.3 0.3 shininess 16\n";
+	file << "directional direction 0.2 -0.6 -0.5 ambient 0.1 0.1 0.1 diffuse 0.8 0.8 0.8 specular 0.2 0.2 0.2\n";
+	file << "point position 0 3 -3 ambient 0.05 0.05 0.05 diffuse 1 1 1 specular 0.2 0.2 0.2\n";
+	file << "node plane scale " << columns * STRESS_SPACING << " 1 " << columns * STRESS_SPACING
+		<< " rotation 0 0 0 position 0 0 " << STRESS_START_Z - columns * STRESS_SPACING * 0.5f
+		<< " material matteblack occluder\n";
+
+	for (int i = 0; i < nodeCount; i++)
+	{
+		int row = i / columns;
+		int column = i % columns;
+		float x = ((float)column - (float)(columns - 1) * 0.5f) * STRESS_SPACING;
+		float z = STRESS_START_Z - (float)row * STRESS_SPACING;
+		bool bTorus = ((row + column) % 2) != 0;
+
+		if (bTorus)
+		{
+			file << "node torus scale 0.1 0.1 0.1 rotation 90 " << (i * 37) % 360 << " 0";
+		}
+		else
+		{
+			file << "node box scale 0.15 0.15 0.15 rotation 0 " << (i * 53) % 360 << " 0";
+		}
+		file << " position " << x << " 0.1 " << z
+			<< " material " << materials[i % 3]
+			<< " color " << colors[(i / 3) % 4] << "\n";
+	}
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  MakeDirectory()
+ *
+ *  This method is used for making a directory along with any
+ *  of its parents that are missing, which is not an error
+ *  when they are already there.
+ ***********************************************************/
+bool RegressionSuite::MakeDirectory(const char* path)
+{
+	std::string directory = path;
+
+	for (size_t i = 1; i <= directory.size(); i++)
+	{
+		// make every parent in turn, skipping the root and a
+		// drive letter which can not be made
+		if ((i < directory.size()) && (directory[i] != '/') && (directory[i] != '\\'))
+		{
+			continue;
+		}
+		if (directory[i - 1] == ':')
+		{
+			continue;
+		}
+
+		std::string parent = directory.substr(0, i);
+#ifdef _WIN32
+		struct _stat info;
+
+		if ((_stat(parent.c_str(), &info) == 0) && ((info.st_mode & _S_IFDIR) != 0))
+		{
+			continue;
+		}
+		if (_mkdir(parent.c_str()) != 0)
+		{
+			return(false);
+		}
+#else
+		struct stat info;
+
+		if ((stat(parent.c_str(), &info) == 0) && S_ISDIR(info.st_mode))
+		{
+			continue;
+		}
+		if (mkdir(parent.c_str(), 0755) != 0)
+		{
+			return(false);
+		}
+#endif
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetGoldenPath()
+ *
+ *  This method is used for getting the path of a golden file
+ *  of the scene.
+ ***********************************************************/
+std::string RegressionSuite::GetGoldenPath(const std::string& name, const char* suffix) const
+{
+	return(m_goldenDirectory + "/" + m_sceneName + "_" + name + suffix);
+}
+
+/***********************************************************
+ *  ReadImage()
+ *
+ *  This method is used for reading a binary PPM image with
+ *  8-bit channels, stored from the bottom row up like the
+ *  pixels that are read back.
+ ***********************************************************/
+bool RegressionSuite::ReadImage(const std::string& filename, int& width, int& height, std::vector<unsigned char>& pixels)
+{
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	std::string magic;
+	int maximum = 0;
+
+	if (!file.is_open() || !(file >> magic >> width >> height >> maximum) ||
+		(magic != "P6") || (width <= 0) || (height <= 0) || (maximum != 255))
+	{
+		return(false);
+	}
+
+	// a single white space ends the header
+	file.get();
+	pixels.resize((size_t)width * (size_t)height * 3);
+	file.read((char*)&pixels[0], pixels.size());
+
+	return(file.gcount() == (std::streamsize)pixels.size());
+}
+
+/***********************************************************
+ *  WriteImage()
+ *
+ *  This method is used for writing a binary PPM image, which
+ *  needs no library and opens in most image viewers.
+ ***********************************************************/
+bool RegressionSuite::WriteImage(const std::string& filename, int width, int height, const std::vector<unsigned char>& pixels)
+{
+	std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open() || (pixels.size() != (size_t)width * (size_t)height * 3))
+	{
+		return(false);
+	}
+
+	file << "P6\n" << width << " " << height << "\n255\n";
+	file.write((const char*)&pixels[0], pixels.size());
+
+	return(file.good());
+}
+
+/***********************************************************
+ *  GetPercentile()
+ *
+ *  This method is used for getting the nearest rank
+ *  percentile of the passed in times, so it is always one of
+ *  the times.  Negative times were not measured and are left
+ *  out, and without any time it is negative too.
+ ***********************************************************/
+double RegressionSuite::GetPercentile(std::vector<double> times, double percentile)
+{
+	times.erase(std::remove_if(times.begin(), times.end(),
+		[](double time) { return(time < 0.0); }), times.end());
+	if (times.empty())
+	{
+		return(-1.0);
+	}
+
+	std::sort(times.begin(), times.end());
+	size_t rank = (size_t)std::ceil(percentile * (double)times.size());
+
+	return(times[(rank > 0) ? (rank - 1) : 0]);
+}
+
+/***********************************************************
+ *  QueryGpuMemoryKilobytes()
+ *
+ *  This method is used for getting the video memory in use,
+ *  which only the NVIDIA memory info extension reports; the
+ *  AMD one only reports what is free.
+ ***********************************************************/
+double RegressionSuite::QueryGpuMemoryKilobytes()
+{
+	GLint totalKilobytes = 0;
+	GLint availableKilobytes = 0;
+
+	if (GL_TRUE != glewIsSupported("GL_NVX_gpu_memory_info"))
+	{
+		return(-1.0);
+	}
+
+	glGetIntegerv(GL_GPU_MEMORY_INFO_TOTAL_AVAILABLE_MEMORY_NVX, &totalKilobytes);
+	glGetIntegerv(GL_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, &availableKilobytes);
+
+	return((double)(totalKilobytes - availableKilobytes));
+}
+
+/***********************************************************
+ *  GetStatusName()
+ *
+ *  This method is used for getting the name of a pass status
+ *  for the results.
+ ***********************************************************/
+const char* RegressionSuite::GetStatusName(PASS_STATUS status)
+{
+	switch (status)
+	{
+	case PASS_PASSED:
+		return("passed");
+	case PASS_FAILED:
+		return("failed");
+	case PASS_RECORDED:
+		return("recorded");
+	case PASS_SKIPPED:
+		return("skipped");
+	default:
+		return("pending");
+	}
+}
@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+// regressionsuite.h
+// ============
+// run the benchmark on every render path and check it against golden results
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Benchmark.h"
+#include "FrameProfiler.h"
+#include "SceneManager.h"
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  RegressionSuite
+ *
+ *  This class replays the benchmark camera path once for each
+ *  render path.  Every pass records the percentiles of its
+ *  frame times, its draw calls and the video memory in use,
+ *  and the last frame of the pass is compared with the golden
+ *  image of its path.  A pass fails when more than a few of
+ *  its pixels differ from the golden image, or when its
+ *  median frame time is slower than the recorded baseline by
+ *  more than a threshold.  The golden images and baselines
+ *  are recorded by the first run of a scene, or again when
+ *  they are asked to be updated.
+ ***********************************************************/
+class RegressionSuite
+{
+public:
+	// constructor
+	RegressionSuite();
+
+	// set where the golden images and baselines of the scene are
+	// kept, and how much slower a pass may be than its baseline
+	bool Initialize(
+		const char* goldenDirectory,
+		const std::string& sceneFile,
+		double slowdownPercent,
+		bool bUpdateGoldens);
+	// add a render path to check, in the order they are run
+	void AddPass(SceneManager::RENDER_PATH renderPath, const char* name);
+
+	// switch the scene to the render path of the first pass
+	void BeginFirstPass(SceneManager& sceneManager, const FrameProfiler& profiler);
+	// check the pass that the benchmark just finished, and switch
+	// to the next render path, returning false after the last one
+	bool EndPass(const Benchmark& benchmark, FrameProfiler& profiler, SceneManager& sceneManager);
+
+	// write the results of every pass as JSON
+	bool WriteResults(const char* filename) const;
+	// whether any pass failed
+	bool HasFailed() const;
+
+	// most nodes of a stress scene, which keeps the sequence
+	// numbers of the sort keys unique
+	static const int MAX_STRESS_NODES = 60000;
+
+	// write a text scene of instanced boxes and tori for
+	// stressing the render paths
+	static bool WriteStressScene(const char* filename, int nodeCount);
+	// make the golden directory and its parents when they do
+	// not exist
+	static bool MakeDirectory(const char* path);
+
+private:
+	// outcome of one pass
+	enum PASS_STATUS
+	{
+		PASS_PENDING = 0,
+		PASS_PASSED,
+		PASS_FAILED,
+		// nothing was recorded yet, so the pass became the golden
+		PASS_RECORDED,
+		// the render path is not supported by the context
+		PASS_SKIPPED
+	};
+
+	// timings the frame times of a pass are compared with
+	struct BASELINE
+	{
+		std::string name;
+		double frameMedian;
+		double frameP95;
+		double frameP99;
+		double drawCalls;
+	};
+
+	// everything measured for one render path
+	struct PASS_RESULT
+	{
+		SceneManager::RENDER_PATH renderPath;
+		std::string name;
+		PASS_STATUS status;
+		std::string reason;
+		size_t frameCount;
+		double frameMedian;
+		double frameP95;
+		double frameP99;
+		// GPU time of the scene, negative when not available
+		double sceneGpuMedian;
+		double drawCalls;
+		double triangles;
+		// video memory in use at the end of the pass in kilobytes,
+		// negative when the driver does not report it
+		double gpuMemoryKilobytes;
+		// pixels of the last frame that differ from the golden
+		// image, and the largest difference of a channel
+		size_t differentPixels;
+		int maximumDifference;
+	};
+
+	std::string m_goldenDirectory;
+	// name of the scene file without its directory or extension,
+	// which starts the names of the golden files
+	std::string m_sceneName;
+	double m_slowdownPercent;
+	bool m_bUpdateGoldens;
+	std::vector<PASS_RESULT> m_passes;
+	std::vector<BASELINE> m_baselines;
+	size_t m_currentPass;
+	// first profiler frame of the current pass
+	size_t m_passFirstFrame;
+
+	// measure the frames of the current pass
+	void MeasurePass(const Benchmark& benchmark, const FrameProfiler& profiler, PASS_RESULT& pass) const;
+	// compare the last frame with the golden image of its pass
+	void CheckImage(const Benchmark& benchmark, PASS_RESULT& pass) const;
+	// compare the timings with the baseline of the pass
+	void CheckBaseline(PASS_RESULT& pass);
+
+	// read and write the baselines of the scene
+	bool ReadBaselines();
+	bool WriteBaselines() const;
+	std::string GetGoldenPath(const std::string& name, const char* suffix) const;
+
+	// read and write binary PPM images
+	static bool ReadImage(const std::string& filename, int& width, int& height, std::vector<unsigned char>& pixels);
+	static bool WriteImage(const std::string& filename, int width, int height, const std::vector<unsigned char>& pixels);
+	// nearest rank percentile of the passed in times, skipping
+	// the negative ones
+	static double GetPercentile(std::vector<double> times, double percentile);
+	// video memory in use, from the memory info extensions
+	static double QueryGpuMemoryKilobytes();
+	static const char* GetStatusName(PASS_STATUS status);
+};
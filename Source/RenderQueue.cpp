@@ -0,0 +1,276 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.cpp
+// ===============
+// collect the draw items of a frame and sort them to minimize state changes
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+// declaration of the sort key layout
+namespace
+{
+	// bit 63 - transparent, bits 56-62 - program, bits 40-55 - mesh,
+	// bits 24-39 - texture, bits 16-23 - material, bits 0-15 - sequence
+	// the material block holds far fewer materials than the mesh
+	// library holds meshes with all their levels of detail, so the
+	// mesh field takes the bits the material does not need
+	const int TRANSPARENT_SHIFT = 63;
+	const int PROGRAM_SHIFT = 56;
+	const int MESH_SHIFT = 40;
+	const int TEXTURE_SHIFT = 24;
+	const int MATERIAL_SHIFT = 16;
+	const uint64_t PROGRAM_MASK = 0x7F;
+	const uint64_t MESH_MASK = RenderQueue::MAX_MESH_COUNT - 1;
+	const uint64_t TEXTURE_MASK = 0xFFFF;
+	const uint64_t MATERIAL_MASK = 0xFF;
+	const uint64_t SEQUENCE_MASK = 0xFFFF;
+
+	bool CompareSortKeys(const RenderQueue::DRAW_ITEM& a, const RenderQueue::DRAW_ITEM& b)
+	{
+		// the farthest transparent item is blended first
+		if ((true == RenderQueue::IsTransparent(a.sortKey)) && (true == RenderQueue::IsTransparent(b.sortKey)) &&
+			(a.viewDepth != b.viewDepth))
+		{
+			return(a.viewDepth > b.viewDepth);
+		}
+
+		return(a.sortKey < b.sortKey);
+	}
+
+	bool IsOpaqueItem(const RenderQueue::DRAW_ITEM& item)
+	{
+		return(false == RenderQueue::IsTransparent(item.sortKey));
+	}
+}
+
+/***********************************************************
+ *  RenderQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderQueue::RenderQueue()
+{
+}
+
+/***********************************************************
+ *  BuildSortKey()
+ *
+ *  This method is used for packing the draw state of an item
+ *  into its sort key.  Texture and material handles are
+ *  stored off by one, so that no texture or material (-1)
+ *  sorts ahead of all the valid handles.
+ ***********************************************************/
+uint64_t RenderQueue::BuildSortKey(
+	bool bTransparent,
+	int program,
+	int mesh,
+	int texture,
+	int material,
+	uint32_t sequence)
+{
+	uint64_t sortKey = 0;
+
+	sortKey |= (uint64_t)(bTransparent ? 1 : 0) << TRANSPARENT_SHIFT;
+	sortKey |= ((uint64_t)program & PROGRAM_MASK) << PROGRAM_SHIFT;
+	sortKey |= ((uint64_t)mesh & MESH_MASK) << MESH_SHIFT;
+	sortKey |= ((uint64_t)(texture + 1) & TEXTURE_MASK) << TEXTURE_SHIFT;
+	sortKey |= ((uint64_t)(material + 1) & MATERIAL_MASK) << MATERIAL_SHIFT;
+	sortKey |= (uint64_t)sequence & SEQUENCE_MASK;
+
+	return(sortKey);
+}
+
+/***********************************************************
+ *  IsTransparent()
+ *
+ *  This method is used for checking the transparency bit of
+ *  the passed in sort key.
+ ***********************************************************/
+bool RenderQueue::IsTransparent(uint64_t sortKey)
+{
+	return(((sortKey >> TRANSPARENT_SHIFT) & 1) != 0);
+}
+
+/***********************************************************
+ *  GetProgram()
+ *
+ *  This method is used for getting the program stored in the
+ *  passed in sort key.
+ ***********************************************************/
+int RenderQueue::GetProgram(uint64_t sortKey)
+{
+	return((int)((sortKey >> PROGRAM_SHIFT) & PROGRAM_MASK));
+}
+
+/***********************************************************
+ *  GetMesh()
+ *
+ *  This method is used for getting the mesh stored in the
+ *  passed in sort key.
+ ***********************************************************/
+int RenderQueue::GetMesh(uint64_t sortKey)
+{
+	return((int)((sortKey >> MESH_SHIFT) & MESH_MASK));
+}
+
+/***********************************************************
+ *  GetTexture()
+ *
+ *  This method is used for getting the texture handle stored
+ *  in the passed in sort key.
+ ***********************************************************/
+int RenderQueue::GetTexture(uint64_t sortKey)
+{
+	return((int)((sortKey >> TEXTURE_SHIFT) & TEXTURE_MASK) - 1);
+}
+
+/***********************************************************
+ *  GetMaterial()
+ *
+ *  This method is used for getting the material handle stored
+ *  in the passed in sort key.
+ ***********************************************************/
+int RenderQueue::GetMaterial(uint64_t sortKey)
+{
+	return((int)((sortKey >> MATERIAL_SHIFT) & MATERIAL_MASK) - 1);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all the queued items.
+ *  The memory of the queue is kept for the next frame.
+ ***********************************************************/
+void RenderQueue::Clear()
+{
+	m_items.clear();
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method is used for removing all the queued items and
+ *  taking the memory of the next ones from the passed in frame
+ *  arena.  The memory of the old items is never touched again,
+ *  so this is called after the arena has been reset.
+ ***********************************************************/
+void RenderQueue::Reset(FrameArena* pArena, size_t capacity)
+{
+	m_items = FrameVector<DRAW_ITEM>(FrameAllocator<DRAW_ITEM>(pArena));
+	m_items.reserve(capacity);
+}
+
+/***********************************************************
+ *  AddItem()
+ *
+ *  This method is used for queueing a draw item for the
+ *  passed in scene node.
+ ***********************************************************/
+void RenderQueue::AddItem(uint64_t sortKey, uint32_t nodeIndex, float viewDepth)
+{
+	DRAW_ITEM item;
+
+	item.sortKey = sortKey;
+	item.nodeIndex = nodeIndex;
+	item.viewDepth = viewDepth;
+	m_items.push_back(item);
+}
+
+/***********************************************************
+ *  Sort()
+ *
+ *  This method is used for ordering the queued items by
+ *  their sort key.  The transparency bit puts the transparent
+ *  items last, and among them the view depth comes first, so
+ *  they are blended from the back to the front.
+ ***********************************************************/
+void RenderQueue::Sort()
+{
+	std::sort(m_items.begin(), m_items.end(), CompareSortKeys);
+}
+
+/***********************************************************
+ *  SortTransparent()
+ *
+ *  This method is used for ordering only what blending needs,
+ *  for a queue that is otherwise drawn in the order it was
+ *  built.  The opaque items keep their order in front of the
+ *  transparent ones, which are sorted back to front.
+ ***********************************************************/
+void RenderQueue::SortTransparent()
+{
+	FrameVector<DRAW_ITEM>::iterator firstTransparent =
+		std::stable_partition(m_items.begin(), m_items.end(), IsOpaqueItem);
+
+	std::sort(firstTransparent, m_items.end(), CompareSortKeys);
+}
+
+/***********************************************************
+ *  GetOpaqueCount()
+ *
+ *  This method is used for counting the items that are not
+ *  transparent.  After Sort() they are the first items of the
+ *  queue, so the count is also where the transparent ones start.
+ ***********************************************************/
+size_t RenderQueue::GetOpaqueCount() const
+{
+	size_t opaqueCount = 0;
+
+	for (size_t i = 0; i < m_items.size(); i++)
+	{
+		if (false == IsTransparent(m_items[i].sortKey))
+		{
+			opaqueCount++;
+		}
+	}
+
+	return(opaqueCount);
+}
+
+/***********************************************************
+ *  CountStateChanges()
+ *
+ *  This method is used for counting how often the program,
+ *  the mesh, the texture and the material change when the
+ *  queued items are submitted in their current order.
+ ***********************************************************/
+RenderQueue::QUEUE_STATS RenderQueue::CountStateChanges() const
+{
+	QUEUE_STATS stats;
+
+	stats.drawCount = (unsigned int)m_items.size();
+	stats.programChanges = 0;
+	stats.meshChanges = 0;
+	stats.textureChanges = 0;
+	stats.materialChanges = 0;
+	stats.triangleCount = 0;
+
+	for (size_t i = 0; i < m_items.size(); i++)
+	{
+		uint64_t sortKey = m_items[i].sortKey;
+
+		// the first item always needs all of its state set
+		if ((i == 0) || (GetProgram(sortKey) != GetProgram(m_items[i - 1].sortKey)))
+		{
+			stats.programChanges++;
+		}
+		if ((i == 0) || (GetMesh(sortKey) != GetMesh(m_items[i - 1].sortKey)))
+		{
+			stats.meshChanges++;
+		}
+		if ((i == 0) || (GetTexture(sortKey) != GetTexture(m_items[i - 1].sortKey)))
+		{
+			stats.textureChanges++;
+		}
+		if ((i == 0) || (GetMaterial(sortKey) != GetMaterial(m_items[i - 1].sortKey)))
+		{
+			stats.materialChanges++;
+		}
+	}
+
+	return(stats);
+}
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.h
+// ============
+// collect the draw items of a frame and sort them to minimize state changes
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameArena.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/***********************************************************
+ *  RenderQueue
+ *
+ *  This class collects one draw item per visible object and
+ *  sorts the items by a packed 64-bit key, so that draws
+ *  sharing a program, mesh, texture and material are
+ *  submitted next to each other and transparent draws come
+ *  last.  The transparent draws are blended over each other,
+ *  so they are ordered back to front by their view depth
+ *  instead of by their draw state.
+ ***********************************************************/
+class RenderQueue
+{
+public:
+	// one queued draw, referring to a node of the scene
+	struct DRAW_ITEM
+	{
+		uint64_t sortKey;
+		uint32_t nodeIndex;
+		// distance in front of the camera, which orders the
+		// transparent items
+		float viewDepth;
+	};
+
+	// state changes between consecutive items of the queue
+	struct QUEUE_STATS
+	{
+		unsigned int drawCount;
+		unsigned int programChanges;
+		unsigned int meshChanges;
+		unsigned int textureChanges;
+		unsigned int materialChanges;
+		// triangles drawn for the queue, which the queue cannot
+		// count itself because it does not know the meshes
+		unsigned int triangleCount;
+	};
+
+	// meshes the sort key tells apart, the mesh library holds
+	// no more than this
+	static const int MAX_MESH_COUNT = 1 << 16;
+
+	// constructor
+	RenderQueue();
+
+	// pack the draw state into a sort key, most significant
+	// field first: transparency, program, mesh, texture, material
+	// and finally a sequence number that keeps the sort stable
+	static uint64_t BuildSortKey(
+		bool bTransparent,
+		int program,
+		int mesh,
+		int texture,
+		int material,
+		uint32_t sequence);
+
+	// unpack the fields of a sort key
+	static bool IsTransparent(uint64_t sortKey);
+	static int GetProgram(uint64_t sortKey);
+	static int GetMesh(uint64_t sortKey);
+	static int GetTexture(uint64_t sortKey);
+	static int GetMaterial(uint64_t sortKey);
+
+	// remove all the queued items
+	void Clear();
+	// remove all the queued items, and keep the items of the
+	// next frame in the passed in arena with room for a count
+	void Reset(FrameArena* pArena, size_t capacity);
+	// queue a draw item for the passed in scene node
+	void AddItem(uint64_t sortKey, uint32_t nodeIndex, float viewDepth);
+	// order the queued items by their sort key, and the
+	// transparent ones back to front
+	void Sort();
+	// move the transparent items after the opaque ones, which
+	// keep their queued order, and order them back to front
+	void SortTransparent();
+
+	size_t GetItemCount() const { return(m_items.size()); }
+	const DRAW_ITEM& GetItem(size_t index) const { return(m_items[index]); }
+
+	// count the state changes needed to submit the queue in order
+	QUEUE_STATS CountStateChanges() const;
+	// number of opaque items, which come first once sorted
+	size_t GetOpaqueCount() const;
+
+private:
+	// the draw items queued for the frame
+	FrameVector<DRAW_ITEM> m_items;
+};
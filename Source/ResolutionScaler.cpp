@@ -0,0 +1,331 @@
+///////////////////////////////////////////////////////////////////////////////
+// resolutionscaler.cpp
+// ============
+// draw the scene at a scaled resolution that holds a target GPU frame time
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ResolutionScaler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+const float ResolutionScaler::MIN_SCALE = 0.5f;
+
+// declaration of global variables
+namespace
+{
+	// the scale moves in steps of this size, so a small change
+	// in the GPU time does not resize the targets of the view
+	const float SCALE_STEP = 0.05f;
+	// most the scale changes by at once
+	const float MAX_SCALE_CHANGE = 0.15f;
+	// the scale is picked for this part of the target time, which
+	// leaves room for the frames that take longer
+	const double FRAME_TIME_BUDGET = 0.9;
+	// the scale only rises once the time is under this part of
+	// the target, so it does not go back and forth
+	const double RAISE_THRESHOLD = 0.75;
+	// weight of a new frame in the smoothed GPU time
+	const double TIME_SMOOTHING = 0.2;
+	// frames measured at a scale before it is changed again
+	const int SETTLE_FRAMES = 8;
+}
+
+/***********************************************************
+ *  ResolutionScaler()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ResolutionScaler::ResolutionScaler()
+{
+	m_framebuffer = 0;
+	m_colorTexture = 0;
+	m_depthBuffer = 0;
+	m_targetWidth = 0;
+	m_targetHeight = 0;
+	m_outputWidth = 0;
+	m_outputHeight = 0;
+	m_renderWidth = 0;
+	m_renderHeight = 0;
+	m_scale = 1.0f;
+	m_maximumScale = 1.0f;
+	m_targetMilliseconds = 0.0;
+	m_averageMilliseconds = 0.0;
+	m_sampleCount = 0;
+	m_lastSampledFrame = 0;
+	m_scaleFrame = 0;
+	m_bHasSample = false;
+}
+
+/***********************************************************
+ *  ~ResolutionScaler()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ResolutionScaler::~ResolutionScaler()
+{
+	DestroyTarget();
+}
+
+/***********************************************************
+ *  SetMaximumScale()
+ *
+ *  This method is used for setting the scale that the scene
+ *  is drawn at, or the highest scale that a target frame
+ *  time can pick.
+ ***********************************************************/
+void ResolutionScaler::SetMaximumScale(float scale)
+{
+	m_maximumScale = std::min(std::max(scale, MIN_SCALE), 1.0f);
+	m_scale = m_maximumScale;
+	m_sampleCount = 0;
+	UpdateRenderSize();
+}
+
+/***********************************************************
+ *  SetTargetFrameTime()
+ *
+ *  This method is used for setting the GPU time of the scene
+ *  that the scale is picked to hold.  Zero keeps the scale at
+ *  its maximum.
+ ***********************************************************/
+void ResolutionScaler::SetTargetFrameTime(double milliseconds)
+{
+	m_targetMilliseconds = std::max(milliseconds, 0.0);
+	m_scale = m_maximumScale;
+	m_sampleCount = 0;
+	UpdateRenderSize();
+}
+
+/***********************************************************
+ *  SetOutputSize()
+ *
+ *  This method is used for setting the size of the window
+ *  framebuffer, which changes when the window is resized or
+ *  moved to a display of another pixel density.  The target
+ *  is made again at the new size when the scene is next drawn.
+ ***********************************************************/
+void ResolutionScaler::SetOutputSize(int width, int height)
+{
+	if ((width == m_outputWidth) && (height == m_outputHeight))
+	{
+		return;
+	}
+
+	m_outputWidth = width;
+	m_outputHeight = height;
+	UpdateRenderSize();
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for picking the scale of the next
+ *  frame.  Each frame that the profiler has read back is
+ *  taken once into a smoothed GPU time of the scene, leaving
+ *  out the frames still drawn at the previous scale.  The
+ *  shading work goes with the pixel count, so the scale that
+ *  meets the budget is the square root of the ratio of the
+ *  budget to the time.
+ ***********************************************************/
+void ResolutionScaler::Update(const FrameProfiler& profiler)
+{
+	const FrameProfiler::FRAME_STATS* pStats = NULL;
+	double milliseconds = 0.0;
+	float scale = m_scale;
+
+	if (m_targetMilliseconds <= 0.0)
+	{
+		return;
+	}
+
+	pStats = profiler.GetLatestCompleteFrame();
+	if ((NULL == pStats) || ((true == m_bHasSample) && (pStats->frameIndex <= m_lastSampledFrame)))
+	{
+		return;
+	}
+	m_lastSampledFrame = pStats->frameIndex;
+	m_bHasSample = true;
+
+	milliseconds = pStats->gpuMilliseconds[FrameProfiler::SCOPE_VIEW] + pStats->gpuMilliseconds[FrameProfiler::SCOPE_SCENE];
+	if ((pStats->frameIndex < m_scaleFrame) || (pStats->gpuMilliseconds[FrameProfiler::SCOPE_SCENE] < 0.0))
+	{
+		return;
+	}
+
+	m_averageMilliseconds = (m_sampleCount == 0) ? milliseconds :
+		(m_averageMilliseconds + (milliseconds - m_averageMilliseconds) * TIME_SMOOTHING);
+	m_sampleCount++;
+	if ((m_sampleCount < SETTLE_FRAMES) || (m_averageMilliseconds <= 0.0))
+	{
+		return;
+	}
+
+	if ((m_averageMilliseconds > m_targetMilliseconds) ||
+		(m_averageMilliseconds < m_targetMilliseconds * RAISE_THRESHOLD))
+	{
+		scale = m_scale * (float)std::sqrt(m_targetMilliseconds * FRAME_TIME_BUDGET / m_averageMilliseconds);
+		scale = std::min(std::max(scale, m_scale - MAX_SCALE_CHANGE), m_scale + MAX_SCALE_CHANGE);
+		scale = std::floor(scale / SCALE_STEP + 0.5f) * SCALE_STEP;
+		scale = std::min(std::max(scale, MIN_SCALE), m_maximumScale);
+	}
+
+	if (scale != m_scale)
+	{
+		m_scale = scale;
+		m_sampleCount = 0;
+		// the frame being recorded is the first at the new scale
+		m_scaleFrame = profiler.GetFrames().empty() ? 0 : profiler.GetFrames().back().frameIndex;
+		UpdateRenderSize();
+	}
+}
+
+/***********************************************************
+ *  UpdateRenderSize()
+ *
+ *  This method is used for setting the size the scene is
+ *  drawn at from the output size and the scale.
+ ***********************************************************/
+void ResolutionScaler::UpdateRenderSize()
+{
+	float scale = IsScaling() ? m_scale : 1.0f;
+
+	m_renderWidth = std::max((int)std::floor((float)m_outputWidth * scale + 0.5f), 1);
+	m_renderHeight = std::max((int)std::floor((float)m_outputHeight * scale + 0.5f), 1);
+}
+
+/***********************************************************
+ *  BeginScene()
+ *
+ *  This method is used for binding the target the scene is
+ *  drawn into and setting the viewport to the scaled size.
+ *  Only the part of the target that is drawn is cleared, so
+ *  the fill of a clear also follows the scale.  When the
+ *  target cannot be made the scene is drawn into the window.
+ ***********************************************************/
+void ResolutionScaler::BeginScene()
+{
+	if ((true == IsScaling()) && (true == CreateTarget()))
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		glViewport(0, 0, m_renderWidth, m_renderHeight);
+		glEnable(GL_SCISSOR_TEST);
+		glScissor(0, 0, m_renderWidth, m_renderHeight);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		glDisable(GL_SCISSOR_TEST);
+		return;
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, m_outputWidth, m_outputHeight);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+/***********************************************************
+ *  EndScene()
+ *
+ *  This method is used for stretching the drawn part of the
+ *  target over the whole window framebuffer with a bilinear
+ *  filter, and binding the window framebuffer at its full
+ *  size for the overlay.
+ ***********************************************************/
+void ResolutionScaler::EndScene()
+{
+	if ((true == IsScaling()) && (0 != m_framebuffer))
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		glBlitFramebuffer(
+			0, 0, m_renderWidth, m_renderHeight,
+			0, 0, m_outputWidth, m_outputHeight,
+			GL_COLOR_BUFFER_BIT, GL_LINEAR);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, m_outputWidth, m_outputHeight);
+}
+
+/***********************************************************
+ *  CreateTarget()
+ *
+ *  This method is used for making the offscreen target at
+ *  the output size, unless it already has that size.
+ ***********************************************************/
+bool ResolutionScaler::CreateTarget()
+{
+	if ((0 != m_framebuffer) && (m_targetWidth == m_outputWidth) && (m_targetHeight == m_outputHeight))
+	{
+		return(true);
+	}
+
+	DestroyTarget();
+	if ((m_outputWidth <= 0) || (m_outputHeight <= 0))
+	{
+		return(false);
+	}
+
+	glGenTextures(1, &m_colorTexture);
+	glBindTexture(GL_TEXTURE_2D, m_colorTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_outputWidth, m_outputHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_outputWidth, m_outputHeight);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_colorTexture, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+	if (GL_FRAMEBUFFER_COMPLETE != glCheckFramebufferStatus(GL_FRAMEBUFFER))
+	{
+		std::cout << "The scaled scene framebuffer is incomplete, drawing at the window size" << std::endl;
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		DestroyTarget();
+		m_scale = 1.0f;
+		m_maximumScale = 1.0f;
+		m_targetMilliseconds = 0.0;
+		UpdateRenderSize();
+		return(false);
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	m_targetWidth = m_outputWidth;
+	m_targetHeight = m_outputHeight;
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyTarget()
+ *
+ *  This method is used for freeing the offscreen target.
+ ***********************************************************/
+void ResolutionScaler::DestroyTarget()
+{
+	if (0 != m_framebuffer)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	if (0 != m_colorTexture)
+	{
+		glDeleteTextures(1, &m_colorTexture);
+		m_colorTexture = 0;
+	}
+	if (0 != m_depthBuffer)
+	{
+		glDeleteRenderbuffers(1, &m_depthBuffer);
+		m_depthBuffer = 0;
+	}
+	m_targetWidth = 0;
+	m_targetHeight = 0;
+}
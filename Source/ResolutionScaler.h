@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// resolutionscaler.h
+// ============
+// draw the scene at a scaled resolution that holds a target GPU frame time
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "FrameProfiler.h"
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  ResolutionScaler
+ *
+ *  This class draws the scene into an offscreen target at a
+ *  fraction of the window size, and stretches the result over
+ *  the window afterwards, so the shading runs for fewer pixels
+ *  on a large display.  The target is made at the full window
+ *  size and the scene only uses its lower left corner, so the
+ *  scale can change every few frames without the target being
+ *  made again.  With a target frame time the scale follows
+ *  the GPU time of the scene that the profiler reads back: it
+ *  drops as soon as the time is over the target, and only
+ *  rises again once the time is well under it, by steps large
+ *  enough that the other targets sized to the viewport are
+ *  seldom made again.  At a scale of one without a target the
+ *  scene is drawn straight into the window.
+ ***********************************************************/
+class ResolutionScaler
+{
+public:
+	// lowest scale, which halves the width and height
+	static const float MIN_SCALE;
+
+	// constructor
+	ResolutionScaler();
+	// destructor
+	~ResolutionScaler();
+
+	// set the scale the scene is drawn at, which is the highest
+	// one once a target frame time is set
+	void SetMaximumScale(float scale);
+	// set the GPU time in milliseconds that the scale is picked
+	// to hold, zero keeps the scale fixed
+	void SetTargetFrameTime(double milliseconds);
+	bool IsAdaptive() const { return(m_targetMilliseconds > 0.0); }
+
+	// set the size of the window framebuffer the scene is shown in
+	void SetOutputSize(int width, int height);
+	// pick the scale of the next frame from the GPU times of the
+	// latest frame that the profiler has read back
+	void Update(const FrameProfiler& profiler);
+
+	// bind the target the scene is drawn into at the current
+	// scale, set its viewport and clear it
+	void BeginScene();
+	// stretch the drawn scene over the window framebuffer and
+	// bind that for what is drawn over the scene
+	void EndScene();
+
+	float GetScale() const { return(m_scale); }
+	int GetRenderWidth() const { return(m_renderWidth); }
+	int GetRenderHeight() const { return(m_renderHeight); }
+
+private:
+	// offscreen target at the output size, made once it is used
+	GLuint m_framebuffer;
+	GLuint m_colorTexture;
+	GLuint m_depthBuffer;
+	int m_targetWidth;
+	int m_targetHeight;
+	// size of the window framebuffer, and of the scaled scene
+	int m_outputWidth;
+	int m_outputHeight;
+	int m_renderWidth;
+	int m_renderHeight;
+	float m_scale;
+	float m_maximumScale;
+	// GPU time to hold, and the smoothed time of the frames
+	// drawn since the scale last changed
+	double m_targetMilliseconds;
+	double m_averageMilliseconds;
+	int m_sampleCount;
+	// last frame read from the profiler, and the first frame
+	// drawn at the current scale
+	unsigned int m_lastSampledFrame;
+	unsigned int m_scaleFrame;
+	bool m_bHasSample;
+
+	// whether the scene goes through the offscreen target
+	bool IsScaling() const { return((m_scale < 1.0f) || (m_targetMilliseconds > 0.0)); }
+	// make the offscreen target at the output size
+	bool CreateTarget();
+	void DestroyTarget();
+	// set the scaled size of the scene from the scale
+	void UpdateRenderSize();
+};
@@ -0,0 +1,689 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenecooker.cpp
+// ============
+// cook a scene described in a text file into the binary scene format
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneCooker.h"
+#include "SceneFile.h"
+#include "TextureCache.h"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+// declaration of global variables
+namespace
+{
+	const char* const SOURCE_EXTENSION = ".scene";
+	const char* const COOKED_EXTENSION = ".scenebin";
+
+	// names of the meshes in the order of SceneFile::SCENE_MESH
+	const char* const g_MeshNames[SceneFile::SCENE_MESH_COUNT] =
+	{
+		"box",
+		"plane",
+		"cylinder",
+		"torus"
+	};
+
+	// the tables of a scene while it is being cooked
+	struct COOKED_SCENE
+	{
+		std::vector<SceneFile::TEXTURE_RECORD> textures;
+		std::vector<SceneFile::MESH_RECORD> meshes;
+		std::vector<SceneFile::MATERIAL_RECORD> materials;
+		std::vector<SceneFile::LIGHT_RECORD> lights;
+		std::vector<SceneFile::NODE_RECORD> nodes;
+		std::vector<std::string> textureNames;
+		std::vector<std::string> meshNames;
+		std::vector<std::string> materialNames;
+		// names referenced by each node and the line it is on,
+		// resolved once the whole file has been read
+		std::vector<std::string> nodeMeshes;
+		std::vector<std::string> nodeTextures;
+		std::vector<std::string> nodeMaterials;
+		std::vector<int> nodeLines;
+		// every name once, each one ending with a terminator
+		std::string strings;
+		std::map<std::string, uint32_t> stringOffsets;
+	};
+
+	/***********************************************************
+	 *  ReadSourceFile()
+	 *
+	 *  This function is used for reading a whole text scene.
+	 ***********************************************************/
+	bool ReadSourceFile(const char* sourcePath, std::string& text)
+	{
+		std::ifstream file(sourcePath, std::ios::binary);
+		std::ostringstream contents;
+
+		if (!file.is_open())
+		{
+			return(false);
+		}
+
+		contents << file.rdbuf();
+		text = contents.str();
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ReadValues()
+	 *
+	 *  This function is used for reading the passed in number of
+	 *  values that follow a keyword.
+	 ***********************************************************/
+	bool ReadValues(std::istringstream& values, float* pValues, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (!(values >> pValues[i]))
+			{
+				return(false);
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  AddString()
+	 *
+	 *  This function is used for adding a name to the string
+	 *  table, once however often it is used, and returning its
+	 *  offset.
+	 ***********************************************************/
+	uint32_t AddString(COOKED_SCENE& scene, const std::string& text)
+	{
+		std::map<std::string, uint32_t>::const_iterator found = scene.stringOffsets.find(text);
+		uint32_t offset = (uint32_t)scene.strings.size();
+
+		if (found != scene.stringOffsets.end())
+		{
+			return(found->second);
+		}
+
+		scene.strings.append(text);
+		scene.strings.push_back('\0');
+		scene.stringOffsets[text] = offset;
+
+		return(offset);
+	}
+
+	/***********************************************************
+	 *  FindName()
+	 *
+	 *  This function is used for getting the index of a name in
+	 *  a table, or NO_INDEX when it is not there.
+	 ***********************************************************/
+	int32_t FindName(const std::vector<std::string>& names, const std::string& name)
+	{
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			if (names[i] == name)
+			{
+				return((int32_t)i);
+			}
+		}
+
+		return(SceneFile::NO_INDEX);
+	}
+
+	/***********************************************************
+	 *  ParseTexture()
+	 *
+	 *  This function is used for reading a texture line.
+	 ***********************************************************/
+	bool ParseTexture(std::istringstream& values, COOKED_SCENE& scene)
+	{
+		SceneFile::TEXTURE_RECORD record;
+		std::string name;
+		std::string path;
+		std::string extra;
+
+		if (!(values >> name >> path) || (values >> extra) ||
+			(FindName(scene.textureNames, name) != SceneFile::NO_INDEX))
+		{
+			return(false);
+		}
+
+		record.nameOffset = AddString(scene, name);
+		record.pathOffset = AddString(scene, path);
+		scene.textures.push_back(record);
+		scene.textureNames.push_back(name);
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ParseMesh()
+	 *
+	 *  This function is used for reading a mesh line.  A mesh
+	 *  cannot take the name of one of the primitive meshes.
+	 ***********************************************************/
+	bool ParseMesh(std::istringstream& values, COOKED_SCENE& scene)
+	{
+		SceneFile::MESH_RECORD record;
+		std::string name;
+		std::string path;
+		std::string extra;
+
+		if (!(values >> name >> path) || (values >> extra) ||
+			(FindName(scene.meshNames, name) != SceneFile::NO_INDEX))
+		{
+			return(false);
+		}
+		for (uint32_t mesh = 0; mesh < SceneFile::SCENE_MESH_COUNT; mesh++)
+		{
+			if (name == g_MeshNames[mesh])
+			{
+				return(false);
+			}
+		}
+
+		record.nameOffset = AddString(scene, name);
+		record.pathOffset = AddString(scene, path);
+		scene.meshes.push_back(record);
+		scene.meshNames.push_back(name);
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ParseMaterial()
+	 *
+	 *  This function is used for reading a material line.
+	 ***********************************************************/
+	bool ParseMaterial(std::istringstream& values, COOKED_SCENE& scene)
+	{
+		SceneFile::MATERIAL_RECORD record;
+		std::string name;
+		std::string keyword;
+
+		memset(&record, 0, sizeof(record));
+		record.opacity = 1.0f;
+		if (!(values >> name) || (FindName(scene.materialNames, name) != SceneFile::NO_INDEX))
+		{
+			return(false);
+		}
+
+		while (values >> keyword)
+		{
+			bool bValid = false;
+
+			if (keyword == "diffuse")
+			{
+				bValid = ReadValues(values, record.diffuse, 3);
+			}
+			else if (keyword == "specular")
+			{
+				bValid = ReadValues(values, record.specular, 3);
+			}
+			else if (keyword == "shininess")
+			{
+				bValid = ReadValues(values, &record.shininess, 1);
+			}
+			else if (keyword == "opacity")
+			{
+				bValid = ReadValues(values, &record.opacity, 1) && (record.opacity >= 0.0f) && (record.opacity <= 1.0f);
+			}
+
+			if (false == bValid)
+			{
+				return(false);
+			}
+		}
+
+		record.nameOffset = AddString(scene, name);
+		scene.materials.push_back(record);
+		scene.materialNames.push_back(name);
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ParseLight()
+	 *
+	 *  This function is used for reading a light line of the
+	 *  passed in type.  The directional light has a direction
+	 *  where the others have a position, and the local lights
+	 *  have one color and an intensity where the lights of the
+	 *  light block have their three colors.  The spot light also
+	 *  has a direction, its cut off angles and its attenuation.
+	 ***********************************************************/
+	bool ParseLight(std::istringstream& values, SceneFile::SCENE_LIGHT type, COOKED_SCENE& scene)
+	{
+		SceneFile::LIGHT_RECORD record;
+		const char* vectorName = (type == SceneFile::SCENE_LIGHT_DIRECTIONAL) ? "direction" : "position";
+		bool bLocal = (type == SceneFile::SCENE_LIGHT_LOCAL);
+		bool bSpot = (type == SceneFile::SCENE_LIGHT_SPOT);
+		std::string keyword;
+
+		memset(&record, 0, sizeof(record));
+		record.type = type;
+		record.intensity = 1.0f;
+		record.attenuation[0] = 1.0f;
+
+		while (values >> keyword)
+		{
+			bool bValid = false;
+
+			if (keyword == vectorName)
+			{
+				bValid = ReadValues(values, record.vector, 3);
+			}
+			else if ((keyword == "ambient") && (false == bLocal))
+			{
+				bValid = ReadValues(values, record.ambient, 3);
+			}
+			else if (((keyword == "diffuse") && (false == bLocal)) || ((keyword == "color") && bLocal))
+			{
+				bValid = ReadValues(values, record.diffuse, 3);
+			}
+			else if ((keyword == "specular") && (false == bLocal))
+			{
+				bValid = ReadValues(values, record.specular, 3);
+			}
+			else if ((keyword == "radius") && bLocal)
+			{
+				bValid = ReadValues(values, &record.radius, 1);
+			}
+			else if ((keyword == "intensity") && bLocal)
+			{
+				bValid = ReadValues(values, &record.intensity, 1);
+			}
+			else if ((keyword == "direction") && bSpot)
+			{
+				bValid = ReadValues(values, record.direction, 3);
+			}
+			else if ((keyword == "cutoff") && bSpot)
+			{
+				bValid = ReadValues(values, &record.cutOff, 1) && ReadValues(values, &record.outerCutOff, 1);
+			}
+			else if ((keyword == "attenuation") && bSpot)
+			{
+				bValid = ReadValues(values, record.attenuation, 3);
+			}
+
+			if (false == bValid)
+			{
+				return(false);
+			}
+		}
+
+		scene.lights.push_back(record);
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ParseNode()
+	 *
+	 *  This function is used for reading a node line.  A node
+	 *  starts out untextured and white with a scale of one, as
+	 *  the scene manager adds it.  A mesh that is not one of the
+	 *  primitives is looked up once the whole file is read, like
+	 *  the material and texture.
+	 ***********************************************************/
+	bool ParseNode(std::istringstream& values, int lineNumber, COOKED_SCENE& scene)
+	{
+		SceneFile::NODE_RECORD record;
+		std::string meshName;
+		std::string keyword;
+		std::string materialName;
+		std::string textureName;
+
+		memset(&record, 0, sizeof(record));
+		record.mesh = SceneFile::SCENE_MESH_COUNT;
+		record.material = SceneFile::NO_INDEX;
+		record.texture = SceneFile::NO_INDEX;
+		for (int i = 0; i < 3; i++)
+		{
+			record.scale[i] = 1.0f;
+		}
+		for (int i = 0; i < 4; i++)
+		{
+			record.color[i] = 1.0f;
+		}
+		record.uvScale[0] = 1.0f;
+		record.uvScale[1] = 1.0f;
+
+		if (!(values >> meshName))
+		{
+			return(false);
+		}
+		for (uint32_t mesh = 0; mesh < SceneFile::SCENE_MESH_COUNT; mesh++)
+		{
+			if (meshName == g_MeshNames[mesh])
+			{
+				record.mesh = mesh;
+				meshName.clear();
+			}
+		}
+
+		while (values >> keyword)
+		{
+			bool bValid = false;
+
+			if (keyword == "scale")
+			{
+				bValid = ReadValues(values, record.scale, 3);
+			}
+			else if (keyword == "rotation")
+			{
+				bValid = ReadValues(values, record.rotation, 3);
+			}
+			else if (keyword == "position")
+			{
+				bValid = ReadValues(values, record.position, 3);
+			}
+			else if (keyword == "material")
+			{
+				bValid = !!(values >> materialName);
+			}
+			else if (keyword == "texture")
+			{
+				bValid = !!(values >> textureName);
+			}
+			else if (keyword == "uv")
+			{
+				bValid = ReadValues(values, record.uvScale, 2);
+			}
+			else if (keyword == "color")
+			{
+				// a solid color is drawn instead of a texture
+				bValid = ReadValues(values, record.color, 4);
+				textureName.clear();
+			}
+			else if (keyword == "occluder")
+			{
+				record.flags |= SceneFile::NODE_OCCLUDER;
+				bValid = true;
+			}
+			else if (keyword == "dynamic")
+			{
+				record.flags |= SceneFile::NODE_DYNAMIC;
+				bValid = true;
+			}
+
+			if (false == bValid)
+			{
+				return(false);
+			}
+		}
+
+		scene.nodes.push_back(record);
+		scene.nodeMeshes.push_back(meshName);
+		scene.nodeMaterials.push_back(materialName);
+		scene.nodeTextures.push_back(textureName);
+		scene.nodeLines.push_back(lineNumber);
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  ResolveNodeNames()
+	 *
+	 *  This function is used for replacing the mesh, material
+	 *  and texture names of the nodes with indices into their
+	 *  tables.  An unknown mesh cannot be drawn, so it fails the
+	 *  scene, while an unknown material falls back to the first
+	 *  one, as the scene manager does for a node, and an unknown
+	 *  texture leaves the node untextured.
+	 ***********************************************************/
+	bool ResolveNodeNames(const char* sourcePath, COOKED_SCENE& scene)
+	{
+		for (size_t i = 0; i < scene.nodes.size(); i++)
+		{
+			SceneFile::NODE_RECORD& record = scene.nodes[i];
+
+			if (!scene.nodeMeshes[i].empty())
+			{
+				int32_t mesh = FindName(scene.meshNames, scene.nodeMeshes[i]);
+				if (mesh == SceneFile::NO_INDEX)
+				{
+					std::cout << "Could not find mesh:" << scene.nodeMeshes[i]
+						<< " on line " << scene.nodeLines[i] << " of " << sourcePath << std::endl;
+					return(false);
+				}
+				record.mesh = SceneFile::SCENE_MESH_COUNT + (uint32_t)mesh;
+			}
+
+			if (!scene.nodeMaterials[i].empty())
+			{
+				record.material = FindName(scene.materialNames, scene.nodeMaterials[i]);
+				if (record.material == SceneFile::NO_INDEX)
+				{
+					std::cout << "Could not find material:" << scene.nodeMaterials[i]
+						<< " on line " << scene.nodeLines[i] << " of " << sourcePath << std::endl;
+					if (scene.materials.size() > 0)
+					{
+						record.material = 0;
+					}
+				}
+			}
+
+			if (!scene.nodeTextures[i].empty())
+			{
+				record.texture = FindName(scene.textureNames, scene.nodeTextures[i]);
+				if (record.texture == SceneFile::NO_INDEX)
+				{
+					std::cout << "Could not find texture:" << scene.nodeTextures[i]
+						<< " on line " << scene.nodeLines[i] << " of " << sourcePath << std::endl;
+				}
+			}
+		}
+
+		return(true);
+	}
+
+	/***********************************************************
+	 *  AppendTable()
+	 *
+	 *  This function is used for appending the records of a table
+	 *  to the file contents and recording where they went.
+	 ***********************************************************/
+	template <typename RECORD>
+	void AppendTable(std::vector<unsigned char>& contents, const std::vector<RECORD>& records, SceneFile::TABLE& table)
+	{
+		table.offset = (uint32_t)contents.size();
+		table.count = (uint32_t)records.size();
+		if (records.size() > 0)
+		{
+			const unsigned char* pRecords = (const unsigned char*)&records[0];
+			contents.insert(contents.end(), pRecords, pRecords + records.size() * sizeof(RECORD));
+		}
+	}
+
+	/***********************************************************
+	 *  WriteScene()
+	 *
+	 *  This function is used for writing the cooked tables after
+	 *  the header, with the string table at the end.
+	 ***********************************************************/
+	bool WriteScene(const char* cookedPath, const COOKED_SCENE& scene, uint64_t sourceHash)
+	{
+		std::vector<unsigned char> contents(sizeof(SceneFile::HEADER), 0);
+		SceneFile::HEADER header;
+
+		memset(&header, 0, sizeof(header));
+		memcpy(header.identifier, SceneFile::IDENTIFIER, sizeof(header.identifier));
+		header.version = SceneFile::FORMAT_VERSION;
+		header.sourceHashLow = (uint32_t)(sourceHash & 0xFFFFFFFFULL);
+		header.sourceHashHigh = (uint32_t)(sourceHash >> 32);
+
+		AppendTable(contents, scene.textures, header.textures);
+		AppendTable(contents, scene.meshes, header.meshes);
+		AppendTable(contents, scene.materials, header.materials);
+		AppendTable(contents, scene.lights, header.lights);
+		AppendTable(contents, scene.nodes, header.nodes);
+		header.strings.offset = (uint32_t)contents.size();
+		header.strings.count = (uint32_t)scene.strings.size();
+		contents.insert(contents.end(), scene.strings.begin(), scene.strings.end());
+		header.fileSize = (uint32_t)contents.size();
+		memcpy(&contents[0], &header, sizeof(header));
+
+		std::ofstream file(cookedPath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			return(false);
+		}
+		file.write((const char*)&contents[0], contents.size());
+
+		return(file.good());
+	}
+}
+
+/***********************************************************
+ *  CookScene()
+ *
+ *  This method is used for reading a text scene, resolving
+ *  the names it references, and writing it as a cooked file.
+ *  Nothing is written when a line cannot be read.
+ ***********************************************************/
+bool SceneCooker::CookScene(const char* sourcePath, const char* cookedPath)
+{
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	COOKED_SCENE scene;
+	std::string text;
+	std::string line;
+	int lineNumber = 0;
+
+	if (false == ReadSourceFile(sourcePath, text))
+	{
+		std::cout << "Could not open the scene:" << sourcePath << std::endl;
+		return(false);
+	}
+
+	// the string table always has a terminator to end on
+	AddString(scene, "");
+
+	std::istringstream lines(text);
+	while (std::getline(lines, line))
+	{
+		std::istringstream values(line);
+		std::string keyword;
+		bool bValid = false;
+
+		lineNumber++;
+		if (!(values >> keyword) || (keyword[0] == '#'))
+		{
+			continue;
+		}
+
+		if (keyword == "texture")
+		{
+			bValid = ParseTexture(values, scene);
+		}
+		else if (keyword == "mesh")
+		{
+			bValid = ParseMesh(values, scene);
+		}
+		else if (keyword == "material")
+		{
+			bValid = ParseMaterial(values, scene);
+		}
+		else if (keyword == "directional")
+		{
+			bValid = ParseLight(values, SceneFile::SCENE_LIGHT_DIRECTIONAL, scene);
+		}
+		else if (keyword == "point")
+		{
+			bValid = ParseLight(values, SceneFile::SCENE_LIGHT_POINT, scene);
+		}
+		else if (keyword == "local")
+		{
+			bValid = ParseLight(values, SceneFile::SCENE_LIGHT_LOCAL, scene);
+		}
+		else if (keyword == "spot")
+		{
+			bValid = ParseLight(values, SceneFile::SCENE_LIGHT_SPOT, scene);
+		}
+		else if (keyword == "node")
+		{
+			bValid = ParseNode(values, lineNumber, scene);
+		}
+
+		if (false == bValid)
+		{
+			std::cout << "Invalid scene line " << lineNumber << " of " << sourcePath << ":" << line << std::endl;
+			return(false);
+		}
+	}
+
+	if (false == ResolveNodeNames(sourcePath, scene))
+	{
+		return(false);
+	}
+
+	uint64_t sourceHash = TextureCache::HashData((const unsigned char*)text.data(), text.size());
+	if (false == WriteScene(cookedPath, scene, sourceHash))
+	{
+		std::cout << "Could not write the cooked scene:" << cookedPath << std::endl;
+		return(false);
+	}
+
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	std::cout << "INFO: Cooked " << sourcePath << " into " << cookedPath << ", "
+		<< scene.nodes.size() << " nodes in " << milliseconds << " ms" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  HashSourceFile()
+ *
+ *  This method is used for hashing the contents of a text
+ *  scene the same way as when it is cooked.
+ ***********************************************************/
+bool SceneCooker::HashSourceFile(const char* sourcePath, uint64_t& hash)
+{
+	std::string text;
+
+	if (false == ReadSourceFile(sourcePath, text))
+	{
+		return(false);
+	}
+
+	hash = TextureCache::HashData((const unsigned char*)text.data(), text.size());
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsSourcePath()
+ *
+ *  This method is used for checking whether a path ends with
+ *  the extension of a text scene.
+ ***********************************************************/
+bool SceneCooker::IsSourcePath(const std::string& path)
+{
+	size_t length = strlen(SOURCE_EXTENSION);
+
+	return((path.size() >= length) && (path.compare(path.size() - length, length, SOURCE_EXTENSION) == 0));
+}
+
+/***********************************************************
+ *  GetCookedPath()
+ *
+ *  This method is used for getting the path of the cooked
+ *  file of a text scene, which is written next to it.
+ ***********************************************************/
+std::string SceneCooker::GetCookedPath(const std::string& sourcePath)
+{
+	if (IsSourcePath(sourcePath))
+	{
+		return(sourcePath.substr(0, sourcePath.size() - strlen(SOURCE_EXTENSION)) + COOKED_EXTENSION);
+	}
+
+	return(sourcePath + COOKED_EXTENSION);
+}
@@ -0,0 +1,53 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenecooker.h
+// ============
+// cook a scene described in a text file into the binary scene format
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+/***********************************************************
+ *  SceneCooker
+ *
+ *  This class turns a scene written as text into the flat
+ *  binary file that SceneFile maps.  Every line of the text
+ *  starts with a keyword and is followed by named values:
+ *
+ *    texture <name> <path>
+ *    mesh <name> <path of a .gltf or .glb file>
+ *    material <name> diffuse r g b specular r g b shininess s [opacity a]
+ *    directional direction x y z ambient r g b diffuse r g b specular r g b
+ *    point position x y z ambient r g b diffuse r g b specular r g b
+ *    local position x y z radius r color r g b intensity i
+ *    spot position x y z direction x y z cutoff inner outer
+ *         attenuation c l q ambient r g b diffuse r g b specular r g b
+ *    node <box|plane|cylinder|torus|mesh name> scale x y z rotation x y z
+ *         position x y z [material <name>] [texture <name> [uv u v]]
+ *         [color r g b a] [occluder] [dynamic]
+ *
+ *  Empty lines and lines starting with # are skipped.  The
+ *  names of meshes, textures and materials are resolved to
+ *  indices of their tables while cooking, so nothing is
+ *  looked up when the scene is loaded.  A color replaces the
+ *  texture given before it on the same line.
+ ***********************************************************/
+class SceneCooker
+{
+public:
+	// cook the text scene into a binary file
+	static bool CookScene(const char* sourcePath, const char* cookedPath);
+
+	// hash the contents of a text scene, recorded in the cooked
+	// file so a stale one is cooked again
+	static bool HashSourceFile(const char* sourcePath, uint64_t& hash);
+	// check whether a path names a text scene rather than a
+	// cooked one
+	static bool IsSourcePath(const std::string& path);
+	// path of the cooked file for the passed in text scene
+	static std::string GetCookedPath(const std::string& sourcePath);
+};
@@ -0,0 +1,320 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.cpp
+// ============
+// map a cooked scene file into memory and read its tables in place
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// the tables are read in place, so the records must not have
+// any padding that differs between compilers
+static_assert(sizeof(SceneFile::HEADER) == 72, "scene header layout changed");
+static_assert(sizeof(SceneFile::TEXTURE_RECORD) == 8, "scene texture record layout changed");
+static_assert(sizeof(SceneFile::MESH_RECORD) == 8, "scene mesh record layout changed");
+static_assert(sizeof(SceneFile::MATERIAL_RECORD) == 36, "scene material record layout changed");
+static_assert(sizeof(SceneFile::LIGHT_RECORD) == 92, "scene light record layout changed");
+static_assert(sizeof(SceneFile::NODE_RECORD) == 76, "scene node record layout changed");
+
+const char SceneFile::IDENTIFIER[8] = { 'C', 'S', '3', '3', '0', 'S', 'C', 'N' };
+
+/***********************************************************
+ *  SceneFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneFile::SceneFile()
+{
+	m_pData = NULL;
+	m_size = 0;
+	m_pHeader = NULL;
+	m_fileHandle = NULL;
+	m_mappingHandle = NULL;
+}
+
+/***********************************************************
+ *  ~SceneFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneFile::~SceneFile()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for mapping a cooked scene file and
+ *  checking that it can be read in place.  Nothing is copied
+ *  or parsed, but Validate() reads every record once to check
+ *  its indices, so opening takes time in proportion to the
+ *  records of the scene and touches every page of the tables.
+ *  A missing or stale file is not reported here, since it is
+ *  then cooked again.
+ ***********************************************************/
+bool SceneFile::Open(const char* filename)
+{
+	Close();
+
+	if (false == MapFile(filename))
+	{
+		Close();
+		return(false);
+	}
+
+	m_pHeader = (const HEADER*)m_pData;
+	if (false == Validate())
+	{
+		Close();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for unmapping the file.  The records
+ *  handed out before are no longer valid.
+ ***********************************************************/
+void SceneFile::Close()
+{
+#ifdef _WIN32
+	if (NULL != m_pData)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+	if (NULL != m_mappingHandle)
+	{
+		CloseHandle((HANDLE)m_mappingHandle);
+	}
+	if (NULL != m_fileHandle)
+	{
+		CloseHandle((HANDLE)m_fileHandle);
+	}
+#else
+	if (NULL != m_pData)
+	{
+		munmap((void*)m_pData, m_size);
+	}
+#endif
+
+	m_pData = NULL;
+	m_size = 0;
+	m_pHeader = NULL;
+	m_fileHandle = NULL;
+	m_mappingHandle = NULL;
+}
+
+/***********************************************************
+ *  GetSourceHash()
+ *
+ *  This method is used for getting the hash of the text file
+ *  that the scene was cooked from, so a stale cooked file can
+ *  be noticed and cooked again.
+ ***********************************************************/
+uint64_t SceneFile::GetSourceHash() const
+{
+	if (NULL == m_pHeader)
+	{
+		return(0);
+	}
+
+	return(((uint64_t)m_pHeader->sourceHashHigh << 32) | m_pHeader->sourceHashLow);
+}
+
+/***********************************************************
+ *  GetString()
+ *
+ *  This method is used for getting a name from the string
+ *  table.  Every offset was checked when the file was opened.
+ ***********************************************************/
+const char* SceneFile::GetString(uint32_t offset) const
+{
+	return((const char*)(m_pData + m_pHeader->strings.offset + offset));
+}
+
+/***********************************************************
+ *  MapFile()
+ *
+ *  This method is used for mapping the whole file into memory
+ *  read only, with MapViewOfFile on Windows and mmap on the
+ *  other systems.
+ ***********************************************************/
+bool SceneFile::MapFile(const char* filename)
+{
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	LARGE_INTEGER fileSize;
+
+	if (INVALID_HANDLE_VALUE == file)
+	{
+		return(false);
+	}
+	m_fileHandle = file;
+
+	if ((FALSE == GetFileSizeEx(file, &fileSize)) || (fileSize.QuadPart < (LONGLONG)sizeof(HEADER)))
+	{
+		return(false);
+	}
+
+	m_mappingHandle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (NULL == m_mappingHandle)
+	{
+		return(false);
+	}
+
+	m_pData = (const unsigned char*)MapViewOfFile((HANDLE)m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	m_size = (size_t)fileSize.QuadPart;
+#else
+	int file = open(filename, O_RDONLY);
+	struct stat fileStatus;
+	void* pMapping = MAP_FAILED;
+
+	if (file < 0)
+	{
+		return(false);
+	}
+
+	if ((fstat(file, &fileStatus) == 0) && (fileStatus.st_size >= (off_t)sizeof(HEADER)))
+	{
+		pMapping = mmap(NULL, (size_t)fileStatus.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	}
+	// the mapping keeps the file open on its own
+	close(file);
+
+	if (MAP_FAILED == pMapping)
+	{
+		return(false);
+	}
+
+	m_pData = (const unsigned char*)pMapping;
+	m_size = (size_t)fileStatus.st_size;
+#endif
+
+	return(NULL != m_pData);
+}
+
+/***********************************************************
+ *  Validate()
+ *
+ *  This method is used for checking the header of the mapped
+ *  file, that every table lies inside the file, and that the
+ *  names and indices of the records point inside their tables,
+ *  so the records can be used later without any checks.
+ ***********************************************************/
+bool SceneFile::Validate() const
+{
+	const HEADER& header = *m_pHeader;
+
+	if ((memcmp(header.identifier, IDENTIFIER, sizeof(IDENTIFIER)) != 0) ||
+		(header.version != FORMAT_VERSION) || (header.fileSize != m_size))
+	{
+		return(false);
+	}
+
+	if ((false == IsTableValid(header.textures, sizeof(TEXTURE_RECORD))) ||
+		(false == IsTableValid(header.meshes, sizeof(MESH_RECORD))) ||
+		(false == IsTableValid(header.materials, sizeof(MATERIAL_RECORD))) ||
+		(false == IsTableValid(header.lights, sizeof(LIGHT_RECORD))) ||
+		(false == IsTableValid(header.nodes, sizeof(NODE_RECORD))) ||
+		(false == IsTableValid(header.strings, 1)))
+	{
+		return(false);
+	}
+
+	// every name ends inside the string table once it ends with
+	// a terminator
+	if ((header.strings.count == 0) || (m_pData[header.strings.offset + header.strings.count - 1] != '\0'))
+	{
+		return(false);
+	}
+
+	const TEXTURE_RECORD* pTextures = GetTextures();
+	for (uint32_t i = 0; i < header.textures.count; i++)
+	{
+		if ((pTextures[i].nameOffset >= header.strings.count) || (pTextures[i].pathOffset >= header.strings.count))
+		{
+			return(false);
+		}
+	}
+
+	const MESH_RECORD* pMeshes = GetMeshes();
+	for (uint32_t i = 0; i < header.meshes.count; i++)
+	{
+		if ((pMeshes[i].nameOffset >= header.strings.count) || (pMeshes[i].pathOffset >= header.strings.count))
+		{
+			return(false);
+		}
+	}
+
+	const MATERIAL_RECORD* pMaterials = GetMaterials();
+	for (uint32_t i = 0; i < header.materials.count; i++)
+	{
+		if (pMaterials[i].nameOffset >= header.strings.count)
+		{
+			return(false);
+		}
+	}
+
+	const LIGHT_RECORD* pLights = GetLights();
+	for (uint32_t i = 0; i < header.lights.count; i++)
+	{
+		if (pLights[i].type >= SCENE_LIGHT_COUNT)
+		{
+			return(false);
+		}
+	}
+
+	const NODE_RECORD* pNodes = GetNodes();
+	for (uint32_t i = 0; i < header.nodes.count; i++)
+	{
+		const NODE_RECORD& node = pNodes[i];
+
+		if ((node.mesh >= SCENE_MESH_COUNT + header.meshes.count) ||
+			(node.material < NO_INDEX) || (node.material >= (int32_t)header.materials.count) ||
+			(node.texture < NO_INDEX) || (node.texture >= (int32_t)header.textures.count))
+		{
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsTableValid()
+ *
+ *  This method is used for checking that a table of records
+ *  of the passed in size is aligned and lies inside the file.
+ ***********************************************************/
+bool SceneFile::IsTableValid(const TABLE& table, size_t recordSize) const
+{
+	if ((table.offset < sizeof(HEADER)) || (table.offset % sizeof(uint32_t) != 0) || (table.offset > m_size))
+	{
+		return(false);
+	}
+
+	return((uint64_t)table.count * recordSize <= (uint64_t)(m_size - table.offset));
+}
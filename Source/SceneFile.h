@@ -0,0 +1,199 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.h
+// ============
+// map a cooked scene file into memory and read its tables in place
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  This class opens a scene cooked by the SceneCooker.  The
+ *  file is mapped into memory and its header is checked once,
+ *  and the texture, mesh, material, light and node tables are then
+ *  read straight from the mapping without being parsed or
+ *  copied.  Every record is a fixed size and made of 32-bit
+ *  values only, so a table is a plain array in the file, and
+ *  names are offsets into one table of strings.  The records
+ *  stay valid until the file is closed.
+ ***********************************************************/
+class SceneFile
+{
+public:
+	// bumped whenever the layout of a record changes
+	static const uint32_t FORMAT_VERSION = 4;
+	// no texture or material in a node record
+	static const int32_t NO_INDEX = -1;
+
+	// primitive meshes a node can reference, in the order of the
+	// mesh names in the text format; a mesh above these is the
+	// record of the mesh table at its index less SCENE_MESH_COUNT
+	enum SCENE_MESH
+	{
+		SCENE_MESH_BOX = 0,
+		SCENE_MESH_PLANE,
+		SCENE_MESH_CYLINDER,
+		SCENE_MESH_TORUS,
+		SCENE_MESH_COUNT
+	};
+
+	// kinds of light in the light table
+	enum SCENE_LIGHT
+	{
+		// the sunlight, one per scene
+		SCENE_LIGHT_DIRECTIONAL = 0,
+		// a light of the light block, shaded by every fragment
+		SCENE_LIGHT_POINT,
+		// a light with a radius, shaded through the clusters
+		SCENE_LIGHT_LOCAL,
+		// the flashlight of the light block, one per scene
+		SCENE_LIGHT_SPOT,
+		SCENE_LIGHT_COUNT
+	};
+
+	// node flags
+	enum NODE_FLAGS
+	{
+		NODE_OCCLUDER = 0x01,
+		// moves every frame, so its shadow is not cached
+		NODE_DYNAMIC = 0x02
+	};
+
+	// offset and count of one table in the file
+	struct TABLE
+	{
+		uint32_t offset;
+		uint32_t count;
+	};
+
+	// start of every cooked file
+	struct HEADER
+	{
+		char identifier[8];
+		uint32_t version;
+		uint32_t fileSize;
+		// hash of the text file the scene was cooked from
+		uint32_t sourceHashLow;
+		uint32_t sourceHashHigh;
+		TABLE textures;
+		TABLE meshes;
+		TABLE materials;
+		TABLE lights;
+		TABLE nodes;
+		// the count of the string table is in bytes
+		TABLE strings;
+	};
+
+	struct TEXTURE_RECORD
+	{
+		uint32_t nameOffset;
+		uint32_t pathOffset;
+	};
+
+	// a mesh imported from a glTF file
+	struct MESH_RECORD
+	{
+		uint32_t nameOffset;
+		uint32_t pathOffset;
+	};
+
+	struct MATERIAL_RECORD
+	{
+		uint32_t nameOffset;
+		float diffuse[3];
+		float specular[3];
+		float shininess;
+		// one for an opaque material
+		float opacity;
+	};
+
+	struct LIGHT_RECORD
+	{
+		uint32_t type;
+		// position of a point, local or spot light, direction of
+		// the directional light
+		float vector[3];
+		float ambient[3];
+		// the color of a local light
+		float diffuse[3];
+		float specular[3];
+		// only used by local lights
+		float radius;
+		float intensity;
+		// only used by the spot light, with the cut offs in degrees
+		float direction[3];
+		float cutOff;
+		float outerCutOff;
+		float attenuation[3];
+	};
+
+	struct NODE_RECORD
+	{
+		uint32_t mesh;
+		float scale[3];
+		float rotation[3];
+		float position[3];
+		// indices into the material and texture tables
+		int32_t material;
+		int32_t texture;
+		float uvScale[2];
+		float color[4];
+		uint32_t flags;
+	};
+
+	// constructor
+	SceneFile();
+	// destructor
+	~SceneFile();
+
+	// map a cooked scene file and check its header, tables and
+	// the indices of every record
+	bool Open(const char* filename);
+	// unmap the file, freeing the records
+	void Close();
+	bool IsOpen() const { return(NULL != m_pData); }
+
+	// hash of the text file the scene was cooked from
+	uint64_t GetSourceHash() const;
+	size_t GetFileSize() const { return(m_size); }
+
+	// the tables of the scene, valid while the file is open
+	const TEXTURE_RECORD* GetTextures() const { return((const TEXTURE_RECORD*)GetTable(m_pHeader->textures)); }
+	uint32_t GetTextureCount() const { return(m_pHeader->textures.count); }
+	const MESH_RECORD* GetMeshes() const { return((const MESH_RECORD*)GetTable(m_pHeader->meshes)); }
+	uint32_t GetMeshCount() const { return(m_pHeader->meshes.count); }
+	const MATERIAL_RECORD* GetMaterials() const { return((const MATERIAL_RECORD*)GetTable(m_pHeader->materials)); }
+	uint32_t GetMaterialCount() const { return(m_pHeader->materials.count); }
+	const LIGHT_RECORD* GetLights() const { return((const LIGHT_RECORD*)GetTable(m_pHeader->lights)); }
+	uint32_t GetLightCount() const { return(m_pHeader->lights.count); }
+	const NODE_RECORD* GetNodes() const { return((const NODE_RECORD*)GetTable(m_pHeader->nodes)); }
+	uint32_t GetNodeCount() const { return(m_pHeader->nodes.count); }
+
+	// a name of the string table by its offset
+	const char* GetString(uint32_t offset) const;
+
+	// identifier at the start of every cooked file
+	static const char IDENTIFIER[8];
+
+private:
+	const unsigned char* m_pData;
+	size_t m_size;
+	const HEADER* m_pHeader;
+	// handles of the file and its mapping on Windows
+	void* m_fileHandle;
+	void* m_mappingHandle;
+
+	// map the whole file read only
+	bool MapFile(const char* filename);
+	// check that every table and index is inside the file
+	bool Validate() const;
+	bool IsTableValid(const TABLE& table, size_t recordSize) const;
+
+	const void* GetTable(const TABLE& table) const { return(m_pData + table.offset); }
+};
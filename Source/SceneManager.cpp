@@ -1,724 +1,2605 @@
-///////////////////////////////////////////////////////////////////////////////
-// scenemanager.cpp
-// ================
-// This file contains the implementation of the `SceneManager` class, which is 
-// responsible for managing the preparation and rendering of 3D scenes. It 
-// handles textures, materials, lighting configurations, and object rendering.
-//
-// AUTHOR: Brian Battersby
-// INSTITUTION: Southern New Hampshire University (SNHU)
-// COURSE: CS-330 Computational Graphics and Visualization
-//
-// INITIAL VERSION: November 1, 2023
-// LAST REVISED: December 1, 2024
-//
-// RESPONSIBILITIES:
-// - Load, bind, and manage textures in OpenGL.
-// - Define materials and lighting properties for 3D objects.
-// - Manage transformations and shader configurations.
-// - Render complex 3D scenes using basic meshes.
-//
-// NOTE: This implementation leverages external libraries like `stb_image` for 
-// texture loading and GLM for matrix and vector operations.
-///////////////////////////////////////////////////////////////////////////////
-
-#include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables
-namespace
-{
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager *pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
-}
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
-}
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationZ * rotationY * rotationX * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
-}
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
-}
-
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
-
-/***********************************************************
-* LoadSceneTextures()
-*
-* This method is used for preparing the 3D scene by loading
-* the shapes, textures in memory to support the 3D scene
-* rendering
-***********************************************************/
-void SceneManager::LoadSceneTextures() {
-	bool bReturn = false;
-
-	bReturn = CreateGLTexture("textures/leather1.jpg", "dash");//Dashboard leather texture
-	bReturn = CreateGLTexture("textures/tesla_screen.jpg", "screen");//Screen display texture
-	bReturn = CreateGLTexture("textures/leatherwhite.jpg", "base");//Dashboard base texture which is a white leather base
-	bReturn = CreateGLTexture("textures/metalgrid.jpg", "ground");//Ground texture for plane
-	bReturn = CreateGLTexture("textures/grayleather.jpg", "dashText");//Alternative texture for the dashboard.
-	bReturn = CreateGLTexture("textures/black_plastic.jpg", "plastic");//Plastic texture
-	bReturn = CreateGLTexture("textures/steering_wheel.jpg", "wheel");//Steering wheel texture
-
-	BindGLTextures();
-}
-
-/********************************************************
-*DefineObjectMaterials()
-*
-* This method is used for configuring the various material
-* settings for all of the objects within the 3D scene.
-* **********************************************************/
-void SceneManager::DefineObjectMaterials() {
-
-	OBJECT_MATERIAL matteBlack;
-	matteBlack.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	matteBlack.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	matteBlack.shininess = 8.0f;
-	matteBlack.tag = "matteblack";
-	m_objectMaterials.push_back(matteBlack);
-
-	OBJECT_MATERIAL polishWhite;
-	polishWhite.diffuseColor = glm::vec3(0.95f, 0.95f, 0.95f);
-	polishWhite.specularColor = glm::vec3(0.5f, 0.5f, 0.5f);
-	polishWhite.shininess = 32.0f;
-	polishWhite.tag = "polishwhite";
-	m_objectMaterials.push_back(polishWhite);
-
-	OBJECT_MATERIAL glassScreen;
-	glassScreen.diffuseColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	glassScreen.specularColor = glm::vec3(0.9f, 0.9f, 0.9f);
-	glassScreen.shininess = 128.0f;
-	glassScreen.tag = "glassscreen";
-	m_objectMaterials.push_back(glassScreen);
-
-	OBJECT_MATERIAL greyLeather;
-	greyLeather.diffuseColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	greyLeather.specularColor = glm::vec3(0.1f, 0.1f, 0.1f);
-	greyLeather.shininess = 4.0f;
-	greyLeather.tag = "dashmat";
-	m_objectMaterials.push_back(greyLeather);
-
-	OBJECT_MATERIAL plastic;
-	plastic.diffuseColor = glm::vec3(0.15f, 0.15f, 0.15f);
-	plastic.specularColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	plastic.shininess = 16.0f;
-	plastic.tag = "plastic";
-	m_objectMaterials.push_back(plastic);
-}
-
-void SceneManager::SetupSceneLights() {
-	m_pShaderManager->setBoolValue(g_UseLightingName, true);
-
-	//Directional light which is simulating sunlight
-	m_pShaderManager->setVec3Value("directionalLight.direction", 0.2f, -0.2f, -0.5f);
-	m_pShaderManager->setVec3Value("directionalLight.ambient", 0.1f, 0.0f, 0.1f);
-	m_pShaderManager->setVec3Value("directionalLight.diffuse", 0.8f, 0.8f, 0.8f);
-	m_pShaderManager->setVec3Value("directionalLight.specular", 0.2f, 0.2f, 0.2f);
-	m_pShaderManager->setBoolValue("directionalLight.bActive", true);
-
-	//Point Light which simulates the interior light of a car
-	m_pShaderManager->setVec3Value("pointLights[0].position", 0.0f, 2.5f, -2.0f);
-	m_pShaderManager->setVec3Value("pointLights[0].ambient", 0.05f, 0.05f, 0.05f);
-	m_pShaderManager->setVec3Value("pointLights[0].diffuse", 1.0f, 1.0f, 1.0f);
-	m_pShaderManager->setVec3Value("pointLights[0].specular", 0.2f, 0.2f, 0.2f);
-	m_pShaderManager->setBoolValue("pointLights[0].bActive", true);
-}
-
-
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-	DefineObjectMaterials();
-	LoadSceneTextures();
-	SetupSceneLights();
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-	
-
-	m_basicMeshes->LoadBoxMesh();
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadTorusMesh();
-}
-
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-void SceneManager::RenderScene()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-/***************************************************************************************************/
-	//Drawing the ground plane
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderMaterial("dashmat");
-	SetShaderTexture("ground");
-
-	m_basicMeshes->DrawPlaneMesh();
-	/***************************************************************************************************/
-
-	/*** COMPLETELY REDESIGNED DASHBOARD ***/
-	// Main dashboard body - curved design
-	scaleXYZ = glm::vec3(2.8f, 0.12f, 0.6f);  // Wider, thinner, shallower
-	positionXYZ = glm::vec3(0.0f, 0.8f, -1.5f);  // Positioned closer to driver
-
-	SetTransformations(
-		scaleXYZ,
-		20.0f,  // Natural angle toward driver
-		0.0f,
-		0.0f,
-		positionXYZ
-	);
-	SetShaderMaterial("dashmat");
-	SetShaderTexture("dash");
-	SetTextureUVScale(3.0f, 1.0f);  // Better leather texture scaling
-	m_basicMeshes->DrawCylinderMesh();  // Using cylinder for curved dashboard
-
-	/***************************************************************************************************/
-
-	// Dashboard top surface - minimalist design
-	scaleXYZ = glm::vec3(2.8f, 0.02f, 0.2f);
-	positionXYZ = glm::vec3(0.0f, 0.95f, -1.4f);  // Sits on top of main body
-
-	SetTransformations(
-		scaleXYZ,
-		5.0f,  // Nearly horizontal
-		0.0f,
-		0.0f,
-		positionXYZ
-	);
-	SetShaderMaterial("metal");
-	SetShaderColor(0.15f, 0.15f, 0.15f, 1.0f);
-	m_basicMeshes->DrawBoxMesh();
-
-	/***************************************************************************************************/
-
-	/*** ACCURATE TOUCHSCREEN (VERTICAL, CENTER-MOUNTED) ***/
-	// Screen frame (thin bezel)
-	scaleXYZ = glm::vec3(0.49f, 0.65f, 0.04f);  // Proper 15:9 aspect ratio
-	positionXYZ = glm::vec3(0.0f, 0.9f, -0.85f);  // Positioned above dashboard
-
-	SetTransformations(
-		scaleXYZ,
-		5.0f,  // Slight tilt back
-		0.0f,
-		0.0f,
-		positionXYZ
-	);
-	SetShaderMaterial("plastic");
-	SetShaderColor(0.05f, 0.05f, 0.05f, 1.0f);
-	m_basicMeshes->DrawBoxMesh();
-
-	/***************************************************************************************************/
-
-	// Display surface (with Tesla UI)
-	scaleXYZ = glm::vec3(0.47f, 0.63f, 0.02f);  // Slightly smaller than frame
-	positionXYZ = glm::vec3(0.0f, 0.9f, -0.83f);  // Slightly in front of frame
-
-	SetTransformations(
-		scaleXYZ,
-		5.0f,
-		0.0f,
-		0.0f,
-		positionXYZ
-	);
-	SetShaderMaterial("glassscreen");
-	SetShaderTexture("screen");
-	SetTextureUVScale(1.0f, 1.0f);
-	m_basicMeshes->DrawBoxMesh();
-
-	/***************************************************************************************************/
-
-	/*** STEERING WHEEL (PROPER SCALE AND PLACEMENT) ***/
-	// Steering wheel ring
-	scaleXYZ = glm::vec3(0.26f, 0.26f, 0.05f);  // Proper diameter
-	positionXYZ = glm::vec3(-0.65f, 0.85f, -0.7f);  // Driver position
-
-	SetTransformations(
-		scaleXYZ,
-		20.0f,  // Angled toward driver
-		0.0f,  // Slightly turned
-		0.0f,
-		positionXYZ
-	);
-	SetShaderMaterial("plastic");
-	SetShaderTexture("wheel");
-	m_basicMeshes->DrawTorusMesh();
-
-	/***************************************************************************************************/
-
-	// Steering column
-	scaleXYZ = glm::vec3(0.04f, 0.41f, 0.04f);
-	positionXYZ = glm::vec3(-0.65f, 0.85f, -0.7f);  // Connecting to dashboard
-
-	SetTransformations(
-		scaleXYZ,
-		-90.0f,  // Match wheel angle
-		0.0f,
-		0.0f,
-		positionXYZ
-	);
-	SetShaderMaterial("matteblack");
-	m_basicMeshes->DrawCylinderMesh();
-
-	/***************************************************************************************************/
-
-	// Steering wheel center (airbag cover)
-	scaleXYZ = glm::vec3(0.12f, 0.12f, 0.05f);
-	positionXYZ = glm::vec3(-0.65f, 0.85f, -0.7f);  // Center of wheel
-
-	SetTransformations(
-		scaleXYZ,
-		20.0f,
-		0.0f,
-		0.0f,
-		positionXYZ
-	);
-	SetShaderMaterial("plastic");
-	SetShaderColor(0.2f, 0.2f, 0.2f, 1.0f);
-	m_basicMeshes->DrawBoxMesh();
-
-	/***************************************************************************************************/
-
-	/*** DRIVER'S SEAT (SIMPLE BUT RECOGNIZABLE) ***/
-	// Seat base
-	scaleXYZ = glm::vec3(0.5f, 0.1f, 0.5f);
-	positionXYZ = glm::vec3(-0.7f, 0.1f, 0.0f);
-
-	SetTransformations(
-		scaleXYZ,
-		0.0f,
-		0.0f,
-		0.0f,  // Slight angle for driver position
-		positionXYZ
-	);
-	SetShaderMaterial("dashmat");
-	SetShaderTexture("dash");
-	m_basicMeshes->DrawBoxMesh();
-
-	/***************************************************************************************************/
-
-	// Seat back
-	scaleXYZ = glm::vec3(0.5f, 0.7f, 0.1f);
-	positionXYZ = glm::vec3(-0.699f, 0.5f, 0.35);
-
-	SetTransformations(
-		scaleXYZ,
-		15.0f,
-		0.0f,
-		0.0f,  // Reclined angle
-		positionXYZ
-	);
-	SetShaderMaterial("dashmat");
-	SetShaderTexture("dash");
-	m_basicMeshes->DrawBoxMesh();
-
-	/***************************************************************************************************/
-
-	/*** CENTER CONSOLE (RUNNING BETWEEN SEATS) ***/
-	scaleXYZ = glm::vec3(0.3f, 0.25f, 1.8f);
-	positionXYZ = glm::vec3(0.0f, 0.2f, -0.2f);
-
-	SetTransformations(
-		scaleXYZ,
-		0.0f,
-		0.0f,
-		0.0f,
-		positionXYZ
-	);
-	SetShaderMaterial("plastic");
-	SetShaderColor(0.1f, 0.1f, 0.1f, 1.0f);
-	m_basicMeshes->DrawBoxMesh();
-
-	/***************************************************************************************************/
-
-	// Cup holders
-	scaleXYZ = glm::vec3(0.2f, 0.1f, 0.2f);
-	positionXYZ = glm::vec3(0.0f, 0.3f, 0.4f);
-
-	SetTransformations(
-		scaleXYZ,
-		0.0f,
-		0.0f,
-		0.0f,
-		positionXYZ
-	);
-	SetShaderMaterial("matteblack");
-	m_basicMeshes->DrawBoxMesh();
-}
-
+///////////////////////////////////////////////////////////////////////////////
+// scenemanager.cpp
+// ================
+// This file contains the implementation of the `SceneManager` class, which is 
+// responsible for managing the preparation and rendering of 3D scenes. It 
+// handles textures, materials, lighting configurations, and object rendering.
+//
+// AUTHOR: Brian Battersby
+// INSTITUTION: Southern New Hampshire University (SNHU)
+// COURSE: CS-330 Computational Graphics and Visualization
+//
+// INITIAL VERSION: November 1, 2023
+// LAST REVISED: December 1, 2024
+//
+// RESPONSIBILITIES:
+// - Load, bind, and manage textures in OpenGL.
+// - Define materials and lighting properties for 3D objects.
+// - Manage transformations and shader configurations.
+// - Render complex 3D scenes using basic meshes.
+//
+// NOTE: This implementation leverages external libraries like `stb_image` for 
+// texture loading and GLM for matrix and vector operations.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneManager.h"
+#include "SceneCooker.h"
+#include "MeshImporter.h"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	const char* g_UseLightingName = "bUseLighting";
+	const char* g_MaterialBlockName = "MaterialBlock";
+	const char* g_LightBlockName = "LightBlock";
+	const char* g_CameraBlockName = "CameraBlock";
+	const char* g_ShadowBlockName = "ShadowBlock";
+
+	// shaders of the multi-draw indirect render path
+	const char* g_IndirectVertexShader = "shaders/indirectVertexShader.glsl";
+	const char* g_IndirectFragmentShader = "shaders/fragmentShader.glsl";
+	// shaders that the specialized variants are built from
+	const char* g_VariantVertexShader = "shaders/vertexShader.glsl";
+	const char* g_VariantFragmentShader = "shaders/fragmentShader.glsl";
+	// the linked variant binaries are cached next to the shaders
+	const char* g_ProgramCacheDirectory = "shaders/";
+	// compute shaders of the occlusion culling pass
+	const char* g_HiZBuildShader = "shaders/hiZBuildCompute.glsl";
+	const char* g_OcclusionCullShader = "shaders/occlusionCullCompute.glsl";
+
+	// scene nodes in one job of the frame building loops, enough
+	// that taking a job costs little next to running it
+	const size_t NODE_JOB_GRAIN = 256;
+
+	// mesh of the scene manager for each primitive of a scene file
+	const SceneManager::MESH_TYPE g_SceneMeshTypes[SceneFile::SCENE_MESH_COUNT] =
+	{
+		SceneManager::MESH_BOX,
+		SceneManager::MESH_PLANE,
+		SceneManager::MESH_CYLINDER,
+		SceneManager::MESH_TORUS
+	};
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(ShaderManager *pShaderManager)
+{
+	m_pShaderManager = pShaderManager;
+	m_instancedMeshes = new MeshLibrary();
+	m_pIndirectRenderer = NULL;
+	m_pOcclusionCuller = NULL;
+	m_bOcclusionCulling = false;
+	m_materialBuffer = 0;
+	m_lightBuffer = 0;
+	m_lightBlock = LIGHT_BLOCK();
+	m_bMaterialsDirty = false;
+	m_bLightsDirty = false;
+	m_renderPath = RENDER_PATH_BATCHED;
+	memset(&m_renderStats, 0, sizeof(m_renderStats));
+	m_view = glm::mat4(1.0f);
+	m_projection = glm::mat4(1.0f);
+	m_viewProjection = glm::mat4(1.0f);
+	m_bHasViewProjection = false;
+	m_bCullingEnabled = true;
+	m_culledNodeCount = 0;
+	m_lightingMode = LIGHTING_FORWARD;
+	m_bDepthPrepass = false;
+	m_bLevelOfDetail = true;
+	m_bHotReload = false;
+	m_bShadows = true;
+	m_bShadowCastersDirty = true;
+	m_baseProgramID = 0;
+	m_currentProgram = 0;
+	m_currentFeatures = 0;
+	m_pUniformCache = &m_uniformCache;
+	m_shadingFeatures = 0;
+	m_bDepthOnlyPass = false;
+	m_bUseLighting = false;
+	m_activePointLights = 0;
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	m_pShaderManager = NULL;
+	m_jobSystem.Stop();
+	// the indirect renderer draws from the mesh library buffers
+	delete m_pOcclusionCuller;
+	m_pOcclusionCuller = NULL;
+	delete m_pIndirectRenderer;
+	m_pIndirectRenderer = NULL;
+	delete m_instancedMeshes;
+	m_instancedMeshes = NULL;
+
+	if (0 != m_materialBuffer)
+	{
+		glDeleteBuffers(1, &m_materialBuffer);
+		m_materialBuffer = 0;
+	}
+	if (0 != m_lightBuffer)
+	{
+		glDeleteBuffers(1, &m_lightBuffer);
+		m_lightBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  RegisterTexture()
+ *
+ *  This method is used for loading a texture from an image
+ *  file and returning the handle that it is drawn with, or
+ *  INVALID_HANDLE when the image could not be loaded.
+ ***********************************************************/
+SceneManager::TextureHandle SceneManager::RegisterTexture(const char* filename, const std::string& tag)
+{
+	// the handle is the texture array layer of the image
+	return(m_textureLibrary.LoadTexture(filename, tag));
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for creating the texture array for the
+ *  loaded textures and binding it to its texture unit, where
+ *  it stays for every draw.  The layers show a placeholder
+ *  until their images have been decoded and uploaded.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	m_textureLibrary.BuildTextureArray();
+	m_textureLibrary.BindTextureArray(TEXTURE_ARRAY_UNIT);
+	m_uniformCache.SetIntValue(UniformCache::UNIFORM_OBJECT_TEXTURE, TEXTURE_ARRAY_UNIT);
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory of the texture
+ *  array holding all the loaded textures.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	m_textureLibrary.Destroy();
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting the texture array layer of
+ *  the previously loaded texture associated with the passed
+ *  in tag.
+ ***********************************************************/
+SceneManager::TextureHandle SceneManager::FindTextureSlot(const std::string& tag)
+{
+	return(m_textureLibrary.FindTexture(tag));
+}
+
+/***********************************************************
+ *  RegisterMaterial()
+ *
+ *  This method is used for adding a material to the defined
+ *  materials list and returning the handle it is drawn with.
+ ***********************************************************/
+SceneManager::MaterialHandle SceneManager::RegisterMaterial(const OBJECT_MATERIAL& material)
+{
+	m_objectMaterials.push_back(material);
+	m_bMaterialsDirty = true;
+
+	if (m_objectMaterials.size() > MAX_MATERIALS)
+	{
+		std::cout << "Material " << material.tag << " exceeds the " << MAX_MATERIALS << " materials in the material block" << std::endl;
+	}
+
+	return((MaterialHandle)m_objectMaterials.size() - 1);
+}
+
+/***********************************************************
+ *  FindMaterial()
+ *
+ *  This method is used for getting a material from the previously
+ *  defined materials list that is associated with the passed in tag.
+ ***********************************************************/
+bool SceneManager::FindMaterial(const std::string& tag, OBJECT_MATERIAL& material)
+{
+	if (m_objectMaterials.size() == 0)
+	{
+		return(false);
+	}
+
+	int index = 0;
+	bool bFound = false;
+	while ((index < m_objectMaterials.size()) && (bFound == false))
+	{
+		if (m_objectMaterials[index].tag.compare(tag) == 0)
+		{
+			bFound = true;
+			material.diffuseColor = m_objectMaterials[index].diffuseColor;
+			material.specularColor = m_objectMaterials[index].specularColor;
+			material.shininess = m_objectMaterials[index].shininess;
+			material.opacity = m_objectMaterials[index].opacity;
+		}
+		else
+		{
+			index++;
+		}
+	}
+
+	return(bFound);
+}
+
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the index of a material
+ *  in the defined materials list that is associated with the
+ *  passed in tag, or INVALID_HANDLE if there is no such
+ *  material.
+ ***********************************************************/
+SceneManager::MaterialHandle SceneManager::FindMaterialIndex(const std::string& tag)
+{
+	int index = 0;
+	while (index < m_objectMaterials.size())
+	{
+		if (m_objectMaterials[index].tag.compare(tag) == 0)
+		{
+			return(index);
+		}
+		index++;
+	}
+
+	return(INVALID_HANDLE);
+}
+
+/***********************************************************
+ *  BuildTransformations()
+ *
+ *  This method is used for building the model matrix from
+ *  the passed in transformation values.
+ ***********************************************************/
+glm::mat4 SceneManager::BuildTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	// variables for this method
+	glm::mat4 scale;
+	glm::mat4 rotationX;
+	glm::mat4 rotationY;
+	glm::mat4 rotationZ;
+	glm::mat4 translation;
+
+	// set the scale value in the transform buffer
+	scale = glm::scale(scaleXYZ);
+	// set the rotation values in the transform buffer
+	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
+	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
+	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
+	// set the translation value in the transform buffer
+	translation = glm::translate(positionXYZ);
+
+	return(translation * rotationZ * rotationY * rotationX * scale);
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using the passed in transformation values.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	glm::mat4 modelView = BuildTransformations(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	m_pUniformCache->SetMat4Value(UniformCache::UNIFORM_MODEL, modelView);
+	m_pUniformCache->SetMat3Value(UniformCache::UNIFORM_NORMAL_MATRIX, glm::inverseTranspose(glm::mat3(modelView)));
+}
+
+/***********************************************************
+ *  SetShaderColor()
+ *
+ *  This method is used for setting the passed in color
+ *  into the shader for the next draw command
+ ***********************************************************/
+void SceneManager::SetShaderColor(
+	float redColorValue,
+	float greenColorValue,
+	float blueColorValue,
+	float alphaValue)
+{
+	// variables for this method
+	glm::vec4 currentColor;
+
+	currentColor.r = redColorValue;
+	currentColor.g = greenColorValue;
+	currentColor.b = blueColorValue;
+	currentColor.a = alphaValue;
+
+	m_pUniformCache->SetIntValue(UniformCache::UNIFORM_TEXTURE_LAYER, TextureLibrary::INVALID_LAYER);
+	m_pUniformCache->SetVec4Value(UniformCache::UNIFORM_OBJECT_COLOR, currentColor);
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in handle into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	TextureHandle texture)
+{
+	// every texture is a layer of the one bound texture array
+	m_pUniformCache->SetIntValue(UniformCache::UNIFORM_TEXTURE_LAYER, texture);
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in tag into the shader.  The
+ *  tag lookup is meant for load time, draws use handles.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	const std::string& textureTag)
+{
+	SetShaderTexture(FindTextureSlot(textureTag));
+}
+
+/***********************************************************
+ *  SetTextureUVScale()
+ *
+ *  This method is used for setting the texture UV scale
+ *  values into the shader.
+ ***********************************************************/
+void SceneManager::SetTextureUVScale(float u, float v)
+{
+	m_pUniformCache->SetVec2Value(UniformCache::UNIFORM_UV_SCALE, glm::vec2(u, v));
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for selecting the material associated
+ *  with the passed in handle from the material block.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	MaterialHandle material)
+{
+	if ((material < 0) || (material >= m_objectMaterials.size()) ||
+		(material >= MAX_MATERIALS))
+	{
+		return;
+	}
+
+	// the material values live in the material block, so only
+	// the index of the material is passed for the draw
+	m_pUniformCache->SetIntValue(UniformCache::UNIFORM_MATERIAL_INDEX, material);
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for passing the material values
+ *  associated with the passed in tag into the shader.  The
+ *  tag lookup is meant for load time, draws use handles.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	const std::string& materialTag)
+{
+	SetShaderMaterial(FindMaterialIndex(materialTag));
+}
+
+/***********************************************************
+ *  CreateUniformBlocks()
+ *
+ *  This method is used for creating the uniform buffers for
+ *  the material and light blocks and attaching them to their
+ *  binding points in the passed in shader program.
+ ***********************************************************/
+void SceneManager::CreateUniformBlocks(GLuint programID)
+{
+	glGenBuffers(1, &m_materialBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_materialBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(MATERIAL_BLOCK), NULL, GL_STATIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BLOCK_BINDING, m_materialBuffer);
+
+	glGenBuffers(1, &m_lightBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_lightBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(LIGHT_BLOCK), NULL, GL_DYNAMIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BLOCK_BINDING, m_lightBuffer);
+
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	AttachUniformBlocks(programID);
+}
+
+/***********************************************************
+ *  AttachUniformBlocks()
+ *
+ *  This method is used for pointing the material, light,
+ *  camera and shadow blocks of the passed in program at their shared
+ *  binding points, so every program reads the same buffers.
+ ***********************************************************/
+void SceneManager::AttachUniformBlocks(GLuint programID)
+{
+	GLuint blockIndex = GL_INVALID_INDEX;
+
+	blockIndex = glGetUniformBlockIndex(programID, g_MaterialBlockName);
+	if (blockIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(programID, blockIndex, MATERIAL_BLOCK_BINDING);
+	}
+	blockIndex = glGetUniformBlockIndex(programID, g_LightBlockName);
+	if (blockIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(programID, blockIndex, LIGHT_BLOCK_BINDING);
+	}
+	blockIndex = glGetUniformBlockIndex(programID, g_CameraBlockName);
+	if (blockIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(programID, blockIndex, CAMERA_BLOCK_BINDING);
+	}
+	blockIndex = glGetUniformBlockIndex(programID, g_ShadowBlockName);
+	if (blockIndex != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(programID, blockIndex, SHADOW_BLOCK_BINDING);
+	}
+}
+
+/***********************************************************
+ *  UploadUniformBlocks()
+ *
+ *  This method is used for uploading the material and light
+ *  blocks into their uniform buffers, but only when they
+ *  have changed since they were last uploaded.
+ ***********************************************************/
+void SceneManager::UploadUniformBlocks()
+{
+	if ((m_bMaterialsDirty == true) && (0 != m_materialBuffer))
+	{
+		MATERIAL_BLOCK materialBlock = {};
+
+		for (int i = 0; (i < m_objectMaterials.size()) && (i < MAX_MATERIALS); i++)
+		{
+			materialBlock.materials[i].diffuseColor = m_objectMaterials[i].diffuseColor;
+			materialBlock.materials[i].specularColor = m_objectMaterials[i].specularColor;
+			materialBlock.materials[i].shininess = m_objectMaterials[i].shininess;
+			materialBlock.materials[i].opacity = m_objectMaterials[i].opacity;
+		}
+
+		glBindBuffer(GL_UNIFORM_BUFFER, m_materialBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(materialBlock), &materialBlock);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		m_bMaterialsDirty = false;
+	}
+
+	if ((m_bLightsDirty == true) && (0 != m_lightBuffer))
+	{
+		// the shader variants only loop over the active point
+		// lights, so those are moved to the front of the block
+		m_activePointLights = 0;
+		for (int i = 0; i < TOTAL_POINT_LIGHTS; i++)
+		{
+			if (m_lightBlock.pointLights[i].bActive)
+			{
+				std::swap(m_lightBlock.pointLights[m_activePointLights], m_lightBlock.pointLights[i]);
+				m_activePointLights++;
+			}
+		}
+
+		glBindBuffer(GL_UNIFORM_BUFFER, m_lightBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(m_lightBlock), &m_lightBlock);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		m_bLightsDirty = false;
+	}
+}
+
+/***********************************************************
+ *  AddSceneNode()
+ *
+ *  This method is used for adding a new node to the retained
+ *  scene.  The node starts out dirty, untextured and white,
+ *  and its index is returned for setting its render state.
+ ***********************************************************/
+int SceneManager::AddSceneNode(
+	int mesh,
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	SCENE_NODE node;
+
+	node.scaleXYZ = scaleXYZ;
+	node.rotationDegrees = glm::vec3(XrotationDegrees, YrotationDegrees, ZrotationDegrees);
+	node.positionXYZ = positionXYZ;
+	node.worldMatrix = glm::mat4(1.0f);
+	node.normalMatrix = glm::mat3(1.0f);
+	node.material = INVALID_HANDLE;
+	node.texture = INVALID_HANDLE;
+	node.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+	node.uvScale = m_loadedMeshes[mesh].uvScale;
+	node.mesh = mesh;
+	node.lodMesh = MeshLibrary::INVALID_MESH;
+	node.bOccluder = false;
+	node.bDynamic = false;
+	node.bDirty = true;
+
+	m_sceneNodes.push_back(node);
+
+	return((int)m_sceneNodes.size() - 1);
+}
+
+/***********************************************************
+ *  SetNodeTransform()
+ *
+ *  This method is used for changing the transformation values
+ *  of a scene node.  The world matrix is rebuilt on the next
+ *  call to UpdateSceneNodes().
+ ***********************************************************/
+void SceneManager::SetNodeTransform(
+	int nodeIndex,
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	if ((nodeIndex < 0) || (nodeIndex >= m_sceneNodes.size()))
+	{
+		return;
+	}
+
+	SCENE_NODE& node = m_sceneNodes[nodeIndex];
+	node.scaleXYZ = scaleXYZ;
+	node.rotationDegrees = glm::vec3(XrotationDegrees, YrotationDegrees, ZrotationDegrees);
+	node.positionXYZ = positionXYZ;
+	node.bDirty = true;
+}
+
+/***********************************************************
+ *  SetNodeMaterial()
+ *
+ *  This method is used for setting the material handle that
+ *  a scene node is drawn with.
+ ***********************************************************/
+void SceneManager::SetNodeMaterial(int nodeIndex, MaterialHandle material)
+{
+	if ((nodeIndex < 0) || (nodeIndex >= m_sceneNodes.size()))
+	{
+		return;
+	}
+
+	m_sceneNodes[nodeIndex].material = material;
+	// the opacity of the material decides whether it casts
+	m_bShadowCastersDirty = true;
+}
+
+/***********************************************************
+ *  SetNodeMaterial()
+ *
+ *  This method is used for resolving the passed in material
+ *  tag once and storing its handle in the scene node.  An
+ *  unknown tag falls back to the first defined material, so
+ *  the node looks the same on every render path.
+ ***********************************************************/
+void SceneManager::SetNodeMaterial(int nodeIndex, const std::string& materialTag)
+{
+	MaterialHandle material = FindMaterialIndex(materialTag);
+	if (material == INVALID_HANDLE)
+	{
+		std::cout << "Could not find material:" << materialTag << std::endl;
+		if (m_objectMaterials.size() > 0)
+		{
+			material = 0;
+		}
+	}
+
+	SetNodeMaterial(nodeIndex, material);
+}
+
+/***********************************************************
+ *  SetNodeTexture()
+ *
+ *  This method is used for setting the texture handle and
+ *  UV scale that a scene node is drawn with.
+ ***********************************************************/
+void SceneManager::SetNodeTexture(int nodeIndex, TextureHandle texture, float u, float v)
+{
+	if ((nodeIndex < 0) || (nodeIndex >= m_sceneNodes.size()))
+	{
+		return;
+	}
+
+	m_sceneNodes[nodeIndex].texture = texture;
+	m_sceneNodes[nodeIndex].uvScale = glm::vec2(u, v) * m_loadedMeshes[m_sceneNodes[nodeIndex].mesh].uvScale;
+	// the alpha of the color of a textured node is not used, so
+	// it can stop being transparent and start casting a shadow
+	m_bShadowCastersDirty = true;
+}
+
+/***********************************************************
+ *  SetNodeTexture()
+ *
+ *  This method is used for resolving the passed in texture
+ *  tag once and storing its handle in the scene node.
+ ***********************************************************/
+void SceneManager::SetNodeTexture(int nodeIndex, const std::string& textureTag, float u, float v)
+{
+	TextureHandle texture = FindTextureSlot(textureTag);
+	if (texture == INVALID_HANDLE)
+	{
+		std::cout << "Could not find texture:" << textureTag << std::endl;
+	}
+
+	SetNodeTexture(nodeIndex, texture, u, v);
+}
+
+/***********************************************************
+ *  SetNodeColor()
+ *
+ *  This method is used for drawing a scene node with a solid
+ *  color instead of a texture.
+ ***********************************************************/
+void SceneManager::SetNodeColor(int nodeIndex, float red, float green, float blue, float alpha)
+{
+	if ((nodeIndex < 0) || (nodeIndex >= m_sceneNodes.size()))
+	{
+		return;
+	}
+
+	m_sceneNodes[nodeIndex].texture = INVALID_HANDLE;
+	m_sceneNodes[nodeIndex].color = glm::vec4(red, green, blue, alpha);
+	// a transparent node casts no shadow
+	m_bShadowCastersDirty = true;
+}
+
+/***********************************************************
+ *  SetNodeOccluder()
+ *
+ *  This method is used for marking a scene node as an
+ *  occluder.  Occluders are drawn into the depth pyramid that
+ *  the other indirect draws are culled against, so they
+ *  should be large, opaque, and in front of a lot of the scene.
+ ***********************************************************/
+void SceneManager::SetNodeOccluder(int nodeIndex, bool bOccluder)
+{
+	if ((nodeIndex < 0) || (nodeIndex >= m_sceneNodes.size()))
+	{
+		return;
+	}
+
+	m_sceneNodes[nodeIndex].bOccluder = bOccluder;
+}
+
+/***********************************************************
+ *  SetNodeDynamic()
+ *
+ *  This method is used for marking a scene node as dynamic.
+ *  Dynamic nodes are drawn into a copy of the cached shadow
+ *  maps every frame, so moving them never draws the cached
+ *  maps again, which a static node does whenever it moves.
+ ***********************************************************/
+void SceneManager::SetNodeDynamic(int nodeIndex, bool bDynamic)
+{
+	if ((nodeIndex < 0) || (nodeIndex >= m_sceneNodes.size()))
+	{
+		return;
+	}
+
+	m_sceneNodes[nodeIndex].bDynamic = bDynamic;
+	m_bShadowCastersDirty = true;
+}
+
+/***********************************************************
+ *  UpdateSceneNodes()
+ *
+ *  This method is used for rebuilding the cached world matrix
+ *  of every scene node that has been marked as dirty.  Every
+ *  node only writes its own matrices and bounds, so the nodes
+ *  are updated in jobs on the worker threads.  A static node
+ *  that moved draws the cached shadow maps again.
+ ***********************************************************/
+void SceneManager::UpdateSceneNodes()
+{
+	std::atomic<bool> bStaticMoved(false);
+
+	// nodes added since the last frame are dirty, so their
+	// bounds are set below
+	if (m_frustumCuller.GetCount() != m_sceneNodes.size())
+	{
+		m_frustumCuller.Resize(m_sceneNodes.size());
+	}
+
+	m_jobSystem.ParallelFor(m_sceneNodes.size(), NODE_JOB_GRAIN, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			SCENE_NODE& node = m_sceneNodes[i];
+			if (node.bDirty == true)
+			{
+				if (node.bDynamic == false)
+				{
+					bStaticMoved = true;
+				}
+
+				MeshLibrary::MESH_BOUNDS bounds;
+
+				node.worldMatrix = BuildTransformations(
+					node.scaleXYZ,
+					node.rotationDegrees.x,
+					node.rotationDegrees.y,
+					node.rotationDegrees.z,
+					node.positionXYZ) * m_loadedMeshes[node.mesh].meshMatrix;
+				// the inverse is only taken when the node moves,
+				// instead of for every vertex in the shaders
+				node.normalMatrix = glm::inverseTranspose(glm::mat3(node.worldMatrix));
+
+				// the world bounds follow the world matrix
+				if (m_instancedMeshes->GetMeshBounds(m_loadedMeshes[node.mesh].handle, bounds))
+				{
+					m_frustumCuller.SetBounds(i, bounds.minimum, bounds.maximum, node.worldMatrix);
+				}
+				node.bDirty = false;
+			}
+		}
+	});
+
+	if (bStaticMoved == true)
+	{
+		m_bShadowCastersDirty = true;
+	}
+}
+
+/***********************************************************
+ *  SetCameraMatrices()
+ *
+ *  This method is used for setting the camera matrices that
+ *  the scene nodes are culled against and the local lights
+ *  are clustered for in the next RenderScene().
+ ***********************************************************/
+void SceneManager::SetCameraMatrices(const glm::mat4& view, const glm::mat4& projection)
+{
+	m_view = view;
+	m_projection = projection;
+	m_viewProjection = projection * view;
+	m_bHasViewProjection = true;
+}
+
+/***********************************************************
+ *  CullSceneNodes()
+ *
+ *  This method is used for flagging the scene nodes whose
+ *  world bounds are inside the view frustum, in jobs of
+ *  consecutive nodes.  Every node is visible when culling is
+ *  off or no camera matrix was set.
+ ***********************************************************/
+void SceneManager::CullSceneNodes()
+{
+	size_t visibleCount = m_sceneNodes.size();
+
+	if ((m_bCullingEnabled == true) && (m_bHasViewProjection == true))
+	{
+		FrustumCuller::FRUSTUM frustum = FrustumCuller::ExtractFrustum(m_viewProjection);
+		std::atomic<size_t> jobVisibleCount(0);
+
+		// the ranges of the jobs never overlap, so they write
+		// the flags of their own nodes
+		m_nodeVisible.resize(m_sceneNodes.size());
+		m_jobSystem.ParallelFor(m_sceneNodes.size(), NODE_JOB_GRAIN, [&](size_t first, size_t last)
+		{
+			jobVisibleCount += m_frustumCuller.CullRange(frustum, first, last, &m_nodeVisible[0]);
+		});
+		visibleCount = jobVisibleCount;
+	}
+	else
+	{
+		m_nodeVisible.assign(m_sceneNodes.size(), 1);
+	}
+
+	m_culledNodeCount = (unsigned int)(m_sceneNodes.size() - visibleCount);
+}
+
+/***********************************************************
+ *  DrawSceneNode()
+ *
+ *  This method is used for sending the retained render state
+ *  of a scene node into the shader and drawing its mesh.
+ ***********************************************************/
+void SceneManager::DrawSceneNode(const SCENE_NODE& node)
+{
+	UseShaderVariant(GetDrawFeatures(node));
+
+	m_pUniformCache->SetIntValue(UniformCache::UNIFORM_USE_INSTANCING, false);
+	m_pUniformCache->SetMat4Value(UniformCache::UNIFORM_MODEL, node.worldMatrix);
+	m_pUniformCache->SetMat3Value(UniformCache::UNIFORM_NORMAL_MATRIX, node.normalMatrix);
+
+	// an unresolved material leaves the previous one in place
+	SetShaderMaterial(node.material);
+
+	if (node.texture != INVALID_HANDLE)
+	{
+		SetShaderTexture(node.texture);
+		SetTextureUVScale(node.uvScale.x, node.uvScale.y);
+	}
+	else
+	{
+		SetShaderColor(node.color.r, node.color.g, node.color.b, node.color.a);
+	}
+
+	// every path draws from the shared buffers of the mesh
+	// library, so changing meshes never changes the vertex array
+	m_instancedMeshes->DrawMesh(node.lodMesh);
+}
+
+/***********************************************************
+ *  SelectNodeLod()
+ *
+ *  This method is used for picking the level of detail that
+ *  a scene node is drawn with, from the fraction of the screen
+ *  height covered by the bounding sphere of its world box.
+ *  The size is the radius over the view depth, scaled by the
+ *  projection, so a stretched mesh near the camera gets more
+ *  triangles than a small one further away.
+ ***********************************************************/
+MeshLibrary::MeshHandle SceneManager::SelectNodeLod(size_t nodeIndex) const
+{
+	MeshLibrary::MeshHandle mesh = m_loadedMeshes[m_sceneNodes[nodeIndex].mesh].handle;
+	glm::vec3 center;
+	glm::vec3 extent;
+
+	if ((m_bLevelOfDetail == false) || (m_bHasViewProjection == false) ||
+		(m_instancedMeshes->GetLodCount(mesh) <= 1))
+	{
+		return(mesh);
+	}
+
+	m_frustumCuller.GetBounds(nodeIndex, center, extent);
+
+	float radius = glm::length(extent);
+	float depth = -(m_view * glm::vec4(center, 1.0f)).z;
+
+	// an orthographic projection does not shrink with depth, and
+	// a camera inside the sphere sees the mesh at its largest
+	if (m_projection[3][3] != 0.0f)
+	{
+		depth = 1.0f;
+	}
+	else
+	{
+		depth = std::max(depth, radius);
+	}
+
+	float screenSize = radius * m_projection[1][1] / std::max(depth, 0.0001f);
+
+	return(m_instancedMeshes->GetLodMesh(mesh, m_instancedMeshes->SelectLodLevel(mesh, screenSize)));
+}
+
+/***********************************************************
+ *  IsTransparentNode()
+ *
+ *  This method is used for checking whether a scene node is
+ *  seen through, either because its material is glass or
+ *  because it is untextured with a color alpha below one.
+ *  These nodes are blended after the opaque ones, which are
+ *  drawn with blending turned off.
+ ***********************************************************/
+bool SceneManager::IsTransparentNode(const SCENE_NODE& node) const
+{
+	if ((node.material >= 0) && (node.material < (MaterialHandle)m_objectMaterials.size()) &&
+		(m_objectMaterials[node.material].opacity < 1.0f))
+	{
+		return(true);
+	}
+
+	return((node.texture == INVALID_HANDLE) && (node.color.a < 1.0f));
+}
+
+/***********************************************************
+ *  GetNodeViewDepth()
+ *
+ *  This method is used for getting the distance of the center
+ *  of the world box of a scene node in front of the camera.
+ ***********************************************************/
+float SceneManager::GetNodeViewDepth(size_t nodeIndex) const
+{
+	glm::vec3 center;
+	glm::vec3 extent;
+
+	if (m_bHasViewProjection == false)
+	{
+		return(0.0f);
+	}
+
+	m_frustumCuller.GetBounds(nodeIndex, center, extent);
+
+	return(-(m_view * glm::vec4(center, 1.0f)).z);
+}
+
+/***********************************************************
+ *  BuildRenderQueue()
+ *
+ *  This method is used for queueing a draw item for every
+ *  scene node.  The batched path sorts the items by their
+ *  draw state, while the legacy path keeps the node order
+ *  and only moves the transparent items to the end.  Either
+ *  way the transparent items are sorted back to front.
+ *  The levels of detail and sort keys are worked out in jobs
+ *  on the worker threads, and the visible nodes are then
+ *  queued in node order on this thread.
+ ***********************************************************/
+void SceneManager::BuildRenderQueue()
+{
+	int untexturedProgram = 0;
+	int texturedProgram = 0;
+
+	m_renderQueue.Clear();
+	m_nodeSortKeys.resize(m_sceneNodes.size());
+
+	// the indirect path draws every node with its own program,
+	// and the others look their programs up here, because a
+	// variant that is not built yet is compiled on the GL thread
+	if (m_renderPath != RENDER_PATH_INDIRECT)
+	{
+		ShaderVariants::VARIANT* pVariant = m_shaderVariants.GetVariant(m_shadingFeatures);
+		untexturedProgram = (NULL != pVariant) ? pVariant->index : 0;
+		pVariant = m_shaderVariants.GetVariant(m_shadingFeatures | ShaderVariants::FEATURE_TEXTURED);
+		texturedProgram = (NULL != pVariant) ? pVariant->index : 0;
+	}
+
+	m_jobSystem.ParallelFor(m_sceneNodes.size(), NODE_JOB_GRAIN, [&](size_t first, size_t last)
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			SCENE_NODE& node = m_sceneNodes[i];
+
+			// nodes outside of the view frustum are never queued
+			if (m_nodeVisible[i] == 0)
+			{
+				continue;
+			}
+
+			// every path draws the level picked here, so the depth
+			// pre-pass and the shading pass use the same triangles
+			node.lodMesh = SelectNodeLod(i);
+
+			// transparent nodes need blending and have to be
+			// drawn after all the opaque nodes
+			bool bTransparent = IsTransparentNode(node);
+
+			m_nodeSortKeys[i] = RenderQueue::BuildSortKey(
+				bTransparent,
+				(node.texture != INVALID_HANDLE) ? texturedProgram : untexturedProgram,
+				node.lodMesh,
+				node.texture,
+				node.material,
+				(uint32_t)i);
+		}
+	});
+
+	for (size_t i = 0; i < m_sceneNodes.size(); i++)
+	{
+		if (m_nodeVisible[i] != 0)
+		{
+			// only the few transparent items are ordered by depth
+			float viewDepth = RenderQueue::IsTransparent(m_nodeSortKeys[i]) ? GetNodeViewDepth(i) : 0.0f;
+			m_renderQueue.AddItem(m_nodeSortKeys[i], (uint32_t)i, viewDepth);
+		}
+	}
+
+	// the depth pre-pass needs the opaque items sorted, so the
+	// queue is sorted for it even on the legacy path
+	if ((m_renderPath != RENDER_PATH_LEGACY) || (m_bDepthPrepass == true))
+	{
+		m_renderQueue.Sort();
+	}
+	else
+	{
+		m_renderQueue.SortTransparent();
+	}
+}
+
+/***********************************************************
+ *  SubmitQueueRange()
+ *
+ *  This method is used for drawing the queued items from the
+ *  first up to, but not including, the last item with the
+ *  selected render path, and returns the draw calls made.
+ ***********************************************************/
+unsigned int SceneManager::SubmitQueueRange(size_t firstItem, size_t lastItem)
+{
+	if (firstItem >= lastItem)
+	{
+		return(0);
+	}
+
+	if (m_renderPath == RENDER_PATH_INSTANCED)
+	{
+		return(SubmitInstancedRenderQueue(firstItem, lastItem));
+	}
+	else if (m_renderPath == RENDER_PATH_INDIRECT)
+	{
+		return(SubmitIndirectRenderQueue(firstItem, lastItem));
+	}
+
+	return(SubmitRenderQueue(firstItem, lastItem));
+}
+
+/***********************************************************
+ *  SubmitRenderQueue()
+ *
+ *  This method is used for drawing a range of the queued
+ *  items in queue order, one draw per item.
+ ***********************************************************/
+unsigned int SceneManager::SubmitRenderQueue(size_t firstItem, size_t lastItem)
+{
+	for (size_t i = firstItem; i < lastItem; i++)
+	{
+		DrawSceneNode(m_sceneNodes[m_renderQueue.GetItem(i).nodeIndex]);
+	}
+
+	return((unsigned int)(lastItem - firstItem));
+}
+
+/***********************************************************
+ *  CanShareInstancedDraw()
+ *
+ *  This method is used for checking whether the passed in
+ *  node can be drawn in the same instanced draw as the first
+ *  node of a run.  The material and color are per instance,
+ *  the mesh and its level of detail, the texture and the UV
+ *  scale are shared by the run.
+ ***********************************************************/
+bool SceneManager::CanShareInstancedDraw(const SCENE_NODE& first, const SCENE_NODE& node) const
+{
+	if ((node.lodMesh != first.lodMesh) || (node.texture != first.texture))
+	{
+		return(false);
+	}
+	if ((node.texture != INVALID_HANDLE) && (node.uvScale != first.uvScale))
+	{
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  SubmitInstancedRenderQueue()
+ *
+ *  This method is used for drawing a range of the sorted queue
+ *  with one instanced draw for every run of consecutive items
+ *  that share their mesh, texture and UV scale.
+ ***********************************************************/
+unsigned int SceneManager::SubmitInstancedRenderQueue(size_t firstItem, size_t lastItem)
+{
+	unsigned int drawCount = 0;
+	size_t runStart = firstItem;
+
+	while (runStart < lastItem)
+	{
+		const SCENE_NODE& first = m_sceneNodes[m_renderQueue.GetItem(runStart).nodeIndex];
+		size_t runEnd = runStart;
+
+		m_instanceModels.clear();
+		m_instanceNormalMatrices.clear();
+		m_instanceMaterials.clear();
+		m_instanceColors.clear();
+
+		// transparent items are never merged, so that they stay
+		// in the order the queue sorted them in
+		while (runEnd < lastItem)
+		{
+			const RenderQueue::DRAW_ITEM& item = m_renderQueue.GetItem(runEnd);
+			const SCENE_NODE& node = m_sceneNodes[item.nodeIndex];
+
+			if ((runEnd > runStart) &&
+				((RenderQueue::IsTransparent(item.sortKey) == true) || (CanShareInstancedDraw(first, node) == false)))
+			{
+				break;
+			}
+
+			m_instanceModels.push_back(node.worldMatrix);
+			m_instanceNormalMatrices.push_back(node.normalMatrix);
+			m_instanceMaterials.push_back((node.material != INVALID_HANDLE) ? (uint32_t)node.material : 0);
+			m_instanceColors.push_back(node.color);
+			runEnd++;
+
+			if (RenderQueue::IsTransparent(item.sortKey) == true)
+			{
+				break;
+			}
+		}
+
+		// the nodes of a run share their texture, and so their variant
+		UseShaderVariant(GetDrawFeatures(first));
+		m_pUniformCache->SetIntValue(UniformCache::UNIFORM_USE_INSTANCING, true);
+
+		if (first.texture != INVALID_HANDLE)
+		{
+			SetShaderTexture(first.texture);
+			SetTextureUVScale(first.uvScale.x, first.uvScale.y);
+		}
+		else
+		{
+			m_pUniformCache->SetIntValue(UniformCache::UNIFORM_TEXTURE_LAYER, TextureLibrary::INVALID_LAYER);
+		}
+
+		m_instancedMeshes->DrawMeshInstanced(
+			first.lodMesh,
+			&m_instanceModels[0],
+			&m_instanceNormalMatrices[0],
+			&m_instanceMaterials[0],
+			m_instanceModels.size(),
+			&m_instanceColors[0]);
+		drawCount++;
+
+		runStart = runEnd;
+	}
+
+	return(drawCount);
+}
+
+/***********************************************************
+ *  PrepareIndirectRenderQueue()
+ *
+ *  This method is used for turning the sorted queue into the
+ *  commands of the indirect renderer.  Every item becomes one
+ *  indirect command with its own per-draw data, in the order
+ *  of the queue, so that a range of items is the same range of
+ *  commands.  With occlusion culling the occluders are first
+ *  drawn into a depth pyramid, and the commands hidden behind
+ *  them get an instance count of zero on the GPU, before any
+ *  of the ranges are drawn.  The order of the draws is picked
+ *  here, and the jobs then write the commands, the per-draw
+ *  data and the bounds of their own ranges of draws, so only
+ *  the uploads and the draws are made on the GL thread.  The
+ *  occluder draws are returned.
+ ***********************************************************/
+unsigned int SceneManager::PrepareIndirectRenderQueue()
+{
+	unsigned int drawCount = 0;
+	size_t occluderCount = 0;
+	bool bOcclusionPass = (m_bOcclusionCulling == true) && (NULL != m_pOcclusionCuller) && (m_bHasViewProjection == true);
+
+	m_indirectItems.clear();
+	m_indirectItems.reserve(m_renderQueue.GetItemCount());
+
+	// with occlusion culling the occluders are added first, so
+	// that they can be drawn on their own as the first range;
+	// they are opaque, so the transparent items stay last
+	for (int pass = (bOcclusionPass ? 0 : 1); pass < 2; pass++)
+	{
+		for (size_t i = 0; i < m_renderQueue.GetItemCount(); i++)
+		{
+			const RenderQueue::DRAW_ITEM& item = m_renderQueue.GetItem(i);
+			bool bOccluder = bOcclusionPass && m_sceneNodes[item.nodeIndex].bOccluder &&
+				(false == RenderQueue::IsTransparent(item.sortKey));
+
+			if (bOcclusionPass && (bOccluder != (pass == 0)))
+			{
+				continue;
+			}
+
+			m_indirectItems.push_back((uint32_t)i);
+			occluderCount += bOccluder ? 1 : 0;
+		}
+	}
+
+	m_pIndirectRenderer->ResizeDraws(m_indirectItems.size());
+	if (NULL != m_pOcclusionCuller)
+	{
+		m_pOcclusionCuller->ResizeBounds(bOcclusionPass ? m_indirectItems.size() : 0);
+	}
+
+	m_jobSystem.ParallelFor(m_indirectItems.size(), NODE_JOB_GRAIN, [&](size_t first, size_t last)
+	{
+		for (size_t draw = first; draw < last; draw++)
+		{
+			uint32_t nodeIndex = m_renderQueue.GetItem(m_indirectItems[draw]).nodeIndex;
+			const SCENE_NODE& node = m_sceneNodes[nodeIndex];
+			DRAW_DATA_STD430 drawData;
+
+			drawData.model = node.worldMatrix;
+			for (int column = 0; column < 3; column++)
+			{
+				drawData.normalMatrix[column] = glm::vec4(node.normalMatrix[column], 0.0f);
+			}
+			drawData.color = node.color;
+			drawData.materialIndex = (node.material != INVALID_HANDLE) ? (uint32_t)node.material : 0;
+			drawData.textureLayer = node.texture;
+			if (node.texture != INVALID_HANDLE)
+			{
+				drawData.uvScale = node.uvScale;
+			}
+			else
+			{
+				drawData.uvScale = glm::vec2(1.0f, 1.0f);
+			}
+
+			m_pIndirectRenderer->SetDraw(draw, node.lodMesh, drawData);
+			if (bOcclusionPass)
+			{
+				glm::vec3 center;
+				glm::vec3 extent;
+
+				m_frustumCuller.GetBounds(nodeIndex, center, extent);
+				m_pOcclusionCuller->SetBounds(draw, center, extent, draw < occluderCount);
+			}
+		}
+	});
+
+	if ((m_pIndirectRenderer->Upload() == true) && (bOcclusionPass == true) && (occluderCount > 0))
+	{
+		// draw the depth of the occluders into the pyramid, then
+		// cull every command against it on the GPU
+		m_pOcclusionCuller->BeginOccluderPass();
+		m_pIndirectRenderer->SetDepthOnly(true);
+		UseIndirectProgram();
+		drawCount += m_pIndirectRenderer->Draw(0, occluderCount);
+		m_pIndirectRenderer->SetDepthOnly(false);
+		m_pOcclusionCuller->EndOccluderPass();
+		m_pOcclusionCuller->BuildHiZ();
+		m_pOcclusionCuller->CullCommands(m_pIndirectRenderer->GetCommandBuffer(), m_viewProjection);
+
+		// the indirect program is left in use after drawing
+		m_currentProgram = 0;
+	}
+
+	return(drawCount);
+}
+
+/***********************************************************
+ *  SubmitIndirectRenderQueue()
+ *
+ *  This method is used for drawing a range of the commands
+ *  made by PrepareIndirectRenderQueue() with one multi-draw
+ *  call.  Occluders are moved to the front of the commands,
+ *  but they are opaque, so the opaque and transparent items
+ *  keep the same ranges as in the queue.
+ ***********************************************************/
+unsigned int SceneManager::SubmitIndirectRenderQueue(size_t firstItem, size_t lastItem)
+{
+	unsigned int drawCount = 0;
+
+	// every item has a command, even when its mesh was not in
+	// the library, so this only guards against a stale queue
+	lastItem = std::min(lastItem, m_pIndirectRenderer->GetDrawCount());
+	if (firstItem < lastItem)
+	{
+		UseIndirectProgram();
+		drawCount = m_pIndirectRenderer->Draw(firstItem, lastItem - firstItem);
+	}
+
+	// the indirect program is left in use after submitting
+	m_currentProgram = 0;
+
+	return(drawCount);
+}
+
+/***********************************************************
+ *  SetDepthOnly()
+ *
+ *  This method is used for switching the draws between the
+ *  depth-only variant, for the pre-pass, and the shading
+ *  variants that shade the fragments that passed it.
+ ***********************************************************/
+void SceneManager::SetDepthOnly(bool bDepthOnly)
+{
+	m_bDepthOnlyPass = bDepthOnly;
+	if (NULL != m_pIndirectRenderer)
+	{
+		m_pIndirectRenderer->SetDepthOnly(bDepthOnly);
+	}
+
+	glColorMask(!bDepthOnly, !bDepthOnly, !bDepthOnly, !bDepthOnly);
+}
+
+/***********************************************************
+ *  PrepareLocalLights()
+ *
+ *  This method is used for assigning the local lights to the
+ *  clusters of the current camera and uploading them for the
+ *  frame.  The forward mode only needs the lights themselves,
+ *  so it skips building the clusters.  Each program is given
+ *  the lights of the frame as it is put in use.
+ ***********************************************************/
+void SceneManager::PrepareLocalLights()
+{
+	bool bClustered = (m_lightingMode == LIGHTING_CLUSTERED) && (m_bHasViewProjection == true);
+
+	if (bClustered == true)
+	{
+		m_lightClusters.Update(m_view, m_projection);
+	}
+	else
+	{
+		m_lightClusters.UploadLights();
+	}
+	m_lightClusters.Bind();
+
+	// the next draw puts its own variant in use, which sets
+	// the lights of this frame into it
+	m_currentProgram = 0;
+}
+
+/***********************************************************
+ *  SetLightUniforms()
+ *
+ *  This method is used for setting the local lights and the
+ *  shadows of the frame into the program in use.  The values
+ *  go through the uniform cache of the program, so one that
+ *  was already drawn with them is not sent them again, and
+ *  the switches that a variant has built in are skipped.
+ ***********************************************************/
+void SceneManager::SetLightUniforms(UniformCache& uniforms)
+{
+	m_lightClusters.SetShaderUniforms(uniforms, (m_shadingFeatures & ShaderVariants::FEATURE_CLUSTERED_LIGHTS) != 0);
+	m_shadowMaps.SetShaderUniforms(uniforms, (m_shadingFeatures & ShaderVariants::FEATURE_SHADOWS) != 0);
+}
+
+/***********************************************************
+ *  RenderShadowMaps()
+ *
+ *  This method is used for drawing the shadow maps of the
+ *  frame.  The static casters are only drawn into a cached
+ *  layer again when its light or matrix moved or a static
+ *  caster changed, so a still scene draws no shadow casters
+ *  at all.  The dynamic casters are drawn over a copy of
+ *  every active layer each frame.
+ ***********************************************************/
+unsigned int SceneManager::RenderShadowMaps()
+{
+	unsigned int drawCount = 0;
+	bool bDynamicCasters = false;
+
+	if ((m_bShadows == false) || (m_shadowMaps.IsInitialized() == false) || (m_bUseLighting == false))
+	{
+		return(0);
+	}
+
+	if (m_bShadowCastersDirty == true)
+	{
+		UpdateShadowCasters();
+		m_bShadowCastersDirty = false;
+	}
+	m_shadowMaps.SetLights(m_lightBlock.directionalLight, m_lightBlock.spotLight);
+	m_shadowMaps.Update(m_view, m_projection, m_bHasViewProjection);
+	if (m_shadowMaps.IsActive() == false)
+	{
+		return(0);
+	}
+
+	bDynamicCasters = (m_dynamicCasters.empty() == false);
+	m_shadowMaps.BeginPass();
+	for (int layer = 0; layer < ShadowMaps::LAYER_COUNT; layer++)
+	{
+		if (m_shadowMaps.IsLayerActive(layer) == false)
+		{
+			continue;
+		}
+
+		if (m_shadowMaps.IsLayerDirty(layer) == true)
+		{
+			m_shadowMaps.BeginStaticLayer(layer);
+			drawCount += DrawShadowCasters(m_shadowMaps.GetLayerMatrix(layer), false);
+		}
+		if (bDynamicCasters == true)
+		{
+			m_shadowMaps.BeginDynamicLayer(layer);
+			drawCount += DrawShadowCasters(m_shadowMaps.GetLayerMatrix(layer), true);
+		}
+	}
+	m_shadowMaps.EndPass();
+	m_shadowMaps.Bind(bDynamicCasters);
+
+	// the next draw puts its own variant in use
+	m_currentProgram = 0;
+
+	return(drawCount);
+}
+
+/***********************************************************
+ *  UpdateShadowCasters()
+ *
+ *  This method is used for fitting the depth range of the
+ *  shadow maps around the world bounds of every caster, and
+ *  listing the dynamic casters.  The box is only fit again
+ *  when a static caster changed, so a dynamic caster that
+ *  leaves it is flattened onto its edge by the depth clamp.
+ ***********************************************************/
+void SceneManager::UpdateShadowCasters()
+{
+	glm::vec3 minimum(FLT_MAX);
+	glm::vec3 maximum(-FLT_MAX);
+
+	m_dynamicCasters.clear();
+	for (size_t i = 0; i < m_sceneNodes.size(); i++)
+	{
+		const SCENE_NODE& node = m_sceneNodes[i];
+		glm::vec3 center;
+		glm::vec3 extent;
+
+		if (IsShadowCaster(node) == false)
+		{
+			continue;
+		}
+
+		m_frustumCuller.GetBounds(i, center, extent);
+		minimum = glm::min(minimum, center - extent);
+		maximum = glm::max(maximum, center + extent);
+		if (node.bDynamic == true)
+		{
+			m_dynamicCasters.push_back((uint32_t)i);
+		}
+	}
+
+	m_shadowMaps.SetCasterBounds(minimum, maximum);
+}
+
+/***********************************************************
+ *  DrawShadowCasters()
+ *
+ *  This method is used for drawing the static or the dynamic
+ *  casters that the passed in light matrix sees, with one
+ *  instanced depth-only draw per mesh.  The casters are drawn
+ *  with the full mesh, since the levels of detail are picked
+ *  for the size of a node on the screen.
+ ***********************************************************/
+unsigned int SceneManager::DrawShadowCasters(const glm::mat4& lightMatrix, bool bDynamic)
+{
+	FrustumCuller::FRUSTUM frustum = FrustumCuller::ExtractFrustum(lightMatrix);
+	size_t casterCount = (bDynamic == true) ? m_dynamicCasters.size() : m_sceneNodes.size();
+	unsigned int drawCount = 0;
+
+	m_casterVisible.resize(m_sceneNodes.size());
+	if (bDynamic == true)
+	{
+		for (size_t i = 0; i < m_dynamicCasters.size(); i++)
+		{
+			m_frustumCuller.CullRange(frustum, m_dynamicCasters[i], m_dynamicCasters[i] + 1, &m_casterVisible[0]);
+		}
+	}
+	else
+	{
+		m_jobSystem.ParallelFor(m_sceneNodes.size(), NODE_JOB_GRAIN, [&](size_t first, size_t last)
+		{
+			m_frustumCuller.CullRange(frustum, first, last, &m_casterVisible[0]);
+		});
+	}
+
+	UseShaderVariant(ShaderVariants::FEATURE_DEPTH_ONLY);
+	m_pUniformCache->SetIntValue(UniformCache::UNIFORM_USE_INSTANCING, true);
+
+	for (int mesh = 0; mesh < (int)m_loadedMeshes.size(); mesh++)
+	{
+		m_instanceModels.clear();
+		m_instanceNormalMatrices.clear();
+		m_instanceMaterials.clear();
+		m_instanceColors.clear();
+
+		for (size_t i = 0; i < casterCount; i++)
+		{
+			size_t nodeIndex = (bDynamic == true) ? m_dynamicCasters[i] : i;
+			const SCENE_NODE& node = m_sceneNodes[nodeIndex];
+
+			if ((node.mesh != mesh) || (node.bDynamic != bDynamic) ||
+				(m_casterVisible[nodeIndex] == 0) || (IsShadowCaster(node) == false))
+			{
+				continue;
+			}
+
+			m_instanceModels.push_back(node.worldMatrix);
+			m_instanceNormalMatrices.push_back(node.normalMatrix);
+			m_instanceMaterials.push_back(0);
+			m_instanceColors.push_back(node.color);
+		}
+
+		if (m_instanceModels.empty() == false)
+		{
+			m_instancedMeshes->DrawMeshInstanced(
+				m_loadedMeshes[mesh].handle,
+				&m_instanceModels[0],
+				&m_instanceNormalMatrices[0],
+				&m_instanceMaterials[0],
+				m_instanceModels.size(),
+				&m_instanceColors[0]);
+			drawCount++;
+		}
+	}
+
+	return(drawCount);
+}
+
+/***********************************************************
+ *  IsShadowCaster()
+ *
+ *  This method is used for checking whether a node casts a
+ *  shadow, which the transparent nodes do not.
+ ***********************************************************/
+bool SceneManager::IsShadowCaster(const SCENE_NODE& node) const
+{
+	return(false == IsTransparentNode(node));
+}
+
+/***********************************************************
+ *  GetShadingFeatures()
+ *
+ *  This method is used for finding the shader features that
+ *  every draw of the frame shares, from the lights that are
+ *  active, the selected lighting mode and the shadows.
+ ***********************************************************/
+uint32_t SceneManager::GetShadingFeatures() const
+{
+	uint32_t features = 0;
+
+	if (m_bUseLighting == false)
+	{
+		return(0);
+	}
+
+	features |= ShaderVariants::FEATURE_LIGHTING;
+	features |= ShaderVariants::PointLightFeatures(m_activePointLights);
+	if (m_lightBlock.directionalLight.bActive)
+	{
+		features |= ShaderVariants::FEATURE_DIRECTIONAL_LIGHT;
+	}
+	if (m_lightBlock.spotLight.bActive)
+	{
+		features |= ShaderVariants::FEATURE_SPOT_LIGHT;
+	}
+	if ((m_lightingMode == LIGHTING_CLUSTERED) && (m_bHasViewProjection == true))
+	{
+		features |= ShaderVariants::FEATURE_CLUSTERED_LIGHTS;
+	}
+	if ((m_bShadows == true) && (m_shadowMaps.IsActive() == true))
+	{
+		features |= ShaderVariants::FEATURE_SHADOWS;
+	}
+
+	return(features);
+}
+
+/***********************************************************
+ *  GetDrawFeatures()
+ *
+ *  This method is used for finding the shader features that
+ *  the passed in node is drawn with.  The depth pre-pass uses
+ *  one variant for every node, since nothing is shaded.
+ ***********************************************************/
+uint32_t SceneManager::GetDrawFeatures(const SCENE_NODE& node) const
+{
+	if (m_bDepthOnlyPass == true)
+	{
+		return(ShaderVariants::FEATURE_DEPTH_ONLY);
+	}
+	if (node.texture != INVALID_HANDLE)
+	{
+		return(m_shadingFeatures | ShaderVariants::FEATURE_TEXTURED);
+	}
+
+	return(m_shadingFeatures);
+}
+
+/***********************************************************
+ *  UseShaderVariant()
+ *
+ *  This method is used for putting the program of the passed
+ *  in features in use, along with its uniform cache.  A new
+ *  variant gets the shared blocks, the texture array and the
+ *  lights the first time it is drawn with.  When the variant
+ *  could not be built the generic program is used, which
+ *  reads the same features from its uniforms at runtime.
+ ***********************************************************/
+void SceneManager::UseShaderVariant(uint32_t features)
+{
+	ShaderVariants::VARIANT* pVariant = NULL;
+	GLuint programID = m_baseProgramID;
+	UniformCache* pUniformCache = &m_uniformCache;
+
+	if ((features == m_currentFeatures) && (0 != m_currentProgram))
+	{
+		return;
+	}
+
+	pVariant = m_shaderVariants.GetVariant(features);
+	if (NULL != pVariant)
+	{
+		programID = pVariant->programID;
+		pUniformCache = &pVariant->uniforms;
+	}
+
+	if (programID != m_currentProgram)
+	{
+		glUseProgram(programID);
+		m_currentProgram = programID;
+	}
+	m_currentFeatures = features;
+	m_pUniformCache = pUniformCache;
+
+	if ((NULL != pVariant) && (false == pVariant->bPrepared))
+	{
+		AttachUniformBlocks(programID);
+		m_pUniformCache->SetIntValue(UniformCache::UNIFORM_OBJECT_TEXTURE, TEXTURE_ARRAY_UNIT);
+		LightClusters::SetSamplerUnits(programID);
+		ShadowMaps::SetSamplerUnit(programID);
+		pVariant->bPrepared = true;
+	}
+	SetLightUniforms(*m_pUniformCache);
+
+	// only the generic program has the depth-only switch
+	m_pUniformCache->SetIntValue(UniformCache::UNIFORM_DEPTH_ONLY, (features & ShaderVariants::FEATURE_DEPTH_ONLY) != 0);
+}
+
+/***********************************************************
+ *  UseIndirectProgram()
+ *
+ *  This method is used for putting the program of the indirect
+ *  renderer in use before its commands are drawn, and setting
+ *  the lights of the frame into it.
+ ***********************************************************/
+void SceneManager::UseIndirectProgram()
+{
+	UniformCache* pUniformCache = m_pIndirectRenderer->Use();
+
+	if (NULL != pUniformCache)
+	{
+		SetLightUniforms(*pUniformCache);
+	}
+}
+
+/***********************************************************
+ *  PrepareIndirectRenderer()
+ *
+ *  This method is used for creating the indirect renderer
+ *  when the context supports multi-draw indirect, and giving
+ *  its program the same blocks and lighting switch as the
+ *  main program.  On other contexts it stays NULL and the
+ *  indirect render path uses the batched path instead.
+ ***********************************************************/
+void SceneManager::PrepareIndirectRenderer()
+{
+	if (false == IndirectRenderer::IsSupported())
+	{
+		return;
+	}
+
+	m_pIndirectRenderer = new IndirectRenderer();
+	if (false == m_pIndirectRenderer->Initialize(g_IndirectVertexShader, g_IndirectFragmentShader, m_instancedMeshes))
+	{
+		delete m_pIndirectRenderer;
+		m_pIndirectRenderer = NULL;
+		return;
+	}
+
+	PrepareIndirectProgram();
+
+	// the occlusion pass culls the indirect commands, so it is
+	// only created along with the indirect renderer
+	if (true == OcclusionCuller::IsSupported())
+	{
+		m_pOcclusionCuller = new OcclusionCuller();
+		if (false == m_pOcclusionCuller->Initialize(g_HiZBuildShader, g_OcclusionCullShader))
+		{
+			delete m_pOcclusionCuller;
+			m_pOcclusionCuller = NULL;
+		}
+	}
+}
+
+/***********************************************************
+ *  PrepareIndirectProgram()
+ *
+ *  This method is used for attaching the shared blocks to the
+ *  program of the indirect renderer and turning its lighting
+ *  on, whenever that program has been built.
+ ***********************************************************/
+void SceneManager::PrepareIndirectProgram()
+{
+	AttachUniformBlocks(m_pIndirectRenderer->GetProgramID());
+
+	m_pIndirectRenderer->GetShaderManager()->use();
+	m_pIndirectRenderer->GetShaderManager()->setBoolValue(g_UseLightingName, true);
+	LightClusters::SetSamplerUnits(m_pIndirectRenderer->GetProgramID());
+	ShadowMaps::SetSamplerUnit(m_pIndirectRenderer->GetProgramID());
+	m_pShaderManager->use();
+	m_currentProgram = 0;
+}
+
+/***********************************************************
+ *  SetHotReloadEnabled()
+ *
+ *  This method is used for turning the watching of the asset
+ *  files on or off.  The files are taken as unchanged at the
+ *  moment they start being watched.
+ ***********************************************************/
+void SceneManager::SetHotReloadEnabled(bool bEnabled)
+{
+	m_bHotReload = bEnabled;
+	m_fileWatcher.Clear();
+	m_watchedAssets.clear();
+
+	if (true == bEnabled)
+	{
+		WatchAssetFiles();
+		std::cout << "INFO: Watching " << m_fileWatcher.GetFileCount() << " asset files for changes" << std::endl;
+	}
+}
+
+/***********************************************************
+ *  WatchAssetFiles()
+ *
+ *  This method is used for watching the shader files of every
+ *  program the scene draws with, the image of every texture
+ *  layer, and the scene file.
+ ***********************************************************/
+void SceneManager::WatchAssetFiles()
+{
+	WatchAsset(g_VariantVertexShader, ASSET_SHADER, INVALID_HANDLE);
+	WatchAsset(g_VariantFragmentShader, ASSET_SHADER, INVALID_HANDLE);
+	if (NULL != m_pIndirectRenderer)
+	{
+		WatchAsset(g_IndirectVertexShader, ASSET_SHADER, INVALID_HANDLE);
+		WatchAsset(g_IndirectFragmentShader, ASSET_SHADER, INVALID_HANDLE);
+	}
+	if (NULL != m_pOcclusionCuller)
+	{
+		WatchAsset(g_HiZBuildShader, ASSET_SHADER, INVALID_HANDLE);
+		WatchAsset(g_OcclusionCullShader, ASSET_SHADER, INVALID_HANDLE);
+	}
+
+	for (int layer = 0; layer < m_textureLibrary.GetLayerCount(); layer++)
+	{
+		WatchAsset(m_textureLibrary.GetTextureFilename(layer), ASSET_TEXTURE, layer);
+	}
+
+	if (!m_sceneFilename.empty())
+	{
+		WatchAsset(m_sceneFilename, ASSET_SCENE, INVALID_HANDLE);
+	}
+}
+
+/***********************************************************
+ *  WatchAsset()
+ *
+ *  This method is used for watching one asset file.  A file
+ *  that is used by several programs, like the fragment shader,
+ *  is only watched once.
+ ***********************************************************/
+void SceneManager::WatchAsset(const std::string& filename, ASSET_TYPE type, TextureHandle texture)
+{
+	WATCHED_ASSET asset;
+
+	if (m_fileWatcher.WatchFile(filename) < (FileWatcher::WatchHandle)m_watchedAssets.size())
+	{
+		return;
+	}
+
+	asset.type = type;
+	asset.texture = texture;
+	m_watchedAssets.push_back(asset);
+}
+
+/***********************************************************
+ *  ReloadChangedAssets()
+ *
+ *  This method is used for reloading the asset files that
+ *  were changed on disk.  A changed shader only rebuilds the
+ *  programs made from it, a changed image only decodes and
+ *  uploads its own layer on the loader threads, and a changed
+ *  scene only patches the nodes that differ.  Checking the
+ *  files costs a few stat calls every poll interval, and
+ *  nothing at all on the frames in between.
+ ***********************************************************/
+bool SceneManager::ReloadChangedAssets()
+{
+	bool bSceneShaders = false;
+	bool bIndirectShaders = false;
+	bool bReloaded = false;
+
+	if (false == m_bHotReload)
+	{
+		return(false);
+	}
+
+	m_changedFiles.clear();
+	if (false == m_fileWatcher.PollChanges(m_changedFiles))
+	{
+		return(false);
+	}
+
+	for (size_t i = 0; i < m_changedFiles.size(); i++)
+	{
+		const std::string& filename = m_fileWatcher.GetFilename(m_changedFiles[i]);
+		const WATCHED_ASSET& asset = m_watchedAssets[m_changedFiles[i]];
+
+		std::cout << "INFO: Reloading changed file:" << filename << std::endl;
+		if (asset.type == ASSET_TEXTURE)
+		{
+			bReloaded |= m_textureLibrary.ReloadTexture(asset.texture);
+		}
+		else if (asset.type == ASSET_SCENE)
+		{
+			bReloaded |= ReloadScene();
+		}
+		else
+		{
+			// the programs are rebuilt once below, however many
+			// of their files changed
+			bSceneShaders |= ((filename == g_VariantVertexShader) || (filename == g_VariantFragmentShader));
+			bIndirectShaders |= ((filename == g_IndirectVertexShader) || (filename == g_IndirectFragmentShader));
+			if (NULL != m_pOcclusionCuller)
+			{
+				bReloaded |= m_pOcclusionCuller->ReloadShader(filename);
+			}
+		}
+	}
+
+	if (true == bSceneShaders)
+	{
+		bReloaded |= ReloadSceneShaders();
+	}
+	if (true == bIndirectShaders)
+	{
+		bReloaded |= ReloadIndirectShaders();
+	}
+
+	return(bReloaded);
+}
+
+/***********************************************************
+ *  ReloadSceneShaders()
+ *
+ *  This method is used for rebuilding the generic program and
+ *  the shader variants after the scene shaders were changed.
+ *  The variants check that the new sources build, so with an
+ *  error in them the current programs are all kept, and a
+ *  generic program that does not link is deleted again.  The
+ *  variants drawn with are built again on their next use.
+ ***********************************************************/
+bool SceneManager::ReloadSceneShaders()
+{
+	GLint bLinked = GL_FALSE;
+	GLuint programID = 0;
+
+	if (false == m_shaderVariants.Reload())
+	{
+		std::cout << "Could not reload the scene shaders, keeping the current ones" << std::endl;
+		return(false);
+	}
+
+	programID = m_pShaderManager->LoadShaders(g_VariantVertexShader, g_VariantFragmentShader);
+	if (0 != programID)
+	{
+		glGetProgramiv(programID, GL_LINK_STATUS, &bLinked);
+	}
+	if (GL_TRUE == bLinked)
+	{
+		glDeleteProgram(m_baseProgramID);
+		m_baseProgramID = programID;
+	}
+	else
+	{
+		// LoadShaders() left the shader manager on the failed
+		// program, which is deleted so repeated bad edits do not
+		// leak programs, and the manager goes back to the current one
+		std::cout << "Could not reload the generic scene program, keeping the current one" << std::endl;
+		if (0 != programID)
+		{
+			glDeleteProgram(programID);
+		}
+		m_pShaderManager->m_programID = m_baseProgramID;
+	}
+
+	// the generic program is set up the way PrepareScene() did
+	glUseProgram(m_baseProgramID);
+	m_uniformCache.ResolveLocations(m_baseProgramID);
+	AttachUniformBlocks(m_baseProgramID);
+	LightClusters::SetSamplerUnits(m_baseProgramID);
+	ShadowMaps::SetSamplerUnit(m_baseProgramID);
+	m_uniformCache.SetIntValue(UniformCache::UNIFORM_OBJECT_TEXTURE, TEXTURE_ARRAY_UNIT);
+	if (GL_TRUE == bLinked)
+	{
+		m_pShaderManager->setBoolValue(g_UseLightingName, m_bUseLighting);
+	}
+	m_currentProgram = 0;
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReloadIndirectShaders()
+ *
+ *  This method is used for rebuilding the program of the
+ *  indirect renderer after one of its shaders was changed.
+ ***********************************************************/
+bool SceneManager::ReloadIndirectShaders()
+{
+	if ((NULL == m_pIndirectRenderer) || (false == m_pIndirectRenderer->ReloadShaders()))
+	{
+		return(false);
+	}
+
+	PrepareIndirectProgram();
+
+	return(true);
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+
+/***********************************************************
+* LoadSceneTextures()
+*
+* This method is used for loading the textures of the scene
+* file in memory to support the 3D scene rendering, keeping
+* the handle of each one in the order of the texture table
+***********************************************************/
+void SceneManager::LoadSceneTextures(const SceneFile& sceneFile, std::vector<TextureHandle>& textures) {
+	const SceneFile::TEXTURE_RECORD* pTextures = sceneFile.GetTextures();
+
+	textures.resize(sceneFile.GetTextureCount());
+	for (uint32_t i = 0; i < sceneFile.GetTextureCount(); i++)
+	{
+		textures[i] = RegisterTexture(
+			sceneFile.GetString(pTextures[i].pathOffset),
+			sceneFile.GetString(pTextures[i].nameOffset));
+	}
+
+	BindGLTextures();
+}
+
+/***********************************************************
+* LoadSceneMeshes()
+*
+* This method is used for importing the meshes of the mesh
+* table of the scene file and keeping the loaded mesh of
+* every mesh a node record can reference, the primitives
+* first.  A file that is already loaded is not imported
+* again, and a mesh that cannot be imported is drawn as a
+* box so the rest of the scene still loads.
+***********************************************************/
+void SceneManager::LoadSceneMeshes(const SceneFile& sceneFile, std::vector<int>& meshes) {
+	const SceneFile::MESH_RECORD* pMeshes = sceneFile.GetMeshes();
+
+	meshes.resize(SceneFile::SCENE_MESH_COUNT + sceneFile.GetMeshCount());
+	for (int i = 0; i < SceneFile::SCENE_MESH_COUNT; i++)
+	{
+		meshes[i] = g_SceneMeshTypes[i];
+	}
+
+	for (uint32_t i = 0; i < sceneFile.GetMeshCount(); i++)
+	{
+		const char* path = sceneFile.GetString(pMeshes[i].pathOffset);
+		int& mesh = meshes[SceneFile::SCENE_MESH_COUNT + i];
+
+		mesh = MESH_BOX;
+		for (size_t loaded = MESH_TYPE_COUNT; loaded < m_loadedMeshes.size(); loaded++)
+		{
+			if (m_loadedMeshes[loaded].path == path)
+			{
+				mesh = (int)loaded;
+			}
+		}
+		if (mesh != MESH_BOX)
+		{
+			continue;
+		}
+
+		MeshImporter::IMPORTED_MESH imported;
+		if (false == MeshImporter::ImportGltf(path, *m_instancedMeshes, imported))
+		{
+			std::cout << "Could not import mesh " << sceneFile.GetString(pMeshes[i].nameOffset)
+				<< ", drawing a box instead:" << path << std::endl;
+			continue;
+		}
+
+		LOADED_MESH loadedMesh;
+		loadedMesh.handle = imported.mesh;
+		loadedMesh.path = path;
+		loadedMesh.uvScale = imported.uvScale;
+		loadedMesh.meshMatrix = imported.meshMatrix;
+		m_loadedMeshes.push_back(loadedMesh);
+		mesh = (int)m_loadedMeshes.size() - 1;
+	}
+}
+
+/********************************************************
+*DefineObjectMaterials()
+*
+* This method is used for configuring the various material
+* settings for all of the objects within the 3D scene from
+* the material table of the scene file.
+* **********************************************************/
+void SceneManager::DefineObjectMaterials(const SceneFile& sceneFile) {
+	const SceneFile::MATERIAL_RECORD* pMaterials = sceneFile.GetMaterials();
+
+	for (uint32_t i = 0; i < sceneFile.GetMaterialCount(); i++)
+	{
+		const SceneFile::MATERIAL_RECORD& record = pMaterials[i];
+		OBJECT_MATERIAL material;
+
+		material.diffuseColor = glm::vec3(record.diffuse[0], record.diffuse[1], record.diffuse[2]);
+		material.specularColor = glm::vec3(record.specular[0], record.specular[1], record.specular[2]);
+		material.shininess = record.shininess;
+		material.opacity = record.opacity;
+		material.tag = sceneFile.GetString(record.nameOffset);
+		RegisterMaterial(material);
+	}
+}
+
+/***********************************************************
+ *  SetupSceneLights()
+ *
+ *  This method is used for setting up the lights of the
+ *  light table.  The directional, point and spot lights go
+ *  into the light block, and the local lights, which only reach
+ *  as far as their radius, are shaded through the clusters.
+ ***********************************************************/
+void SceneManager::SetupSceneLights(const SceneFile& sceneFile) {
+	const SceneFile::LIGHT_RECORD* pLights = sceneFile.GetLights();
+	int pointLightCount = 0;
+
+	m_pShaderManager->setBoolValue(g_UseLightingName, true);
+	m_bUseLighting = true;
+
+	// the lights are kept in the light block, which is only
+	// uploaded to the shader when it has been changed
+	m_lightBlock = LIGHT_BLOCK();
+	m_lightClusters.ClearLights();
+
+	for (uint32_t i = 0; i < sceneFile.GetLightCount(); i++)
+	{
+		const SceneFile::LIGHT_RECORD& record = pLights[i];
+		glm::vec3 vector(record.vector[0], record.vector[1], record.vector[2]);
+		glm::vec3 ambient(record.ambient[0], record.ambient[1], record.ambient[2]);
+		glm::vec3 diffuse(record.diffuse[0], record.diffuse[1], record.diffuse[2]);
+		glm::vec3 specular(record.specular[0], record.specular[1], record.specular[2]);
+
+		if (record.type == SceneFile::SCENE_LIGHT_DIRECTIONAL)
+		{
+			m_lightBlock.directionalLight.direction = vector;
+			m_lightBlock.directionalLight.ambient = ambient;
+			m_lightBlock.directionalLight.diffuse = diffuse;
+			m_lightBlock.directionalLight.specular = specular;
+			m_lightBlock.directionalLight.bActive = true;
+		}
+		else if (record.type == SceneFile::SCENE_LIGHT_POINT)
+		{
+			if (pointLightCount >= TOTAL_POINT_LIGHTS)
+			{
+				std::cout << "Point light " << i << " exceeds the " << TOTAL_POINT_LIGHTS << " point lights in the light block" << std::endl;
+				continue;
+			}
+
+			m_lightBlock.pointLights[pointLightCount].position = vector;
+			m_lightBlock.pointLights[pointLightCount].ambient = ambient;
+			m_lightBlock.pointLights[pointLightCount].diffuse = diffuse;
+			m_lightBlock.pointLights[pointLightCount].specular = specular;
+			m_lightBlock.pointLights[pointLightCount].bActive = true;
+			pointLightCount++;
+		}
+		else if (record.type == SceneFile::SCENE_LIGHT_SPOT)
+		{
+			// the block keeps the cosines of the cut off angles
+			m_lightBlock.spotLight.position = vector;
+			m_lightBlock.spotLight.direction = glm::vec3(record.direction[0], record.direction[1], record.direction[2]);
+			m_lightBlock.spotLight.cutOff = std::cos(glm::radians(record.cutOff));
+			m_lightBlock.spotLight.outerCutOff = std::cos(glm::radians(record.outerCutOff));
+			m_lightBlock.spotLight.constant = record.attenuation[0];
+			m_lightBlock.spotLight.linear = record.attenuation[1];
+			m_lightBlock.spotLight.quadratic = record.attenuation[2];
+			m_lightBlock.spotLight.ambient = ambient;
+			m_lightBlock.spotLight.diffuse = diffuse;
+			m_lightBlock.spotLight.specular = specular;
+			m_lightBlock.spotLight.bActive = true;
+		}
+		else
+		{
+			m_lightClusters.AddLight(vector, record.radius, diffuse, record.intensity);
+		}
+	}
+
+	m_bLightsDirty = true;
+}
+
+/***********************************************************
+ *  OpenSceneFile()
+ *
+ *  This method is used for opening the cooked form of the
+ *  passed in scene.  A text scene is cooked into the file
+ *  next to it whenever that file is missing or was cooked
+ *  from a different version of the text, so the layout of a
+ *  scene can be changed without rebuilding the program.  To
+ *  tell, the whole text is read and hashed on every load.
+ ***********************************************************/
+bool SceneManager::OpenSceneFile(const char* filename, SceneFile& sceneFile)
+{
+	std::string cookedPath = filename;
+
+	if (true == SceneCooker::IsSourcePath(filename))
+	{
+		uint64_t sourceHash = 0;
+
+		cookedPath = SceneCooker::GetCookedPath(filename);
+		if (false == SceneCooker::HashSourceFile(filename, sourceHash))
+		{
+			std::cout << "Could not open the scene:" << filename << std::endl;
+			return(false);
+		}
+
+		if ((false == sceneFile.Open(cookedPath.c_str())) || (sceneFile.GetSourceHash() != sourceHash))
+		{
+			sceneFile.Close();
+			if (false == SceneCooker::CookScene(filename, cookedPath.c_str()))
+			{
+				return(false);
+			}
+		}
+	}
+
+	if ((false == sceneFile.IsOpen()) && (false == sceneFile.Open(cookedPath.c_str())))
+	{
+		std::cout << "Could not open the cooked scene:" << cookedPath << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering, as they are described by the passed in scene
+ ***********************************************************/
+bool SceneManager::PrepareScene(const char* sceneFilename)
+{
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	std::vector<TextureHandle> textures;
+	std::vector<int> meshes;
+	SceneFile sceneFile;
+
+	if (false == OpenSceneFile(sceneFilename, sceneFile))
+	{
+		return(false);
+	}
+	m_sceneFilename = sceneFilename;
+
+	// the shader program is loaded and in use by now, so the
+	// per-draw uniform locations only need resolving once
+	GLint programID = 0;
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+	m_baseProgramID = (GLuint)programID;
+	m_uniformCache.ResolveLocations(m_baseProgramID);
+	LightClusters::SetSamplerUnits(m_baseProgramID);
+	ShadowMaps::SetSamplerUnit(m_baseProgramID);
+	CreateUniformBlocks(m_baseProgramID);
+
+	// the specialized variants are compiled as they are first
+	// drawn with, and the program above is used without them
+	if (false == m_shaderVariants.Initialize(g_VariantVertexShader, g_VariantFragmentShader, g_ProgramCacheDirectory))
+	{
+		std::cout << "Could not prepare the shader variants, using the generic shader" << std::endl;
+	}
+
+	DefineObjectMaterials(sceneFile);
+	LoadSceneTextures(sceneFile, textures);
+	SetupSceneLights(sceneFile);
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene, and every primitive shares the
+	// quantized vertex and index buffers of the mesh library
+	m_loadedMeshes.resize(MESH_TYPE_COUNT);
+	m_loadedMeshes[MESH_BOX].handle = m_instancedMeshes->LoadBoxMesh();
+	m_loadedMeshes[MESH_PLANE].handle = m_instancedMeshes->LoadPlaneMesh();
+	m_loadedMeshes[MESH_CYLINDER].handle = m_instancedMeshes->LoadCylinderMesh();
+	m_loadedMeshes[MESH_TORUS].handle = m_instancedMeshes->LoadTorusMesh();
+	for (int i = 0; i < MESH_TYPE_COUNT; i++)
+	{
+		m_loadedMeshes[i].uvScale = glm::vec2(1.0f, 1.0f);
+		m_loadedMeshes[i].meshMatrix = glm::mat4(1.0f);
+	}
+	// the imported meshes are added to the same buffers
+	LoadSceneMeshes(sceneFile, meshes);
+
+	// the indirect path draws from the same mesh library buffers
+	PrepareIndirectRenderer();
+
+	// the local lights are read from buffer textures by both
+	// programs, without them only the forward lights are drawn
+	if (false == m_lightClusters.Initialize())
+	{
+		m_lightClusters.ClearLights();
+	}
+
+	// the shadow maps are left out where their depth textures
+	// cannot be drawn into
+	if (false == m_shadowMaps.Initialize(ShadowMaps::DEFAULT_RESOLUTION))
+	{
+		std::cout << "Could not prepare the shadow maps, drawing the scene without shadows" << std::endl;
+		m_bShadows = false;
+	}
+
+	// the scene nodes are defined once, after the materials,
+	// textures and meshes they reference have been loaded
+	BuildSceneNodes(sceneFile, meshes, textures);
+	UpdateSceneNodes();
+
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	std::cout << "INFO: Loaded " << sceneFilename << ", " << m_sceneNodes.size() << " nodes in " << milliseconds << " ms" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  BuildSceneNodes()
+ *
+ *  This method is used for defining the retained scene nodes
+ *  for the 3D scene from the node table of the scene file.
+ *  Every node keeps its transform, material, texture and mesh
+ *  so that nothing is rebuilt per frame.
+ ***********************************************************/
+void SceneManager::BuildSceneNodes(
+	const SceneFile& sceneFile,
+	const std::vector<int>& meshes,
+	const std::vector<TextureHandle>& textures)
+{
+	const SceneFile::NODE_RECORD* pNodes = sceneFile.GetNodes();
+	int nodeIndex = -1;
+
+	m_sceneNodes.clear();
+	m_sceneNodes.reserve(sceneFile.GetNodeCount());
+
+	for (uint32_t i = 0; i < sceneFile.GetNodeCount(); i++)
+	{
+		nodeIndex = AddSceneNode(MESH_BOX, glm::vec3(1.0f), 0.0f, 0.0f, 0.0f, glm::vec3(0.0f));
+		ApplyNodeRecord(nodeIndex, pNodes[i], meshes, textures);
+	}
+}
+
+/***********************************************************
+ *  ApplyNodeRecord()
+ *
+ *  This method is used for setting the state of a scene node
+ *  to a record of the node table.  The indices of the record
+ *  were resolved when the scene was cooked.  Only a node whose
+ *  state differs is changed, and only a changed transform or
+ *  mesh marks the node dirty, so patching a scene that was
+ *  edited leaves the other nodes as they are.
+ ***********************************************************/
+bool SceneManager::ApplyNodeRecord(
+	int nodeIndex,
+	const SceneFile::NODE_RECORD& record,
+	const std::vector<int>& meshes,
+	const std::vector<TextureHandle>& textures)
+{
+	SCENE_NODE& node = m_sceneNodes[nodeIndex];
+	int mesh = meshes[record.mesh];
+	glm::vec3 scaleXYZ(record.scale[0], record.scale[1], record.scale[2]);
+	glm::vec3 rotationDegrees(record.rotation[0], record.rotation[1], record.rotation[2]);
+	glm::vec3 positionXYZ(record.position[0], record.position[1], record.position[2]);
+	glm::vec4 color(record.color[0], record.color[1], record.color[2], record.color[3]);
+	glm::vec2 uvScale = glm::vec2(record.uvScale[0], record.uvScale[1]) * m_loadedMeshes[mesh].uvScale;
+	TextureHandle texture = (record.texture != SceneFile::NO_INDEX) ? textures[record.texture] : INVALID_HANDLE;
+	bool bOccluder = (record.flags & SceneFile::NODE_OCCLUDER) != 0;
+	bool bDynamic = (record.flags & SceneFile::NODE_DYNAMIC) != 0;
+
+	if ((node.mesh == mesh) && (node.scaleXYZ == scaleXYZ) && (node.rotationDegrees == rotationDegrees) &&
+		(node.positionXYZ == positionXYZ) && (node.material == (MaterialHandle)record.material) &&
+		(node.texture == texture) && (node.color == color) && (node.uvScale == uvScale) &&
+		(node.bOccluder == bOccluder) && (node.bDynamic == bDynamic))
+	{
+		return(false);
+	}
+
+	if ((node.mesh != mesh) || (node.scaleXYZ != scaleXYZ) || (node.rotationDegrees != rotationDegrees) ||
+		(node.positionXYZ != positionXYZ))
+	{
+		node.mesh = mesh;
+		SetNodeTransform(nodeIndex, scaleXYZ, rotationDegrees.x, rotationDegrees.y, rotationDegrees.z, positionXYZ);
+	}
+	SetNodeMaterial(nodeIndex, (MaterialHandle)record.material);
+	SetNodeColor(nodeIndex, color.r, color.g, color.b, color.a);
+	SetNodeOccluder(nodeIndex, bOccluder);
+	SetNodeDynamic(nodeIndex, bDynamic);
+	node.texture = texture;
+	node.uvScale = uvScale;
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReloadScene()
+ *
+ *  This method is used for bringing the loaded scene up to
+ *  date with its changed scene file, which is cooked again
+ *  first.  The materials are updated in place and the few
+ *  lights are set up again, while the nodes are matched to
+ *  the node table by their order and only the nodes that
+ *  differ are patched; nodes are added or removed at the end.
+ *  The texture array cannot take new layers, so a texture
+ *  that was added to the scene is left out until a restart.
+ *  A mesh that was added is imported, while a mesh file that
+ *  was changed is only read again on the next start.
+ ***********************************************************/
+bool SceneManager::ReloadScene()
+{
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	std::vector<TextureHandle> textures;
+	std::vector<int> meshes;
+	SceneFile sceneFile;
+	const SceneFile::TEXTURE_RECORD* pTextures = NULL;
+	const SceneFile::MATERIAL_RECORD* pMaterials = NULL;
+	const SceneFile::NODE_RECORD* pNodes = NULL;
+	size_t nodeCount = 0;
+	unsigned int changedCount = 0;
+
+	if (false == OpenSceneFile(m_sceneFilename.c_str(), sceneFile))
+	{
+		std::cout << "Could not reload the scene, keeping the current one:" << m_sceneFilename << std::endl;
+		return(false);
+	}
+
+	pTextures = sceneFile.GetTextures();
+	textures.resize(sceneFile.GetTextureCount());
+	for (uint32_t i = 0; i < sceneFile.GetTextureCount(); i++)
+	{
+		textures[i] = FindTextureSlot(sceneFile.GetString(pTextures[i].nameOffset));
+		if (textures[i] == INVALID_HANDLE)
+		{
+			std::cout << "New texture " << sceneFile.GetString(pTextures[i].nameOffset) << " is loaded on the next start" << std::endl;
+		}
+	}
+
+	// a mesh that was added to the scene is imported now, while
+	// the meshes that are already loaded are kept as they are
+	LoadSceneMeshes(sceneFile, meshes);
+
+	pMaterials = sceneFile.GetMaterials();
+	for (uint32_t i = 0; i < sceneFile.GetMaterialCount(); i++)
+	{
+		const SceneFile::MATERIAL_RECORD& record = pMaterials[i];
+		OBJECT_MATERIAL material;
+
+		material.diffuseColor = glm::vec3(record.diffuse[0], record.diffuse[1], record.diffuse[2]);
+		material.specularColor = glm::vec3(record.specular[0], record.specular[1], record.specular[2]);
+		material.shininess = record.shininess;
+		material.opacity = record.opacity;
+		material.tag = sceneFile.GetString(record.nameOffset);
+		if (i >= m_objectMaterials.size())
+		{
+			RegisterMaterial(material);
+		}
+		else if ((m_objectMaterials[i].diffuseColor != material.diffuseColor) ||
+			(m_objectMaterials[i].specularColor != material.specularColor) ||
+			(m_objectMaterials[i].shininess != material.shininess) ||
+			(m_objectMaterials[i].opacity != material.opacity) ||
+			(m_objectMaterials[i].tag != material.tag))
+		{
+			m_objectMaterials[i] = material;
+			m_bMaterialsDirty = true;
+			// a material that became transparent stops casting
+			m_bShadowCastersDirty = true;
+		}
+	}
+	if (m_objectMaterials.size() > sceneFile.GetMaterialCount())
+	{
+		m_objectMaterials.resize(sceneFile.GetMaterialCount());
+		m_bMaterialsDirty = true;
+	}
+
+	// the lighting switch is set on the generic program
+	m_pShaderManager->use();
+	SetupSceneLights(sceneFile);
+	m_currentProgram = 0;
+
+	pNodes = sceneFile.GetNodes();
+	nodeCount = sceneFile.GetNodeCount();
+	if (m_sceneNodes.size() > nodeCount)
+	{
+		changedCount += (unsigned int)(m_sceneNodes.size() - nodeCount);
+		m_sceneNodes.resize(nodeCount);
+		m_bShadowCastersDirty = true;
+	}
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		if (i >= m_sceneNodes.size())
+		{
+			AddSceneNode(MESH_BOX, glm::vec3(1.0f), 0.0f, 0.0f, 0.0f, glm::vec3(0.0f));
+		}
+		if (true == ApplyNodeRecord((int)i, pNodes[i], meshes, textures))
+		{
+			changedCount++;
+		}
+	}
+
+	double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	std::cout << "INFO: Reloaded " << m_sceneFilename << ", " << changedCount << " of " << nodeCount << " nodes changed in " << milliseconds << " ms" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting the per-frame arrays of
+ *  the next frame in the passed in frame arena.  The arrays of
+ *  the last frame were in the memory the arena just took back,
+ *  so they are replaced without being freed.  The arrays with
+ *  an item per node get their room up front, so they do not
+ *  leave copies of themselves behind in the arena as they grow.
+ ***********************************************************/
+void SceneManager::BeginFrame(FrameArena* pArena)
+{
+	size_t nodeCount = m_sceneNodes.size();
+
+	m_nodeVisible = FrameVector<uint8_t>(FrameAllocator<uint8_t>(pArena));
+	m_nodeSortKeys = FrameVector<uint64_t>(FrameAllocator<uint64_t>(pArena));
+	m_indirectItems = FrameVector<uint32_t>(FrameAllocator<uint32_t>(pArena));
+	m_instanceModels = FrameVector<glm::mat4>(FrameAllocator<glm::mat4>(pArena));
+	m_instanceNormalMatrices = FrameVector<glm::mat3>(FrameAllocator<glm::mat3>(pArena));
+	m_instanceMaterials = FrameVector<uint32_t>(FrameAllocator<uint32_t>(pArena));
+	m_instanceColors = FrameVector<glm::vec4>(FrameAllocator<glm::vec4>(pArena));
+	m_casterVisible = FrameVector<uint8_t>(FrameAllocator<uint8_t>(pArena));
+
+	m_nodeVisible.reserve(nodeCount);
+	m_casterVisible.reserve(nodeCount);
+	m_nodeSortKeys.reserve(nodeCount);
+	m_indirectItems.reserve(nodeCount);
+	m_renderQueue.Reset(pArena, nodeCount);
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by 
+ *  drawing the retained scene nodes
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	m_uniformCache.ResetCounters();
+	m_shaderVariants.ResetCounters();
+	m_textureLibrary.ResetCounters();
+	m_shadowMaps.ResetCounters();
+
+	// textures that finished decoding on the loader threads
+	// replace their placeholders a few at a time
+	m_textureLibrary.UpdateUploads();
+
+	// the material and light blocks are only re-sent
+	// when they have been changed
+	UploadUniformBlocks();
+
+	// only the nodes that were changed since the last
+	// frame need their world matrix rebuilt
+	UpdateSceneNodes();
+
+	// only the nodes inside the view frustum are queued
+	CullSceneNodes();
+
+	// the cached shadow maps are only drawn again for a light
+	// or static caster that changed, before the frame reads them
+	unsigned int drawCount = RenderShadowMaps();
+
+	// every draw of the frame shares the lighting features of
+	// its shader variant, and adds whether it is textured
+	m_shadingFeatures = GetShadingFeatures();
+
+	// without multi-draw indirect support the batched path is
+	// used, which draws the same sorted queue one node at a time
+	if ((m_renderPath == RENDER_PATH_INDIRECT) && (NULL == m_pIndirectRenderer))
+	{
+		std::cout << "Multi-draw indirect is not supported, using the batched render path" << std::endl;
+		m_renderPath = RENDER_PATH_BATCHED;
+	}
+
+	// the nodes are drawn through the render queue, which
+	// groups them by their draw state on the batched path
+	BuildRenderQueue();
+
+	// the local lights are clustered for the current camera
+	PrepareLocalLights();
+
+	size_t itemCount = m_renderQueue.GetItemCount();
+	size_t opaqueCount = m_renderQueue.GetOpaqueCount();
+
+	if (m_renderPath == RENDER_PATH_INDIRECT)
+	{
+		drawCount += PrepareIndirectRenderQueue();
+	}
+
+	// the opaque items are drawn without blending, which saves
+	// reading back every pixel they cover
+	if (m_bDepthPrepass == true)
+	{
+		// lay down the depth of the opaque items without shading,
+		// then shade only the fragments that match it, so every
+		// covered pixel runs the lighting once
+		SetDepthOnly(true);
+		drawCount += SubmitQueueRange(0, opaqueCount);
+		SetDepthOnly(false);
+
+		glDepthMask(GL_FALSE);
+		glDepthFunc(GL_EQUAL);
+		drawCount += SubmitQueueRange(0, opaqueCount);
+		glDepthMask(GL_TRUE);
+		glDepthFunc(GL_LESS);
+	}
+	else
+	{
+		drawCount += SubmitQueueRange(0, opaqueCount);
+	}
+
+	// the transparent items are blended over the result from
+	// the back to the front, testing against the opaque depth
+	// without writing their own, so glass behind glass shows
+	if (opaqueCount < itemCount)
+	{
+		glEnable(GL_BLEND);
+		glDepthMask(GL_FALSE);
+		drawCount += SubmitQueueRange(opaqueCount, itemCount);
+		glDepthMask(GL_TRUE);
+		glDisable(GL_BLEND);
+	}
+
+	m_renderStats = m_renderQueue.CountStateChanges();
+	m_renderStats.drawCount = drawCount;
+	m_renderStats.triangleCount = CountQueuedTriangles();
+}
+
+/***********************************************************
+ *  CountQueuedTriangles()
+ *
+ *  This method is used for counting the triangles of every
+ *  item in the render queue, which is the same on every
+ *  render path.
+ ***********************************************************/
+unsigned int SceneManager::CountQueuedTriangles() const
+{
+	unsigned int triangleCount = 0;
+
+	for (size_t i = 0; i < m_renderQueue.GetItemCount(); i++)
+	{
+		const SCENE_NODE& node = m_sceneNodes[m_renderQueue.GetItem(i).nodeIndex];
+		triangleCount += m_instancedMeshes->GetTriangleCount(node.lodMesh);
+	}
+
+	return(triangleCount);
+}
\ No newline at end of file
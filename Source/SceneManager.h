@@ -1,111 +1,500 @@
-///////////////////////////////////////////////////////////////////////////////
-// scenemanager.h
-// ============
-// manage the preparing and rendering of 3D scenes - textures, materials, lighting
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager *pShaderManager);
-	// destructor
-	~SceneManager();
-
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	struct OBJECT_MATERIAL
-	{
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
-	void BindGLTextures();
-	// free the loaded OpenGL textures
-	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	// set the UV scale for the texture mapping
-	void SetTextureUVScale(
-		float u, float v);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-public:
-
-	void DefineObjectMaterials();
-
-	void SetupSceneLights();
-
-	void LoadSceneTextures();
-
-	// The following methods are for the students to 
-	// customize for their own 3D scene
-	void PrepareScene();
-	void RenderScene();
-
+///////////////////////////////////////////////////////////////////////////////
+// scenemanager.h
+// ============
+// manage the preparing and rendering of 3D scenes - textures, materials, lighting
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "UniformCache.h"
+#include "ShaderBlocks.h"
+#include "RenderQueue.h"
+#include "MeshLibrary.h"
+#include "IndirectRenderer.h"
+#include "TextureLibrary.h"
+#include "FrustumCuller.h"
+#include "OcclusionCuller.h"
+#include "LightClusters.h"
+#include "ShaderVariants.h"
+#include "JobSystem.h"
+#include "FrameArena.h"
+#include "SceneFile.h"
+#include "FileWatcher.h"
+#include "ShadowMaps.h"
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor
+	SceneManager(ShaderManager *pShaderManager);
+	// destructor
+	~SceneManager();
+
+	// compact ids returned when textures and materials are
+	// registered, used in place of the tag strings at draw time
+	typedef int TextureHandle;
+	typedef int MaterialHandle;
+	static const int INVALID_HANDLE = -1;
+
+	struct OBJECT_MATERIAL
+	{
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		// below one for a material that is seen through, whose
+		// nodes are drawn in the transparent pass
+		float opacity;
+		std::string tag;
+	};
+
+	// basic mesh shapes that a scene node can reference, which
+	// are the first of the loaded meshes
+	enum MESH_TYPE
+	{
+		MESH_BOX = 0,
+		MESH_PLANE,
+		MESH_CYLINDER,
+		MESH_TORUS,
+		MESH_TYPE_COUNT
+	};
+
+	// how the scene nodes are submitted for drawing
+	enum RENDER_PATH
+	{
+		// one draw per node, in the order the nodes were added
+		RENDER_PATH_LEGACY = 0,
+		// one draw per node, sorted by the render queue
+		RENDER_PATH_BATCHED,
+		// one instanced draw per run of nodes in the sorted queue
+		// that share a mesh, texture and UV scale
+		RENDER_PATH_INSTANCED,
+		// one multi-draw indirect call for the whole sorted queue,
+		// falls back to the batched path without GL 4.6
+		RENDER_PATH_INDIRECT
+	};
+
+	// how the local lights are shaded by each fragment
+	enum LIGHTING_MODE
+	{
+		// every fragment loops over every local light
+		LIGHTING_FORWARD = 0,
+		// every fragment loops over the local lights of its
+		// cluster of the view only
+		LIGHTING_CLUSTERED
+	};
+
+	// retained render state for one drawn object in the scene;
+	// the world matrix is only rebuilt when the node is dirty
+	struct SCENE_NODE
+	{
+		glm::vec3 scaleXYZ;
+		glm::vec3 rotationDegrees;
+		glm::vec3 positionXYZ;
+		glm::mat4 worldMatrix;
+		// inverse transpose of the world matrix for the normals,
+		// rebuilt together with it
+		glm::mat3 normalMatrix;
+		MaterialHandle material;
+		TextureHandle texture;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		// index of the loaded mesh, a MESH_TYPE for a primitive
+		int mesh;
+		// level of detail of the mesh picked for the current frame
+		MeshLibrary::MeshHandle lodMesh;
+		// large opaque nodes drawn first for occlusion culling
+		bool bOccluder;
+		// nodes that move every frame, whose shadows are drawn
+		// every frame instead of into the cached shadow maps
+		bool bDynamic;
+		bool bDirty;
+	};
+
+private:
+	// kinds of asset file that are watched for hot reload
+	enum ASSET_TYPE
+	{
+		ASSET_SHADER = 0,
+		ASSET_TEXTURE,
+		ASSET_SCENE
+	};
+
+	// a mesh that scene nodes can be drawn with
+	struct LOADED_MESH
+	{
+		MeshLibrary::MeshHandle handle;
+		// glTF file of an imported mesh, empty for a primitive
+		std::string path;
+		// multiplies the UV scale of the nodes that draw the mesh
+		glm::vec2 uvScale;
+		// moves an imported mesh from its packed range back into
+		// place, ahead of the transform of the nodes
+		glm::mat4 meshMatrix;
+	};
+
+	// what a watched file is reloaded as
+	struct WATCHED_ASSET
+	{
+		ASSET_TYPE type;
+		// layer of a texture file
+		TextureHandle texture;
+	};
+
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// primitive meshes that every render path draws from, in
+	// one shared vertex array that also supports instancing
+	MeshLibrary* m_instancedMeshes;
+	// the primitives in the order of MESH_TYPE, followed by the
+	// meshes imported for the scene
+	std::vector<LOADED_MESH> m_loadedMeshes;
+	// per-instance data of the instanced draw being built
+	FrameVector<glm::mat4> m_instanceModels;
+	FrameVector<glm::mat3> m_instanceNormalMatrices;
+	FrameVector<uint32_t> m_instanceMaterials;
+	FrameVector<glm::vec4> m_instanceColors;
+	// multi-draw indirect renderer, NULL when not supported
+	IndirectRenderer* m_pIndirectRenderer;
+	// GPU occlusion culling of the indirect draws, NULL when
+	// compute shaders are not supported
+	OcclusionCuller* m_pOcclusionCuller;
+	bool m_bOcclusionCulling;
+	// loaded textures, one layer of the texture array each
+	TextureLibrary m_textureLibrary;
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// retained scene nodes, stored contiguously in draw order
+	std::vector<SCENE_NODE> m_sceneNodes;
+	// cached locations and values of the per-draw uniforms of
+	// the generic program
+	UniformCache m_uniformCache;
+	GLuint m_baseProgramID;
+	// programs specialized for the shading features of a draw,
+	// and the one in use with its uniform cache
+	ShaderVariants m_shaderVariants;
+	GLuint m_currentProgram;
+	uint32_t m_currentFeatures;
+	UniformCache* m_pUniformCache;
+	// features shared by every draw of the frame
+	uint32_t m_shadingFeatures;
+	bool m_bDepthOnlyPass;
+	bool m_bUseLighting;
+	// number of active point lights, packed at the front of the block
+	int m_activePointLights;
+	// uniform buffers holding the material and light blocks
+	GLuint m_materialBuffer;
+	GLuint m_lightBuffer;
+	// scene lights in the layout of the light block
+	LIGHT_BLOCK m_lightBlock;
+	// set when a block has changed since it was last uploaded
+	bool m_bMaterialsDirty;
+	bool m_bLightsDirty;
+	// selected path for submitting the scene nodes
+	RENDER_PATH m_renderPath;
+	// draw items of the current frame and their state changes
+	RenderQueue m_renderQueue;
+	RenderQueue::QUEUE_STATS m_renderStats;
+	// world bounds of the scene nodes for frustum culling
+	FrustumCuller m_frustumCuller;
+	// visibility of each scene node in the current frame
+	FrameVector<uint8_t> m_nodeVisible;
+	// camera matrices that the nodes are culled against and
+	// the local lights are clustered for
+	glm::mat4 m_view;
+	glm::mat4 m_projection;
+	glm::mat4 m_viewProjection;
+	bool m_bHasViewProjection;
+	bool m_bCullingEnabled;
+	unsigned int m_culledNodeCount;
+	// local lights and the clusters of the view they reach
+	LightClusters m_lightClusters;
+	LIGHTING_MODE m_lightingMode;
+	// draw the depth of the opaque nodes before shading them
+	bool m_bDepthPrepass;
+	// pick the level of detail of the meshes by their screen size
+	bool m_bLevelOfDetail;
+	// worker threads that the frame is built on
+	JobSystem m_jobSystem;
+	// sort key of every visible node, built by the jobs
+	FrameVector<uint64_t> m_nodeSortKeys;
+	// queue item of every indirect draw, occluders first
+	FrameVector<uint32_t> m_indirectItems;
+	// scene the nodes were loaded from
+	std::string m_sceneFilename;
+	// asset files watched for changes, what each of them is,
+	// and the ones that changed on the last check
+	FileWatcher m_fileWatcher;
+	std::vector<WATCHED_ASSET> m_watchedAssets;
+	std::vector<FileWatcher::WatchHandle> m_changedFiles;
+	bool m_bHotReload;
+	// shadows of the directional and spot lights, and the
+	// dynamic nodes drawn into them every frame
+	ShadowMaps m_shadowMaps;
+	bool m_bShadows;
+	// set when a static caster moved or was added, removed, or
+	// made transparent, which draws the cached maps again
+	bool m_bShadowCastersDirty;
+	std::vector<uint32_t> m_dynamicCasters;
+	// visibility of each scene node to the light being drawn
+	FrameVector<uint8_t> m_casterVisible;
+
+	// load a texture and return the handle it is drawn with
+	TextureHandle RegisterTexture(const char* filename, const std::string& tag);
+	// build the texture array from the loaded textures and bind it
+	void BindGLTextures();
+	// free the loaded OpenGL textures
+	void DestroyGLTextures();
+	// find a loaded texture by tag
+	TextureHandle FindTextureSlot(const std::string& tag);
+	// add a material and return the handle it is drawn with
+	MaterialHandle RegisterMaterial(const OBJECT_MATERIAL& material);
+	// find a defined material by tag
+	bool FindMaterial(const std::string& tag, OBJECT_MATERIAL& material);
+	MaterialHandle FindMaterialIndex(const std::string& tag);
+
+	// create the uniform buffers and attach them to the program
+	void CreateUniformBlocks(GLuint programID);
+	// attach the shared uniform blocks to the program
+	void AttachUniformBlocks(GLuint programID);
+	// upload the material and light blocks if they have changed
+	void UploadUniformBlocks();
+
+	// build the transform matrix from the passed in values
+	glm::mat4 BuildTransformations(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set the transformation values 
+	// into the transform buffer
+	void SetTransformations(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set the color values into the shader
+	void SetShaderColor(
+		float redColorValue,
+		float greenColorValue,
+		float blueColorValue,
+		float alphaValue);
+
+	// set the texture data into the shader
+	void SetShaderTexture(
+		TextureHandle texture);
+	void SetShaderTexture(
+		const std::string& textureTag);
+
+	// set the UV scale for the texture mapping
+	void SetTextureUVScale(
+		float u, float v);
+
+	// set the object material into the shader
+	void SetShaderMaterial(
+		MaterialHandle material);
+	void SetShaderMaterial(
+		const std::string& materialTag);
+
+	// add a new node to the retained scene and return its index
+	int AddSceneNode(
+		int mesh,
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set the render state that a scene node is drawn with
+	void SetNodeMaterial(int nodeIndex, MaterialHandle material);
+	void SetNodeMaterial(int nodeIndex, const std::string& materialTag);
+	void SetNodeTexture(int nodeIndex, TextureHandle texture, float u = 1.0f, float v = 1.0f);
+	void SetNodeTexture(int nodeIndex, const std::string& textureTag, float u = 1.0f, float v = 1.0f);
+	void SetNodeColor(int nodeIndex, float red, float green, float blue, float alpha);
+	// mark a large opaque node that hides the geometry behind it
+	void SetNodeOccluder(int nodeIndex, bool bOccluder);
+	// mark a node that moves every frame, so that it is left out
+	// of the cached shadow maps
+	void SetNodeDynamic(int nodeIndex, bool bDynamic);
+
+	// rebuild the world matrices of the nodes marked as dirty
+	void UpdateSceneNodes();
+	// send the retained state of a node to the shader and draw it
+	void DrawSceneNode(const SCENE_NODE& node);
+
+	// pick the level of detail of a node from its screen size
+	MeshLibrary::MeshHandle SelectNodeLod(size_t nodeIndex) const;
+	// whether a node is blended in the transparent pass, and its
+	// distance in front of the camera that the pass is sorted by
+	bool IsTransparentNode(const SCENE_NODE& node) const;
+	float GetNodeViewDepth(size_t nodeIndex) const;
+	// queue a draw item for every scene node
+	void BuildRenderQueue();
+	// draw a range of the queued items with the selected render
+	// path, returning the number of draw calls
+	unsigned int SubmitQueueRange(size_t firstItem, size_t lastItem);
+	// draw the queued items in queue order
+	unsigned int SubmitRenderQueue(size_t firstItem, size_t lastItem);
+	// draw the queued items with one instanced draw per run of
+	// items that can share their draw state
+	unsigned int SubmitInstancedRenderQueue(size_t firstItem, size_t lastItem);
+	bool CanShareInstancedDraw(const SCENE_NODE& first, const SCENE_NODE& node) const;
+	// build and upload an indirect command for every queued item,
+	// culling them against the occluders when that is turned on
+	unsigned int PrepareIndirectRenderQueue();
+	// draw the queued items with multi-draw indirect calls
+	unsigned int SubmitIndirectRenderQueue(size_t firstItem, size_t lastItem);
+	// switch the programs between drawing depth only and shading
+	void SetDepthOnly(bool bDepthOnly);
+	// shader features shared by the draws of the frame, and the
+	// ones that the passed in node is drawn with
+	uint32_t GetShadingFeatures() const;
+	uint32_t GetDrawFeatures(const SCENE_NODE& node) const;
+	// put the shader variant of the passed in features in use
+	void UseShaderVariant(uint32_t features);
+	// put the indirect program in use along with the lights
+	void UseIndirectProgram();
+	// cluster the local lights and upload them for the frame
+	void PrepareLocalLights();
+	// set the lights of the frame into the program in use
+	void SetLightUniforms(UniformCache& uniforms);
+	// draw the layers of the shadow maps that need it, returning
+	// the number of draw calls
+	unsigned int RenderShadowMaps();
+	// fit the shadow maps to the casters and list the dynamic ones
+	void UpdateShadowCasters();
+	// draw the static or dynamic casters seen by a light matrix
+	unsigned int DrawShadowCasters(const glm::mat4& lightMatrix, bool bDynamic);
+	bool IsShadowCaster(const SCENE_NODE& node) const;
+	// count the triangles of the queued items
+	unsigned int CountQueuedTriangles() const;
+	// flag the scene nodes that are inside the view frustum
+	void CullSceneNodes();
+	// set up the indirect renderer when the context supports it
+	void PrepareIndirectRenderer();
+	// attach the blocks and set the lighting of the indirect program
+	void PrepareIndirectProgram();
+	// open the cooked form of a scene, cooking a text scene first
+	// when its cooked file is missing or stale
+	bool OpenSceneFile(const char* filename, SceneFile& sceneFile);
+	// set a scene node to a node record, returning whether any of
+	// its state was changed
+	bool ApplyNodeRecord(
+		int nodeIndex,
+		const SceneFile::NODE_RECORD& record,
+		const std::vector<int>& meshes,
+		const std::vector<TextureHandle>& textures);
+
+	// watch the shaders, textures and scene of the loaded scene
+	void WatchAssetFiles();
+	void WatchAsset(const std::string& filename, ASSET_TYPE type, TextureHandle texture);
+	// rebuild the programs of changed shader files
+	bool ReloadSceneShaders();
+	bool ReloadIndirectShaders();
+	// patch the materials, lights and nodes that were changed in
+	// the scene file
+	bool ReloadScene();
+
+public:
+
+	// set up the materials, textures and lights of a scene file
+	void DefineObjectMaterials(const SceneFile& sceneFile);
+
+	void SetupSceneLights(const SceneFile& sceneFile);
+
+	void LoadSceneTextures(const SceneFile& sceneFile, std::vector<TextureHandle>& textures);
+
+	// import the meshes of a scene file that are not loaded yet,
+	// keeping the loaded mesh of each mesh a node can reference
+	void LoadSceneMeshes(const SceneFile& sceneFile, std::vector<int>& meshes);
+
+	// define the retained scene nodes of a scene file, with the
+	// loaded meshes and the handles of its loaded textures
+	void BuildSceneNodes(
+		const SceneFile& sceneFile,
+		const std::vector<int>& meshes,
+		const std::vector<TextureHandle>& textures);
+
+	// change the transform of a scene node and mark it dirty
+	void SetNodeTransform(
+		int nodeIndex,
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// The following methods are for the students to 
+	// customize for their own 3D scene
+	bool PrepareScene(const char* sceneFilename);
+	void RenderScene();
+
+	// watch the shaders, textures and scene file for changes
+	void SetHotReloadEnabled(bool bEnabled);
+	bool IsHotReloadEnabled() const { return(m_bHotReload); }
+	// reload the asset files that were changed on disk since the
+	// last check, returning whether anything was reloaded
+	bool ReloadChangedAssets();
+
+	// per-draw uniform uploads of every program in the last rendered frame
+	unsigned int GetUniformUploadCount() const { return(m_uniformCache.GetUploadCount() + m_shaderVariants.GetUploadCount()); }
+	// check whether any texture still shows its placeholder
+	bool IsLoadingTextures() const { return(m_textureLibrary.IsLoading()); }
+	// wait for all the textures to be decoded and uploaded
+	void FinishTextureLoading() { m_textureLibrary.FinishUploads(); }
+
+	// draw calls and state changes of the last rendered frame
+	const RenderQueue::QUEUE_STATS& GetRenderStats() const { return(m_renderStats); }
+	// camera matrices of the current frame, which the scene
+	// nodes are culled against and the lights clustered for
+	void SetCameraMatrices(const glm::mat4& view, const glm::mat4& projection);
+	// turn frustum culling on or off
+	void SetCullingEnabled(bool bEnabled) { m_bCullingEnabled = bEnabled; }
+	// turn the GPU occlusion culling of the indirect path on or off
+	void SetOcclusionCullingEnabled(bool bEnabled) { m_bOcclusionCulling = bEnabled; }
+	// scene nodes skipped by culling in the last rendered frame
+	unsigned int GetCulledNodeCount() const { return(m_culledNodeCount); }
+	// texture binds made during the last rendered frame
+	unsigned int GetTextureBindCount() const { return(m_textureLibrary.GetBindCount()); }
+	// cached shadow map layers drawn again in the last rendered frame
+	unsigned int GetShadowLayerCount() const { return(m_shadowMaps.GetStaticRenderCount()); }
+
+	// select how the local lights are shaded
+	void SetLightingMode(LIGHTING_MODE lightingMode) { m_lightingMode = lightingMode; }
+	LIGHTING_MODE GetLightingMode() const { return(m_lightingMode); }
+	// turn the depth pre-pass of the opaque nodes on or off
+	void SetDepthPrepassEnabled(bool bEnabled) { m_bDepthPrepass = bEnabled; }
+	// turn the screen size levels of detail on or off
+	void SetLevelOfDetailEnabled(bool bEnabled) { m_bLevelOfDetail = bEnabled; }
+	// turn the shadows of the directional and spot lights on or off
+	void SetShadowsEnabled(bool bEnabled) { m_bShadows = bEnabled; }
+	// start the threads that the frame is built on, zero picks
+	// a count for the machine and one builds it on this thread
+	void StartJobThreads(unsigned int threadCount) { m_jobSystem.Start(threadCount); }
+	unsigned int GetJobThreadCount() const { return(m_jobSystem.GetThreadCount()); }
+
+	// keep the arrays of the next frame in the passed in arena,
+	// called every frame after the arena has been reset
+	void BeginFrame(FrameArena* pArena);
+
+	// select how the scene nodes are submitted for drawing
+	void SetRenderPath(RENDER_PATH renderPath) { m_renderPath = renderPath; }
+	RENDER_PATH GetRenderPath() const { return(m_renderPath); }
+
 };
\ No newline at end of file
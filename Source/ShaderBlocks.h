@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderblocks.h
+// ============
+// std140 and std430 layouts of the blocks that are shared with the GLSL shaders
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+// the structures below must match the block declarations in the
+// shaders member for member, including padding
+
+// uniform buffer binding points for the shared blocks
+const GLuint MATERIAL_BLOCK_BINDING = 0;
+const GLuint LIGHT_BLOCK_BINDING = 1;
+const GLuint CAMERA_BLOCK_BINDING = 2;
+// the uniform buffer binding points are apart from the shader
+// storage ones below, so this one can share its number
+const GLuint SHADOW_BLOCK_BINDING = 3;
+
+// shader storage binding point of the per-draw data of the
+// multi-draw indirect path
+const GLuint DRAW_BLOCK_BINDING = 3;
+
+// shader storage binding points of the occlusion culling pass
+const GLuint BOUNDS_BLOCK_BINDING = 4;
+const GLuint COMMAND_BLOCK_BINDING = 5;
+
+// texture unit that the array of all the scene textures is bound to
+const GLuint TEXTURE_ARRAY_UNIT = 0;
+// texture unit that the depth pyramid is read from while culling
+const GLuint HI_Z_TEXTURE_UNIT = 1;
+// texture units of the local lights and their cluster lists
+const GLuint LOCAL_LIGHT_TEXTURE_UNIT = 2;
+const GLuint CLUSTER_RANGE_TEXTURE_UNIT = 3;
+const GLuint CLUSTER_INDEX_TEXTURE_UNIT = 4;
+// texture unit of the shadow maps of the directional and spot lights
+const GLuint SHADOW_MAP_TEXTURE_UNIT = 5;
+
+// must match MAX_MATERIALS and TOTAL_POINT_LIGHTS in the shaders
+const int MAX_MATERIALS = 64;
+const int TOTAL_POINT_LIGHTS = 5;
+// must match SHADOW_CASCADE_COUNT in shaders/fragmentShader.glsl
+const int SHADOW_CASCADE_COUNT = 3;
+
+struct MATERIAL_STD140
+{
+	glm::vec3 diffuseColor;
+	float shininess;
+	glm::vec3 specularColor;
+	float opacity;
+};
+
+struct DIRECTIONAL_LIGHT_STD140
+{
+	glm::vec3 direction;
+	float padding0;
+	glm::vec3 ambient;
+	float padding1;
+	glm::vec3 diffuse;
+	float padding2;
+	glm::vec3 specular;
+	int32_t bActive;
+};
+
+struct POINT_LIGHT_STD140
+{
+	glm::vec3 position;
+	float padding0;
+	glm::vec3 ambient;
+	float padding1;
+	glm::vec3 diffuse;
+	float padding2;
+	glm::vec3 specular;
+	int32_t bActive;
+};
+
+struct SPOT_LIGHT_STD140
+{
+	glm::vec3 position;
+	float padding0;
+	glm::vec3 direction;
+	float cutOff;
+	float outerCutOff;
+	float constant;
+	float linear;
+	float quadratic;
+	glm::vec3 ambient;
+	float padding1;
+	glm::vec3 diffuse;
+	float padding2;
+	glm::vec3 specular;
+	int32_t bActive;
+};
+
+struct MATERIAL_BLOCK
+{
+	MATERIAL_STD140 materials[MAX_MATERIALS];
+};
+
+struct LIGHT_BLOCK
+{
+	DIRECTIONAL_LIGHT_STD140 directionalLight;
+	POINT_LIGHT_STD140 pointLights[TOTAL_POINT_LIGHTS];
+	SPOT_LIGHT_STD140 spotLight;
+};
+
+// view and projection shared by every program that draws the scene
+struct CAMERA_BLOCK
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+	glm::vec3 viewPosition;
+	float padding;
+};
+
+// light space matrices of the shadow maps and how they are
+// sampled, shared by every program that shades the scene
+struct SHADOW_BLOCK
+{
+	glm::mat4 cascadeMatrices[SHADOW_CASCADE_COUNT];
+	glm::mat4 spotMatrix;
+	// view depth that each cascade reaches
+	glm::vec4 cascadeSplits;
+	// world distance a position is moved along its normal in
+	// each cascade before it is looked up, against acne
+	glm::vec4 cascadeNormalOffsets;
+	// x is the size of a texel, y the normal offset of the spot
+	// light for every unit of distance from it
+	glm::vec4 parameters;
+	int32_t bDirectionalShadow;
+	int32_t bSpotShadow;
+	float padding[2];
+};
+
+// std430 layout of one entry in the DrawBlock storage buffer of
+// shaders/indirectVertexShader.glsl, indexed by gl_DrawID
+struct DRAW_DATA_STD430
+{
+	glm::mat4 model;
+	// inverse transpose of the model matrix, a std430 mat3 has
+	// its columns padded out to vec4
+	glm::vec4 normalMatrix[3];
+	glm::vec4 color;
+	glm::vec2 uvScale;
+	uint32_t materialIndex;
+	// texture array layer, or -1 for an untextured draw
+	int32_t textureLayer;
+};
+
+// std430 layout of one entry in the BoundsBlock storage buffer of
+// shaders/occlusionCullCompute.glsl, the world box of one draw
+struct DRAW_BOUNDS_STD430
+{
+	// w is 1 for an occluder, which is never culled
+	glm::vec4 center;
+	glm::vec4 extent;
+};
+
+static_assert(sizeof(MATERIAL_STD140) == 32, "MATERIAL_STD140 does not match std140");
+static_assert(sizeof(DIRECTIONAL_LIGHT_STD140) == 64, "DIRECTIONAL_LIGHT_STD140 does not match std140");
+static_assert(sizeof(POINT_LIGHT_STD140) == 64, "POINT_LIGHT_STD140 does not match std140");
+static_assert(sizeof(SPOT_LIGHT_STD140) == 96, "SPOT_LIGHT_STD140 does not match std140");
+static_assert(sizeof(LIGHT_BLOCK) == 480, "LIGHT_BLOCK does not match std140");
+static_assert(sizeof(CAMERA_BLOCK) == 144, "CAMERA_BLOCK does not match std140");
+static_assert(sizeof(SHADOW_BLOCK) == 320, "SHADOW_BLOCK does not match std140");
+static_assert(sizeof(DRAW_DATA_STD430) == 144, "DRAW_DATA_STD430 does not match std430");
+static_assert(sizeof(DRAW_BOUNDS_STD430) == 32, "DRAW_BOUNDS_STD430 does not match std430");
@@ -0,0 +1,411 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadervariants.cpp
+// ============
+// build and cache the programs specialized for a set of shading features
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderVariants.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// declaration of global variables
+namespace
+{
+	// most variants the render queue can tell apart in its sort key
+	const int MAX_VARIANTS = 128;
+
+	// names of the defines set for each feature flag
+	struct FEATURE_DEFINE
+	{
+		uint32_t feature;
+		const char* name;
+	};
+
+	const FEATURE_DEFINE g_FeatureDefines[] =
+	{
+		{ ShaderVariants::FEATURE_TEXTURED, "USE_TEXTURE" },
+		{ ShaderVariants::FEATURE_LIGHTING, "USE_LIGHTING" },
+		{ ShaderVariants::FEATURE_DIRECTIONAL_LIGHT, "USE_DIRECTIONAL_LIGHT" },
+		{ ShaderVariants::FEATURE_SPOT_LIGHT, "USE_SPOT_LIGHT" },
+		{ ShaderVariants::FEATURE_CLUSTERED_LIGHTS, "USE_CLUSTERED_LIGHTS" },
+		{ ShaderVariants::FEATURE_DEPTH_ONLY, "DEPTH_ONLY" },
+		{ ShaderVariants::FEATURE_SHADOWS, "USE_SHADOWS" }
+	};
+	const int g_FeatureDefineCount = sizeof(g_FeatureDefines) / sizeof(g_FeatureDefines[0]);
+}
+
+/***********************************************************
+ *  ShaderVariants()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShaderVariants::ShaderVariants()
+{
+	m_vertexShader = 0;
+	m_bVertexShaderFailed = false;
+	m_cachedCount = 0;
+	m_compiledCount = 0;
+}
+
+/***********************************************************
+ *  ~ShaderVariants()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShaderVariants::~ShaderVariants()
+{
+	DestroyVariants();
+
+	if (0 != m_vertexShader)
+	{
+		glDeleteShader(m_vertexShader);
+		m_vertexShader = 0;
+	}
+}
+
+/***********************************************************
+ *  PointLightFeatures()
+ *
+ *  This method is used for packing the number of active point
+ *  lights into the bits of the feature bitmask above the flags.
+ ***********************************************************/
+uint32_t ShaderVariants::PointLightFeatures(int activeCount)
+{
+	return(((uint32_t)activeCount << POINT_LIGHT_SHIFT) & POINT_LIGHT_MASK);
+}
+
+/***********************************************************
+ *  ReadSource()
+ *
+ *  This method is used for reading a whole shader file into
+ *  the passed in string.
+ ***********************************************************/
+bool ShaderVariants::ReadSource(const char* filename, std::string& source)
+{
+	std::ifstream file(filename);
+	std::stringstream contents;
+
+	if (!file.is_open())
+	{
+		std::cout << "Could not open the shader:" << filename << std::endl;
+		return(false);
+	}
+
+	contents << file.rdbuf();
+	source = contents.str();
+
+	return(true);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for reading the shader sources that
+ *  every variant is built from, and for preparing the program
+ *  cache.  Nothing is compiled until a variant is asked for.
+ ***********************************************************/
+bool ShaderVariants::Initialize(const char* vertexShaderPath, const char* fragmentShaderPath, const char* cacheDirectory)
+{
+	if ((false == ReadSource(vertexShaderPath, m_vertexSource)) ||
+		(false == ReadSource(fragmentShaderPath, m_fragmentSource)))
+	{
+		return(false);
+	}
+	m_vertexShaderPath = vertexShaderPath;
+	m_fragmentShaderPath = fragmentShaderPath;
+
+	m_programCache.Initialize(cacheDirectory);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Reload()
+ *
+ *  This method is used for reading the shader sources again
+ *  after they were changed on disk.  The generic program is
+ *  built from the new sources first, and only when that works
+ *  are the current variants freed, so a shader with an error
+ *  leaves the scene drawing as before.  The other variants are
+ *  built from the new sources as they are next drawn with.
+ ***********************************************************/
+bool ShaderVariants::Reload()
+{
+	std::string vertexSource;
+	std::string fragmentSource;
+	std::string previousVertexSource = m_vertexSource;
+	std::string previousFragmentSource = m_fragmentSource;
+	GLuint previousVertexShader = m_vertexShader;
+	bool bPreviousVertexShaderFailed = m_bVertexShaderFailed;
+	GLuint program = 0;
+
+	if ((false == ReadSource(m_vertexShaderPath.c_str(), vertexSource)) ||
+		(false == ReadSource(m_fragmentShaderPath.c_str(), fragmentSource)))
+	{
+		return(false);
+	}
+
+	// the new vertex shader is compiled along with the program,
+	// unless an unchanged one can be kept
+	m_vertexSource = vertexSource;
+	m_fragmentSource = fragmentSource;
+	if (vertexSource != previousVertexSource)
+	{
+		m_vertexShader = 0;
+		m_bVertexShaderFailed = false;
+	}
+
+	program = BuildProgram(0);
+	if (0 == program)
+	{
+		if (m_vertexShader != previousVertexShader)
+		{
+			if (0 != m_vertexShader)
+			{
+				glDeleteShader(m_vertexShader);
+			}
+			m_vertexShader = previousVertexShader;
+			m_bVertexShaderFailed = bPreviousVertexShaderFailed;
+		}
+		m_vertexSource = previousVertexSource;
+		m_fragmentSource = previousFragmentSource;
+		return(false);
+	}
+
+	DestroyVariants();
+	if ((m_vertexShader != previousVertexShader) && (0 != previousVertexShader))
+	{
+		glDeleteShader(previousVertexShader);
+	}
+
+	// the generic program becomes the first of the new variants
+	VARIANT* pVariant = new VARIANT();
+	pVariant->features = 0;
+	pVariant->index = 0;
+	pVariant->programID = program;
+	pVariant->bPrepared = false;
+	pVariant->uniforms.ResolveLocations(program);
+	m_variants.push_back(pVariant);
+	m_variantsByFeatures[0] = pVariant;
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyVariants()
+ *
+ *  This method is used for freeing the program of every
+ *  variant built so far.
+ ***********************************************************/
+void ShaderVariants::DestroyVariants()
+{
+	for (size_t i = 0; i < m_variants.size(); i++)
+	{
+		if (0 != m_variants[i]->programID)
+		{
+			glDeleteProgram(m_variants[i]->programID);
+		}
+		delete m_variants[i];
+	}
+	m_variants.clear();
+	m_variantsByFeatures.clear();
+}
+
+/***********************************************************
+ *  BuildDefines()
+ *
+ *  This method is used for placing the #define lines of the
+ *  passed in features after the #version line, which has to
+ *  stay first.  A #line directive keeps the line numbers of
+ *  the compile errors matching the shader file.
+ ***********************************************************/
+std::string ShaderVariants::BuildDefines(const std::string& source, uint32_t features)
+{
+	std::stringstream defines;
+	size_t versionEnd = source.find('\n');
+
+	if (versionEnd == std::string::npos)
+	{
+		versionEnd = source.size();
+	}
+
+	defines << "#define SHADER_VARIANT 1\n";
+	for (int i = 0; i < g_FeatureDefineCount; i++)
+	{
+		defines << "#define " << g_FeatureDefines[i].name << " " << (((features & g_FeatureDefines[i].feature) != 0) ? 1 : 0) << "\n";
+	}
+	defines << "#define ACTIVE_POINT_LIGHTS " << ((features & POINT_LIGHT_MASK) >> POINT_LIGHT_SHIFT) << "\n";
+	defines << "#line 2\n";
+
+	return(source.substr(0, versionEnd) + "\n" + defines.str() + source.substr(std::min(versionEnd + 1, source.size())));
+}
+
+/***********************************************************
+ *  CompileShader()
+ *
+ *  This method is used for compiling one shader stage from
+ *  the passed in source, and returns 0 when that fails.
+ ***********************************************************/
+GLuint ShaderVariants::CompileShader(GLenum stage, const std::string& source, const char* name)
+{
+	const char* sourcePointer = source.c_str();
+	GLuint shader = glCreateShader(stage);
+	GLint bSuccess = GL_FALSE;
+	char log[1024];
+
+	glShaderSource(shader, 1, &sourcePointer, NULL);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &bSuccess);
+	if (GL_TRUE != bSuccess)
+	{
+		glGetShaderInfoLog(shader, sizeof(log), NULL, log);
+		std::cout << "Could not compile the shader:" << name << std::endl << log << std::endl;
+		glDeleteShader(shader);
+		return(0);
+	}
+
+	return(shader);
+}
+
+/***********************************************************
+ *  BuildProgram()
+ *
+ *  This method is used for loading the program of the passed
+ *  in features from the program cache, or when it is not
+ *  there, compiling the fragment shader with the defines of
+ *  the features, linking it with the shared vertex shader and
+ *  storing the linked binary in the cache.
+ ***********************************************************/
+GLuint ShaderVariants::BuildProgram(uint32_t features)
+{
+	std::string fragmentSource = BuildDefines(m_fragmentSource, features);
+	uint64_t sourceHash = ProgramCache::HashSources(m_vertexSource, fragmentSource);
+	GLuint fragmentShader = 0;
+	GLuint program = 0;
+	GLint bSuccess = GL_FALSE;
+	char log[1024];
+
+	program = m_programCache.LoadProgram(sourceHash);
+	if (0 != program)
+	{
+		m_cachedCount++;
+		return(program);
+	}
+
+	// the shared vertex shader is compiled on the first miss,
+	// and not tried again once it has failed
+	if ((0 == m_vertexShader) && (false == m_bVertexShaderFailed))
+	{
+		m_vertexShader = CompileShader(GL_VERTEX_SHADER, m_vertexSource, m_vertexShaderPath.c_str());
+		m_bVertexShaderFailed = (0 == m_vertexShader);
+	}
+	if (0 == m_vertexShader)
+	{
+		return(0);
+	}
+
+	fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource, m_fragmentShaderPath.c_str());
+	if (0 == fragmentShader)
+	{
+		return(0);
+	}
+
+	program = glCreateProgram();
+	m_programCache.PrepareProgram(program);
+	glAttachShader(program, m_vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+	glDetachShader(program, m_vertexShader);
+	glDeleteShader(fragmentShader);
+	glGetProgramiv(program, GL_LINK_STATUS, &bSuccess);
+	if (GL_TRUE != bSuccess)
+	{
+		glGetProgramInfoLog(program, sizeof(log), NULL, log);
+		std::cout << "Could not link the shader variant:" << features << std::endl << log << std::endl;
+		glDeleteProgram(program);
+		return(0);
+	}
+
+	m_programCache.StoreProgram(sourceHash, program);
+	m_compiledCount++;
+
+	return(program);
+}
+
+/***********************************************************
+ *  GetVariant()
+ *
+ *  This method is used for finding the variant built for the
+ *  passed in features, compiling it the first time it is
+ *  asked for.  A variant that failed to build is remembered
+ *  too, so that it is not compiled again, and NULL is
+ *  returned for it so the caller uses the generic program.
+ ***********************************************************/
+ShaderVariants::VARIANT* ShaderVariants::GetVariant(uint32_t features)
+{
+	std::map<uint32_t, VARIANT*>::iterator found = m_variantsByFeatures.find(features);
+	VARIANT* pVariant = NULL;
+
+	if (found != m_variantsByFeatures.end())
+	{
+		pVariant = found->second;
+		return((0 != pVariant->programID) ? pVariant : NULL);
+	}
+
+	if (m_vertexSource.empty() || m_bVertexShaderFailed || (m_variants.size() >= MAX_VARIANTS))
+	{
+		return(NULL);
+	}
+
+	pVariant = new VARIANT();
+	pVariant->features = features;
+	pVariant->index = (int)m_variants.size();
+	pVariant->programID = BuildProgram(features);
+	pVariant->bPrepared = false;
+	if (0 != pVariant->programID)
+	{
+		pVariant->uniforms.ResolveLocations(pVariant->programID);
+	}
+
+	m_variants.push_back(pVariant);
+	m_variantsByFeatures[features] = pVariant;
+
+	return((0 != pVariant->programID) ? pVariant : NULL);
+}
+
+/***********************************************************
+ *  GetUploadCount()
+ *
+ *  This method is used for summing the uniform uploads of
+ *  every variant since the counters were last reset.
+ ***********************************************************/
+unsigned int ShaderVariants::GetUploadCount() const
+{
+	unsigned int uploadCount = 0;
+
+	for (size_t i = 0; i < m_variants.size(); i++)
+	{
+		uploadCount += m_variants[i]->uniforms.GetUploadCount();
+	}
+
+	return(uploadCount);
+}
+
+/***********************************************************
+ *  ResetCounters()
+ *
+ *  This method is used for resetting the uniform counters of
+ *  every variant.
+ ***********************************************************/
+void ShaderVariants::ResetCounters()
+{
+	for (size_t i = 0; i < m_variants.size(); i++)
+	{
+		m_variants[i]->uniforms.ResetCounters();
+	}
+}
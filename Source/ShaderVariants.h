@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadervariants.h
+// ============
+// build and cache the programs specialized for a set of shading features
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ProgramCache.h"
+#include "UniformCache.h"
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  ShaderVariants
+ *
+ *  This class compiles the scene shaders once for every set
+ *  of shading features that is drawn with.  The features are
+ *  turned into #define lines placed after the #version line
+ *  of the fragment shader, so that the lighting, texturing
+ *  and light count branches are decided by the compiler,
+ *  which removes the unused code and unrolls the light loop.
+ *  The programs are compiled on first use and looked up by
+ *  their feature bitmask afterwards.  Without any defines the
+ *  same shader sources still build the generic program that
+ *  branches on the uniforms at runtime.  Linked variants are
+ *  kept in the program cache, so that a later launch loads
+ *  their binaries instead of compiling them again.
+ ***********************************************************/
+class ShaderVariants
+{
+public:
+	// shading features that a variant is specialized for
+	enum FEATURE_FLAGS
+	{
+		FEATURE_TEXTURED = 0x01,
+		FEATURE_LIGHTING = 0x02,
+		FEATURE_DIRECTIONAL_LIGHT = 0x04,
+		FEATURE_SPOT_LIGHT = 0x08,
+		FEATURE_CLUSTERED_LIGHTS = 0x10,
+		FEATURE_DEPTH_ONLY = 0x20,
+		// sits above the point light count
+		FEATURE_SHADOWS = 0x200
+	};
+	// the number of active point lights is kept above the flags
+	static const int POINT_LIGHT_SHIFT = 6;
+	static const uint32_t POINT_LIGHT_MASK = 0x7 << POINT_LIGHT_SHIFT;
+
+	// one compiled program and the cached uniforms it is drawn with
+	struct VARIANT
+	{
+		uint32_t features;
+		// position in the order the variants were made, which
+		// the render queue sorts the draws by
+		int index;
+		GLuint programID;
+		UniformCache uniforms;
+		// set once the shared blocks have been attached
+		bool bPrepared;
+	};
+
+	// constructor
+	ShaderVariants();
+	// destructor
+	~ShaderVariants();
+
+	// pack a point light count into the feature bitmask
+	static uint32_t PointLightFeatures(int activeCount);
+
+	// read the shader sources that the variants are built from,
+	// and keep their binaries in the passed in directory
+	bool Initialize(const char* vertexShaderPath, const char* fragmentShaderPath, const char* cacheDirectory);
+	// read the changed shader sources and drop the variants built
+	// from the old ones, keeping them when the new sources fail
+	bool Reload();
+	// find the variant for the passed in features, compiling it
+	// on first use, or NULL when it could not be built
+	VARIANT* GetVariant(uint32_t features);
+
+	size_t GetVariantCount() const { return(m_variants.size()); }
+	VARIANT* GetVariantAt(size_t index) { return(m_variants[index]); }
+
+	// uniform counters summed over every variant
+	unsigned int GetUploadCount() const;
+	void ResetCounters();
+
+	// variants loaded from the program cache and from source
+	unsigned int GetCachedCount() const { return(m_cachedCount); }
+	unsigned int GetCompiledCount() const { return(m_compiledCount); }
+
+private:
+	// the sources that every variant is built from
+	std::string m_vertexSource;
+	std::string m_fragmentSource;
+	std::string m_fragmentShaderPath;
+	std::string m_vertexShaderPath;
+	// the vertex shader is the same for every variant, and is
+	// only compiled once a variant is not in the program cache
+	GLuint m_vertexShader;
+	bool m_bVertexShaderFailed;
+	ProgramCache m_programCache;
+	unsigned int m_cachedCount;
+	unsigned int m_compiledCount;
+	// variants in the order they were made, and by their features
+	std::vector<VARIANT*> m_variants;
+	std::map<uint32_t, VARIANT*> m_variantsByFeatures;
+
+	// read a whole shader file into a string
+	static bool ReadSource(const char* filename, std::string& source);
+	// put the #define lines of the features after the #version
+	static std::string BuildDefines(const std::string& source, uint32_t features);
+	// compile one shader stage, returning 0 when that fails
+	static GLuint CompileShader(GLenum stage, const std::string& source, const char* name);
+	// build and link the program of a set of features
+	GLuint BuildProgram(uint32_t features);
+	// free the programs of every variant
+	void DestroyVariants();
+};
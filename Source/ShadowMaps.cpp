@@ -0,0 +1,702 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.cpp
+// ============
+// cached shadow maps of the directional light cascades and the spot light
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShadowMaps.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	const char* g_ShadowMapsName = "shadowMaps";
+
+	// farthest view depth that the cascades reach, which covers
+	// the cabin from anywhere inside it
+	const float MAX_SHADOW_DISTANCE = 12.0f;
+	// blend between logarithmic and even cascade splits, more
+	// logarithmic gives the near cascades more of the texels
+	const float CASCADE_SPLIT_BLEND = 0.75f;
+	// the center of a cascade snaps to this fraction of its
+	// radius, so a small camera move keeps the cached matrix
+	const float CASCADE_SNAP_FRACTION = 0.5f;
+	// the radius of a cascade is rounded up to this step, so the
+	// float noise in it never moves the cascade
+	const float CASCADE_RADIUS_STEP = 1.0f / 16.0f;
+	// depth added in front of and behind the caster box
+	const float CASCADE_DEPTH_MARGIN = 0.5f;
+	// texels that a position is moved along its normal before the
+	// maps are looked up, which keeps the surfaces out of their
+	// own shadow
+	const float NORMAL_OFFSET_TEXELS = 1.5f;
+	// slope scaled and constant polygon offset of the casters
+	const float CASTER_SLOPE_BIAS = 2.0f;
+	const float CASTER_CONSTANT_BIAS = 2.0f;
+	// projection of the spot light, whose cone is widened a little
+	// so the filter near its edge stays inside the map
+	const float SPOT_NEAR_PLANE = 0.05f;
+	const float MAX_SPOT_RANGE = 20.0f;
+	const float SPOT_FIELD_MARGIN = 0.035f;
+	const float MAX_SPOT_FIELD = 2.97f;
+	// the spot light is taken as faded out once it is this many
+	// times weaker than at its position
+	const float SPOT_ATTENUATION_CUTOFF = 256.0f;
+}
+
+/***********************************************************
+ *  ShadowMaps()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShadowMaps::ShadowMaps()
+{
+	m_resolution = 0;
+	m_staticTexture = 0;
+	m_frameTexture = 0;
+	m_staticFramebuffer = 0;
+	m_frameFramebuffer = 0;
+	m_shadowBuffer = 0;
+	m_cameraBuffer = 0;
+	m_shadowBlock = SHADOW_BLOCK();
+	m_bBlockDirty = true;
+	for (int layer = 0; layer < LAYER_COUNT; layer++)
+	{
+		m_layerMatrices[layer] = glm::mat4(1.0f);
+		m_bLayerDirty[layer] = true;
+	}
+	m_staticRenderCount = 0;
+	m_bDirectionalLight = false;
+	m_bSpotLight = false;
+	m_lightDirection = glm::vec3(0.0f, -1.0f, 0.0f);
+	m_spotPosition = glm::vec3(0.0f);
+	m_spotDirection = glm::vec3(0.0f, -1.0f, 0.0f);
+	m_spotOuterCutOff = 0.0f;
+	m_spotRange = 0.0f;
+	m_casterMinimum = glm::vec3(FLT_MAX);
+	m_casterMaximum = glm::vec3(-FLT_MAX);
+	m_previousDrawFramebuffer = 0;
+	m_previousReadFramebuffer = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		m_previousViewport[i] = 0;
+	}
+	m_previousCameraBuffer = 0;
+}
+
+/***********************************************************
+ *  ~ShadowMaps()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShadowMaps::~ShadowMaps()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the depth arrays, their
+ *  framebuffers and the uniform buffers.
+ ***********************************************************/
+void ShadowMaps::Destroy()
+{
+	if (0 != m_staticFramebuffer)
+	{
+		glDeleteFramebuffers(1, &m_staticFramebuffer);
+		m_staticFramebuffer = 0;
+	}
+	if (0 != m_frameFramebuffer)
+	{
+		glDeleteFramebuffers(1, &m_frameFramebuffer);
+		m_frameFramebuffer = 0;
+	}
+	if (0 != m_staticTexture)
+	{
+		glDeleteTextures(1, &m_staticTexture);
+		m_staticTexture = 0;
+	}
+	if (0 != m_frameTexture)
+	{
+		glDeleteTextures(1, &m_frameTexture);
+		m_frameTexture = 0;
+	}
+	if (0 != m_shadowBuffer)
+	{
+		glDeleteBuffers(1, &m_shadowBuffer);
+		m_shadowBuffer = 0;
+	}
+	if (0 != m_cameraBuffer)
+	{
+		glDeleteBuffers(1, &m_cameraBuffer);
+		m_cameraBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the cached depth array
+ *  with a layer of the passed in size for every cascade and
+ *  the spot light, the framebuffers its layers are drawn
+ *  through, and the shadow block.  The frame array is only
+ *  created once a dynamic caster is drawn.
+ ***********************************************************/
+bool ShadowMaps::Initialize(int resolution)
+{
+	bool bComplete = true;
+
+	Destroy();
+	m_resolution = resolution;
+	m_staticTexture = CreateDepthArray();
+
+	// both framebuffers have no color, and get their layer
+	// attached as they are drawn into
+	glGenFramebuffers(1, &m_staticFramebuffer);
+	glGenFramebuffers(1, &m_frameFramebuffer);
+	for (int i = 0; i < 2; i++)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, (i == 0) ? m_staticFramebuffer : m_frameFramebuffer);
+		glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticTexture, 0, 0);
+		glDrawBuffer(GL_NONE);
+		glReadBuffer(GL_NONE);
+		bComplete = bComplete && (GL_FRAMEBUFFER_COMPLETE == glCheckFramebufferStatus(GL_FRAMEBUFFER));
+	}
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (false == bComplete)
+	{
+		std::cout << "The shadow map framebuffer is incomplete" << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	m_shadowBlock.parameters.x = 1.0f / (float)m_resolution;
+	glGenBuffers(1, &m_shadowBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_shadowBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(SHADOW_BLOCK), &m_shadowBlock, GL_DYNAMIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, SHADOW_BLOCK_BINDING, m_shadowBuffer);
+
+	glGenBuffers(1, &m_cameraBuffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, m_cameraBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(CAMERA_BLOCK), NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	for (int layer = 0; layer < LAYER_COUNT; layer++)
+	{
+		m_bLayerDirty[layer] = true;
+	}
+	m_bBlockDirty = true;
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateDepthArray()
+ *
+ *  This method is used for creating a depth texture array with
+ *  a layer for every cascade and the spot light.  Lookups
+ *  compare against the stored depth and filter the results
+ *  of four texels, and anything outside of a map is lit.
+ ***********************************************************/
+GLuint ShadowMaps::CreateDepthArray() const
+{
+	const GLfloat borderColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	GLuint texture = 0;
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, texture);
+	glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_DEPTH_COMPONENT24, m_resolution, m_resolution, LAYER_COUNT, 0,
+		GL_DEPTH_COMPONENT, GL_UNSIGNED_INT, NULL);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	glTexParameterfv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BORDER_COLOR, borderColor);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	return(texture);
+}
+
+/***********************************************************
+ *  SetSamplerUnit()
+ *
+ *  This method is used for pointing the shadow sampler of the
+ *  passed in program at its texture unit, once after it has
+ *  been built.  The sampler is set even without shadows, so
+ *  that it never shares a unit with a sampler of another type.
+ *  The program must be in use.
+ ***********************************************************/
+void ShadowMaps::SetSamplerUnit(GLuint programID)
+{
+	if (0 == programID)
+	{
+		return;
+	}
+
+	glUniform1i(glGetUniformLocation(programID, g_ShadowMapsName), SHADOW_MAP_TEXTURE_UNIT);
+}
+
+/***********************************************************
+ *  SetShaderUniforms()
+ *
+ *  This method is used for turning the shadows of the generic
+ *  program on or off through the uniform cache of the program
+ *  in use, so the switch is only sent when it changes.  The
+ *  variants have it built in and skip it.
+ ***********************************************************/
+void ShadowMaps::SetShaderUniforms(UniformCache& uniforms, bool bUseShadows) const
+{
+	uniforms.SetIntValue(UniformCache::UNIFORM_USE_SHADOWS, bUseShadows ? 1 : 0);
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for setting the directional and spot
+ *  lights from the light block.  The cascades are marked
+ *  when the direction of the sunlight changes, and the spot
+ *  layer gets its new matrix when the spot light moves.
+ ***********************************************************/
+void ShadowMaps::SetLights(const DIRECTIONAL_LIGHT_STD140& directionalLight, const SPOT_LIGHT_STD140& spotLight)
+{
+	bool bDirectional = (directionalLight.bActive != 0) && (glm::length(directionalLight.direction) > 0.0f);
+	bool bSpot = (spotLight.bActive != 0) && (glm::length(spotLight.direction) > 0.0f);
+
+	if (true == bDirectional)
+	{
+		glm::vec3 direction = glm::normalize(directionalLight.direction);
+
+		if ((false == m_bDirectionalLight) || (direction != m_lightDirection))
+		{
+			m_lightDirection = direction;
+			for (int cascade = 0; cascade < SHADOW_CASCADE_COUNT; cascade++)
+			{
+				m_bLayerDirty[cascade] = true;
+			}
+		}
+	}
+	m_bDirectionalLight = bDirectional;
+
+	if (true == bSpot)
+	{
+		glm::vec3 direction = glm::normalize(spotLight.direction);
+		float range = GetAttenuationRange(spotLight.constant, spotLight.linear, spotLight.quadratic);
+
+		if ((false == m_bSpotLight) || (spotLight.position != m_spotPosition) || (direction != m_spotDirection) ||
+			(spotLight.outerCutOff != m_spotOuterCutOff) || (range != m_spotRange))
+		{
+			// the cosine of the outer cut off is kept in the block
+			float halfAngle = std::acos(glm::clamp(spotLight.outerCutOff, -1.0f, 1.0f));
+			float fieldOfView = std::min(2.0f * halfAngle + SPOT_FIELD_MARGIN, MAX_SPOT_FIELD);
+			glm::mat4 projection = glm::perspective(fieldOfView, 1.0f, SPOT_NEAR_PLANE, range);
+			glm::mat4 view = glm::lookAt(spotLight.position, spotLight.position + direction, GetLightUp(direction));
+
+			m_spotPosition = spotLight.position;
+			m_spotDirection = direction;
+			m_spotOuterCutOff = spotLight.outerCutOff;
+			m_spotRange = range;
+			SetLayerMatrix(SPOT_LAYER, projection * view);
+			m_bLayerDirty[SPOT_LAYER] = true;
+
+			// a texel of the spot map grows with the distance
+			m_shadowBlock.parameters.y = NORMAL_OFFSET_TEXELS * 2.0f * std::tan(fieldOfView * 0.5f) / (float)m_resolution;
+			m_bBlockDirty = true;
+		}
+	}
+	m_bSpotLight = bSpot;
+}
+
+/***********************************************************
+ *  SetCasterBounds()
+ *
+ *  This method is used for setting the world box around the
+ *  shadow casters, which has changed whenever this is called,
+ *  so every cached layer is drawn again.
+ ***********************************************************/
+void ShadowMaps::SetCasterBounds(const glm::vec3& minimum, const glm::vec3& maximum)
+{
+	m_casterMinimum = minimum;
+	m_casterMaximum = maximum;
+	for (int layer = 0; layer < LAYER_COUNT; layer++)
+	{
+		m_bLayerDirty[layer] = true;
+	}
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for turning the shadows of the lights
+ *  on or off for the frame, and fitting every cascade to its
+ *  slice of the passed in camera.  The slices end at depths
+ *  between an even and a logarithmic split of the shadow
+ *  distance, and the corners of each slice are found along
+ *  the edges of the view frustum, which works for both the
+ *  perspective and the orthographic projection.
+ ***********************************************************/
+void ShadowMaps::Update(const glm::mat4& view, const glm::mat4& projection, bool bHasViewProjection)
+{
+	bool bCasters = (m_casterMinimum.x <= m_casterMaximum.x);
+	int32_t bDirectionalShadow = (m_bDirectionalLight && bCasters && bHasViewProjection) ? 1 : 0;
+	int32_t bSpotShadow = (m_bSpotLight && bCasters) ? 1 : 0;
+	glm::mat4 inverseProjection = glm::inverse(projection);
+	glm::mat4 inverseView = glm::inverse(view);
+	glm::vec3 nearCorners[4];
+	glm::vec3 farCorners[4];
+
+	for (int i = 0; i < 4; i++)
+	{
+		glm::vec2 corner(((i & 1) != 0) ? 1.0f : -1.0f, ((i & 2) != 0) ? 1.0f : -1.0f);
+		glm::vec4 nearPosition = inverseProjection * glm::vec4(corner.x, corner.y, -1.0f, 1.0f);
+		glm::vec4 farPosition = inverseProjection * glm::vec4(corner.x, corner.y, 1.0f, 1.0f);
+
+		nearCorners[i] = glm::vec3(nearPosition) / nearPosition.w;
+		farCorners[i] = glm::vec3(farPosition) / farPosition.w;
+	}
+
+	float nearDepth = -nearCorners[0].z;
+	float farDepth = -farCorners[0].z;
+	if ((nearDepth <= 0.0f) || (farDepth <= nearDepth))
+	{
+		bDirectionalShadow = 0;
+	}
+
+	if ((bDirectionalShadow != m_shadowBlock.bDirectionalShadow) || (bSpotShadow != m_shadowBlock.bSpotShadow))
+	{
+		m_shadowBlock.bDirectionalShadow = bDirectionalShadow;
+		m_shadowBlock.bSpotShadow = bSpotShadow;
+		m_bBlockDirty = true;
+	}
+	if (bDirectionalShadow == 0)
+	{
+		return;
+	}
+
+	float shadowDepth = std::min(farDepth, MAX_SHADOW_DISTANCE);
+	float sliceStart = nearDepth;
+
+	for (int cascade = 0; cascade < SHADOW_CASCADE_COUNT; cascade++)
+	{
+		float fraction = (float)(cascade + 1) / (float)SHADOW_CASCADE_COUNT;
+		float logarithmicSplit = nearDepth * std::pow(shadowDepth / nearDepth, fraction);
+		float evenSplit = nearDepth + (shadowDepth - nearDepth) * fraction;
+		float sliceEnd = CASCADE_SPLIT_BLEND * logarithmicSplit + (1.0f - CASCADE_SPLIT_BLEND) * evenSplit;
+		glm::vec3 sliceCorners[8];
+
+		for (int i = 0; i < 4; i++)
+		{
+			glm::vec3 edge = (farCorners[i] - nearCorners[i]) / (farDepth - nearDepth);
+
+			sliceCorners[i] = glm::vec3(inverseView * glm::vec4(nearCorners[i] + edge * (sliceStart - nearDepth), 1.0f));
+			sliceCorners[i + 4] = glm::vec3(inverseView * glm::vec4(nearCorners[i] + edge * (sliceEnd - nearDepth), 1.0f));
+		}
+		FitCascade(cascade, sliceCorners);
+
+		if (m_shadowBlock.cascadeSplits[cascade] != sliceEnd)
+		{
+			m_shadowBlock.cascadeSplits[cascade] = sliceEnd;
+			m_bBlockDirty = true;
+		}
+		sliceStart = sliceEnd;
+	}
+}
+
+/***********************************************************
+ *  FitCascade()
+ *
+ *  This method is used for fitting a cascade around the
+ *  bounding sphere of its slice of the view.  The sphere has
+ *  the same radius however the camera turns, and its center
+ *  is snapped in light space to steps of whole texels, a good
+ *  part of the radius apart, with the map made wide enough
+ *  to still cover the sphere.  The matrix only changes once
+ *  the camera has moved by a step, and the edges of the
+ *  shadows never crawl.  The depth range takes in every
+ *  caster, so those outside of the slice still cast into it.
+ ***********************************************************/
+void ShadowMaps::FitCascade(int cascade, const glm::vec3 sliceCorners[8])
+{
+	glm::vec3 center(0.0f);
+	float radius = 0.0f;
+
+	for (int i = 0; i < 8; i++)
+	{
+		center += sliceCorners[i] / 8.0f;
+	}
+	for (int i = 0; i < 8; i++)
+	{
+		radius = std::max(radius, glm::length(sliceCorners[i] - center));
+	}
+	radius = std::ceil(radius / CASCADE_RADIUS_STEP) * CASCADE_RADIUS_STEP;
+
+	float halfWidth = radius * (1.0f + CASCADE_SNAP_FRACTION * 0.5f);
+	float texelSize = 2.0f * halfWidth / (float)m_resolution;
+	float snapStep = std::max(std::floor(radius * CASCADE_SNAP_FRACTION / texelSize), 1.0f) * texelSize;
+	glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), m_lightDirection, GetLightUp(m_lightDirection));
+	glm::vec3 lightCenter = glm::vec3(lightRotation * glm::vec4(center, 1.0f));
+	float minimumZ = FLT_MAX;
+	float maximumZ = -FLT_MAX;
+
+	lightCenter.x = std::floor(lightCenter.x / snapStep + 0.5f) * snapStep;
+	lightCenter.y = std::floor(lightCenter.y / snapStep + 0.5f) * snapStep;
+
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 corner(
+			((i & 1) != 0) ? m_casterMaximum.x : m_casterMinimum.x,
+			((i & 2) != 0) ? m_casterMaximum.y : m_casterMinimum.y,
+			((i & 4) != 0) ? m_casterMaximum.z : m_casterMinimum.z);
+		float depth = (lightRotation * glm::vec4(corner, 1.0f)).z;
+
+		minimumZ = std::min(minimumZ, depth);
+		maximumZ = std::max(maximumZ, depth);
+	}
+
+	// the light looks down its -z axis
+	glm::mat4 projection = glm::ortho(
+		lightCenter.x - halfWidth, lightCenter.x + halfWidth,
+		lightCenter.y - halfWidth, lightCenter.y + halfWidth,
+		-maximumZ - CASCADE_DEPTH_MARGIN, -minimumZ + CASCADE_DEPTH_MARGIN);
+	SetLayerMatrix(cascade, projection * lightRotation);
+
+	if (m_shadowBlock.cascadeNormalOffsets[cascade] != NORMAL_OFFSET_TEXELS * texelSize)
+	{
+		m_shadowBlock.cascadeNormalOffsets[cascade] = NORMAL_OFFSET_TEXELS * texelSize;
+		m_bBlockDirty = true;
+	}
+}
+
+/***********************************************************
+ *  SetLayerMatrix()
+ *
+ *  This method is used for setting the light matrix of a
+ *  layer, which marks the layer and the block when it moved.
+ ***********************************************************/
+void ShadowMaps::SetLayerMatrix(int layer, const glm::mat4& matrix)
+{
+	if (matrix == m_layerMatrices[layer])
+	{
+		return;
+	}
+
+	m_layerMatrices[layer] = matrix;
+	m_bLayerDirty[layer] = true;
+	if (layer == SPOT_LAYER)
+	{
+		m_shadowBlock.spotMatrix = matrix;
+	}
+	else
+	{
+		m_shadowBlock.cascadeMatrices[layer] = matrix;
+	}
+	m_bBlockDirty = true;
+}
+
+/***********************************************************
+ *  IsLayerActive()
+ *
+ *  This method is used for checking whether the light of a
+ *  layer casts a shadow in the current frame.
+ ***********************************************************/
+bool ShadowMaps::IsLayerActive(int layer) const
+{
+	if (layer == SPOT_LAYER)
+	{
+		return(m_shadowBlock.bSpotShadow != 0);
+	}
+
+	return(m_shadowBlock.bDirectionalShadow != 0);
+}
+
+/***********************************************************
+ *  BeginPass()
+ *
+ *  This method is used for saving the bound framebuffers, the
+ *  viewport and the camera block, and setting up the state
+ *  that the casters are drawn with.  Casters in front of the
+ *  near plane of a cascade are flattened onto it instead of
+ *  being clipped, and every caster is pushed back by its slope.
+ ***********************************************************/
+void ShadowMaps::BeginPass()
+{
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousDrawFramebuffer);
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &m_previousReadFramebuffer);
+	glGetIntegerv(GL_VIEWPORT, m_previousViewport);
+	glGetIntegeri_v(GL_UNIFORM_BUFFER_BINDING, CAMERA_BLOCK_BINDING, &m_previousCameraBuffer);
+
+	glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, m_cameraBuffer);
+	glViewport(0, 0, m_resolution, m_resolution);
+	glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+	glDepthMask(GL_TRUE);
+	glEnable(GL_DEPTH_CLAMP);
+	glEnable(GL_POLYGON_OFFSET_FILL);
+	glPolygonOffset(CASTER_SLOPE_BIAS, CASTER_CONSTANT_BIAS);
+}
+
+/***********************************************************
+ *  BeginStaticLayer()
+ *
+ *  This method is used for binding and clearing the cached
+ *  map of a layer, and pointing the camera block at the
+ *  matrix of its light, for drawing the static casters.
+ ***********************************************************/
+void ShadowMaps::BeginStaticLayer(int layer)
+{
+	AttachLayer(m_staticFramebuffer, GL_DRAW_FRAMEBUFFER, m_staticTexture, layer);
+	glClear(GL_DEPTH_BUFFER_BIT);
+	UseLayerCamera(layer);
+
+	m_bLayerDirty[layer] = false;
+	m_staticRenderCount++;
+}
+
+/***********************************************************
+ *  BeginDynamicLayer()
+ *
+ *  This method is used for copying the cached map of a layer
+ *  into the same layer of the frame maps and binding it, for
+ *  drawing the dynamic casters over the static ones.
+ ***********************************************************/
+void ShadowMaps::BeginDynamicLayer(int layer)
+{
+	if (0 == m_frameTexture)
+	{
+		m_frameTexture = CreateDepthArray();
+	}
+
+	AttachLayer(m_staticFramebuffer, GL_READ_FRAMEBUFFER, m_staticTexture, layer);
+	AttachLayer(m_frameFramebuffer, GL_DRAW_FRAMEBUFFER, m_frameTexture, layer);
+	glBlitFramebuffer(
+		0, 0, m_resolution, m_resolution,
+		0, 0, m_resolution, m_resolution,
+		GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+	UseLayerCamera(layer);
+}
+
+/***********************************************************
+ *  EndPass()
+ *
+ *  This method is used for restoring the framebuffers, the
+ *  viewport and the camera block saved by BeginPass(), and
+ *  the state that the scene is drawn with.
+ ***********************************************************/
+void ShadowMaps::EndPass()
+{
+	glDisable(GL_POLYGON_OFFSET_FILL);
+	glDisable(GL_DEPTH_CLAMP);
+	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)m_previousDrawFramebuffer);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)m_previousReadFramebuffer);
+	glViewport(m_previousViewport[0], m_previousViewport[1], m_previousViewport[2], m_previousViewport[3]);
+	glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, (GLuint)m_previousCameraBuffer);
+}
+
+/***********************************************************
+ *  AttachLayer()
+ *
+ *  This method is used for binding a framebuffer to the
+ *  passed in target with a layer of a depth array attached.
+ ***********************************************************/
+void ShadowMaps::AttachLayer(GLuint framebuffer, GLenum target, GLuint texture, int layer) const
+{
+	glBindFramebuffer(target, framebuffer);
+	glFramebufferTextureLayer(target, GL_DEPTH_ATTACHMENT, texture, 0, layer);
+}
+
+/***********************************************************
+ *  UseLayerCamera()
+ *
+ *  This method is used for drawing the next casters from the
+ *  light of a layer.  The vertex shaders multiply by the view
+ *  and projection of the camera block, so the light matrix is
+ *  sent as the view with no projection.
+ ***********************************************************/
+void ShadowMaps::UseLayerCamera(int layer)
+{
+	CAMERA_BLOCK cameraBlock;
+
+	cameraBlock.view = m_layerMatrices[layer];
+	cameraBlock.projection = glm::mat4(1.0f);
+	cameraBlock.viewPosition = (layer == SPOT_LAYER) ? m_spotPosition : glm::vec3(0.0f);
+	cameraBlock.padding = 0.0f;
+
+	// orphaned so the draws of the previous layer keep theirs
+	glBindBuffer(GL_UNIFORM_BUFFER, m_cameraBuffer);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(CAMERA_BLOCK), &cameraBlock, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for uploading the shadow block when it
+ *  changed, and binding the maps that the frame is shaded
+ *  with to their texture unit.
+ ***********************************************************/
+void ShadowMaps::Bind(bool bDynamicCasters)
+{
+	if (true == m_bBlockDirty)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, m_shadowBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(SHADOW_BLOCK), &m_shadowBlock);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		m_bBlockDirty = false;
+	}
+
+	glActiveTexture(GL_TEXTURE0 + SHADOW_MAP_TEXTURE_UNIT);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, ((true == bDynamicCasters) && (0 != m_frameTexture)) ? m_frameTexture : m_staticTexture);
+	glActiveTexture(GL_TEXTURE0 + TEXTURE_ARRAY_UNIT);
+}
+
+/***********************************************************
+ *  GetAttenuationRange()
+ *
+ *  This method is used for finding the distance at which the
+ *  attenuation of the spot light has weakened it to nothing
+ *  that shows, which is as far as its map has to reach.
+ ***********************************************************/
+float ShadowMaps::GetAttenuationRange(float constant, float linear, float quadratic)
+{
+	float range = MAX_SPOT_RANGE;
+
+	// constant + linear * d + quadratic * d * d = cutoff
+	if (quadratic > 0.0f)
+	{
+		float discriminant = linear * linear - 4.0f * quadratic * (constant - SPOT_ATTENUATION_CUTOFF);
+		range = (-linear + std::sqrt(std::max(discriminant, 0.0f))) / (2.0f * quadratic);
+	}
+	else if (linear > 0.0f)
+	{
+		range = (SPOT_ATTENUATION_CUTOFF - constant) / linear;
+	}
+
+	return(glm::clamp(range, SPOT_NEAR_PLANE * 2.0f, MAX_SPOT_RANGE));
+}
+
+/***********************************************************
+ *  GetLightUp()
+ *
+ *  This method is used for picking the up vector of a light
+ *  rotation, which must not be parallel to its direction.
+ ***********************************************************/
+glm::vec3 ShadowMaps::GetLightUp(const glm::vec3& direction)
+{
+	if (std::fabs(direction.y) > 0.99f)
+	{
+		return(glm::vec3(0.0f, 0.0f, 1.0f));
+	}
+
+	return(glm::vec3(0.0f, 1.0f, 0.0f));
+}
@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.h
+// ============
+// cached shadow maps of the directional light cascades and the spot light
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderBlocks.h"
+#include "UniformCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  ShadowMaps
+ *
+ *  This class keeps the depth maps that the directional and
+ *  spot lights are shadowed with, as the layers of one depth
+ *  texture array: the directional light is split into
+ *  cascades along the view, followed by one layer for the
+ *  spot light.  The static casters are drawn into a cached
+ *  array that is only drawn again for a layer whose light or
+ *  matrix moved, or when a static caster changed.  The
+ *  cascades are fit to bounding spheres of the view slices
+ *  and snapped to a coarse grid of whole texels, so they keep
+ *  their matrix while the camera turns and moves a little.
+ *  When the scene has dynamic casters, the cached layers are
+ *  copied into a second array every frame and the dynamic
+ *  casters are drawn over them.  The fragment shader filters
+ *  the maps with hardware depth compares.
+ ***********************************************************/
+class ShadowMaps
+{
+public:
+	// the cascades come first, then the spot light
+	static const int SPOT_LAYER = SHADOW_CASCADE_COUNT;
+	static const int LAYER_COUNT = SHADOW_CASCADE_COUNT + 1;
+	// width and height of every layer
+	static const int DEFAULT_RESOLUTION = 2048;
+
+	// constructor
+	ShadowMaps();
+	// destructor
+	~ShadowMaps();
+
+	// create the cached depth array and the shadow block
+	bool Initialize(int resolution);
+	bool IsInitialized() const { return(0 != m_staticTexture); }
+	// point the sampler of the maps in the program in use at its
+	// texture unit, once after the program is built
+	static void SetSamplerUnit(GLuint programID);
+	// set the shadow switch of the generic program into the
+	// program in use through its cache
+	void SetShaderUniforms(UniformCache& uniforms, bool bUseShadows) const;
+
+	// set the lights that cast the shadows, marking the cached
+	// layers of a light that moved
+	void SetLights(const DIRECTIONAL_LIGHT_STD140& directionalLight, const SPOT_LIGHT_STD140& spotLight);
+	// set the world box around every shadow caster, which the
+	// depth range of the cascades is fit to, marking every layer
+	void SetCasterBounds(const glm::vec3& minimum, const glm::vec3& maximum);
+	// fit the cascades to the passed in camera, marking the
+	// cached ones whose matrix moved
+	void Update(const glm::mat4& view, const glm::mat4& projection, bool bHasViewProjection);
+
+	// whether any light casts a shadow in the current frame
+	bool IsActive() const { return((m_shadowBlock.bDirectionalShadow != 0) || (m_shadowBlock.bSpotShadow != 0)); }
+	bool IsLayerActive(int layer) const;
+	// whether the static casters need drawing into a layer again
+	bool IsLayerDirty(int layer) const { return(m_bLayerDirty[layer]); }
+	// light space projection * view matrix of a layer
+	const glm::mat4& GetLayerMatrix(int layer) const { return(m_layerMatrices[layer]); }
+
+	// set up the depth-only state the casters are drawn with,
+	// saving the framebuffers, viewport and camera block
+	void BeginPass();
+	// clear the cached map of a layer for drawing the static
+	// casters into it, after which the layer is no longer dirty
+	void BeginStaticLayer(int layer);
+	// copy the cached map of a layer into the frame maps for
+	// drawing the dynamic casters over it
+	void BeginDynamicLayer(int layer);
+	// restore the state saved by BeginPass()
+	void EndPass();
+
+	// upload the shadow block if it changed and bind the maps
+	// that the frame is shaded with, the frame maps when the
+	// dynamic casters were drawn into them
+	void Bind(bool bDynamicCasters);
+
+	// layers that the static casters were drawn into again
+	// since the counters were reset
+	unsigned int GetStaticRenderCount() const { return(m_staticRenderCount); }
+	void ResetCounters() { m_staticRenderCount = 0; }
+
+private:
+	int m_resolution;
+	// depth arrays of the static casters and of the whole frame,
+	// the last one only made once there are dynamic casters
+	GLuint m_staticTexture;
+	GLuint m_frameTexture;
+	GLuint m_staticFramebuffer;
+	GLuint m_frameFramebuffer;
+	// shadow block and the camera block the casters are drawn
+	// through, which the vertex shaders already read
+	GLuint m_shadowBuffer;
+	GLuint m_cameraBuffer;
+	SHADOW_BLOCK m_shadowBlock;
+	bool m_bBlockDirty;
+	glm::mat4 m_layerMatrices[LAYER_COUNT];
+	bool m_bLayerDirty[LAYER_COUNT];
+	unsigned int m_staticRenderCount;
+	// the lights as they were last set
+	bool m_bDirectionalLight;
+	bool m_bSpotLight;
+	glm::vec3 m_lightDirection;
+	glm::vec3 m_spotPosition;
+	glm::vec3 m_spotDirection;
+	float m_spotOuterCutOff;
+	float m_spotRange;
+	// world box around the casters, empty while minimum > maximum
+	glm::vec3 m_casterMinimum;
+	glm::vec3 m_casterMaximum;
+	// state restored at the end of the pass
+	GLint m_previousDrawFramebuffer;
+	GLint m_previousReadFramebuffer;
+	GLint m_previousViewport[4];
+	GLint m_previousCameraBuffer;
+
+	// free the textures, framebuffers and buffers
+	void Destroy();
+	// create a depth array with every layer and depth compares
+	GLuint CreateDepthArray() const;
+	// attach a layer of a depth array to a framebuffer
+	void AttachLayer(GLuint framebuffer, GLenum target, GLuint texture, int layer) const;
+	// point the camera block at the matrix of a layer
+	void UseLayerCamera(int layer);
+	// fit one cascade to the slice of the view between two depths
+	void FitCascade(int cascade, const glm::vec3 sliceCorners[8]);
+	// set the matrix of a layer, marking it when it moved
+	void SetLayerMatrix(int layer, const glm::mat4& matrix);
+	// distance at which the spot light has faded to nothing
+	static float GetAttenuationRange(float constant, float linear, float quadratic);
+	// a vector to build a light rotation with that is never
+	// parallel to the passed in direction
+	static glm::vec3 GetLightUp(const glm::vec3& direction);
+};
@@ -0,0 +1,409 @@
+///////////////////////////////////////////////////////////////////////////////
+// statsoverlay.cpp
+// ============
+// draw the frame profiler times and counters on top of the scene
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "StatsOverlay.h"
+#include "AllocationCounter.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// rows of one font glyph, top row first, with the left
+	// pixel of each row in bit 2
+	struct FONT_GLYPH
+	{
+		char character;
+		unsigned char rows[5];
+	};
+
+	const FONT_GLYPH g_FontGlyphs[] =
+	{
+		{ '0', { 0x7, 0x5, 0x5, 0x5, 0x7 } },
+		{ '1', { 0x2, 0x6, 0x2, 0x2, 0x7 } },
+		{ '2', { 0x7, 0x1, 0x7, 0x4, 0x7 } },
+		{ '3', { 0x7, 0x1, 0x3, 0x1, 0x7 } },
+		{ '4', { 0x5, 0x5, 0x7, 0x1, 0x1 } },
+		{ '5', { 0x7, 0x4, 0x7, 0x1, 0x7 } },
+		{ '6', { 0x7, 0x4, 0x7, 0x5, 0x7 } },
+		{ '7', { 0x7, 0x1, 0x2, 0x2, 0x2 } },
+		{ '8', { 0x7, 0x5, 0x7, 0x5, 0x7 } },
+		{ '9', { 0x7, 0x5, 0x7, 0x1, 0x7 } },
+		{ 'A', { 0x2, 0x5, 0x7, 0x5, 0x5 } },
+		{ 'B', { 0x6, 0x5, 0x6, 0x5, 0x6 } },
+		{ 'C', { 0x3, 0x4, 0x4, 0x4, 0x3 } },
+		{ 'D', { 0x6, 0x5, 0x5, 0x5, 0x6 } },
+		{ 'E', { 0x7, 0x4, 0x6, 0x4, 0x7 } },
+		{ 'F', { 0x7, 0x4, 0x6, 0x4, 0x4 } },
+		{ 'G', { 0x3, 0x4, 0x5, 0x5, 0x3 } },
+		{ 'H', { 0x5, 0x5, 0x7, 0x5, 0x5 } },
+		{ 'I', { 0x7, 0x2, 0x2, 0x2, 0x7 } },
+		{ 'J', { 0x1, 0x1, 0x1, 0x5, 0x2 } },
+		{ 'K', { 0x5, 0x5, 0x6, 0x5, 0x5 } },
+		{ 'L', { 0x4, 0x4, 0x4, 0x4, 0x7 } },
+		{ 'M', { 0x5, 0x7, 0x7, 0x5, 0x5 } },
+		{ 'N', { 0x6, 0x5, 0x5, 0x5, 0x5 } },
+		{ 'O', { 0x2, 0x5, 0x5, 0x5, 0x2 } },
+		{ 'P', { 0x6, 0x5, 0x6, 0x4, 0x4 } },
+		{ 'Q', { 0x2, 0x5, 0x5, 0x6, 0x3 } },
+		{ 'R', { 0x6, 0x5, 0x6, 0x5, 0x5 } },
+		{ 'S', { 0x3, 0x4, 0x2, 0x1, 0x6 } },
+		{ 'T', { 0x7, 0x2, 0x2, 0x2, 0x2 } },
+		{ 'U', { 0x5, 0x5, 0x5, 0x5, 0x7 } },
+		{ 'V', { 0x5, 0x5, 0x5, 0x5, 0x2 } },
+		{ 'W', { 0x5, 0x5, 0x7, 0x7, 0x5 } },
+		{ 'X', { 0x5, 0x5, 0x2, 0x5, 0x5 } },
+		{ 'Y', { 0x5, 0x5, 0x2, 0x2, 0x2 } },
+		{ 'Z', { 0x7, 0x1, 0x2, 0x4, 0x7 } },
+		{ ' ', { 0x0, 0x0, 0x0, 0x0, 0x0 } },
+		{ '.', { 0x0, 0x0, 0x0, 0x0, 0x2 } },
+		{ ':', { 0x0, 0x2, 0x0, 0x2, 0x0 } },
+		{ '/', { 0x1, 0x1, 0x2, 0x4, 0x4 } },
+		{ '%', { 0x5, 0x1, 0x2, 0x4, 0x5 } },
+		{ '-', { 0x0, 0x0, 0x7, 0x0, 0x0 } },
+	};
+	const int g_FontGlyphCount = sizeof(g_FontGlyphs) / sizeof(g_FontGlyphs[0]);
+
+	// screen pixels per font pixel, and the spacing of the text
+	const float g_FontScale = 2.0f;
+	const float g_CharacterAdvance = 4.0f * g_FontScale;
+	const float g_LineAdvance = 7.0f * g_FontScale;
+	// most lines of text, one per pass and six around them
+	const int MAX_TEXT_LINES = FrameProfiler::SCOPE_COUNT + 6;
+	const size_t TEXT_LINE_LENGTH = 128;
+	const float g_Margin = 8.0f;
+
+	/***********************************************************
+	 *  FindGlyph()
+	 *
+	 *  This function is used for finding the glyph of a
+	 *  character, lower case letters use the upper case glyphs.
+	 ***********************************************************/
+	const FONT_GLYPH* FindGlyph(char character)
+	{
+		if ((character >= 'a') && (character <= 'z'))
+		{
+			character = (char)(character - 'a' + 'A');
+		}
+
+		for (int i = 0; i < g_FontGlyphCount; i++)
+		{
+			if (g_FontGlyphs[i].character == character)
+			{
+				return(&g_FontGlyphs[i]);
+			}
+		}
+
+		return(NULL);
+	}
+
+	/***********************************************************
+	 *  FormatMilliseconds()
+	 *
+	 *  This function is used for formatting a time into the
+	 *  passed in buffer, or a dash when it has not been measured.
+	 ***********************************************************/
+	const char* FormatMilliseconds(double milliseconds, char* text, size_t size)
+	{
+		if (milliseconds < 0.0)
+		{
+			snprintf(text, size, "-");
+		}
+		else
+		{
+			snprintf(text, size, "%.2f", milliseconds);
+		}
+
+		return(text);
+	}
+}
+
+/***********************************************************
+ *  StatsOverlay()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+StatsOverlay::StatsOverlay()
+{
+	m_pShaderManager = NULL;
+	m_programID = 0;
+	m_vao = 0;
+	m_vertexBuffer = 0;
+	m_vertexCapacity = 0;
+	m_bVisible = false;
+	m_contentScale = 1.0f;
+}
+
+/***********************************************************
+ *  ~StatsOverlay()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+StatsOverlay::~StatsOverlay()
+{
+	if (0 != m_vertexBuffer)
+	{
+		glDeleteBuffers(1, &m_vertexBuffer);
+		m_vertexBuffer = 0;
+	}
+	if (0 != m_vao)
+	{
+		glDeleteVertexArrays(1, &m_vao);
+		m_vao = 0;
+	}
+	if (NULL != m_pShaderManager)
+	{
+		delete m_pShaderManager;
+		m_pShaderManager = NULL;
+	}
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for loading the overlay shader program
+ *  and creating its vertex array.  The previously used
+ *  program is restored afterwards.
+ ***********************************************************/
+bool StatsOverlay::Initialize(
+	const char* vertexShaderPath,
+	const char* fragmentShaderPath)
+{
+	GLint previousProgram = 0;
+	GLint previousVertexArray = 0;
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVertexArray);
+
+	m_pShaderManager = new ShaderManager();
+	m_programID = m_pShaderManager->LoadShaders(vertexShaderPath, fragmentShaderPath);
+	if (0 == m_programID)
+	{
+		std::cout << "Could not load the overlay shaders:" << vertexShaderPath << std::endl;
+		delete m_pShaderManager;
+		m_pShaderManager = NULL;
+		glUseProgram((GLuint)previousProgram);
+		return(false);
+	}
+
+	glGenVertexArrays(1, &m_vao);
+	glGenBuffers(1, &m_vertexBuffer);
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(OVERLAY_VERTEX), (void*)offsetof(OVERLAY_VERTEX, position));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(OVERLAY_VERTEX), (void*)offsetof(OVERLAY_VERTEX, color));
+
+	glBindVertexArray((GLuint)previousVertexArray);
+	glUseProgram((GLuint)previousProgram);
+
+	return(true);
+}
+
+/***********************************************************
+ *  AddRect()
+ *
+ *  This method is used for adding a filled rectangle as two
+ *  triangles.
+ ***********************************************************/
+void StatsOverlay::AddRect(float x, float y, float width, float height, const glm::vec4& color)
+{
+	OVERLAY_VERTEX corners[4];
+
+	corners[0].position = glm::vec2(x, y);
+	corners[1].position = glm::vec2(x + width, y);
+	corners[2].position = glm::vec2(x + width, y + height);
+	corners[3].position = glm::vec2(x, y + height);
+	for (int i = 0; i < 4; i++)
+	{
+		corners[i].color = color;
+	}
+
+	m_vertices.push_back(corners[0]);
+	m_vertices.push_back(corners[1]);
+	m_vertices.push_back(corners[2]);
+	m_vertices.push_back(corners[0]);
+	m_vertices.push_back(corners[2]);
+	m_vertices.push_back(corners[3]);
+}
+
+/***********************************************************
+ *  AddText()
+ *
+ *  This method is used for adding a line of text with its top
+ *  left corner at the passed in pixel position.  Characters
+ *  without a glyph are drawn as blanks.
+ ***********************************************************/
+float StatsOverlay::AddText(float x, float y, const char* text, const glm::vec4& color)
+{
+	size_t length = strlen(text);
+
+	for (size_t i = 0; i < length; i++)
+	{
+		const FONT_GLYPH* pGlyph = FindGlyph(text[i]);
+		float characterX = x + (float)i * g_CharacterAdvance;
+
+		if (NULL == pGlyph)
+		{
+			continue;
+		}
+
+		for (int row = 0; row < 5; row++)
+		{
+			for (int column = 0; column < 3; column++)
+			{
+				if (pGlyph->rows[row] & (0x4 >> column))
+				{
+					AddRect(
+						characterX + (float)column * g_FontScale,
+						y + (float)row * g_FontScale,
+						g_FontScale,
+						g_FontScale,
+						color);
+				}
+			}
+		}
+	}
+
+	return((float)length * g_CharacterAdvance);
+}
+
+/***********************************************************
+ *  BuildText()
+ *
+ *  This method is used for building the quads of the overlay
+ *  text for the passed in frame, on a dark background.  The
+ *  lines are formatted into fixed buffers, so drawing the
+ *  overlay does not show up in the heap allocation count.
+ ***********************************************************/
+void StatsOverlay::BuildText(const FrameProfiler::FRAME_STATS* pStats)
+{
+	char lines[MAX_TEXT_LINES][TEXT_LINE_LENGTH];
+	char cpuTime[32];
+	char gpuTime[32];
+	int lineCount = 0;
+	float width = 0.0f;
+
+	m_vertices.clear();
+
+	if (NULL == pStats)
+	{
+		snprintf(lines[lineCount++], TEXT_LINE_LENGTH, "WAITING FOR GPU TIMES");
+	}
+	else
+	{
+		double fps = (pStats->frameMilliseconds > 0.0) ? (1000.0 / pStats->frameMilliseconds) : 0.0;
+
+		snprintf(lines[lineCount++], TEXT_LINE_LENGTH, "FRAME %u  %.1f FPS  %s MS",
+			pStats->frameIndex, fps, FormatMilliseconds(pStats->frameMilliseconds, cpuTime, sizeof(cpuTime)));
+		snprintf(lines[lineCount++], TEXT_LINE_LENGTH, "%-16s  %-7s  %s", "PASS", "CPU MS", "GPU MS");
+		for (int scope = 0; scope < FrameProfiler::SCOPE_COUNT; scope++)
+		{
+			snprintf(lines[lineCount++], TEXT_LINE_LENGTH, "%-16s  %-7s  %s",
+				FrameProfiler::GetScopeName((FrameProfiler::PROFILE_SCOPE)scope),
+				FormatMilliseconds(pStats->cpuMilliseconds[scope], cpuTime, sizeof(cpuTime)),
+				FormatMilliseconds(pStats->gpuMilliseconds[scope], gpuTime, sizeof(gpuTime)));
+		}
+		snprintf(lines[lineCount++], TEXT_LINE_LENGTH, "DRAWS %u  TRIANGLES %u  CULLED %u",
+			pStats->counters.drawCalls, pStats->counters.triangles, pStats->counters.culledNodes);
+		snprintf(lines[lineCount++], TEXT_LINE_LENGTH, "UNIFORMS %u  TEXTURE BINDS %u  SHADOW LAYERS %u",
+			pStats->counters.uniformUploads, pStats->counters.textureBinds, pStats->counters.shadowLayers);
+		snprintf(lines[lineCount++], TEXT_LINE_LENGTH, "RENDER %u X %u",
+			pStats->counters.renderWidth, pStats->counters.renderHeight);
+		if (AllocationCounter::IsEnabled())
+		{
+			snprintf(lines[lineCount++], TEXT_LINE_LENGTH, "HEAP ALLOCATIONS %u", pStats->counters.heapAllocations);
+		}
+	}
+
+	for (int i = 0; i < lineCount; i++)
+	{
+		float lineWidth = (float)strlen(lines[i]) * g_CharacterAdvance;
+		width = (lineWidth > width) ? lineWidth : width;
+	}
+
+	AddRect(
+		g_Margin * 0.5f,
+		g_Margin * 0.5f,
+		width + g_Margin,
+		(float)lineCount * g_LineAdvance + g_Margin,
+		glm::vec4(0.0f, 0.0f, 0.0f, 0.6f));
+
+	for (int i = 0; i < lineCount; i++)
+	{
+		AddText(g_Margin, g_Margin + (float)i * g_LineAdvance, lines[i], glm::vec4(1.0f, 1.0f, 0.6f, 1.0f));
+	}
+}
+
+/***********************************************************
+ *  Draw()
+ *
+ *  This method is used for drawing the overlay over whatever
+ *  has been rendered.  The depth test is turned off and
+ *  blending on while drawing, and the program, vertex array,
+ *  depth test and blending are restored afterwards.
+ ***********************************************************/
+void StatsOverlay::Draw(const FrameProfiler& profiler)
+{
+	GLint previousProgram = 0;
+	GLint previousVertexArray = 0;
+	GLint viewport[4] = { 0, 0, 0, 0 };
+	GLboolean bDepthTest = GL_FALSE;
+	GLboolean bBlend = GL_FALSE;
+
+	if ((false == m_bVisible) || (NULL == m_pShaderManager))
+	{
+		return;
+	}
+
+	BuildText(profiler.GetLatestCompleteFrame());
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+	glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &previousVertexArray);
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	bDepthTest = glIsEnabled(GL_DEPTH_TEST);
+	bBlend = glIsEnabled(GL_BLEND);
+
+	m_pShaderManager->use();
+	// the quads are laid out in screen points, which take up
+	// more than one pixel on a HiDPI display
+	m_pShaderManager->setVec2Value("viewportSize",
+		(float)viewport[2] / m_contentScale, (float)viewport[3] / m_contentScale);
+
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	// the buffer only grows, and is orphaned every frame
+	if (m_vertices.size() > m_vertexCapacity)
+	{
+		m_vertexCapacity = m_vertices.size() * 2;
+	}
+	glBufferData(GL_ARRAY_BUFFER, m_vertexCapacity * sizeof(OVERLAY_VERTEX), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, m_vertices.size() * sizeof(OVERLAY_VERTEX), &m_vertices[0]);
+
+	// the blend function is the one the view manager sets up
+	// for the scene, so only the blend switch is restored
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glDrawArrays(GL_TRIANGLES, 0, (GLsizei)m_vertices.size());
+
+	if (GL_TRUE == bDepthTest)
+	{
+		glEnable(GL_DEPTH_TEST);
+	}
+	if (GL_FALSE == bBlend)
+	{
+		glDisable(GL_BLEND);
+	}
+	glBindVertexArray((GLuint)previousVertexArray);
+	glUseProgram((GLuint)previousProgram);
+}
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+// statsoverlay.h
+// ============
+// draw the frame profiler times and counters on top of the scene
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "FrameProfiler.h"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  StatsOverlay
+ *
+ *  This class draws the latest complete frame of a profiler
+ *  as text in the top left corner of the window.  The text
+ *  uses a built in 3x5 pixel font, and every lit font pixel
+ *  becomes a small quad, so no font texture is needed.
+ ***********************************************************/
+class StatsOverlay
+{
+public:
+	// constructor
+	StatsOverlay();
+	// destructor
+	~StatsOverlay();
+
+	// load the overlay shader program and create the buffers
+	bool Initialize(
+		const char* vertexShaderPath,
+		const char* fragmentShaderPath);
+
+	// show or hide the overlay
+	void SetVisible(bool bVisible) { m_bVisible = bVisible; }
+	void ToggleVisible() { m_bVisible = !m_bVisible; }
+	bool IsVisible() const { return(m_bVisible); }
+	// set the pixels per screen point of the display, which the
+	// text is made larger by so it stays readable on a HiDPI one
+	void SetContentScale(float scale) { m_contentScale = (scale > 1.0f) ? scale : 1.0f; }
+
+	// draw the latest complete frame of the passed in profiler
+	void Draw(const FrameProfiler& profiler);
+
+private:
+	// layout of one overlay vertex, in pixels from the top left
+	struct OVERLAY_VERTEX
+	{
+		glm::vec2 position;
+		glm::vec4 color;
+	};
+
+	// shader program used for the overlay
+	ShaderManager* m_pShaderManager;
+	GLuint m_programID;
+	// vertex array and buffer of the overlay quads
+	GLuint m_vao;
+	GLuint m_vertexBuffer;
+	// capacity of the vertex buffer, in vertices
+	size_t m_vertexCapacity;
+	// quads built for the current frame
+	std::vector<OVERLAY_VERTEX> m_vertices;
+	bool m_bVisible;
+	float m_contentScale;
+
+	// add a filled rectangle
+	void AddRect(float x, float y, float width, float height, const glm::vec4& color);
+	// add a line of text, returning its width in pixels
+	float AddText(float x, float y, const char* text, const glm::vec4& color);
+	// build the text lines for the passed in frame
+	void BuildText(const FrameProfiler::FRAME_STATS* pStats);
+};
@@ -0,0 +1,358 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.cpp
+// ================
+// read and write the block-compressed KTX2 files cached next to the textures
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureCache.h"
+
+#include <GL/glew.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+// declaration of global variables
+namespace
+{
+	// the twelve byte identifier that every KTX2 file starts with
+	const unsigned char KTX2_IDENTIFIER[12] =
+	{
+		0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+	};
+
+	// Vulkan format of the BC7 blocks, as KTX2 stores formats
+	const uint32_t VK_FORMAT_BC7_UNORM_BLOCK = 145;
+
+	// data format descriptor values for BC7 blocks
+	const uint8_t KHR_DF_MODEL_BC7 = 134;
+	const uint8_t KHR_DF_PRIMARIES_BT709 = 1;
+	const uint8_t KHR_DF_TRANSFER_LINEAR = 1;
+
+	// key of the source image hash in the key/value data
+	const char* g_SourceHashKey = "CS330SourceHash";
+
+	// sizes of the fixed parts of the file
+	const size_t KTX2_HEADER_SIZE = 80;
+	const size_t KTX2_LEVEL_INDEX_SIZE = 24;
+	const size_t KTX2_DFD_SIZE = 44;
+	// block compressed levels are aligned to the 16 byte blocks
+	const size_t KTX2_LEVEL_ALIGNMENT = 16;
+
+	// BC7 compresses blocks of 4x4 texels into 16 bytes
+	const uint32_t BLOCK_DIMENSION = 4;
+	const uint32_t BLOCK_BYTES = 16;
+
+	void WriteUint32(std::vector<unsigned char>& data, size_t offset, uint32_t value)
+	{
+		memcpy(&data[offset], &value, sizeof(value));
+	}
+
+	void WriteUint64(std::vector<unsigned char>& data, size_t offset, uint64_t value)
+	{
+		memcpy(&data[offset], &value, sizeof(value));
+	}
+
+	uint32_t ReadUint32(const std::vector<unsigned char>& data, size_t offset)
+	{
+		uint32_t value = 0;
+		memcpy(&value, &data[offset], sizeof(value));
+		return(value);
+	}
+
+	uint64_t ReadUint64(const std::vector<unsigned char>& data, size_t offset)
+	{
+		uint64_t value = 0;
+		memcpy(&value, &data[offset], sizeof(value));
+		return(value);
+	}
+
+	size_t AlignUp(size_t value, size_t alignment)
+	{
+		return((value + alignment - 1) / alignment * alignment);
+	}
+}
+
+/***********************************************************
+ *  HashData()
+ *
+ *  This method is used for hashing the bytes of a source
+ *  image with 64-bit FNV-1a, which is enough to notice that
+ *  a texture has been edited since it was baked.
+ ***********************************************************/
+uint64_t TextureCache::HashData(const unsigned char* data, size_t size)
+{
+	uint64_t hash = 14695981039346656037ULL;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return(hash);
+}
+
+/***********************************************************
+ *  GetCachePath()
+ *
+ *  This method is used for getting the path of the cached file
+ *  of a source image, which is the source path with its
+ *  extension replaced by .ktx2.
+ ***********************************************************/
+std::string TextureCache::GetCachePath(const std::string& sourcePath)
+{
+	size_t extension = sourcePath.find_last_of('.');
+	size_t separator = sourcePath.find_last_of("/\\");
+
+	if ((extension == std::string::npos) ||
+		((separator != std::string::npos) && (extension < separator)))
+	{
+		return(sourcePath + ".ktx2");
+	}
+
+	return(sourcePath.substr(0, extension) + ".ktx2");
+}
+
+/***********************************************************
+ *  IsCacheableFormat()
+ *
+ *  This method is used for checking whether textures in the
+ *  passed in compressed format can be cached.  Only BC7 is
+ *  baked at the moment.
+ ***********************************************************/
+bool TextureCache::IsCacheableFormat(uint32_t glFormat)
+{
+	return(glFormat == GL_COMPRESSED_RGBA_BPTC_UNORM);
+}
+
+/***********************************************************
+ *  GetLevelSize()
+ *
+ *  This method is used for getting the size in bytes of a mip
+ *  level, where even the smallest levels take a whole block.
+ ***********************************************************/
+size_t TextureCache::GetLevelSize(uint32_t glFormat, uint32_t width, uint32_t height)
+{
+	if (IsCacheableFormat(glFormat) == false)
+	{
+		return(0);
+	}
+
+	size_t blocksWide = (width + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+	size_t blocksHigh = (height + BLOCK_DIMENSION - 1) / BLOCK_DIMENSION;
+
+	return(blocksWide * blocksHigh * BLOCK_BYTES);
+}
+
+/***********************************************************
+ *  ReadTexture()
+ *
+ *  This method is used for reading a cached KTX2 file.  The
+ *  file is rejected if it is not one of the files written by
+ *  WriteTexture(), if any of its data runs past the end of
+ *  the file, or if it was baked from a source image with a
+ *  different hash.
+ ***********************************************************/
+bool TextureCache::ReadTexture(
+	const std::string& cachePath,
+	uint64_t sourceHash,
+	COMPRESSED_TEXTURE& texture)
+{
+	std::ifstream file(cachePath.c_str(), std::ios::binary);
+	std::vector<unsigned char> data;
+
+	if (!file.is_open())
+	{
+		return(false);
+	}
+
+	file.seekg(0, std::ios::end);
+	data.resize((size_t)file.tellg());
+	file.seekg(0, std::ios::beg);
+	if ((data.size() < KTX2_HEADER_SIZE) || !file.read((char*)&data[0], data.size()))
+	{
+		return(false);
+	}
+
+	if (memcmp(&data[0], KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0)
+	{
+		return(false);
+	}
+
+	uint32_t vkFormat = ReadUint32(data, 12);
+	uint32_t levelCount = ReadUint32(data, 40);
+	uint32_t supercompression = ReadUint32(data, 44);
+	uint32_t kvdOffset = ReadUint32(data, 56);
+	uint32_t kvdLength = ReadUint32(data, 60);
+
+	if ((vkFormat != VK_FORMAT_BC7_UNORM_BLOCK) || (supercompression != 0) || (levelCount == 0) ||
+		(levelCount > (data.size() - KTX2_HEADER_SIZE) / KTX2_LEVEL_INDEX_SIZE) ||
+		(kvdOffset > data.size()) || (kvdLength > data.size() - kvdOffset))
+	{
+		return(false);
+	}
+
+	// the source hash is kept as a hexadecimal string value, and
+	// an entry running past the key/value data means the file was
+	// cut short or corrupted, so it is baked again
+	bool bHashMatches = false;
+	size_t kvdEnd = (size_t)kvdOffset + kvdLength;
+	size_t entry = kvdOffset;
+	while (entry + 4 <= kvdEnd)
+	{
+		uint32_t entryLength = ReadUint32(data, entry);
+		if ((size_t)entryLength > kvdEnd - entry - 4)
+		{
+			return(false);
+		}
+
+		const char* key = (const char*)&data[entry + 4];
+		size_t keyLength = strnlen(key, entryLength);
+
+		if ((keyLength < entryLength) && (strcmp(key, g_SourceHashKey) == 0))
+		{
+			std::string value(key + keyLength + 1, entryLength - keyLength - 1);
+			if ((uint64_t)strtoull(value.c_str(), NULL, 16) == sourceHash)
+			{
+				bHashMatches = true;
+			}
+		}
+		entry = AlignUp(entry + 4 + entryLength, 4);
+	}
+	if (bHashMatches == false)
+	{
+		return(false);
+	}
+
+	texture.glFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+	texture.width = ReadUint32(data, 20);
+	texture.height = ReadUint32(data, 24);
+	texture.sourceHash = sourceHash;
+	texture.levels.clear();
+	texture.levels.resize(levelCount);
+
+	for (uint32_t level = 0; level < levelCount; level++)
+	{
+		size_t indexOffset = KTX2_HEADER_SIZE + level * KTX2_LEVEL_INDEX_SIZE;
+		uint64_t byteOffset = ReadUint64(data, indexOffset);
+		uint64_t byteLength = ReadUint64(data, indexOffset + 8);
+		uint32_t levelWidth = (texture.width >> level) > 0 ? (texture.width >> level) : 1;
+		uint32_t levelHeight = (texture.height >> level) > 0 ? (texture.height >> level) : 1;
+
+		if ((byteOffset > data.size()) || (byteLength > data.size() - byteOffset) ||
+			(byteLength != GetLevelSize(texture.glFormat, levelWidth, levelHeight)))
+		{
+			texture.levels.clear();
+			return(false);
+		}
+
+		texture.levels[level].assign(data.begin() + (size_t)byteOffset, data.begin() + (size_t)(byteOffset + byteLength));
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteTexture()
+ *
+ *  This method is used for writing a baked texture as a KTX2
+ *  file with a basic data format descriptor, the source hash
+ *  in the key/value data, and the mip levels stored smallest
+ *  first as the format requires.
+ ***********************************************************/
+bool TextureCache::WriteTexture(
+	const std::string& cachePath,
+	const COMPRESSED_TEXTURE& texture)
+{
+	std::vector<unsigned char> data;
+	uint32_t levelCount = (uint32_t)texture.levels.size();
+	char hashValue[17];
+
+	if ((IsCacheableFormat(texture.glFormat) == false) || (levelCount == 0))
+	{
+		return(false);
+	}
+
+	snprintf(hashValue, sizeof(hashValue), "%016llx", (unsigned long long)texture.sourceHash);
+
+	size_t dfdOffset = KTX2_HEADER_SIZE + levelCount * KTX2_LEVEL_INDEX_SIZE;
+	size_t kvdOffset = dfdOffset + KTX2_DFD_SIZE;
+	uint32_t kvdEntryLength = (uint32_t)(strlen(g_SourceHashKey) + 1 + strlen(hashValue) + 1);
+	size_t kvdLength = AlignUp(4 + kvdEntryLength, 4);
+	size_t levelOffset = AlignUp(kvdOffset + kvdLength, KTX2_LEVEL_ALIGNMENT);
+	size_t fileSize = levelOffset;
+
+	for (uint32_t level = 0; level < levelCount; level++)
+	{
+		fileSize = AlignUp(fileSize, KTX2_LEVEL_ALIGNMENT) + texture.levels[level].size();
+	}
+	data.resize(fileSize, 0);
+
+	// identifier and header
+	memcpy(&data[0], KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+	WriteUint32(data, 12, VK_FORMAT_BC7_UNORM_BLOCK);
+	WriteUint32(data, 16, 1);
+	WriteUint32(data, 20, texture.width);
+	WriteUint32(data, 24, texture.height);
+	WriteUint32(data, 28, 0);
+	WriteUint32(data, 32, 0);
+	WriteUint32(data, 36, 1);
+	WriteUint32(data, 40, levelCount);
+	WriteUint32(data, 44, 0);
+
+	// index of the data format descriptor and key/value data,
+	// there is no supercompression global data
+	WriteUint32(data, 48, (uint32_t)dfdOffset);
+	WriteUint32(data, 52, (uint32_t)KTX2_DFD_SIZE);
+	WriteUint32(data, 56, (uint32_t)kvdOffset);
+	WriteUint32(data, 60, (uint32_t)kvdLength);
+	WriteUint64(data, 64, 0);
+	WriteUint64(data, 72, 0);
+
+	// basic data format descriptor with a single BC7 sample
+	WriteUint32(data, dfdOffset, (uint32_t)KTX2_DFD_SIZE);
+	WriteUint32(data, dfdOffset + 4, 0);
+	WriteUint32(data, dfdOffset + 8, 2 | ((uint32_t)(KTX2_DFD_SIZE - 4) << 16));
+	data[dfdOffset + 12] = KHR_DF_MODEL_BC7;
+	data[dfdOffset + 13] = KHR_DF_PRIMARIES_BT709;
+	data[dfdOffset + 14] = KHR_DF_TRANSFER_LINEAR;
+	data[dfdOffset + 15] = 0;
+	data[dfdOffset + 16] = BLOCK_DIMENSION - 1;
+	data[dfdOffset + 17] = BLOCK_DIMENSION - 1;
+	data[dfdOffset + 20] = BLOCK_BYTES;
+	data[dfdOffset + 30] = 127;
+	WriteUint32(data, dfdOffset + 40, 0xFFFFFFFF);
+
+	// key/value data holding the source hash
+	WriteUint32(data, kvdOffset, kvdEntryLength);
+	memcpy(&data[kvdOffset + 4], g_SourceHashKey, strlen(g_SourceHashKey) + 1);
+	memcpy(&data[kvdOffset + 4 + strlen(g_SourceHashKey) + 1], hashValue, strlen(hashValue) + 1);
+
+	// the level data is stored from the smallest level up, while
+	// the level index lists the largest level first
+	size_t offset = levelOffset;
+	for (int level = (int)levelCount - 1; level >= 0; level--)
+	{
+		size_t indexOffset = KTX2_HEADER_SIZE + level * KTX2_LEVEL_INDEX_SIZE;
+
+		offset = AlignUp(offset, KTX2_LEVEL_ALIGNMENT);
+		memcpy(&data[offset], &texture.levels[level][0], texture.levels[level].size());
+		WriteUint64(data, indexOffset, offset);
+		WriteUint64(data, indexOffset + 8, texture.levels[level].size());
+		WriteUint64(data, indexOffset + 16, texture.levels[level].size());
+		offset += texture.levels[level].size();
+	}
+
+	std::ofstream file(cachePath.c_str(), std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+	{
+		return(false);
+	}
+	file.write((const char*)&data[0], data.size());
+
+	return(file.good());
+}
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.h
+// ============
+// read and write the block-compressed KTX2 files cached next to the textures
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureCache
+ *
+ *  This class keeps the baked, block-compressed version of a
+ *  texture in a KTX2 file next to its source image, with the
+ *  full mip chain.  Each file records a hash of the source
+ *  image it was baked from, so a cached file is only used
+ *  while the source is unchanged.  No OpenGL calls are made
+ *  here, so the files can be read on the loader threads.
+ ***********************************************************/
+class TextureCache
+{
+public:
+	// a compressed texture with all of its mip levels
+	struct COMPRESSED_TEXTURE
+	{
+		// OpenGL internal format of the blocks
+		uint32_t glFormat;
+		uint32_t width;
+		uint32_t height;
+		// hash of the source image the texture was baked from
+		uint64_t sourceHash;
+		// block data of every mip level, largest level first
+		std::vector<std::vector<unsigned char> > levels;
+	};
+
+	// hash the contents of a source image file
+	static uint64_t HashData(const unsigned char* data, size_t size);
+	// path of the cached file for the passed in source image
+	static std::string GetCachePath(const std::string& sourcePath);
+
+	// check whether a compressed format can be stored in KTX2
+	static bool IsCacheableFormat(uint32_t glFormat);
+	// size in bytes of one mip level in the passed in format
+	static size_t GetLevelSize(uint32_t glFormat, uint32_t width, uint32_t height);
+
+	// read a cached texture, failing if it was baked from a
+	// different source image
+	static bool ReadTexture(
+		const std::string& cachePath,
+		uint64_t sourceHash,
+		COMPRESSED_TEXTURE& texture);
+	// write a baked texture to its cache file
+	static bool WriteTexture(
+		const std::string& cachePath,
+		const COMPRESSED_TEXTURE& texture);
+};
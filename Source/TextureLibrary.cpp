@@ -0,0 +1,1052 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturelibrary.cpp
+// ==================
+// load the scene textures into the layers of a single texture array
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLibrary.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables
+namespace
+{
+	// largest width and height of a layer, larger images are
+	// scaled down into their layer
+	const int MAX_LAYER_SIZE = 1024;
+
+	// color shown in a layer until its image is resident
+	const GLfloat PLACEHOLDER_COLOR[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+
+	// longest wait for the GPU to finish with an upload buffer
+	const GLuint64 UPLOAD_FENCE_TIMEOUT = 1000000000;
+
+	// block compressed format of the layers when supported
+	const GLenum COMPRESSED_FORMAT = GL_COMPRESSED_RGBA_BPTC_UNORM;
+
+	int GetLevelDimension(int size, int level)
+	{
+		int dimension = size >> level;
+		return((dimension > 0) ? dimension : 1);
+	}
+}
+
+/***********************************************************
+ *  TextureLibrary()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureLibrary::TextureLibrary()
+{
+	m_textureArray = 0;
+	m_layerSize = 0;
+	m_levelCount = 0;
+	m_bCompressed = false;
+	m_framebuffers[0] = 0;
+	m_framebuffers[1] = 0;
+	for (int i = 0; i < UPLOAD_SLOT_COUNT; i++)
+	{
+		m_uploadBuffers[i] = 0;
+		m_uploadPointers[i] = NULL;
+		m_uploadFences[i] = NULL;
+	}
+	m_uploadSlotSize = 0;
+	m_nextUploadSlot = 0;
+	m_bPersistentUpload = false;
+	m_bindCount = 0;
+}
+
+/***********************************************************
+ *  ~TextureLibrary()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureLibrary::~TextureLibrary()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  LoadTexture()
+ *
+ *  This method is used for reading the header of the passed
+ *  in image file and queueing the file to be decoded on the
+ *  loader threads.  The returned layer is the one the image
+ *  will be uploaded into, or INVALID_LAYER if the file could
+ *  not be read.
+ ***********************************************************/
+TextureLibrary::TextureLayer TextureLibrary::LoadTexture(const char* filename, const std::string& tag)
+{
+	TEXTURE_LAYER texture;
+
+	texture.tag = tag;
+	texture.filename = filename;
+	texture.width = 0;
+	texture.height = 0;
+	texture.colorChannels = 0;
+	texture.bResident = false;
+
+	// only the header is read here, which is enough for sizing
+	// the texture array before the image has been decoded
+	if (0 == stbi_info(filename, &texture.width, &texture.height, &texture.colorChannels))
+	{
+		std::cout << "Could not load image:" << filename << std::endl;
+		return(INVALID_LAYER);
+	}
+
+	// only RGB and RGBA images are supported, RGBA supports transparency
+	if ((texture.colorChannels != 3) && (texture.colorChannels != 4))
+	{
+		std::cout << "Not implemented to handle image with " << texture.colorChannels << " channels" << std::endl;
+		return(INVALID_LAYER);
+	}
+
+	// every layer of the array has the same format, which is
+	// settled by the first texture
+	if (m_textures.size() == 0)
+	{
+		m_bCompressed = IsCompressionSupported();
+	}
+
+	m_textures.push_back(texture);
+
+	m_loader.Start();
+	m_loader.QueueImage((int)m_textures.size() - 1, texture.filename, m_bCompressed);
+
+	return((TextureLayer)m_textures.size() - 1);
+}
+
+/***********************************************************
+ *  FindTexture()
+ *
+ *  This method is used for getting the layer of the loaded
+ *  texture associated with the passed in tag.
+ ***********************************************************/
+TextureLibrary::TextureLayer TextureLibrary::FindTexture(const std::string& tag) const
+{
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		if (m_textures[i].tag.compare(tag) == 0)
+		{
+			return((TextureLayer)i);
+		}
+	}
+
+	return(INVALID_LAYER);
+}
+
+/***********************************************************
+ *  ReloadTexture()
+ *
+ *  This method is used for decoding the image of a layer again
+ *  on the loader threads after its file was changed.  The layer
+ *  keeps showing the old image until the new one is uploaded
+ *  by UpdateUploads(), and only this layer is uploaded.  The
+ *  cached BC7 file of the image no longer matches the hash of
+ *  its source, so it is baked and cached again.
+ ***********************************************************/
+bool TextureLibrary::ReloadTexture(TextureLayer layer)
+{
+	if ((layer < 0) || (layer >= (int)m_textures.size()) || (0 == m_textureArray))
+	{
+		return(false);
+	}
+
+	m_loader.Start();
+	m_loader.QueueImage(layer, m_textures[layer].filename, m_bCompressed);
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsCompressionSupported()
+ *
+ *  This method is used for checking whether the context can
+ *  compress into and sample BC7 textures, which is core from
+ *  OpenGL 4.2.  The macOS 3.3 context keeps RGBA8 layers.
+ ***********************************************************/
+bool TextureLibrary::IsCompressionSupported()
+{
+	return((GL_TRUE == glewIsSupported("GL_VERSION_4_2")) ||
+		(GL_TRUE == glewIsSupported("GL_ARB_texture_compression_bptc")));
+}
+
+/***********************************************************
+ *  ChooseLayerSize()
+ *
+ *  This method is used for picking the size of the layers,
+ *  which is the smallest power of two that holds the largest
+ *  loaded image, up to MAX_LAYER_SIZE.
+ ***********************************************************/
+int TextureLibrary::ChooseLayerSize() const
+{
+	int largest = 1;
+	int layerSize = 1;
+
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		if (m_textures[i].width > largest)
+		{
+			largest = m_textures[i].width;
+		}
+		if (m_textures[i].height > largest)
+		{
+			largest = m_textures[i].height;
+		}
+	}
+
+	while ((layerSize < largest) && (layerSize < MAX_LAYER_SIZE))
+	{
+		layerSize *= 2;
+	}
+
+	return(layerSize);
+}
+
+/***********************************************************
+ *  CreateUploadBuffers()
+ *
+ *  This method is used for creating the ring of pixel buffers
+ *  that decoded images are staged in, each large enough for
+ *  the largest image.  With buffer storage (GL 4.4) they are
+ *  mapped once for the lifetime of the library, otherwise
+ *  they are orphaned and mapped again for every upload.
+ ***********************************************************/
+void TextureLibrary::CreateUploadBuffers()
+{
+	m_uploadSlotSize = 0;
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		size_t imageSize = (size_t)m_textures[i].width * m_textures[i].height * m_textures[i].colorChannels;
+		if (imageSize > m_uploadSlotSize)
+		{
+			m_uploadSlotSize = imageSize;
+		}
+	}
+
+	m_bPersistentUpload = (GL_TRUE == glewIsSupported("GL_VERSION_4_4")) ||
+		(GL_TRUE == glewIsSupported("GL_ARB_buffer_storage"));
+
+	glGenBuffers(UPLOAD_SLOT_COUNT, m_uploadBuffers);
+	for (int i = 0; i < UPLOAD_SLOT_COUNT; i++)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadBuffers[i]);
+		if (m_bPersistentUpload)
+		{
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_PIXEL_UNPACK_BUFFER, m_uploadSlotSize, NULL, flags);
+			m_uploadPointers[i] = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_uploadSlotSize, flags);
+		}
+		else
+		{
+			glBufferData(GL_PIXEL_UNPACK_BUFFER, m_uploadSlotSize, NULL, GL_STREAM_DRAW);
+		}
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	m_nextUploadSlot = 0;
+}
+
+/***********************************************************
+ *  FillPlaceholders()
+ *
+ *  This method is used for clearing every layer of the array
+ *  to the placeholder color, so that textured objects can be
+ *  drawn before their images are resident.
+ ***********************************************************/
+void TextureLibrary::FillPlaceholders()
+{
+	GLint previousFramebuffer = 0;
+	GLfloat previousClearColor[4];
+
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, previousClearColor);
+
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffers[1]);
+	glClearColor(PLACEHOLDER_COLOR[0], PLACEHOLDER_COLOR[1], PLACEHOLDER_COLOR[2], PLACEHOLDER_COLOR[3]);
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_textureArray, 0, (GLint)i);
+		glClear(GL_COLOR_BUFFER_BIT);
+	}
+	glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, 0, 0, 0);
+
+	glClearColor(previousClearColor[0], previousClearColor[1], previousClearColor[2], previousClearColor[3]);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)previousFramebuffer);
+}
+
+/***********************************************************
+ *  AllocateCompressedArray()
+ *
+ *  This method is used for allocating every mip level of the
+ *  BC7 texture array, without any block data yet.
+ ***********************************************************/
+void TextureLibrary::AllocateCompressedArray()
+{
+	GLsizei layerCount = (GLsizei)m_textures.size();
+
+	for (int level = 0; level < m_levelCount; level++)
+	{
+		int levelSize = GetLevelDimension(m_layerSize, level);
+
+		glCompressedTexImage3D(
+			GL_TEXTURE_2D_ARRAY,
+			level,
+			COMPRESSED_FORMAT,
+			levelSize,
+			levelSize,
+			layerCount,
+			0,
+			(GLsizei)(TextureCache::GetLevelSize(COMPRESSED_FORMAT, levelSize, levelSize) * layerCount),
+			NULL);
+	}
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, m_levelCount - 1);
+}
+
+/***********************************************************
+ *  FillCompressedPlaceholders()
+ *
+ *  This method is used for filling every level of every layer
+ *  of the BC7 array with the placeholder color.  Compressed
+ *  textures cannot be cleared, so the driver compresses one
+ *  block of the color and the block is repeated.  It fails
+ *  when the driver does not compress into BC7.
+ ***********************************************************/
+bool TextureLibrary::FillCompressedPlaceholders()
+{
+	unsigned char placeholderPixels[4 * 4 * 4];
+	unsigned char placeholderBlock[16];
+	std::vector<unsigned char> levelData;
+	GLuint blockTexture = 0;
+	GLint blockSize = 0;
+
+	for (int i = 0; i < 4 * 4; i++)
+	{
+		for (int channel = 0; channel < 4; channel++)
+		{
+			placeholderPixels[i * 4 + channel] = (unsigned char)(PLACEHOLDER_COLOR[channel] * 255.0f);
+		}
+	}
+
+	glGenTextures(1, &blockTexture);
+	BindTexture(GL_TEXTURE_2D, blockTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, COMPRESSED_FORMAT, 4, 4, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholderPixels);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &blockSize);
+	if (blockSize == (GLint)sizeof(placeholderBlock))
+	{
+		glGetCompressedTexImage(GL_TEXTURE_2D, 0, placeholderBlock);
+	}
+	BindTexture(GL_TEXTURE_2D, 0);
+	glDeleteTextures(1, &blockTexture);
+
+	if (blockSize != (GLint)sizeof(placeholderBlock))
+	{
+		return(false);
+	}
+
+	levelData.resize(TextureCache::GetLevelSize(COMPRESSED_FORMAT, m_layerSize, m_layerSize));
+	for (size_t offset = 0; offset < levelData.size(); offset += sizeof(placeholderBlock))
+	{
+		memcpy(&levelData[offset], placeholderBlock, sizeof(placeholderBlock));
+	}
+
+	BindTexture(GL_TEXTURE_2D_ARRAY, m_textureArray);
+	for (size_t layer = 0; layer < m_textures.size(); layer++)
+	{
+		for (int level = 0; level < m_levelCount; level++)
+		{
+			int levelSize = GetLevelDimension(m_layerSize, level);
+
+			glCompressedTexSubImage3D(
+				GL_TEXTURE_2D_ARRAY,
+				level,
+				0, 0, (GLint)layer,
+				levelSize,
+				levelSize,
+				1,
+				COMPRESSED_FORMAT,
+				(GLsizei)TextureCache::GetLevelSize(COMPRESSED_FORMAT, levelSize, levelSize),
+				&levelData[0]);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  FallBackToUncompressed()
+ *
+ *  This method is used for replacing the BC7 array with an
+ *  RGBA8 one when the driver could not compress a layer, so no
+ *  layer is left without blocks.  The layers uploaded so far
+ *  are lost with the old array, so every image is decoded and
+ *  uploaded again.
+ ***********************************************************/
+bool TextureLibrary::FallBackToUncompressed()
+{
+	std::cout << "Could not compress the textures into BC7, using an RGBA8 texture array" << std::endl;
+
+	m_bCompressed = false;
+	if (CreateTextureArray() == false)
+	{
+		return(false);
+	}
+
+	m_loader.Start();
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		m_textures[i].bResident = false;
+		m_loader.QueueImage((int)i, m_textures[i].filename, false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateSourceTexture()
+ *
+ *  This method is used for creating a temporary texture that
+ *  holds an image at its own size, to be scaled from.  The
+ *  pixels are an offset into the bound pixel unpack buffer,
+ *  or client memory when none is bound.
+ ***********************************************************/
+GLuint TextureLibrary::CreateSourceTexture(
+	int width,
+	int height,
+	int colorChannels,
+	const void* pixels)
+{
+	GLenum format = (colorChannels == 4) ? GL_RGBA : GL_RGB;
+	GLenum internalFormat = (colorChannels == 4) ? GL_RGBA8 : GL_RGB8;
+	GLuint sourceTexture = 0;
+
+	// rows of RGB images are not always a multiple of four bytes
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	glGenTextures(1, &sourceTexture);
+	BindTexture(GL_TEXTURE_2D, sourceTexture);
+	// the source only ever has the one level it is scaled from
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+	BindTexture(GL_TEXTURE_2D, 0);
+
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+	return(sourceTexture);
+}
+
+/***********************************************************
+ *  BlitTexture()
+ *
+ *  This method is used for scaling a source texture to the
+ *  layer size with a framebuffer blit, into a layer of the
+ *  texture array or into level zero of a 2D texture.
+ ***********************************************************/
+bool TextureLibrary::BlitTexture(
+	GLuint sourceTexture,
+	int width,
+	int height,
+	GLuint destinationTexture,
+	TextureLayer layer)
+{
+	GLint previousReadFramebuffer = 0;
+	GLint previousDrawFramebuffer = 0;
+	bool bComplete = false;
+
+	glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousDrawFramebuffer);
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffers[0]);
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, sourceTexture, 0);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_framebuffers[1]);
+	if (layer != INVALID_LAYER)
+	{
+		glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, destinationTexture, 0, layer);
+	}
+	else
+	{
+		glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, destinationTexture, 0);
+	}
+
+	bComplete = (glCheckFramebufferStatus(GL_READ_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE) &&
+		(glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+	if (bComplete)
+	{
+		glBlitFramebuffer(
+			0, 0, width, height,
+			0, 0, m_layerSize, m_layerSize,
+			GL_COLOR_BUFFER_BIT,
+			GL_LINEAR);
+	}
+
+	// detach the textures so the framebuffers can be reused
+	glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+	glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)previousReadFramebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)previousDrawFramebuffer);
+
+	return(bComplete);
+}
+
+/***********************************************************
+ *  UploadLayer()
+ *
+ *  This method is used for copying one image into its layer
+ *  of the uncompressed array.  The pixels are an offset into
+ *  the bound pixel unpack buffer, or client memory when none
+ *  is bound.  Images that already have the layer size are
+ *  uploaded directly, any other size is scaled into the layer.
+ ***********************************************************/
+bool TextureLibrary::UploadLayer(
+	TextureLayer layer,
+	int width,
+	int height,
+	int colorChannels,
+	const void* pixels)
+{
+	GLenum format = (colorChannels == 4) ? GL_RGBA : GL_RGB;
+	GLuint sourceTexture = 0;
+	bool bSuccess = false;
+
+	if ((width == m_layerSize) && (height == m_layerSize))
+	{
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		BindTexture(GL_TEXTURE_2D_ARRAY, m_textureArray);
+		glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, m_layerSize, m_layerSize, 1, format, GL_UNSIGNED_BYTE, pixels);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		return(true);
+	}
+
+	sourceTexture = CreateSourceTexture(width, height, colorChannels, pixels);
+	bSuccess = BlitTexture(sourceTexture, width, height, m_textureArray, layer);
+	glDeleteTextures(1, &sourceTexture);
+
+	return(bSuccess);
+}
+
+/***********************************************************
+ *  UploadCompressedLayer()
+ *
+ *  This method is used for copying the blocks of every mip
+ *  level of a compressed texture into its layer.  The texture
+ *  must have been baked at the layer size of the array.
+ ***********************************************************/
+bool TextureLibrary::UploadCompressedLayer(
+	TextureLayer layer,
+	const TextureCache::COMPRESSED_TEXTURE& texture)
+{
+	if ((texture.width != (uint32_t)m_layerSize) || (texture.height != (uint32_t)m_layerSize) ||
+		(texture.levels.size() != (size_t)m_levelCount) || (texture.glFormat != COMPRESSED_FORMAT))
+	{
+		return(false);
+	}
+
+	BindTexture(GL_TEXTURE_2D_ARRAY, m_textureArray);
+	for (int level = 0; level < m_levelCount; level++)
+	{
+		glCompressedTexSubImage3D(
+			GL_TEXTURE_2D_ARRAY,
+			level,
+			0, 0, layer,
+			GetLevelDimension(m_layerSize, level),
+			GetLevelDimension(m_layerSize, level),
+			1,
+			COMPRESSED_FORMAT,
+			(GLsizei)texture.levels[level].size(),
+			&texture.levels[level][0]);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  BakeCompressedLayer()
+ *
+ *  This method is used for turning a decoded image into a BC7
+ *  mip chain at the layer size.  The image is scaled into an
+ *  RGBA8 texture and its mipmaps are generated, then every
+ *  level is read back and handed to the driver to compress.
+ *  This only happens the first time a texture is loaded, the
+ *  result is cached for the following runs.
+ ***********************************************************/
+bool TextureLibrary::BakeCompressedLayer(
+	const TextureLoader::DECODED_IMAGE& image,
+	TextureCache::COMPRESSED_TEXTURE& texture)
+{
+	GLuint sourceTexture = 0;
+	GLuint scaledTexture = 0;
+	GLuint compressedTexture = 0;
+	std::vector<unsigned char> levelPixels((size_t)m_layerSize * m_layerSize * 4);
+	bool bSuccess = true;
+
+	texture.glFormat = COMPRESSED_FORMAT;
+	texture.width = (uint32_t)m_layerSize;
+	texture.height = (uint32_t)m_layerSize;
+	texture.sourceHash = image.sourceHash;
+	texture.levels.clear();
+	texture.levels.resize(m_levelCount);
+
+	glGenTextures(1, &scaledTexture);
+	BindTexture(GL_TEXTURE_2D, scaledTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_layerSize, m_layerSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	BindTexture(GL_TEXTURE_2D, 0);
+
+	sourceTexture = CreateSourceTexture(image.width, image.height, image.colorChannels, image.pixels);
+	if (BlitTexture(sourceTexture, image.width, image.height, scaledTexture, INVALID_LAYER) == false)
+	{
+		bSuccess = false;
+	}
+	glDeleteTextures(1, &sourceTexture);
+
+	if (bSuccess)
+	{
+		BindTexture(GL_TEXTURE_2D, scaledTexture);
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		glGenTextures(1, &compressedTexture);
+		for (int level = 0; (level < m_levelCount) && bSuccess; level++)
+		{
+			int levelSize = GetLevelDimension(m_layerSize, level);
+			GLint compressedSize = 0;
+
+			BindTexture(GL_TEXTURE_2D, scaledTexture);
+			glGetTexImage(GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, &levelPixels[0]);
+
+			// the driver compresses the level as it is specified
+			BindTexture(GL_TEXTURE_2D, compressedTexture);
+			glTexImage2D(GL_TEXTURE_2D, level, COMPRESSED_FORMAT, levelSize, levelSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, &levelPixels[0]);
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+
+			if ((size_t)compressedSize != TextureCache::GetLevelSize(COMPRESSED_FORMAT, levelSize, levelSize))
+			{
+				bSuccess = false;
+			}
+			else
+			{
+				texture.levels[level].resize((size_t)compressedSize);
+				glGetCompressedTexImage(GL_TEXTURE_2D, level, &texture.levels[level][0]);
+			}
+		}
+
+		BindTexture(GL_TEXTURE_2D, 0);
+		glDeleteTextures(1, &compressedTexture);
+	}
+
+	glDeleteTextures(1, &scaledTexture);
+
+	return(bSuccess);
+}
+
+/***********************************************************
+ *  UploadImage()
+ *
+ *  This method is used for uploading a loaded image into its
+ *  layer.  Cached compressed textures are uploaded as they
+ *  are, decoded images are baked and cached first when the
+ *  array is compressed.  Otherwise the image is staged in the
+ *  next pixel buffer of the ring and uploaded from there, and
+ *  a fence per buffer makes sure the GPU has finished reading
+ *  a buffer before it is written again.
+ ***********************************************************/
+bool TextureLibrary::UploadImage(const TextureLoader::DECODED_IMAGE& image)
+{
+	size_t imageSize = (size_t)image.width * image.height * image.colorChannels;
+	int slot = m_nextUploadSlot;
+	bool bSuccess = false;
+
+	if ((image.layer < 0) || (image.layer >= (int)m_textures.size()))
+	{
+		return(false);
+	}
+
+	if (image.bCompressed == true)
+	{
+		if ((m_bCompressed == true) && (UploadCompressedLayer(image.layer, image.compressed) == true))
+		{
+			std::cout << "Loaded cached texture:" << TextureCache::GetCachePath(image.filename) << std::endl;
+			m_textures[image.layer].bResident = true;
+			return(true);
+		}
+
+		// the cached texture was baked for another layer size,
+		// so the source image is decoded and baked again
+		std::cout << "Cached texture does not match the texture array, baking again:" << image.filename << std::endl;
+		m_loader.QueueImage(image.layer, image.filename, false);
+		return(false);
+	}
+
+	if (NULL == image.pixels)
+	{
+		std::cout << "Could not load image:" << image.filename << std::endl;
+		return(false);
+	}
+
+	std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << image.colorChannels << std::endl;
+
+	if ((image.colorChannels != 3) && (image.colorChannels != 4))
+	{
+		std::cout << "Not implemented to handle image with " << image.colorChannels << " channels" << std::endl;
+		return(false);
+	}
+
+	if (m_bCompressed == true)
+	{
+		TextureCache::COMPRESSED_TEXTURE texture;
+
+		bSuccess = BakeCompressedLayer(image, texture) && UploadCompressedLayer(image.layer, texture);
+		if (bSuccess == true)
+		{
+			if (TextureCache::WriteTexture(TextureCache::GetCachePath(image.filename), texture) == false)
+			{
+				std::cout << "Could not write cached texture:" << TextureCache::GetCachePath(image.filename) << std::endl;
+			}
+			m_textures[image.layer].bResident = true;
+			return(true);
+		}
+
+		// this image is uploaded below into the new array
+		std::cout << "Could not compress texture " << m_textures[image.layer].tag << " into its texture array layer" << std::endl;
+		if (FallBackToUncompressed() == false)
+		{
+			return(false);
+		}
+	}
+
+	// an image that changed since its header was read may not
+	// fit the staging buffers, so it is uploaded directly
+	if (imageSize > m_uploadSlotSize)
+	{
+		bSuccess = UploadLayer(image.layer, image.width, image.height, image.colorChannels, image.pixels);
+		m_textures[image.layer].bResident = bSuccess;
+		return(bSuccess);
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadBuffers[slot]);
+	if (m_bPersistentUpload)
+	{
+		if (NULL != m_uploadFences[slot])
+		{
+			glClientWaitSync(m_uploadFences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, UPLOAD_FENCE_TIMEOUT);
+			glDeleteSync(m_uploadFences[slot]);
+			m_uploadFences[slot] = NULL;
+		}
+		memcpy(m_uploadPointers[slot], image.pixels, imageSize);
+	}
+	else
+	{
+		// orphan the buffer so the driver does not wait for a
+		// previous upload that is still reading from it
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, m_uploadSlotSize, NULL, GL_STREAM_DRAW);
+		void* pMapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, imageSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (NULL != pMapped)
+		{
+			memcpy(pMapped, image.pixels, imageSize);
+		}
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	}
+
+	bSuccess = UploadLayer(image.layer, image.width, image.height, image.colorChannels, (const void*)0);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (m_bPersistentUpload)
+	{
+		m_uploadFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+	m_nextUploadSlot = (m_nextUploadSlot + 1) % UPLOAD_SLOT_COUNT;
+
+	if (bSuccess == false)
+	{
+		std::cout << "Could not copy texture " << m_textures[image.layer].tag << " into its texture array layer" << std::endl;
+	}
+	m_textures[image.layer].bResident = bSuccess;
+
+	return(bSuccess);
+}
+
+/***********************************************************
+ *  BuildTextureArray()
+ *
+ *  This method is used for creating the texture array with a
+ *  layer for every loaded image, filled with the placeholder
+ *  color, and uploading whatever has already been decoded.
+ *  The rest is uploaded by UpdateUploads() as it finishes.
+ ***********************************************************/
+bool TextureLibrary::BuildTextureArray()
+{
+	if (CreateTextureArray() == false)
+	{
+		return(false);
+	}
+
+	UpdateUploads();
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateTextureArray()
+ *
+ *  This method is used for creating the texture array in the
+ *  current format with the placeholder color in every layer.
+ *  A BC7 array that the driver cannot compress the
+ *  placeholder for is created again as an RGBA8 array.
+ ***********************************************************/
+bool TextureLibrary::CreateTextureArray()
+{
+	GLint maxLayers = 0;
+
+	if (m_textures.size() == 0)
+	{
+		return(false);
+	}
+
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+	if ((GLint)m_textures.size() > maxLayers)
+	{
+		std::cout << "The " << m_textures.size() << " loaded textures exceed the " << maxLayers << " layers of a texture array" << std::endl;
+		return(false);
+	}
+
+	if (0 != m_textureArray)
+	{
+		glDeleteTextures(1, &m_textureArray);
+		m_textureArray = 0;
+	}
+
+	m_layerSize = ChooseLayerSize();
+
+	m_levelCount = 1;
+	while ((m_layerSize >> m_levelCount) > 0)
+	{
+		m_levelCount++;
+	}
+
+	glGenTextures(1, &m_textureArray);
+	BindTexture(GL_TEXTURE_2D_ARRAY, m_textureArray);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters, sampling the mip chain
+	// of every layer so minified textures do not alias
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	if (0 == m_framebuffers[0])
+	{
+		glGenFramebuffers(2, m_framebuffers);
+	}
+
+	if (m_bCompressed == true)
+	{
+		// the mip chain of each layer comes from its cached or
+		// baked blocks, it is never generated on the array
+		AllocateCompressedArray();
+		if (FillCompressedPlaceholders() == false)
+		{
+			std::cout << "Could not compress the texture placeholder into BC7, using an RGBA8 texture array" << std::endl;
+			m_bCompressed = false;
+			return(CreateTextureArray());
+		}
+	}
+	else
+	{
+		glTexImage3D(
+			GL_TEXTURE_2D_ARRAY,
+			0,
+			GL_RGBA8,
+			m_layerSize,
+			m_layerSize,
+			(GLsizei)m_textures.size(),
+			0,
+			GL_RGBA,
+			GL_UNSIGNED_BYTE,
+			NULL);
+
+		if (0 == m_uploadBuffers[0])
+		{
+			CreateUploadBuffers();
+		}
+
+		FillPlaceholders();
+
+		// generate the texture mipmaps for mapping textures to lower resolutions
+		BindTexture(GL_TEXTURE_2D_ARRAY, m_textureArray);
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	}
+
+	std::cout << "Built " << (m_bCompressed ? "BC7" : "RGBA8") << " texture array with " << m_textures.size() << " layers of " << m_layerSize << "x" << m_layerSize << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  UpdateUploads()
+ *
+ *  This method is used for uploading the images that the
+ *  loader threads have finished, at most one per upload
+ *  buffer so that a frame never waits on a buffer it used
+ *  itself.  It is called once per frame on the GL thread.
+ ***********************************************************/
+int TextureLibrary::UpdateUploads()
+{
+	TextureLoader::DECODED_IMAGE image;
+	int uploadCount = 0;
+
+	if (0 == m_textureArray)
+	{
+		return(0);
+	}
+
+	while ((uploadCount < UPLOAD_SLOT_COUNT) && (m_loader.PopDecodedImage(image) == true))
+	{
+		if (UploadImage(image) == true)
+		{
+			uploadCount++;
+		}
+		TextureLoader::FreeImage(image);
+	}
+
+	if ((uploadCount > 0) && (m_bCompressed == false))
+	{
+		// the mipmaps of the new layers are rebuilt once per frame
+		BindTexture(GL_TEXTURE_2D_ARRAY, m_textureArray);
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	}
+
+	return(uploadCount);
+}
+
+/***********************************************************
+ *  FinishUploads()
+ *
+ *  This method is used for waiting until every queued image
+ *  has been decoded and uploading all of them, for when the
+ *  textures are needed before the first frame.
+ ***********************************************************/
+void TextureLibrary::FinishUploads()
+{
+	TextureLoader::DECODED_IMAGE image;
+	int uploadCount = 0;
+
+	if (0 == m_textureArray)
+	{
+		return;
+	}
+
+	while (m_loader.WaitForDecodedImage(image) == true)
+	{
+		if (UploadImage(image) == true)
+		{
+			uploadCount++;
+		}
+		TextureLoader::FreeImage(image);
+	}
+
+	if ((uploadCount > 0) && (m_bCompressed == false))
+	{
+		BindTexture(GL_TEXTURE_2D_ARRAY, m_textureArray);
+		glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+	}
+}
+
+/***********************************************************
+ *  IsLoading()
+ *
+ *  This method is used for checking whether any layer is
+ *  still waiting for its image to be decoded or uploaded.
+ ***********************************************************/
+bool TextureLibrary::IsLoading() const
+{
+	for (size_t i = 0; i < m_textures.size(); i++)
+	{
+		if (m_textures[i].bResident == false)
+		{
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method is used for binding a texture and counting the
+ *  bind for the frame statistics.
+ ***********************************************************/
+void TextureLibrary::BindTexture(GLenum target, GLuint texture) const
+{
+	glBindTexture(target, texture);
+	m_bindCount++;
+}
+
+/***********************************************************
+ *  BindTextureArray()
+ *
+ *  This method is used for binding the texture array to the
+ *  passed in texture unit.  It stays bound for every draw.
+ ***********************************************************/
+void TextureLibrary::BindTextureArray(GLuint textureUnit) const
+{
+	glActiveTexture(GL_TEXTURE0 + textureUnit);
+	BindTexture(GL_TEXTURE_2D_ARRAY, m_textureArray);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for stopping the loader threads and
+ *  freeing the texture array and the upload buffers.
+ ***********************************************************/
+void TextureLibrary::Destroy()
+{
+	m_loader.Stop();
+	m_textures.clear();
+
+	for (int i = 0; i < UPLOAD_SLOT_COUNT; i++)
+	{
+		if (NULL != m_uploadFences[i])
+		{
+			glDeleteSync(m_uploadFences[i]);
+			m_uploadFences[i] = NULL;
+		}
+		if (0 != m_uploadBuffers[i])
+		{
+			if (NULL != m_uploadPointers[i])
+			{
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadBuffers[i]);
+				glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+				m_uploadPointers[i] = NULL;
+			}
+			glDeleteBuffers(1, &m_uploadBuffers[i]);
+			m_uploadBuffers[i] = 0;
+		}
+	}
+	m_uploadSlotSize = 0;
+
+	if (0 != m_framebuffers[0])
+	{
+		glDeleteFramebuffers(2, m_framebuffers);
+		m_framebuffers[0] = 0;
+		m_framebuffers[1] = 0;
+	}
+	if (0 != m_textureArray)
+	{
+		glDeleteTextures(1, &m_textureArray);
+		m_textureArray = 0;
+	}
+	m_layerSize = 0;
+	m_levelCount = 0;
+}
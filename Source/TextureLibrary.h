@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturelibrary.h
+// ============
+// load the scene textures into the layers of a single texture array
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureLoader.h"
+
+#include <GL/glew.h>
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  TextureLibrary
+ *
+ *  This class packs the loaded textures into the layers of
+ *  one GL_TEXTURE_2D_ARRAY, so that every texture is selected
+ *  in the shader by its layer index and only one texture unit
+ *  is ever bound.  All layers share one size; images of other
+ *  sizes are scaled into their layer on the GPU.
+ *
+ *  The images are decoded on the worker threads of a texture
+ *  loader.  Until an image has been decoded and uploaded, its
+ *  layer holds a flat placeholder color.  Decoded images are
+ *  copied into a ring of pixel buffers and uploaded from there
+ *  a few per frame, so the GL thread never decodes or stalls.
+ *
+ *  When the context supports BC7 (BPTC) compression the array
+ *  is block compressed.  Each image is then baked once into a
+ *  BC7 mip chain by the driver and cached in a KTX2 file next
+ *  to its source, and later runs upload the cached blocks as
+ *  they are, without decoding or generating mipmaps.
+ ***********************************************************/
+class TextureLibrary
+{
+public:
+	// layer of a texture in the array
+	typedef int TextureLayer;
+	static const int INVALID_LAYER = -1;
+
+	// constructor
+	TextureLibrary();
+	// destructor
+	~TextureLibrary();
+
+	// queue an image file for decoding and return its layer
+	TextureLayer LoadTexture(const char* filename, const std::string& tag);
+	// find the layer of a loaded texture by tag
+	TextureLayer FindTexture(const std::string& tag) const;
+	// queue the image of a layer to be decoded again after its
+	// file was changed
+	bool ReloadTexture(TextureLayer layer);
+	// image file that a layer is loaded from
+	const std::string& GetTextureFilename(TextureLayer layer) const { return(m_textures[layer].filename); }
+
+	// create the texture array with a placeholder in every layer
+	bool BuildTextureArray();
+	// upload the images that have finished decoding, returning
+	// the number of layers that were made resident
+	int UpdateUploads();
+	// wait for every queued image and upload it
+	void FinishUploads();
+	// check whether any layer still holds its placeholder
+	bool IsLoading() const;
+	// check whether the layers are stored block compressed
+	bool IsCompressed() const { return(m_bCompressed); }
+	// bind the texture array to the passed in texture unit
+	void BindTextureArray(GLuint textureUnit) const;
+	// free the texture array, the upload buffers and the loader
+	void Destroy();
+
+	// counter for the texture binds made by the library
+	unsigned int GetBindCount() const { return(m_bindCount); }
+	void ResetCounters() { m_bindCount = 0; }
+
+	GLuint GetTextureArrayID() const { return(m_textureArray); }
+	int GetLayerCount() const { return((int)m_textures.size()); }
+	int GetLayerSize() const { return(m_layerSize); }
+
+private:
+	// number of pixel buffers that uploads rotate through, which
+	// is also the most layers uploaded in one frame
+	static const int UPLOAD_SLOT_COUNT = 2;
+
+	// the image file and header of one texture layer
+	struct TEXTURE_LAYER
+	{
+		std::string tag;
+		std::string filename;
+		int width;
+		int height;
+		int colorChannels;
+		bool bResident;
+	};
+
+	// loaded textures, indexed by layer
+	std::vector<TEXTURE_LAYER> m_textures;
+	// texture array holding every layer
+	GLuint m_textureArray;
+	// width and height of every layer in the array
+	int m_layerSize;
+	// number of mip levels of every layer
+	int m_levelCount;
+	// set when the layers are stored as BC7 blocks
+	bool m_bCompressed;
+	// worker threads decoding the image files
+	TextureLoader m_loader;
+	// framebuffers used for scaling images into their layer
+	GLuint m_framebuffers[2];
+	// pixel buffers that decoded images are staged in, mapped
+	// persistently when the context supports buffer storage
+	GLuint m_uploadBuffers[UPLOAD_SLOT_COUNT];
+	void* m_uploadPointers[UPLOAD_SLOT_COUNT];
+	GLsync m_uploadFences[UPLOAD_SLOT_COUNT];
+	size_t m_uploadSlotSize;
+	int m_nextUploadSlot;
+	bool m_bPersistentUpload;
+	// texture binds made since the counter was last reset
+	mutable unsigned int m_bindCount;
+
+	// check whether the context can store the layers as BC7
+	static bool IsCompressionSupported();
+	// pick the layer size for the loaded images
+	int ChooseLayerSize() const;
+	// bind a texture and count the bind
+	void BindTexture(GLenum target, GLuint texture) const;
+	// create the texture array and fill it with placeholders
+	bool CreateTextureArray();
+	// allocate every mip level of the compressed texture array
+	void AllocateCompressedArray();
+	// replace the compressed array with an uncompressed one and
+	// upload every image again
+	bool FallBackToUncompressed();
+	// create the ring of pixel buffers for the uploads
+	void CreateUploadBuffers();
+	// fill every layer with the placeholder color
+	void FillPlaceholders();
+	bool FillCompressedPlaceholders();
+	// stage a decoded image in a pixel buffer and upload it
+	bool UploadImage(const TextureLoader::DECODED_IMAGE& image);
+	// copy pixels, or a pixel buffer offset, into one layer
+	bool UploadLayer(
+		TextureLayer layer,
+		int width,
+		int height,
+		int colorChannels,
+		const void* pixels);
+	// copy the blocks of a compressed texture into one layer
+	bool UploadCompressedLayer(
+		TextureLayer layer,
+		const TextureCache::COMPRESSED_TEXTURE& texture);
+	// scale a decoded image to the layer size and compress it
+	bool BakeCompressedLayer(
+		const TextureLoader::DECODED_IMAGE& image,
+		TextureCache::COMPRESSED_TEXTURE& texture);
+
+	// create a temporary texture holding the passed in pixels
+	GLuint CreateSourceTexture(
+		int width,
+		int height,
+		int colorChannels,
+		const void* pixels);
+	// scale a texture into a layer of the array, or into level
+	// zero of a 2D texture when the layer is INVALID_LAYER
+	bool BlitTexture(
+		GLuint sourceTexture,
+		int width,
+		int height,
+		GLuint destinationTexture,
+		TextureLayer layer);
+};
@@ -0,0 +1,308 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.cpp
+// =================
+// decode texture image files on a pool of worker threads
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+
+#include "stb_image.h"
+
+#include <fstream>
+
+// declaration of global variables
+namespace
+{
+	// decoding is mostly bound by memory and disk, so a few
+	// workers are enough even on machines with many cores
+	const unsigned int MAX_WORKER_THREADS = 4;
+}
+
+/***********************************************************
+ *  TextureLoader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureLoader::TextureLoader()
+{
+	m_pendingCount = 0;
+	m_bStopping = false;
+}
+
+/***********************************************************
+ *  ~TextureLoader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureLoader::~TextureLoader()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for starting the worker threads.  One
+ *  core is left for the GL thread unless there is only one.
+ ***********************************************************/
+void TextureLoader::Start(unsigned int threadCount)
+{
+	if (m_workers.size() > 0)
+	{
+		return;
+	}
+
+	if (0 == threadCount)
+	{
+		threadCount = std::thread::hardware_concurrency();
+		if (threadCount > 1)
+		{
+			threadCount--;
+		}
+	}
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+	if (threadCount > MAX_WORKER_THREADS)
+	{
+		threadCount = MAX_WORKER_THREADS;
+	}
+
+	// stb_image keeps the flip setting globally, so it is set
+	// here once before any worker starts decoding
+	stbi_set_flip_vertically_on_load(true);
+
+	m_bStopping = false;
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_workers.push_back(std::thread(&TextureLoader::WorkerMain, this));
+	}
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping and joining the worker
+ *  threads, then freeing every image that was not taken.
+ ***********************************************************/
+void TextureLoader::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+	}
+	m_jobQueued.notify_all();
+
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (size_t i = 0; i < m_decodedImages.size(); i++)
+	{
+		FreeImage(m_decodedImages[i]);
+	}
+	m_decodedImages.clear();
+	m_jobs.clear();
+	m_pendingCount = 0;
+	m_bStopping = false;
+	m_imageDecoded.notify_all();
+}
+
+/***********************************************************
+ *  QueueImage()
+ *
+ *  This method is used for queueing an image file to be
+ *  decoded by the next free worker thread.
+ ***********************************************************/
+void TextureLoader::QueueImage(int layer, const std::string& filename, bool bUseCache)
+{
+	DECODE_JOB job;
+
+	job.layer = layer;
+	job.filename = filename;
+	job.bUseCache = bUseCache;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(job);
+		m_pendingCount++;
+	}
+	m_jobQueued.notify_one();
+}
+
+/***********************************************************
+ *  PopDecodedImage()
+ *
+ *  This method is used for taking the next decoded image
+ *  without waiting.  It returns false if none is ready.
+ ***********************************************************/
+bool TextureLoader::PopDecodedImage(DECODED_IMAGE& image)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_decodedImages.size() == 0)
+	{
+		return(false);
+	}
+
+	image = m_decodedImages.front();
+	m_decodedImages.pop_front();
+	m_pendingCount--;
+
+	return(true);
+}
+
+/***********************************************************
+ *  WaitForDecodedImage()
+ *
+ *  This method is used for taking the next decoded image,
+ *  waiting for a worker to finish one if needed.  It returns
+ *  false once there are no more images pending.
+ ***********************************************************/
+bool TextureLoader::WaitForDecodedImage(DECODED_IMAGE& image)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	while ((m_decodedImages.size() == 0) && (m_pendingCount > 0) && (m_workers.size() > 0))
+	{
+		m_imageDecoded.wait(lock);
+	}
+
+	if (m_decodedImages.size() == 0)
+	{
+		return(false);
+	}
+
+	image = m_decodedImages.front();
+	m_decodedImages.pop_front();
+	m_pendingCount--;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetPendingCount()
+ *
+ *  This method is used for getting the number of queued
+ *  images that are still decoding or waiting to be taken.
+ ***********************************************************/
+size_t TextureLoader::GetPendingCount()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return(m_pendingCount);
+}
+
+/***********************************************************
+ *  FreeImage()
+ *
+ *  This method is used for freeing the decoded pixels of an
+ *  image once they have been uploaded.
+ ***********************************************************/
+void TextureLoader::FreeImage(DECODED_IMAGE& image)
+{
+	if (NULL != image.pixels)
+	{
+		stbi_image_free(image.pixels);
+		image.pixels = NULL;
+	}
+}
+
+/***********************************************************
+ *  ReadImage()
+ *
+ *  This method is used for loading the image of one job.  The
+ *  source file is read and hashed first, so that a cached
+ *  compressed texture baked from the same file can be used in
+ *  place of decoding it.
+ ***********************************************************/
+void TextureLoader::ReadImage(const DECODE_JOB& job, DECODED_IMAGE& image)
+{
+	std::ifstream file(job.filename.c_str(), std::ios::binary);
+	std::vector<unsigned char> fileData;
+
+	image.layer = job.layer;
+	image.filename = job.filename;
+	image.width = 0;
+	image.height = 0;
+	image.colorChannels = 0;
+	image.pixels = NULL;
+	image.sourceHash = 0;
+	image.bCompressed = false;
+
+	if (!file.is_open())
+	{
+		return;
+	}
+
+	file.seekg(0, std::ios::end);
+	fileData.resize((size_t)file.tellg());
+	file.seekg(0, std::ios::beg);
+	if ((fileData.size() == 0) || !file.read((char*)&fileData[0], fileData.size()))
+	{
+		return;
+	}
+
+	image.sourceHash = TextureCache::HashData(&fileData[0], fileData.size());
+
+	if ((job.bUseCache == true) &&
+		(TextureCache::ReadTexture(TextureCache::GetCachePath(job.filename), image.sourceHash, image.compressed) == true))
+	{
+		image.width = (int)image.compressed.width;
+		image.height = (int)image.compressed.height;
+		image.colorChannels = 4;
+		image.bCompressed = true;
+		return;
+	}
+
+	image.pixels = stbi_load_from_memory(
+		&fileData[0],
+		(int)fileData.size(),
+		&image.width,
+		&image.height,
+		&image.colorChannels,
+		0);
+}
+
+/***********************************************************
+ *  WorkerMain()
+ *
+ *  This method is run by every worker thread.  It takes the
+ *  queued jobs one at a time and decodes them outside of the
+ *  lock, until the loader is stopped.
+ ***********************************************************/
+void TextureLoader::WorkerMain()
+{
+	while (true)
+	{
+		DECODE_JOB job;
+		DECODED_IMAGE image;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while ((m_jobs.size() == 0) && (m_bStopping == false))
+			{
+				m_jobQueued.wait(lock);
+			}
+			if (m_bStopping == true)
+			{
+				return;
+			}
+			job = m_jobs.front();
+			m_jobs.pop_front();
+		}
+
+		ReadImage(job, image);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_decodedImages.push_back(image);
+		}
+		m_imageDecoded.notify_all();
+	}
+}
@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.h
+// ============
+// decode texture image files on a pool of worker threads
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TextureCache.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  TextureLoader
+ *
+ *  This class decodes queued image files on worker threads
+ *  so that the JPEG and PNG decoding does not hold up the GL
+ *  thread.  When a compressed version of an image is cached
+ *  for the same source file, it is read instead and nothing
+ *  is decoded.  The loaded images are collected in a list
+ *  that the GL thread takes them from when it is ready to
+ *  upload.  No OpenGL calls are made by this class.
+ ***********************************************************/
+class TextureLoader
+{
+public:
+	// one decoded image waiting to be uploaded
+	struct DECODED_IMAGE
+	{
+		int layer;
+		std::string filename;
+		int width;
+		int height;
+		int colorChannels;
+		// NULL when the image could not be decoded
+		unsigned char* pixels;
+		// hash of the source file, used as the cache key
+		uint64_t sourceHash;
+		// set when the cached compressed texture was read, in
+		// which case there are no decoded pixels
+		bool bCompressed;
+		TextureCache::COMPRESSED_TEXTURE compressed;
+	};
+
+	// constructor
+	TextureLoader();
+	// destructor
+	~TextureLoader();
+
+	// start the worker threads, zero picks a count for the machine
+	void Start(unsigned int threadCount = 0);
+	// stop the worker threads and drop any images not taken
+	void Stop();
+
+	// queue an image file to be loaded for the passed in layer,
+	// reading its cached compressed texture when allowed
+	void QueueImage(int layer, const std::string& filename, bool bUseCache = false);
+	// take a decoded image if one is ready, without waiting
+	bool PopDecodedImage(DECODED_IMAGE& image);
+	// take a decoded image, waiting for one while any are pending
+	bool WaitForDecodedImage(DECODED_IMAGE& image);
+
+	// number of queued images that have not been taken yet
+	size_t GetPendingCount();
+	// free the pixels of an image taken from the loader
+	static void FreeImage(DECODED_IMAGE& image);
+
+private:
+	// one image file waiting to be decoded
+	struct DECODE_JOB
+	{
+		int layer;
+		std::string filename;
+		bool bUseCache;
+	};
+
+	std::vector<std::thread> m_workers;
+	std::mutex m_mutex;
+	// signalled when a job is queued or the workers are stopping
+	std::condition_variable m_jobQueued;
+	// signalled when an image has been decoded
+	std::condition_variable m_imageDecoded;
+	std::deque<DECODE_JOB> m_jobs;
+	std::deque<DECODED_IMAGE> m_decodedImages;
+	// queued images that have not been taken yet
+	size_t m_pendingCount;
+	bool m_bStopping;
+
+	// decode jobs until the loader is stopped
+	void WorkerMain();
+	// load the image of one job
+	static void ReadImage(const DECODE_JOB& job, DECODED_IMAGE& image);
+};
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////
+// triplebuffer.h
+// ============
+// hand the newest copy of a value from one thread to another without locks
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/***********************************************************
+ *  TripleBuffer
+ *
+ *  This class passes values of T from one writing thread to
+ *  one reading thread.  The writer fills its own slot and
+ *  publishes it by swapping it with the shared slot, and the
+ *  reader takes the shared slot by swapping it with its own,
+ *  so neither side ever waits for the other.  Values that
+ *  are published faster than they are read are replaced,
+ *  and the reader always gets the newest complete one.  The
+ *  index of the shared slot and whether it holds a value the
+ *  reader has not taken are kept together in one atomic.
+ ***********************************************************/
+template <typename T>
+class TripleBuffer
+{
+public:
+	// constructor
+	TripleBuffer() : m_shared(1), m_writeIndex(0), m_readIndex(2)
+	{
+	}
+
+	// slot that the writing thread fills before publishing it
+	T& GetWriteSlot() { return(m_slots[m_writeIndex]); }
+
+	// make the filled write slot the newest value, and take the
+	// old shared slot as the next one to write into
+	void Publish()
+	{
+		uint32_t previous = m_shared.exchange(m_writeIndex | FRESH_FLAG, std::memory_order_acq_rel);
+		m_writeIndex = previous & INDEX_MASK;
+	}
+
+	// take the newest published value when there is one that has
+	// not been read yet, returning false when there is none
+	bool Consume()
+	{
+		if ((m_shared.load(std::memory_order_relaxed) & FRESH_FLAG) == 0)
+		{
+			return(false);
+		}
+
+		uint32_t previous = m_shared.exchange(m_readIndex, std::memory_order_acq_rel);
+		m_readIndex = previous & INDEX_MASK;
+		return(true);
+	}
+
+	// the value taken by the last Consume() on the reading thread
+	const T& GetReadSlot() const { return(m_slots[m_readIndex]); }
+
+private:
+	static const uint32_t INDEX_MASK = 0x3;
+	static const uint32_t FRESH_FLAG = 0x4;
+
+	T m_slots[3];
+	// index of the shared slot, with the fresh flag when the
+	// writer published it after the reader last took it
+	std::atomic<uint32_t> m_shared;
+	// owned by the writing and the reading thread
+	uint32_t m_writeIndex;
+	uint32_t m_readIndex;
+};
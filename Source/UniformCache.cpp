@@ -0,0 +1,232 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformcache.cpp
+// ================
+// cache the locations and last uploaded values of the per-draw shader uniforms
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UniformCache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+
+// declaration of global variables
+namespace
+{
+	// shader names of the managed uniforms, in UNIFORM_ID order
+	const char* g_UniformNames[UniformCache::UNIFORM_COUNT] =
+	{
+		"model",
+		"normalMatrix",
+		"objectColor",
+		"objectTextures",
+		"textureLayer",
+		"materialIndex",
+		"UVscale",
+		"bUseInstancing",
+		"drawOffset",
+		"bDepthOnly",
+		"bUseClusteredLights",
+		"localLightCount",
+		"clusterDepthScale",
+		"bUseShadows"
+	};
+}
+
+/***********************************************************
+ *  UniformCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+UniformCache::UniformCache()
+{
+	m_programID = 0;
+	m_uploadCount = 0;
+	m_skippedCount = 0;
+
+	for (int i = 0; i < UNIFORM_COUNT; i++)
+	{
+		m_uniforms[i].location = -1;
+		m_uniforms[i].bHasValue = false;
+	}
+}
+
+/***********************************************************
+ *  ResolveLocations()
+ *
+ *  This method is used for looking up the locations of all
+ *  the managed uniforms in the passed in shader program.  It
+ *  only needs to be called once after the shaders are loaded.
+ ***********************************************************/
+void UniformCache::ResolveLocations(GLuint programID)
+{
+	m_programID = programID;
+
+	for (int i = 0; i < UNIFORM_COUNT; i++)
+	{
+		m_uniforms[i].location = glGetUniformLocation(programID, g_UniformNames[i]);
+		m_uniforms[i].bHasValue = false;
+	}
+}
+
+/***********************************************************
+ *  Invalidate()
+ *
+ *  This method is used for forgetting the remembered values,
+ *  which is needed whenever the uniforms may have been set
+ *  without going through the cache.
+ ***********************************************************/
+void UniformCache::Invalidate()
+{
+	for (int i = 0; i < UNIFORM_COUNT; i++)
+	{
+		m_uniforms[i].bHasValue = false;
+	}
+}
+
+/***********************************************************
+ *  ResetCounters()
+ *
+ *  This method is used for clearing the upload counters,
+ *  normally at the start of every frame.
+ ***********************************************************/
+void UniformCache::ResetCounters()
+{
+	m_uploadCount = 0;
+	m_skippedCount = 0;
+}
+
+/***********************************************************
+ *  StoreValue()
+ *
+ *  This method is used for comparing the passed in value with
+ *  the last value uploaded to the uniform.  When they differ
+ *  the new value is remembered and true is returned.
+ ***********************************************************/
+bool UniformCache::StoreValue(UNIFORM_SLOT& slot, const void* value, size_t size)
+{
+	// uniforms that are not used by the shader are never uploaded
+	if (slot.location < 0)
+	{
+		return(false);
+	}
+
+	if ((slot.bHasValue == true) && (memcmp(slot.value, value, size) == 0))
+	{
+		m_skippedCount++;
+		return(false);
+	}
+
+	memcpy(slot.value, value, size);
+	slot.bHasValue = true;
+	m_uploadCount++;
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetIntValue()
+ *
+ *  This method is used for setting an integer or boolean
+ *  uniform value into the shader.
+ ***********************************************************/
+void UniformCache::SetIntValue(UNIFORM_ID uniform, int value)
+{
+	UNIFORM_SLOT& slot = m_uniforms[uniform];
+	if (StoreValue(slot, &value, sizeof(value)) == true)
+	{
+		glUniform1i(slot.location, value);
+	}
+}
+
+/***********************************************************
+ *  SetFloatValue()
+ *
+ *  This method is used for setting a float uniform value
+ *  into the shader.
+ ***********************************************************/
+void UniformCache::SetFloatValue(UNIFORM_ID uniform, float value)
+{
+	UNIFORM_SLOT& slot = m_uniforms[uniform];
+	if (StoreValue(slot, &value, sizeof(value)) == true)
+	{
+		glUniform1f(slot.location, value);
+	}
+}
+
+/***********************************************************
+ *  SetVec2Value()
+ *
+ *  This method is used for setting a vec2 uniform value
+ *  into the shader.
+ ***********************************************************/
+void UniformCache::SetVec2Value(UNIFORM_ID uniform, const glm::vec2& value)
+{
+	UNIFORM_SLOT& slot = m_uniforms[uniform];
+	if (StoreValue(slot, glm::value_ptr(value), sizeof(value)) == true)
+	{
+		glUniform2fv(slot.location, 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetVec3Value()
+ *
+ *  This method is used for setting a vec3 uniform value
+ *  into the shader.
+ ***********************************************************/
+void UniformCache::SetVec3Value(UNIFORM_ID uniform, const glm::vec3& value)
+{
+	UNIFORM_SLOT& slot = m_uniforms[uniform];
+	if (StoreValue(slot, glm::value_ptr(value), sizeof(value)) == true)
+	{
+		glUniform3fv(slot.location, 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetVec4Value()
+ *
+ *  This method is used for setting a vec4 uniform value
+ *  into the shader.
+ ***********************************************************/
+void UniformCache::SetVec4Value(UNIFORM_ID uniform, const glm::vec4& value)
+{
+	UNIFORM_SLOT& slot = m_uniforms[uniform];
+	if (StoreValue(slot, glm::value_ptr(value), sizeof(value)) == true)
+	{
+		glUniform4fv(slot.location, 1, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetMat3Value()
+ *
+ *  This method is used for setting a mat3 uniform value
+ *  into the shader.
+ ***********************************************************/
+void UniformCache::SetMat3Value(UNIFORM_ID uniform, const glm::mat3& value)
+{
+	UNIFORM_SLOT& slot = m_uniforms[uniform];
+	if (StoreValue(slot, glm::value_ptr(value), sizeof(value)) == true)
+	{
+		glUniformMatrix3fv(slot.location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+}
+
+/***********************************************************
+ *  SetMat4Value()
+ *
+ *  This method is used for setting a mat4 uniform value
+ *  into the shader.
+ ***********************************************************/
+void UniformCache::SetMat4Value(UNIFORM_ID uniform, const glm::mat4& value)
+{
+	UNIFORM_SLOT& slot = m_uniforms[uniform];
+	if (StoreValue(slot, glm::value_ptr(value), sizeof(value)) == true)
+	{
+		glUniformMatrix4fv(slot.location, 1, GL_FALSE, glm::value_ptr(value));
+	}
+}
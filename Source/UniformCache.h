@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformcache.h
+// ============
+// cache the locations and last uploaded values of the per-draw shader uniforms
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+/***********************************************************
+ *  UniformCache
+ *
+ *  This class resolves the locations of the uniforms that
+ *  are set for every draw once, after the shaders have been
+ *  loaded, and remembers the last value uploaded to each of
+ *  them so that unchanged values are not sent again.
+ ***********************************************************/
+class UniformCache
+{
+public:
+	// the uniforms that are managed by the cache
+	enum UNIFORM_ID
+	{
+		UNIFORM_MODEL = 0,
+		UNIFORM_NORMAL_MATRIX,
+		UNIFORM_OBJECT_COLOR,
+		UNIFORM_OBJECT_TEXTURE,
+		UNIFORM_TEXTURE_LAYER,
+		UNIFORM_MATERIAL_INDEX,
+		UNIFORM_UV_SCALE,
+		UNIFORM_USE_INSTANCING,
+		UNIFORM_DRAW_OFFSET,
+		UNIFORM_DEPTH_ONLY,
+		// the local lights of the frame, set when a program is
+		// first drawn with in the frame
+		UNIFORM_USE_CLUSTERED_LIGHTS,
+		UNIFORM_LOCAL_LIGHT_COUNT,
+		UNIFORM_CLUSTER_DEPTH_SCALE,
+		UNIFORM_USE_SHADOWS,
+		UNIFORM_COUNT
+	};
+
+	// constructor
+	UniformCache();
+
+	// resolve the uniform locations for the passed in program
+	void ResolveLocations(GLuint programID);
+	// forget the remembered values so the next set always uploads
+	void Invalidate();
+
+	// upload the passed in value unless it is already set
+	void SetIntValue(UNIFORM_ID uniform, int value);
+	void SetFloatValue(UNIFORM_ID uniform, float value);
+	void SetVec2Value(UNIFORM_ID uniform, const glm::vec2& value);
+	void SetVec3Value(UNIFORM_ID uniform, const glm::vec3& value);
+	void SetVec4Value(UNIFORM_ID uniform, const glm::vec4& value);
+	void SetMat3Value(UNIFORM_ID uniform, const glm::mat3& value);
+	void SetMat4Value(UNIFORM_ID uniform, const glm::mat4& value);
+
+	// counters for the uploaded and skipped uniform values
+	unsigned int GetUploadCount() const { return(m_uploadCount); }
+	unsigned int GetSkippedCount() const { return(m_skippedCount); }
+	void ResetCounters();
+
+private:
+	struct UNIFORM_SLOT
+	{
+		GLint location;
+		bool bHasValue;
+		float value[16];
+	};
+
+	// program that the locations were resolved for
+	GLuint m_programID;
+	// location and last value of each managed uniform
+	UNIFORM_SLOT m_uniforms[UNIFORM_COUNT];
+	// number of values sent to and kept back from the driver
+	unsigned int m_uploadCount;
+	unsigned int m_skippedCount;
+
+	// check the passed in value against the remembered one and
+	// store it, returning true when it needs to be uploaded
+	bool StoreValue(UNIFORM_SLOT& slot, const void* value, size_t size);
+};
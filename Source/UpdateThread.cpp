@@ -0,0 +1,300 @@
+///////////////////////////////////////////////////////////////////////////////
+// updatethread.cpp
+// ============
+// move the camera from the input at a fixed timestep on its own thread
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UpdateThread.h"
+
+#include <algorithm>
+
+// declaration of global variables
+namespace
+{
+	// most ticks simulated at once after the thread fell behind,
+	// the rest are dropped instead of replayed in a burst
+	const int MAX_CATCH_UP_TICKS = 8;
+	// slowest the camera can be made to move with the wheel
+	const float MIN_MOVEMENT_SPEED = 1.0f;
+
+	// keys that are held move the camera on every tick
+	struct KEY_MOVEMENT
+	{
+		uint32_t key;
+		Camera_Movement movement;
+	};
+
+	const KEY_MOVEMENT g_KeyMovements[] =
+	{
+		{ UpdateThread::KEY_FORWARD, FORWARD },
+		{ UpdateThread::KEY_BACKWARD, BACKWARD },
+		{ UpdateThread::KEY_LEFT, LEFT },
+		{ UpdateThread::KEY_RIGHT, RIGHT },
+		{ UpdateThread::KEY_UP, UP },
+		{ UpdateThread::KEY_DOWN, DOWN }
+	};
+	const int g_KeyMovementCount = sizeof(g_KeyMovements) / sizeof(g_KeyMovements[0]);
+
+	glm::vec3 BlendDirection(const glm::vec3& from, const glm::vec3& to, float alpha)
+	{
+		glm::vec3 direction = from + (to - from) * alpha;
+		float length = glm::length(direction);
+
+		// opposite directions blend through zero halfway
+		return((length > 0.0001f) ? (direction / length) : to);
+	}
+}
+
+/***********************************************************
+ *  UpdateThread()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+UpdateThread::UpdateThread()
+{
+	m_pCamera = NULL;
+	m_tickSeconds = 0.0;
+	m_startTime = std::chrono::steady_clock::now();
+	m_bStopping = false;
+	m_bHasSnapshot = false;
+}
+
+/***********************************************************
+ *  ~UpdateThread()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+UpdateThread::~UpdateThread()
+{
+	Stop();
+}
+
+/***********************************************************
+ *  GetTime()
+ *
+ *  This method is used for getting the seconds since the
+ *  class was created, which both threads measure ticks by.
+ ***********************************************************/
+double UpdateThread::GetTime() const
+{
+	return(std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count());
+}
+
+/***********************************************************
+ *  CaptureCamera()
+ *
+ *  This method is used for reading the parts of the camera
+ *  that a frame is drawn with.
+ ***********************************************************/
+UpdateThread::CAMERA_STATE UpdateThread::CaptureCamera(const Camera& camera, bool bOrthographic)
+{
+	CAMERA_STATE state;
+
+	state.position = camera.Position;
+	state.front = camera.Front;
+	state.up = camera.Up;
+	state.zoom = camera.Zoom;
+	state.bOrthographic = bOrthographic;
+
+	return(state);
+}
+
+/***********************************************************
+ *  Interpolate()
+ *
+ *  This method is used for blending two camera states.  The
+ *  directions are blended and normalized again, and the
+ *  projection switches with the second state.
+ ***********************************************************/
+UpdateThread::CAMERA_STATE UpdateThread::Interpolate(const CAMERA_STATE& from, const CAMERA_STATE& to, float alpha)
+{
+	CAMERA_STATE state;
+
+	state.position = from.position + (to.position - from.position) * alpha;
+	state.front = BlendDirection(from.front, to.front, alpha);
+	state.up = BlendDirection(from.up, to.up, alpha);
+	state.zoom = from.zoom + (to.zoom - from.zoom) * alpha;
+	state.bOrthographic = to.bOrthographic;
+
+	return(state);
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method is used for starting the update thread on the
+ *  passed in camera.  The first snapshot is published here,
+ *  before the thread runs, so there is always one to draw.
+ ***********************************************************/
+void UpdateThread::Start(Camera* pCamera, double tickSeconds)
+{
+	if ((true == IsRunning()) || (NULL == pCamera) || (tickSeconds <= 0.0))
+	{
+		return;
+	}
+
+	m_pCamera = pCamera;
+	m_tickSeconds = tickSeconds;
+
+	SNAPSHOT& snapshot = m_snapshots.GetWriteSlot();
+	snapshot.current = CaptureCamera(*m_pCamera, false);
+	snapshot.previous = snapshot.current;
+	snapshot.tickTime = GetTime();
+	snapshot.tickCount = 0;
+	m_snapshots.Publish();
+
+	m_bStopping = false;
+	m_thread = std::thread(&UpdateThread::ThreadMain, this);
+}
+
+/***********************************************************
+ *  Stop()
+ *
+ *  This method is used for stopping the update thread.  The
+ *  camera keeps the state of the last simulated tick.
+ ***********************************************************/
+void UpdateThread::Stop()
+{
+	if (false == IsRunning())
+	{
+		return;
+	}
+
+	m_bStopping = true;
+	m_thread.join();
+	m_bHasSnapshot = false;
+}
+
+/***********************************************************
+ *  SubmitInput()
+ *
+ *  This method is used for handing the newest input that the
+ *  render thread polled over to the update thread.
+ ***********************************************************/
+void UpdateThread::SubmitInput(const INPUT_STATE& input)
+{
+	m_input.GetWriteSlot() = input;
+	m_input.Publish();
+}
+
+/***********************************************************
+ *  GetInterpolatedCamera()
+ *
+ *  This method is used for getting the camera to draw at the
+ *  passed in time.  The newest snapshot holds the cameras at
+ *  the end of the last two ticks, and the frame is drawn one
+ *  tick behind, blending from the earlier one at the time of
+ *  the newest tick to the later one a tick after it.
+ ***********************************************************/
+UpdateThread::CAMERA_STATE UpdateThread::GetInterpolatedCamera(double time)
+{
+	if (m_snapshots.Consume())
+	{
+		m_bHasSnapshot = true;
+	}
+
+	const SNAPSHOT& snapshot = m_snapshots.GetReadSlot();
+	float alpha = 1.0f;
+
+	if ((true == m_bHasSnapshot) && (m_tickSeconds > 0.0))
+	{
+		alpha = (float)std::min(std::max((time - snapshot.tickTime) / m_tickSeconds, 0.0), 1.0);
+	}
+
+	return(Interpolate(snapshot.previous, snapshot.current, alpha));
+}
+
+/***********************************************************
+ *  ThreadMain()
+ *
+ *  This method is used for simulating the camera in fixed
+ *  ticks until the thread is stopped.  The mouse and scroll
+ *  motion of each new input is applied once, and the held
+ *  keys move the camera by the tick length on every tick.
+ *  After the thread falls behind, a few ticks are caught up
+ *  and the rest are dropped, restarting the clock from now.
+ ***********************************************************/
+void UpdateThread::ThreadMain()
+{
+	INPUT_STATE input;
+	INPUT_STATE lastInput;
+	bool bOrthographic = false;
+	CAMERA_STATE current = CaptureCamera(*m_pCamera, bOrthographic);
+	double nextTick = GetTime() + m_tickSeconds;
+	uint64_t tickCount = 0;
+
+	input.keys = 0;
+	input.mouseX = 0.0;
+	input.mouseY = 0.0;
+	input.scroll = 0.0;
+	lastInput = input;
+
+	while (false == m_bStopping)
+	{
+		double now = GetTime();
+
+		if (now < nextTick)
+		{
+			std::this_thread::sleep_for(std::chrono::duration<double>(nextTick - now));
+			continue;
+		}
+
+		CAMERA_STATE previous = current;
+		int tickIndex = 0;
+
+		for (tickIndex = 0; (tickIndex < MAX_CATCH_UP_TICKS) && (nextTick <= now); tickIndex++)
+		{
+			previous = current;
+
+			if (m_input.Consume())
+			{
+				input = m_input.GetReadSlot();
+
+				m_pCamera->ProcessMouseMovement(
+					(float)(input.mouseX - lastInput.mouseX),
+					(float)(input.mouseY - lastInput.mouseY));
+
+				m_pCamera->MovementSpeed += (float)(input.scroll - lastInput.scroll);
+				m_pCamera->MovementSpeed = std::max(m_pCamera->MovementSpeed, MIN_MOVEMENT_SPEED);
+
+				lastInput = input;
+			}
+
+			for (int i = 0; i < g_KeyMovementCount; i++)
+			{
+				if ((input.keys & g_KeyMovements[i].key) != 0)
+				{
+					m_pCamera->ProcessKeyboard(g_KeyMovements[i].movement, (float)m_tickSeconds);
+				}
+			}
+
+			// P switches to the perspective view and O to the
+			// orthographic one while they are held
+			if ((input.keys & KEY_PERSPECTIVE) != 0)
+			{
+				bOrthographic = false;
+			}
+			if ((input.keys & KEY_ORTHOGRAPHIC) != 0)
+			{
+				bOrthographic = true;
+			}
+
+			current = CaptureCamera(*m_pCamera, bOrthographic);
+			nextTick += m_tickSeconds;
+			tickCount++;
+		}
+		if (nextTick <= now)
+		{
+			nextTick = now + m_tickSeconds;
+		}
+
+		SNAPSHOT& snapshot = m_snapshots.GetWriteSlot();
+		snapshot.previous = previous;
+		snapshot.current = current;
+		snapshot.tickTime = nextTick - m_tickSeconds;
+		snapshot.tickCount = tickCount;
+		m_snapshots.Publish();
+	}
+}
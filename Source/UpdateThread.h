@@ -0,0 +1,125 @@
+///////////////////////////////////////////////////////////////////////////////
+// updatethread.h
+// ============
+// move the camera from the input at a fixed timestep on its own thread
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TripleBuffer.h"
+#include "camera.h"
+
+#include <glm/glm.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+/***********************************************************
+ *  UpdateThread
+ *
+ *  This class runs the camera simulation on a thread of its
+ *  own, in ticks of a fixed length that do not depend on how
+ *  long the GPU takes to draw a frame.  The render thread
+ *  hands over the input it polled through one triple buffer,
+ *  and every tick publishes the camera before and after the
+ *  tick through another one.  The render thread takes the
+ *  newest of those and blends between the two cameras by how
+ *  far it is into the next tick, so the motion stays smooth at
+ *  any frame rate.  The camera object is only touched by the
+ *  update thread while it runs.
+ ***********************************************************/
+class UpdateThread
+{
+public:
+	// keys that move the camera, as bits of the input state
+	enum INPUT_KEYS
+	{
+		KEY_FORWARD = 0x01,
+		KEY_BACKWARD = 0x02,
+		KEY_LEFT = 0x04,
+		KEY_RIGHT = 0x08,
+		KEY_UP = 0x10,
+		KEY_DOWN = 0x20,
+		KEY_PERSPECTIVE = 0x40,
+		KEY_ORTHOGRAPHIC = 0x80
+	};
+
+	// input polled by the render thread; the mouse and scroll
+	// values are running totals, so no motion is lost when the
+	// update thread skips an input that was replaced
+	struct INPUT_STATE
+	{
+		uint32_t keys;
+		double mouseX;
+		double mouseY;
+		double scroll;
+	};
+
+	// the part of the camera that a frame is drawn with
+	struct CAMERA_STATE
+	{
+		glm::vec3 position;
+		glm::vec3 front;
+		glm::vec3 up;
+		float zoom;
+		bool bOrthographic;
+	};
+
+	// the camera before and after the newest tick
+	struct SNAPSHOT
+	{
+		CAMERA_STATE previous;
+		CAMERA_STATE current;
+		// time the newest tick was simulated up to, in seconds
+		// on the clock of GetTime()
+		double tickTime;
+		uint64_t tickCount;
+	};
+
+	// constructor
+	UpdateThread();
+	// destructor
+	~UpdateThread();
+
+	// start simulating the passed in camera every tick
+	void Start(Camera* pCamera, double tickSeconds);
+	// stop the thread, leaving the camera where it last was
+	void Stop();
+	bool IsRunning() const { return(m_thread.joinable()); }
+
+	// hand the newest input over to the update thread
+	void SubmitInput(const INPUT_STATE& input);
+	// camera to draw at the passed in time, blended between
+	// the two cameras of the newest tick
+	CAMERA_STATE GetInterpolatedCamera(double time);
+
+	// seconds since the thread was created, on a steady clock
+	// that both threads read
+	double GetTime() const;
+	// length of one tick in seconds
+	double GetTickSeconds() const { return(m_tickSeconds); }
+
+	// read the camera into a camera state
+	static CAMERA_STATE CaptureCamera(const Camera& camera, bool bOrthographic);
+	// blend two camera states, zero giving the first one
+	static CAMERA_STATE Interpolate(const CAMERA_STATE& from, const CAMERA_STATE& to, float alpha);
+
+private:
+	Camera* m_pCamera;
+	double m_tickSeconds;
+	std::chrono::steady_clock::time_point m_startTime;
+	std::thread m_thread;
+	std::atomic<bool> m_bStopping;
+	// input from the render thread, and snapshots back to it
+	TripleBuffer<INPUT_STATE> m_input;
+	TripleBuffer<SNAPSHOT> m_snapshots;
+	// newest snapshot taken by the render thread
+	bool m_bHasSnapshot;
+
+	// simulate ticks until the thread is stopped
+	void ThreadMain();
+};
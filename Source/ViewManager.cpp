@@ -1,275 +1,425 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.cpp
-// ============
-// manage the viewing of 3D objects within the viewport - camera, projection
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "ViewManager.h"
-
-// GLM Math Header inclusions
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>    
-
-// declaration of the global variables and defines
-namespace
-{
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1000;
-	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
-	// camera object used for viewing and interacting with
-	// the 3D scene
-	Camera* g_pCamera = nullptr;
-
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
-
-	// the following variable is false when orthographic projection
-	// is off and true when it is on
-	bool bOrthographicProjection = false;
-}
-
-/***********************************************************
- *  ViewManager()
- *
- *  The constructor for the class
- ***********************************************************/
-ViewManager::ViewManager(
-	ShaderManager *pShaderManager)
-{
-	// initialize the member variables
-	m_pShaderManager = pShaderManager;
-	m_pWindow = NULL;
-	g_pCamera = new Camera();
-	// default camera view parameters
-	/*
-	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 80;
-	*/
-	g_pCamera->Position = glm::vec3(0.0f, 1.5f, 3.0f);  // Driver's perspective
-	g_pCamera->Front = glm::vec3(0.0f, -0.2f, -1.0f);   // Looking at dashboard
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 60.0f;  // Narrower FOV for car interior
-	g_pCamera->MovementSpeed = 20;
-}
-
-/***********************************************************
- *  ~ViewManager()
- *
- *  The destructor for the class
- ***********************************************************/
-ViewManager::~ViewManager()
-{
-	// free up allocated memory
-	m_pShaderManager = NULL;
-	m_pWindow = NULL;
-	if (NULL != g_pCamera)
-	{
-		delete g_pCamera;
-		g_pCamera = NULL;
-	}
-}
-
-/***********************************************************
- *  CreateDisplayWindow()
- *
- *  This method is used to create the main display window.
- ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
-{
-	GLFWwindow* window = nullptr;
-
-	// try to create the displayed OpenGL window
-	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
-		windowTitle,
-		NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return NULL;
-	}
-	glfwMakeContextCurrent(window);
-
-	// tell GLFW to capture all mouse events
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-	// this callback is used to receive mouse moving events
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-
-	//this callback is used to receive mouse scrolling events ~ Aqbah
-	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Callback);
-
-	// enable blending for supporting tranparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	m_pWindow = window;
-
-	return(window);
-}
-
-/***********************************************************
- *  Mouse_Position_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse is moved within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
-{
-	// when the first mouse move event is received, this needs to be recorded so that
-	// all subsequent mouse moves can correctly calculate the X position offset and Y
-	// position offset for proper operation
-	if (gFirstMouse)
-	{
-		gLastX = xMousePos;
-		gLastY = yMousePos;
-		gFirstMouse = false;
-	}
-
-	// calculate the X offset and Y offset values for moving the 3D camera accordingly
-	float xOffset = xMousePos - gLastX;
-	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
-
-	// set the current positions into the last position variables
-	gLastX = xMousePos;
-	gLastY = yMousePos;
-
-	// move the 3D camera according to the calculated offsets
-	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
-}
-/*****************************************************************
-* Mouse_Scroll_Callback()
-*
-* This method is called from GLFW whenever the mouse is scrolled
-* within the active GLFW display window. ~ Aqbah
-*******************************************************************/
-void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
-{
-	g_pCamera->MovementSpeed += static_cast<float>(yoffset);
-
-	//Preventing the speed from dropping too low
-	if (g_pCamera->MovementSpeed < 1.0f)
-		g_pCamera->MovementSpeed = 1.0f;
-}
-
-/***********************************************************
- *  ProcessKeyboardEvents()
- *
- *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
-{
-	// close the window if the escape key has been pressed
-	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(m_pWindow, true);
-	}
-
-	// process camera zooming in and out
-	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
-	}
-
-	// process camera panning left and right
-	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
-	}
-
-	// process camera moving up and down ~ Aqbah
-	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(UP, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
-	}
-
-	// switch between orthographic and perspective views on press of P and O
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-	{
-		bOrthographicProjection = false;
-	}
-
-	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
-	{
-		bOrthographicProjection = true;
-	}
-}
-
-/***********************************************************
- *  PrepareSceneView()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void ViewManager::PrepareSceneView()
-{
-	glm::mat4 view;
-	glm::mat4 projection;
-
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-	// define the current projection matrix
-	if (bOrthographicProjection)
-	{
-		float orthoScale = g_pCamera->Zoom * 0.1f;
-		float aspect = (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT;
-		projection = glm::ortho(-orthoScale * aspect, orthoScale * aspect, -orthoScale, orthoScale, 0.1f, 100.0f);
-	}
-	else
-	{
-		projection = glm::perspective(glm::radians(g_pCamera->Zoom), (GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT, 0.1f, 100.0f);
-	}
-
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
-	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
-	}
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.cpp
+// ============
+// manage the viewing of 3D objects within the viewport - camera, projection
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewManager.h"
+
+// GLM Math Header inclusions
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>    
+
+// declaration of the global variables and defines
+namespace
+{
+	// size the window is created at, in screen points
+	const int DEFAULT_WINDOW_WIDTH = 1000;
+	const int DEFAULT_WINDOW_HEIGHT = 800;
+
+	// size of the window framebuffer in pixels, and the pixels
+	// per screen point of the display it is on, kept up to date
+	// by the GLFW callbacks
+	int gFramebufferWidth = DEFAULT_WINDOW_WIDTH;
+	int gFramebufferHeight = DEFAULT_WINDOW_HEIGHT;
+	float gContentScale = 1.0f;
+
+	// camera object used for viewing and interacting with
+	// the 3D scene
+	Camera* g_pCamera = nullptr;
+
+	// these variables are used for mouse movement processing
+	float gLastX = DEFAULT_WINDOW_WIDTH / 2.0f;
+	float gLastY = DEFAULT_WINDOW_HEIGHT / 2.0f;
+	bool gFirstMouse = true;
+
+	// mouse and scroll motion summed since the start, which the
+	// update thread moves the camera by
+	double gMouseTotalX = 0.0;
+	double gMouseTotalY = 0.0;
+	double gScrollTotal = 0.0;
+
+	// the camera is simulated 120 times a second, however fast
+	// the frames are drawn
+	const double UPDATE_TICK_SECONDS = 1.0 / 120.0;
+}
+
+/***********************************************************
+ *  ViewManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewManager::ViewManager(
+	ShaderManager *pShaderManager)
+{
+	// initialize the member variables
+	m_pShaderManager = pShaderManager;
+	m_pWindow = NULL;
+	m_cameraBuffer = 0;
+	m_bScriptedCamera = false;
+	m_cameraBlock.view = glm::mat4(1.0f);
+	m_cameraBlock.projection = glm::mat4(1.0f);
+	m_cameraBlock.viewPosition = glm::vec3(0.0f);
+	m_cameraBlock.padding = 0.0f;
+	g_pCamera = new Camera();
+	// default camera view parameters
+	/*
+	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
+	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+	*/
+	g_pCamera->Position = glm::vec3(0.0f, 1.5f, 3.0f);  // Driver's perspective
+	g_pCamera->Front = glm::vec3(0.0f, -0.2f, -1.0f);   // Looking at dashboard
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 60.0f;  // Narrower FOV for car interior
+	g_pCamera->MovementSpeed = 20;
+}
+
+/***********************************************************
+ *  ~ViewManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ViewManager::~ViewManager()
+{
+	// free up allocated memory, after the update thread has
+	// stopped using the camera
+	m_updateThread.Stop();
+	m_pShaderManager = NULL;
+	m_pWindow = NULL;
+	if (0 != m_cameraBuffer)
+	{
+		glDeleteBuffers(1, &m_cameraBuffer);
+		m_cameraBuffer = 0;
+	}
+	if (NULL != g_pCamera)
+	{
+		delete g_pCamera;
+		g_pCamera = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateDisplayWindow()
+ *
+ *  This method is used to create the main display window.
+ *  A hidden window is only used for its OpenGL context, so
+ *  no mouse input is hooked up for it.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle, bool bHidden)
+{
+	GLFWwindow* window = nullptr;
+
+	glfwWindowHint(GLFW_VISIBLE, bHidden ? GLFW_FALSE : GLFW_TRUE);
+#ifdef GLFW_SCALE_TO_MONITOR
+	// size the window in screen points, so it is not drawn at
+	// half size on a HiDPI display
+	glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_TRUE);
+#endif
+
+	// try to create the displayed OpenGL window
+	window = glfwCreateWindow(
+		DEFAULT_WINDOW_WIDTH,
+		DEFAULT_WINDOW_HEIGHT,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// the framebuffer can be larger than the window on a HiDPI
+	// display, and follows the window when it is resized
+	glfwGetFramebufferSize(window, &gFramebufferWidth, &gFramebufferHeight);
+	glfwSetFramebufferSizeCallback(window, &ViewManager::Framebuffer_Size_Callback);
+#ifdef GLFW_SCALE_TO_MONITOR
+	glfwGetWindowContentScale(window, &gContentScale, NULL);
+	glfwSetWindowContentScaleCallback(window, &ViewManager::Content_Scale_Callback);
+#endif
+
+	if (false == bHidden)
+	{
+		// tell GLFW to capture all mouse events
+		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+		// this callback is used to receive mouse moving events
+		glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+
+		//this callback is used to receive mouse scrolling events ~ Aqbah
+		glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Callback);
+	}
+
+	// blending is only turned on by the transparent pass of the
+	// scene, so the opaque objects are drawn without it
+	glDisable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  Framebuffer_Size_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the framebuffer of the window changes size, after the
+ *  window is resized, minimized or moved to another display.
+ ***********************************************************/
+void ViewManager::Framebuffer_Size_Callback(GLFWwindow* window, int width, int height)
+{
+	gFramebufferWidth = width;
+	gFramebufferHeight = height;
+}
+
+/***********************************************************
+ *  Content_Scale_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the window is moved to a display of another pixel density.
+ ***********************************************************/
+void ViewManager::Content_Scale_Callback(GLFWwindow* window, float xScale, float yScale)
+{
+	gContentScale = xScale;
+}
+
+/***********************************************************
+ *  GetFramebufferSize()
+ *
+ *  This method is used for getting the size in pixels of the
+ *  window framebuffer, which is zero while it is minimized.
+ ***********************************************************/
+void ViewManager::GetFramebufferSize(int& width, int& height) const
+{
+	width = gFramebufferWidth;
+	height = gFramebufferHeight;
+}
+
+/***********************************************************
+ *  GetContentScale()
+ *
+ *  This method is used for getting the pixels per screen
+ *  point of the display the window is on.
+ ***********************************************************/
+float ViewManager::GetContentScale() const
+{
+	return(gContentScale);
+}
+
+/***********************************************************
+ *  Mouse_Position_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse is moved within the active GLFW display window.
+ *  The offsets are summed for the update thread, which is
+ *  the only one that moves the camera.
+ ***********************************************************/
+void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
+{
+	// when the first mouse move event is received, this needs to be recorded so that
+	// all subsequent mouse moves can correctly calculate the X position offset and Y
+	// position offset for proper operation
+	if (gFirstMouse)
+	{
+		gLastX = xMousePos;
+		gLastY = yMousePos;
+		gFirstMouse = false;
+	}
+
+	// calculate the X offset and Y offset values for moving the 3D camera accordingly
+	float xOffset = xMousePos - gLastX;
+	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
+
+	// set the current positions into the last position variables
+	gLastX = xMousePos;
+	gLastY = yMousePos;
+
+	// the update thread moves the 3D camera by the offsets
+	gMouseTotalX += xOffset;
+	gMouseTotalY += yOffset;
+}
+/*****************************************************************
+* Mouse_Scroll_Callback()
+*
+* This method is called from GLFW whenever the mouse is scrolled
+* within the active GLFW display window. ~ Aqbah
+* The update thread changes the camera speed by the summed
+* scrolling, and keeps it from dropping too low.
+*******************************************************************/
+void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+	gScrollTotal += yoffset;
+}
+
+/***********************************************************
+ *  ProcessKeyboardEvents()
+ *
+ *  This method is called to process any keyboard events
+ *  that may be waiting in the event queue.
+ ***********************************************************/
+void ViewManager::ProcessKeyboardEvents()
+{
+	UpdateThread::INPUT_STATE input;
+
+	// close the window if the escape key has been pressed
+	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+	{
+		glfwSetWindowShouldClose(m_pWindow, true);
+	}
+
+	input.keys = 0;
+	input.mouseX = gMouseTotalX;
+	input.mouseY = gMouseTotalY;
+	input.scroll = gScrollTotal;
+
+	// process camera zooming in and out
+	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
+	{
+		input.keys |= UpdateThread::KEY_FORWARD;
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
+	{
+		input.keys |= UpdateThread::KEY_BACKWARD;
+	}
+
+	// process camera panning left and right
+	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
+	{
+		input.keys |= UpdateThread::KEY_LEFT;
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
+	{
+		input.keys |= UpdateThread::KEY_RIGHT;
+	}
+
+	// process camera moving up and down ~ Aqbah
+	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
+	{
+		input.keys |= UpdateThread::KEY_UP;
+	}
+	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
+	{
+		input.keys |= UpdateThread::KEY_DOWN;
+	}
+
+	// switch between orthographic and perspective views on press of P and O
+	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
+	{
+		input.keys |= UpdateThread::KEY_PERSPECTIVE;
+	}
+
+	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
+	{
+		input.keys |= UpdateThread::KEY_ORTHOGRAPHIC;
+	}
+
+	m_updateThread.SubmitInput(input);
+}
+
+/***********************************************************
+ *  SetCameraPose()
+ *
+ *  This method is used for placing the camera at a position
+ *  and pointing it at a target.  From then on the camera only
+ *  moves when this is called again, which keeps replayed
+ *  camera paths independent of input and frame timing.  The
+ *  update thread is stopped first, so it no longer moves the
+ *  camera.
+ ***********************************************************/
+void ViewManager::SetCameraPose(const glm::vec3& position, const glm::vec3& target)
+{
+	glm::vec3 front = target - position;
+
+	m_bScriptedCamera = true;
+	m_updateThread.Stop();
+
+	g_pCamera->Position = position;
+	if (glm::length(front) > 0.0f)
+	{
+		g_pCamera->Front = glm::normalize(front);
+	}
+}
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering.  The camera is moved by the update thread, and
+ *  the frame is drawn with its two newest ticks blended by
+ *  the time, while a scripted camera is drawn where it was put.
+ ***********************************************************/
+void ViewManager::PrepareSceneView()
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+	UpdateThread::CAMERA_STATE camera;
+	float aspect = 1.0f;
+
+	// process any keyboard events that may be waiting in the 
+	// event queue, unless the camera follows a scripted path
+	if (false == m_bScriptedCamera)
+	{
+		if (false == m_updateThread.IsRunning())
+		{
+			m_updateThread.Start(g_pCamera, UPDATE_TICK_SECONDS);
+		}
+		ProcessKeyboardEvents();
+		camera = m_updateThread.GetInterpolatedCamera(m_updateThread.GetTime());
+	}
+	else
+	{
+		camera = UpdateThread::CaptureCamera(*g_pCamera, false);
+	}
+
+	// get the current view matrix from the camera
+	view = glm::lookAt(camera.position, camera.position + camera.front, camera.up);
+
+	// the projection follows the shape of the framebuffer, which
+	// is left alone while the window is minimized to zero size
+	if ((gFramebufferWidth > 0) && (gFramebufferHeight > 0))
+	{
+		aspect = (float)gFramebufferWidth / (float)gFramebufferHeight;
+	}
+
+	// define the current projection matrix
+	if (camera.bOrthographic)
+	{
+		float orthoScale = camera.zoom * 0.1f;
+		projection = glm::ortho(-orthoScale * aspect, orthoScale * aspect, -orthoScale, orthoScale, 0.1f, 100.0f);
+	}
+	else
+	{
+		projection = glm::perspective(glm::radians(camera.zoom), aspect, 0.1f, 100.0f);
+	}
+
+	// the camera block is shared by every program that draws
+	// the scene, so it is created on first use
+	if (0 == m_cameraBuffer)
+	{
+		glGenBuffers(1, &m_cameraBuffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, m_cameraBuffer);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(CAMERA_BLOCK), NULL, GL_DYNAMIC_DRAW);
+		glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BLOCK_BINDING, m_cameraBuffer);
+	}
+
+	// set the view and projection matrices and the view position
+	// of the camera into the camera block for proper rendering
+	m_cameraBlock.view = view;
+	m_cameraBlock.projection = projection;
+	m_cameraBlock.viewPosition = camera.position;
+	m_cameraBlock.padding = 0.0f;
+
+	glBindBuffer(GL_UNIFORM_BUFFER, m_cameraBuffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CAMERA_BLOCK), &m_cameraBlock);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
\ No newline at end of file
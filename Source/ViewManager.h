@@ -1,47 +1,78 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport - camera, projection
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "camera.h"
-
-// GLFW library
-#include "GLFW/glfw3.h" 
-
-class ViewManager
-{
-public:
-	// constructor
-	ViewManager(
-		ShaderManager* pShaderManager);
-	// destructor
-	~ViewManager();
-
-	// mouse position callback for mouse interaction with the 3D scene
-	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
-
-	static void Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset);
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
-	GLFWwindow* m_pWindow;
-
-	// process keyboard events for interaction with the 3D scene
-	void ProcessKeyboardEvents();
-
-public:
-	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
-	
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport - camera, projection
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "ShaderBlocks.h"
+#include "UpdateThread.h"
+#include "camera.h"
+
+// GLFW library
+#include "GLFW/glfw3.h" 
+
+class ViewManager
+{
+public:
+	// constructor
+	ViewManager(
+		ShaderManager* pShaderManager);
+	// destructor
+	~ViewManager();
+
+	// mouse position callback for mouse interaction with the 3D scene
+	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
+
+	static void Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, double yoffset);
+
+	// framebuffer size and display scale callbacks, which keep the
+	// viewport and projection matched to the window
+	static void Framebuffer_Size_Callback(GLFWwindow* window, int width, int height);
+	static void Content_Scale_Callback(GLFWwindow* window, float xScale, float yScale);
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// active OpenGL display window
+	GLFWwindow* m_pWindow;
+	// uniform buffer holding the camera block
+	GLuint m_cameraBuffer;
+	// camera matrices in the layout of the camera block
+	CAMERA_BLOCK m_cameraBlock;
+	// set when the camera is moved by SetCameraPose() instead
+	// of the keyboard and mouse
+	bool m_bScriptedCamera;
+	// moves the camera from the input at a fixed timestep
+	UpdateThread m_updateThread;
+
+	// process keyboard events for interaction with the 3D scene,
+	// and hand them to the update thread with the mouse motion
+	void ProcessKeyboardEvents();
+
+public:
+	// create the initial OpenGL display window, a hidden window
+	// does not capture the mouse or move the camera from input
+	GLFWwindow* CreateDisplayWindow(const char* windowTitle, bool bHidden = false);
+
+	// place the camera at a position looking at a target, and
+	// stop the keyboard and mouse from moving it
+	void SetCameraPose(const glm::vec3& position, const glm::vec3& target);
+	
+	// prepare the conversion from 3D object display to 2D scene display
+	void PrepareSceneView();
+
+	// view and projection matrices of the last prepared scene view
+	const glm::mat4& GetViewMatrix() const { return(m_cameraBlock.view); }
+	const glm::mat4& GetProjectionMatrix() const { return(m_cameraBlock.projection); }
+
+	// size in pixels of the window framebuffer, and the pixels
+	// per screen point of the display the window is on
+	void GetFramebufferSize(int& width, int& height) const;
+	float GetContentScale() const;
 };
\ No newline at end of file
@@ -1,228 +1,477 @@
-#version 330 core
-out vec4 fragmentColor;
-
-in vec3 fragmentPosition;
-in vec3 fragmentVertexNormal;
-in vec2 fragmentTextureCoordinate;
-
-struct Material {
-    vec3 diffuseColor;
-    vec3 specularColor;
-    float shininess;
-}; 
-
-struct DirectionalLight {
-    vec3 direction;
-	
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-
-    bool bActive;
-};
-
-struct PointLight {
-    vec3 position;
-    
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-
-    bool bActive;
-};
-
-struct SpotLight {
-    vec3 position;
-    vec3 direction;
-    float cutOff;
-    float outerCutOff;
-  
-    float constant;
-    float linear;
-    float quadratic;
-  
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;       
-
-    bool bActive;
-};
-
-#define TOTAL_POINT_LIGHTS 5
-
-uniform bool bUseTexture=false;
-uniform bool bUseLighting=false;
-uniform vec4 objectColor = vec4(1.0f);
-uniform vec3 viewPosition;
-uniform DirectionalLight directionalLight;
-uniform PointLight pointLights[TOTAL_POINT_LIGHTS];
-uniform SpotLight spotLight;
-uniform Material material;
-uniform sampler2D objectTexture;
-uniform vec2 UVscale = vec2(1.0f, 1.0f);
-
-// the scaled texture coordinate to use in calculations
-vec2 fragmentTextureCoordinateScaled = fragmentTextureCoordinate * UVscale;
-
-// function prototypes
-vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir);
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
-
-void main()
-{   
-    if(bUseLighting == true)
-    {
-        vec3 phongResult = vec3(0.0f);
-        // properties
-        vec3 norm = normalize(fragmentVertexNormal);
-        vec3 viewDir = normalize(viewPosition - fragmentPosition);
-    
-        // == =====================================================
-        // Our lighting is set up in 3 phases: directional, point lights and an optional flashlight
-        // For each phase, a calculate function is defined that calculates the corresponding color
-        // per light source. In the main() function we take all the calculated colors and sum them 
-        // up for this fragment's final color.
-        // == =====================================================
-        // phase 1: directional lighting
-        if(directionalLight.bActive == true)
-        {
-            phongResult += CalcDirectionalLight(directionalLight, norm, viewDir);
-        }
-        // phase 2: point lights
-        for(int i = 0; i < TOTAL_POINT_LIGHTS; i++)
-        {
-	    if(pointLights[i].bActive == true)
-            {
-                phongResult += CalcPointLight(pointLights[i], norm, fragmentPosition, viewDir);   
-            }
-        } 
-        // phase 3: spot light
-        if(spotLight.bActive == true)
-        {
-            phongResult += CalcSpotLight(spotLight, norm, fragmentPosition, viewDir);    
-        }
-    
-        if(bUseTexture == true)
-        {
-            fragmentColor = vec4(phongResult, (texture(objectTexture, fragmentTextureCoordinateScaled)).a);
-        }
-        else
-        {
-            fragmentColor = vec4(phongResult, objectColor.a);
-        }
-    }
-    else
-    {
-        if(bUseTexture == true)
-        {
-            fragmentColor = texture(objectTexture, fragmentTextureCoordinateScaled);
-        }
-        else
-        {
-            fragmentColor = objectColor;
-        }
-    }
-}
-
-// calculates the color when using a directional light.
-vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir)
-{
-    vec3 ambient = vec3(0.0f);
-    vec3 diffuse = vec3(0.0f);
-    vec3 specular = vec3(0.0f);
-
-    vec3 lightDirection = normalize(-light.direction);
-    // diffuse shading
-    float diff = max(dot(normal, lightDirection), 0.0);
-    // specular shading
-    vec3 reflectDir = reflect(-lightDirection, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-    // combine results
-    if(bUseTexture == true)
-    {
-        ambient = light.ambient * vec3(texture(objectTexture, fragmentTextureCoordinateScaled));
-        diffuse = light.diffuse * diff * material.diffuseColor * vec3(texture(objectTexture, fragmentTextureCoordinateScaled));
-        specular = light.specular * spec * material.specularColor * vec3(texture(objectTexture, fragmentTextureCoordinateScaled));
-    }
-    else
-    {
-        ambient = light.ambient * vec3(objectColor);
-        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectColor);
-        specular = light.specular * spec * material.specularColor * vec3(objectColor);
-    }
-    
-    return (ambient + diffuse + specular);
-}
-
-// calculates the color when using a point light.
-vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
-{
-    vec3 ambient = vec3(0.0f);
-    vec3 diffuse = vec3(0.0f);
-    vec3 specular= vec3(0.0f);
-
-    vec3 lightDir = normalize(light.position - fragPos);
-    // diffuse shading
-    float diff = max(dot(normal, lightDir), 0.0);
-    // specular shading
-    vec3 reflectDir = reflect(-lightDir, normal);
-    // Calculate specular component
-    float specularComponent = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-   
-    // combine results
-    if(bUseTexture == true)
-    {
-        ambient = light.ambient * vec3(texture(objectTexture, fragmentTextureCoordinateScaled));
-        diffuse = light.diffuse * diff * material.diffuseColor * vec3(texture(objectTexture, fragmentTextureCoordinateScaled));
-        specular = light.specular * specularComponent * material.specularColor;
-    }
-    else
-    {
-        ambient = light.ambient * vec3(objectColor);
-        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectColor);
-        specular = light.specular * specularComponent * material.specularColor;
-    }
-    
-    return (ambient + diffuse + specular);
-}
-
-// calculates the color when using a spot light.
-vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
-{
-    vec3 ambient = vec3(0.0f);
-    vec3 diffuse = vec3(0.0f);
-    vec3 specular = vec3(0.0f);
-
-    vec3 lightDir = normalize(light.position - fragPos);
-    // diffuse shading
-    float diff = max(dot(normal, lightDir), 0.0);
-    // specular shading
-    vec3 reflectDir = reflect(-lightDir, normal);
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
-    // attenuation
-    float distance = length(light.position - fragPos);
-    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
-    // spotlight intensity
-    float theta = dot(lightDir, normalize(-light.direction)); 
-    float epsilon = light.cutOff - light.outerCutOff;
-    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
-    // combine results
-    if(bUseTexture == true)
-    {
-        ambient = light.ambient * vec3(texture(objectTexture, fragmentTextureCoordinateScaled));
-        diffuse = light.diffuse * diff * material.diffuseColor * vec3(texture(objectTexture, fragmentTextureCoordinateScaled));
-        specular = light.specular * spec * material.specularColor * vec3(texture(objectTexture, fragmentTextureCoordinateScaled));
-    }
-    else
-    {
-        ambient = light.ambient * vec3(objectColor);
-        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectColor);
-        specular = light.specular * spec * material.specularColor * vec3(objectColor);
-    }
-    
-    ambient *= attenuation * intensity;
-    diffuse *= attenuation * intensity;
-    specular *= attenuation * intensity;
-    return (ambient + diffuse + specular);
-}
+#version 330 core
+out vec4 fragmentColor;
+
+in vec3 fragmentPosition;
+in vec3 fragmentVertexNormal;
+in vec2 fragmentTextureCoordinate;
+flat in int fragmentMaterialIndex;
+flat in vec4 fragmentObjectColor;
+flat in int fragmentTextureLayer;
+
+// the uniform block layouts below are mirrored in Source/ShaderBlocks.h
+struct Material {
+    vec3 diffuseColor;
+    float shininess;
+    vec3 specularColor;
+    // below one for glass, which is blended over the opaque objects
+    float opacity;
+}; 
+
+struct DirectionalLight {
+    vec3 direction;
+	
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    bool bActive;
+};
+
+struct PointLight {
+    vec3 position;
+    
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+
+    bool bActive;
+};
+
+struct SpotLight {
+    vec3 position;
+    vec3 direction;
+    float cutOff;
+    float outerCutOff;
+  
+    float constant;
+    float linear;
+    float quadratic;
+  
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;       
+
+    bool bActive;
+};
+
+#define TOTAL_POINT_LIGHTS 5
+#define MAX_MATERIALS 64
+
+// every defined material, uploaded once
+layout(std140) uniform MaterialBlock
+{
+    Material materials[MAX_MATERIALS];
+};
+
+// the scene lights, uploaded only when they change
+layout(std140) uniform LightBlock
+{
+    DirectionalLight directionalLight;
+    PointLight pointLights[TOTAL_POINT_LIGHTS];
+    SpotLight spotLight;
+};
+
+// the camera matrices and position, uploaded once per frame
+layout(std140) uniform CameraBlock
+{
+    mat4 view;
+    mat4 projection;
+    vec3 viewPosition;
+};
+
+// the light matrices that the directional light cascades and the spot light
+// are shadowed with, filled by Source/ShadowMaps.cpp; the cascade count must
+// match Source/ShaderBlocks.h
+#define SHADOW_CASCADE_COUNT 3
+layout(std140) uniform ShadowBlock
+{
+    mat4 cascadeMatrices[SHADOW_CASCADE_COUNT];
+    mat4 spotShadowMatrix;
+    // view depth at which every cascade ends
+    vec4 cascadeSplits;
+    // world distance that a position is moved along its normal per cascade
+    vec4 cascadeNormalOffsets;
+    // x = texel size of a map, y = spot light normal offset per unit distance
+    vec4 shadowParameters;
+    bool bDirectionalShadow;
+    bool bSpotShadow;
+};
+// the cascades come first, then the spot light
+uniform sampler2DArrayShadow shadowMaps;
+
+// local lights that fade out to nothing at their radius, two texels each:
+// the position and radius, then the color, filled by Source/LightClusters.cpp
+uniform samplerBuffer localLights;
+uniform int localLightCount = 0;
+
+// the view is split into clusters, and every cluster lists the local
+// lights that reach it; the grid size must match Source/LightClusters.h
+#define CLUSTER_COLUMNS 16
+#define CLUSTER_ROWS 9
+#define CLUSTER_SLICES 24
+// offset and count of every cluster into the light index list
+uniform usamplerBuffer clusterRanges;
+uniform usamplerBuffer clusterLightIndices;
+// slice of a view depth is log(depth) * x + y
+uniform vec2 clusterDepthScale;
+
+#ifdef SHADER_VARIANT
+// the features of a variant are set by Source/ShaderVariants.cpp when it is
+// compiled, so the branches on them are removed and the light loop unrolled
+const bool bUseLighting = (USE_LIGHTING != 0);
+const bool bUseClusteredLights = (USE_CLUSTERED_LIGHTS != 0);
+const bool bDepthOnly = (DEPTH_ONLY != 0);
+const bool bUseShadows = (USE_SHADOWS != 0);
+#define DIRECTIONAL_LIGHT_ACTIVE (USE_DIRECTIONAL_LIGHT != 0)
+#define SPOT_LIGHT_ACTIVE (USE_SPOT_LIGHT != 0)
+// the active point lights are packed at the front of the block
+#define POINT_LIGHT_LOOP_COUNT ACTIVE_POINT_LIGHTS
+#define POINT_LIGHT_ACTIVE(i) true
+#else
+// the generic program decides every feature at runtime
+uniform bool bUseLighting=false;
+uniform bool bUseClusteredLights = false;
+// set while only the depth of the opaque objects is drawn
+uniform bool bDepthOnly = false;
+uniform bool bUseShadows = false;
+#define DIRECTIONAL_LIGHT_ACTIVE (directionalLight.bActive == true)
+#define SPOT_LIGHT_ACTIVE (spotLight.bActive == true)
+#define POINT_LIGHT_LOOP_COUNT TOTAL_POINT_LIGHTS
+#define POINT_LIGHT_ACTIVE(i) (pointLights[i].bActive == true)
+#endif
+// every scene texture is one layer of this array
+uniform sampler2DArray objectTextures;
+uniform vec2 UVscale = vec2(1.0f, 1.0f);
+
+// the material and color of the object being drawn, passed on from the
+// vertex shader so that they can differ between instances
+Material material;
+vec4 objectColor;
+// whether the object is textured, and its texture color sampled once
+bool bUseTexture;
+vec4 objectTextureColor;
+
+// the scaled texture coordinate to use in calculations
+vec2 fragmentTextureCoordinateScaled = fragmentTextureCoordinate * UVscale;
+
+// function prototypes
+vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, float shadow);
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir);
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shadow);
+float CalcDirectionalShadow(vec3 normal);
+float CalcSpotShadow(vec3 normal);
+vec3 CalcLocalLight(int lightIndex, vec3 normal, vec3 fragPos, vec3 viewDir);
+uvec2 GetClusterRange(vec3 fragPos);
+
+void main()
+{   
+    // the depth pre-pass writes no color, so nothing is shaded
+    if(bDepthOnly == true)
+    {
+        fragmentColor = vec4(0.0f);
+        return;
+    }
+
+    material = materials[fragmentMaterialIndex];
+    objectColor = fragmentObjectColor;
+#ifdef SHADER_VARIANT
+    bUseTexture = (USE_TEXTURE != 0);
+#else
+    bUseTexture = (fragmentTextureLayer >= 0);
+#endif
+    objectTextureColor = vec4(1.0f);
+    if(bUseTexture == true)
+    {
+        objectTextureColor = texture(objectTextures, vec3(fragmentTextureCoordinateScaled, float(fragmentTextureLayer)));
+    }
+
+    if(bUseLighting == true)
+    {
+        vec3 phongResult = vec3(0.0f);
+        // properties
+        vec3 norm = normalize(fragmentVertexNormal);
+        vec3 viewDir = normalize(viewPosition - fragmentPosition);
+    
+        // == =====================================================
+        // Our lighting is set up in 3 phases: directional, point lights and an optional flashlight
+        // For each phase, a calculate function is defined that calculates the corresponding color
+        // per light source. In the main() function we take all the calculated colors and sum them 
+        // up for this fragment's final color.
+        // == =====================================================
+        // phase 1: directional lighting
+        if(DIRECTIONAL_LIGHT_ACTIVE)
+        {
+            float shadow = 1.0f;
+            if((bUseShadows == true) && (bDirectionalShadow == true))
+            {
+                shadow = CalcDirectionalShadow(norm);
+            }
+            phongResult += CalcDirectionalLight(directionalLight, norm, viewDir, shadow);
+        }
+        // phase 2: point lights
+        for(int i = 0; i < POINT_LIGHT_LOOP_COUNT; i++)
+        {
+	    if(POINT_LIGHT_ACTIVE(i))
+            {
+                phongResult += CalcPointLight(pointLights[i], norm, fragmentPosition, viewDir);   
+            }
+        } 
+        // phase 3: spot light
+        if(SPOT_LIGHT_ACTIVE)
+        {
+            float shadow = 1.0f;
+            if((bUseShadows == true) && (bSpotShadow == true))
+            {
+                shadow = CalcSpotShadow(norm);
+            }
+            phongResult += CalcSpotLight(spotLight, norm, fragmentPosition, viewDir, shadow);
+        }
+        // phase 4: local lights, either all of them or only the ones
+        // listed for the cluster that this fragment falls into
+        if(bUseClusteredLights == true)
+        {
+            uvec2 range = GetClusterRange(fragmentPosition);
+            for(uint i = 0u; i < range.y; i++)
+            {
+                int lightIndex = int(texelFetch(clusterLightIndices, int(range.x + i)).r);
+                phongResult += CalcLocalLight(lightIndex, norm, fragmentPosition, viewDir);
+            }
+        }
+        else
+        {
+            for(int i = 0; i < localLightCount; i++)
+            {
+                phongResult += CalcLocalLight(i, norm, fragmentPosition, viewDir);
+            }
+        }
+    
+        if(bUseTexture == true)
+        {
+            fragmentColor = vec4(phongResult, objectTextureColor.a);
+        }
+        else
+        {
+            fragmentColor = vec4(phongResult, objectColor.a);
+        }
+    }
+    else
+    {
+        if(bUseTexture == true)
+        {
+            fragmentColor = objectTextureColor;
+        }
+        else
+        {
+            fragmentColor = objectColor;
+        }
+    }
+
+    fragmentColor.a *= material.opacity;
+}
+
+// calculates the color when using a directional light, of which only the
+// ambient part reaches a shadowed fragment.
+vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, float shadow)
+{
+    vec3 ambient = vec3(0.0f);
+    vec3 diffuse = vec3(0.0f);
+    vec3 specular = vec3(0.0f);
+
+    vec3 lightDirection = normalize(-light.direction);
+    // diffuse shading
+    float diff = max(dot(normal, lightDirection), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDirection, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // combine results
+    if(bUseTexture == true)
+    {
+        ambient = light.ambient * vec3(objectTextureColor);
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectTextureColor);
+        specular = light.specular * spec * material.specularColor * vec3(objectTextureColor);
+    }
+    else
+    {
+        ambient = light.ambient * vec3(objectColor);
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectColor);
+        specular = light.specular * spec * material.specularColor * vec3(objectColor);
+    }
+    
+    return (ambient + shadow * (diffuse + specular));
+}
+
+// calculates the color when using a point light.
+vec3 CalcPointLight(PointLight light, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec3 ambient = vec3(0.0f);
+    vec3 diffuse = vec3(0.0f);
+    vec3 specular= vec3(0.0f);
+
+    vec3 lightDir = normalize(light.position - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    // Calculate specular component
+    float specularComponent = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+   
+    // combine results
+    if(bUseTexture == true)
+    {
+        ambient = light.ambient * vec3(objectTextureColor);
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectTextureColor);
+        specular = light.specular * specularComponent * material.specularColor;
+    }
+    else
+    {
+        ambient = light.ambient * vec3(objectColor);
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectColor);
+        specular = light.specular * specularComponent * material.specularColor;
+    }
+    
+    return (ambient + diffuse + specular);
+}
+
+// calculates the color when using a spot light, of which only the ambient
+// part reaches a shadowed fragment.
+vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 fragPos, vec3 viewDir, float shadow)
+{
+    vec3 ambient = vec3(0.0f);
+    vec3 diffuse = vec3(0.0f);
+    vec3 specular = vec3(0.0f);
+
+    vec3 lightDir = normalize(light.position - fragPos);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // attenuation
+    float distance = length(light.position - fragPos);
+    float attenuation = 1.0 / (light.constant + light.linear * distance + light.quadratic * (distance * distance));    
+    // spotlight intensity
+    float theta = dot(lightDir, normalize(-light.direction)); 
+    float epsilon = light.cutOff - light.outerCutOff;
+    float intensity = clamp((theta - light.outerCutOff) / epsilon, 0.0, 1.0);
+    // combine results
+    if(bUseTexture == true)
+    {
+        ambient = light.ambient * vec3(objectTextureColor);
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectTextureColor);
+        specular = light.specular * spec * material.specularColor * vec3(objectTextureColor);
+    }
+    else
+    {
+        ambient = light.ambient * vec3(objectColor);
+        diffuse = light.diffuse * diff * material.diffuseColor * vec3(objectColor);
+        specular = light.specular * spec * material.specularColor * vec3(objectColor);
+    }
+    
+    ambient *= attenuation * intensity;
+    diffuse *= attenuation * intensity;
+    specular *= attenuation * intensity;
+    return (ambient + shadow * (diffuse + specular));
+}
+
+// calculates the color when using a local light, which fades out
+// smoothly so that it adds nothing at its radius.
+vec3 CalcLocalLight(int lightIndex, vec3 normal, vec3 fragPos, vec3 viewDir)
+{
+    vec4 positionRadius = texelFetch(localLights, lightIndex * 2);
+    vec3 lightColor = texelFetch(localLights, lightIndex * 2 + 1).rgb;
+    vec3 surfaceColor = vec3(objectColor);
+
+    vec3 toLight = positionRadius.xyz - fragPos;
+    float distance = length(toLight);
+    if(distance >= positionRadius.w)
+    {
+        return vec3(0.0f);
+    }
+    vec3 lightDir = toLight / max(distance, 0.0001);
+    // diffuse shading
+    float diff = max(dot(normal, lightDir), 0.0);
+    // specular shading
+    vec3 reflectDir = reflect(-lightDir, normal);
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), material.shininess);
+    // attenuation, windowed so that it reaches zero at the radius
+    float falloff = clamp(1.0 - pow(distance / positionRadius.w, 4.0), 0.0, 1.0);
+    float attenuation = (falloff * falloff) / (distance * distance + 1.0);
+    // combine results
+    if(bUseTexture == true)
+    {
+        surfaceColor = vec3(objectTextureColor);
+    }
+
+    return lightColor * attenuation * (diff * material.diffuseColor * surfaceColor + spec * material.specularColor);
+}
+
+// finds the offset and count of the light list of the cluster that the
+// passed in world position falls into.
+uvec2 GetClusterRange(vec3 fragPos)
+{
+    vec4 eyePosition = view * vec4(fragPos, 1.0);
+    vec4 clipPosition = projection * eyePosition;
+    vec2 ndcPosition = clipPosition.xy / clipPosition.w;
+
+    int column = clamp(int((ndcPosition.x * 0.5 + 0.5) * float(CLUSTER_COLUMNS)), 0, CLUSTER_COLUMNS - 1);
+    int row = clamp(int((ndcPosition.y * 0.5 + 0.5) * float(CLUSTER_ROWS)), 0, CLUSTER_ROWS - 1);
+    int slice = clamp(int(log(max(-eyePosition.z, 0.0001)) * clusterDepthScale.x + clusterDepthScale.y), 0, CLUSTER_SLICES - 1);
+
+    return texelFetch(clusterRanges, (slice * CLUSTER_ROWS + row) * CLUSTER_COLUMNS + column).rg;
+}
+
+// filters a 3x3 grid of depth compares around the passed in light clip
+// position in a layer of the shadow maps; each compare already blends four
+// texels, so the edge is soft without more taps. 1 is lit, 0 is shadowed.
+float SampleShadow(vec4 lightPosition, int layer)
+{
+    vec3 mapPosition = (lightPosition.xyz / lightPosition.w) * 0.5 + 0.5;
+    float texelSize = shadowParameters.x;
+    float lit = 0.0f;
+
+    // beyond the far plane of the light nothing casts a shadow
+    if(mapPosition.z >= 1.0)
+    {
+        return 1.0f;
+    }
+    for(int y = -1; y <= 1; y++)
+    {
+        for(int x = -1; x <= 1; x++)
+        {
+            vec2 offset = vec2(float(x), float(y)) * texelSize;
+            lit += texture(shadowMaps, vec4(mapPosition.xy + offset, float(layer), mapPosition.z));
+        }
+    }
+
+    return lit / 9.0;
+}
+
+// finds how much of the directional light reaches this fragment, from the
+// first cascade whose slice of the view it falls into.
+float CalcDirectionalShadow(vec3 normal)
+{
+    float viewDepth = -(view * vec4(fragmentPosition, 1.0)).z;
+    int cascade = 0;
+
+    while((cascade < SHADOW_CASCADE_COUNT - 1) && (viewDepth > cascadeSplits[cascade]))
+    {
+        cascade++;
+    }
+    if(viewDepth > cascadeSplits[SHADOW_CASCADE_COUNT - 1])
+    {
+        return 1.0f;
+    }
+
+    vec3 offsetPosition = fragmentPosition + normal * cascadeNormalOffsets[cascade];
+    return SampleShadow(cascadeMatrices[cascade] * vec4(offsetPosition, 1.0), cascade);
+}
+
+// finds how much of the spot light reaches this fragment; the texels of its
+// map grow with the distance, and so does the normal offset.
+float CalcSpotShadow(vec3 normal)
+{
+    float distance = length(spotLight.position - fragmentPosition);
+    vec3 offsetPosition = fragmentPosition + normal * (shadowParameters.y * distance);
+
+    return SampleShadow(spotShadowMatrix * vec4(offsetPosition, 1.0), SHADOW_CASCADE_COUNT);
+}
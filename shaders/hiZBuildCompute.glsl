@@ -0,0 +1,54 @@
+#version 430 core
+// builds one level of the hierarchical depth pyramid, each texel
+// holding the farthest depth of the texels it covers in the level
+// below; level zero is copied from the occluder depth buffer
+layout(local_size_x = 8, local_size_y = 8) in;
+
+uniform sampler2D sourceDepth;
+uniform int sourceLevel = 0;
+uniform bool bCopyLevel = false;
+
+layout(r32f, binding = 0) writeonly uniform image2D destinationLevel;
+
+void main()
+{
+   ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+   ivec2 destinationSize = imageSize(destinationLevel);
+
+   if (any(greaterThanEqual(texel, destinationSize)))
+   {
+      return;
+   }
+
+   if (bCopyLevel)
+   {
+      imageStore(destinationLevel, texel, vec4(texelFetch(sourceDepth, texel, 0).r));
+      return;
+   }
+
+   ivec2 sourceSize = textureSize(sourceDepth, sourceLevel);
+   ivec2 sourceTexel = texel * 2;
+   // an odd source size leaves a last row or column that the
+   // edge texels of the destination also have to cover
+   ivec2 footprint = ivec2(2);
+   if (((sourceSize.x & 1) != 0) && (texel.x == destinationSize.x - 1))
+   {
+      footprint.x = 3;
+   }
+   if (((sourceSize.y & 1) != 0) && (texel.y == destinationSize.y - 1))
+   {
+      footprint.y = 3;
+   }
+
+   float farthest = 0.0f;
+   for (int y = 0; y < footprint.y; y++)
+   {
+      for (int x = 0; x < footprint.x; x++)
+      {
+         ivec2 coordinate = min(sourceTexel + ivec2(x, y), sourceSize - 1);
+         farthest = max(farthest, texelFetch(sourceDepth, coordinate, sourceLevel).r);
+      }
+   }
+
+   imageStore(destinationLevel, texel, vec4(farthest));
+}
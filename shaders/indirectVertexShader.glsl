@@ -0,0 +1,68 @@
+#version 460 core
+// quantized in Source/MeshLibrary.cpp: half float positions, an
+// octahedral normal in two snorm16 values and unorm16 coordinates
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec2 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+flat out int fragmentMaterialIndex;
+flat out vec4 fragmentObjectColor;
+flat out int fragmentTextureLayer;
+// the depth pre-pass and the shading pass must produce the same depth
+invariant gl_Position;
+
+// shared by every program that draws the scene, mirrored in Source/ShaderBlocks.h
+layout(std140) uniform CameraBlock
+{
+   mat4 view;
+   mat4 projection;
+   vec3 viewPosition;
+};
+
+// per-draw data of the multi-draw indirect path, mirrored in Source/ShaderBlocks.h
+struct DrawData
+{
+   mat4 model;
+   // inverse transpose of the model matrix, made once per moved node
+   mat3 normalMatrix;
+   vec4 color;
+   vec2 uvScale;
+   uint materialIndex;
+   int textureLayer;
+};
+
+layout(std430, binding = 3) readonly buffer DrawBlock
+{
+   DrawData draws[];
+};
+
+// index of the first draw of the current multi-draw call
+uniform int drawOffset = 0;
+
+// unfold an octahedral encoded normal back onto the unit sphere,
+// the inverse of EncodeOctahedral() in Source/MeshLibrary.cpp
+vec3 DecodeOctahedral(vec2 encoded)
+{
+   vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+   float fold = max(-normal.z, 0.0);
+   normal.x += (normal.x >= 0.0) ? -fold : fold;
+   normal.y += (normal.y >= 0.0) ? -fold : fold;
+   return normalize(normal);
+}
+
+void main()
+{
+   DrawData drawData = draws[drawOffset + gl_DrawID];
+
+   fragmentMaterialIndex = int(drawData.materialIndex);
+   fragmentObjectColor = drawData.color;
+   fragmentTextureLayer = drawData.textureLayer;
+
+   fragmentPosition = vec3(drawData.model * vec4(inVertexPosition, 1.0));
+   gl_Position = projection * view * drawData.model * vec4(inVertexPosition, 1.0f);
+   fragmentVertexNormal = drawData.normalMatrix * DecodeOctahedral(inVertexNormal);
+   fragmentTextureCoordinate = inTextureCoordinate * drawData.uvScale;
+}
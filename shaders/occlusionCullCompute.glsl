@@ -0,0 +1,107 @@
+#version 430 core
+// tests the world bounds of every indirect draw against the
+// hierarchical depth pyramid and writes the instance count of
+// its command, zero when the draw is hidden behind occluders
+layout(local_size_x = 64) in;
+
+// mirrored in Source/IndirectRenderer.h
+struct DrawCommand
+{
+   uint count;
+   uint instanceCount;
+   uint firstIndex;
+   int baseVertex;
+   uint baseInstance;
+};
+
+// mirrored in Source/ShaderBlocks.h, the w of the center is
+// one for the occluders, which are always drawn
+struct DrawBounds
+{
+   vec4 center;
+   vec4 extent;
+};
+
+layout(std430, binding = 4) readonly buffer BoundsBlock
+{
+   DrawBounds bounds[];
+};
+
+layout(std430, binding = 5) buffer CommandBlock
+{
+   DrawCommand commands[];
+};
+
+uniform mat4 viewProjection;
+uniform uint drawCount;
+uniform sampler2D hiZ;
+uniform int hiZLevelCount;
+
+bool IsVisible(vec3 center, vec3 extent)
+{
+   vec2 minimumUV = vec2(1.0f);
+   vec2 maximumUV = vec2(0.0f);
+   float nearestDepth = 1.0f;
+
+   for (int corner = 0; corner < 8; corner++)
+   {
+      vec3 direction = vec3(
+         ((corner & 1) != 0) ? 1.0f : -1.0f,
+         ((corner & 2) != 0) ? 1.0f : -1.0f,
+         ((corner & 4) != 0) ? 1.0f : -1.0f);
+      vec4 clip = viewProjection * vec4(center + extent * direction, 1.0f);
+
+      // boxes reaching behind the camera are never culled
+      if (clip.w <= 0.0f)
+      {
+         return true;
+      }
+
+      vec3 ndc = clip.xyz / clip.w;
+      minimumUV = min(minimumUV, ndc.xy * 0.5f + 0.5f);
+      maximumUV = max(maximumUV, ndc.xy * 0.5f + 0.5f);
+      nearestDepth = min(nearestDepth, ndc.z * 0.5f + 0.5f);
+   }
+
+   minimumUV = clamp(minimumUV, 0.0f, 1.0f);
+   maximumUV = clamp(maximumUV, 0.0f, 1.0f);
+
+   // pick the level where the box covers at most two texels in
+   // each direction, so four texel reads bound its footprint
+   vec2 size = (maximumUV - minimumUV) * vec2(textureSize(hiZ, 0));
+   int level = int(ceil(log2(max(max(size.x, size.y), 1.0f))));
+   level = clamp(level, 0, hiZLevelCount - 1);
+
+   ivec2 levelSize = textureSize(hiZ, level);
+   ivec2 first = clamp(ivec2(minimumUV * vec2(levelSize)), ivec2(0), levelSize - 1);
+   ivec2 last = clamp(ivec2(maximumUV * vec2(levelSize)), ivec2(0), levelSize - 1);
+
+   float farthest = 0.0f;
+   for (int y = first.y; y <= last.y; y++)
+   {
+      for (int x = first.x; x <= last.x; x++)
+      {
+         farthest = max(farthest, texelFetch(hiZ, ivec2(x, y), level).r);
+      }
+   }
+
+   return (nearestDepth <= farthest);
+}
+
+void main()
+{
+   uint index = gl_GlobalInvocationID.x;
+
+   if (index >= drawCount)
+   {
+      return;
+   }
+
+   bool bVisible = true;
+   if (bounds[index].center.w == 0.0f)
+   {
+      bVisible = IsVisible(bounds[index].center.xyz, bounds[index].extent.xyz);
+   }
+
+   commands[index].instanceCount = bVisible ? 1u : 0u;
+}
@@ -0,0 +1,9 @@
+#version 330 core
+in vec4 fragmentColor;
+
+out vec4 outFragmentColor;
+
+void main()
+{
+   outFragmentColor = fragmentColor;
+}
@@ -0,0 +1,16 @@
+#version 330 core
+layout (location = 0) in vec2 inPixelPosition;
+layout (location = 1) in vec4 inColor;
+
+out vec4 fragmentColor;
+
+// size of the viewport in pixels, the overlay is laid out from
+// its top left corner
+uniform vec2 viewportSize;
+
+void main()
+{
+   vec2 position = (inPixelPosition / viewportSize) * 2.0f - 1.0f;
+   gl_Position = vec4(position.x, -position.y, 0.0f, 1.0f);
+   fragmentColor = inColor;
+}
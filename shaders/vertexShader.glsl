@@ -1,20 +1,70 @@
-#version 330 core
-layout (location = 0) in vec3 inVertexPosition;
-layout (location = 1) in vec3 inVertexNormal;
-layout (location = 2) in vec2 inTextureCoordinate;
-
-out vec3 fragmentPosition;
-out vec3 fragmentVertexNormal;
-out vec2 fragmentTextureCoordinate;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-
-void main()
-{
-   fragmentPosition = vec3(model * vec4(inVertexPosition, 1.0));
-   gl_Position = projection * view * model * vec4(inVertexPosition, 1.0f);
-   fragmentVertexNormal = inVertexNormal;
-   fragmentTextureCoordinate = inTextureCoordinate;
+#version 330 core
+// quantized in Source/MeshLibrary.cpp: half float positions, an
+// octahedral normal in two snorm16 values and unorm16 coordinates
+layout (location = 0) in vec3 inVertexPosition;
+layout (location = 1) in vec2 inVertexNormal;
+layout (location = 2) in vec2 inTextureCoordinate;
+// per-instance attributes, only read when bUseInstancing is set
+layout (location = 3) in mat4 inInstanceModel;
+layout (location = 7) in uint inInstanceMaterial;
+layout (location = 8) in vec4 inInstanceColor;
+layout (location = 9) in mat3 inInstanceNormalMatrix;
+
+out vec3 fragmentPosition;
+out vec3 fragmentVertexNormal;
+out vec2 fragmentTextureCoordinate;
+flat out int fragmentMaterialIndex;
+flat out vec4 fragmentObjectColor;
+flat out int fragmentTextureLayer;
+// the depth pre-pass and the shading pass must produce the same depth
+invariant gl_Position;
+
+// shared by every program that draws the scene, mirrored in Source/ShaderBlocks.h
+layout(std140) uniform CameraBlock
+{
+   mat4 view;
+   mat4 projection;
+   vec3 viewPosition;
+};
+
+uniform mat4 model;
+// inverse transpose of the model matrix, made on the CPU when the
+// node moves, so normals stay perpendicular under any scale
+uniform mat3 normalMatrix = mat3(1.0f);
+uniform bool bUseInstancing = false;
+uniform int materialIndex = 0;
+uniform vec4 objectColor = vec4(1.0f);
+// texture array layer of the draw, -1 when it is untextured
+uniform int textureLayer = -1;
+
+// unfold an octahedral encoded normal back onto the unit sphere,
+// the inverse of EncodeOctahedral() in Source/MeshLibrary.cpp
+vec3 DecodeOctahedral(vec2 encoded)
+{
+   vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+   float fold = max(-normal.z, 0.0);
+   normal.x += (normal.x >= 0.0) ? -fold : fold;
+   normal.y += (normal.y >= 0.0) ? -fold : fold;
+   return normalize(normal);
+}
+
+void main()
+{
+   mat4 modelMatrix = model;
+   mat3 normalModelMatrix = normalMatrix;
+   fragmentMaterialIndex = materialIndex;
+   fragmentObjectColor = objectColor;
+   fragmentTextureLayer = textureLayer;
+   if(bUseInstancing == true)
+   {
+      modelMatrix = inInstanceModel;
+      normalModelMatrix = inInstanceNormalMatrix;
+      fragmentMaterialIndex = int(inInstanceMaterial);
+      fragmentObjectColor = inInstanceColor;
+   }
+
+   fragmentPosition = vec3(modelMatrix * vec4(inVertexPosition, 1.0));
+   gl_Position = projection * view * modelMatrix * vec4(inVertexPosition, 1.0f);
+   fragmentVertexNormal = normalModelMatrix * DecodeOctahedral(inVertexNormal);
+   fragmentTextureCoordinate = inTextureCoordinate;
 }
\ No newline at end of file